@@ -1670,4 +1670,49 @@ SELECT documentdb_api.insert_one('db','lastSetWindowFields','{ "_id": 3, "storeI
 SELECT documentdb_api.insert_one('db','lastSetWindowFields','{ "_id": 4, "storeId": 4, "area": "Chennai", "company": "ABC Cares", "lastUpdated": { "$date" : { "$numberLong" : "1757235600000" } }, "status": "open" }', NULL);
 
 SELECT document FROM documentdb_api_catalog.bson_aggregation_pipeline('db',
-    '{ "aggregate": "lastSetWindowFields", "pipeline":[{"$match":{"company":{"$in":["ABC Cares"]}}}, {"$setWindowFields": {"partitionBy":"$company","sortBy": {"lastUpdated": {"$numberInt" : "1" } }, "output" : { "lastUpdatedDateForStore" : { "$last" : "$lastUpdated", "window" : { "documents" : [ "current", "unbounded" ] } } } } } ]}');
\ No newline at end of file
+    '{ "aggregate": "lastSetWindowFields", "pipeline":[{"$match":{"company":{"$in":["ABC Cares"]}}}, {"$setWindowFields": {"partitionBy":"$company","sortBy": {"lastUpdated": {"$numberInt" : "1" } }, "output" : { "lastUpdatedDateForStore" : { "$last" : "$lastUpdated", "window" : { "documents" : [ "current", "unbounded" ] } } } } } ]}');
+
+-----------------------------------------------------------
+-- Sliding $min/$max/$addToSet windows use the inverse transitions
+-----------------------------------------------------------
+-- Values repeat, mix types, are null or missing, and the current min/max leaves the window.
+SELECT documentdb_api.insert_one('db','windowInverse','{ "_id": 1, "g": 1, "v": 5 }', NULL);
+SELECT documentdb_api.insert_one('db','windowInverse','{ "_id": 2, "g": 1, "v": 3 }', NULL);
+SELECT documentdb_api.insert_one('db','windowInverse','{ "_id": 3, "g": 1, "v": 5 }', NULL);
+SELECT documentdb_api.insert_one('db','windowInverse','{ "_id": 4, "g": 1, "v": 5 }', NULL);
+SELECT documentdb_api.insert_one('db','windowInverse','{ "_id": 5, "g": 1, "v": "b" }', NULL);
+SELECT documentdb_api.insert_one('db','windowInverse','{ "_id": 6, "g": 1, "v": 1 }', NULL);
+SELECT documentdb_api.insert_one('db','windowInverse','{ "_id": 7, "g": 1, "v": 1 }', NULL);
+SELECT documentdb_api.insert_one('db','windowInverse','{ "_id": 8, "g": 1, "v": 2 }', NULL);
+SELECT documentdb_api.insert_one('db','windowInverse','{ "_id": 9, "g": 2, "v": null }', NULL);
+SELECT documentdb_api.insert_one('db','windowInverse','{ "_id": 10, "g": 2 }', NULL);
+SELECT documentdb_api.insert_one('db','windowInverse','{ "_id": 11, "g": 2, "v": "a" }', NULL);
+SELECT documentdb_api.insert_one('db','windowInverse','{ "_id": 12, "g": 2, "v": { "$numberLong": "2" } }', NULL);
+SELECT documentdb_api.insert_one('db','windowInverse','{ "_id": 13, "g": 2, "v": 2.0 }', NULL);
+
+SELECT document FROM documentdb_api_catalog.bson_aggregation_pipeline('db',
+    '{ "aggregate": "windowInverse", "pipeline":  [{"$match": {"g": 1}}, {"$setWindowFields": {"sortBy": {"_id": 1}, "output": {"maxValue": { "$max": "$v", "window": {"documents": [-2, 0]}}, "minValue": { "$min": "$v", "window": {"documents": [-2, 0]}}, "valueSet": { "$addToSet": "$v", "window": {"documents": [-2, 0]}}}}}, {"$addFields": {"valueSet": {"$sortArray": {"input": "$valueSet", "sortBy": 1}}}}, {"$project": {"g": 0}}]}');
+
+-- Compare each sliding frame against the plain (non-inverse) aggregate over the same rows
+CREATE TEMP TABLE window_inverse_values AS
+    SELECT object_id, documentdb_api_catalog.bson_expression_get(document, '{ "": "$g" }', true) AS g, documentdb_api_catalog.bson_expression_get(document, '{ "": "$v" }', true) AS v
+    FROM documentdb_api.collection('db', 'windowInverse');
+WITH numbered AS (
+    SELECT object_id, g, v, row_number() OVER (PARTITION BY g ORDER BY object_id) AS rn FROM window_inverse_values
+), moving AS (
+    SELECT object_id, g, rn, BSONMAX(v) OVER w AS max_value, BSONMIN(v) OVER w AS min_value, documentdb_api_internal.bson_add_to_set(v) OVER w AS set_value
+    FROM numbered WINDOW w AS (PARTITION BY g ORDER BY rn ROWS BETWEEN 2 PRECEDING AND CURRENT ROW)
+)
+SELECT m.object_id,
+    m.max_value OPERATOR(documentdb_core.=) p.max_value AS max_matches,
+    m.min_value OPERATOR(documentdb_core.=) p.min_value AS min_matches,
+    documentdb_api_catalog.bson_expression_get(documentdb_core.bson_repath_and_build('moving'::text, m.set_value, 'plain'::text, p.set_value), '{ "": { "$setEquals": [ "$moving", "$plain" ] } }', true) AS set_matches
+FROM moving m, LATERAL (
+    SELECT BSONMAX(n.v) AS max_value, BSONMIN(n.v) AS min_value, documentdb_api_internal.bson_add_to_set(n.v) AS set_value
+    FROM numbered n WHERE n.g OPERATOR(documentdb_core.=) m.g AND n.rn BETWEEN m.rn - 2 AND m.rn) p
+ORDER BY m.object_id;
+DROP TABLE window_inverse_values;
+
+-- Sliding $maxN/$minN windows keep the frame sorted and remove rows with the inverse transition
+SELECT document FROM documentdb_api_catalog.bson_aggregation_pipeline('db',
+    '{ "aggregate": "windowInverse", "pipeline":  [{"$match": {"g": 1}}, {"$setWindowFields": {"sortBy": {"_id": 1}, "output": {"maxValues": { "$maxN": {"input": "$v", "n": 2}, "window": {"documents": [-2, 0]}}, "minValues": { "$minN": {"input": "$v", "n": 2}, "window": {"documents": [-2, 0]}}}}}, {"$project": {"g": 0}}]}');
@@ -165,3 +165,21 @@ SELECT document FROM documentdb_api_catalog.bson_aggregation_pipeline('db', '{ "
 
 /* Explain */
 EXPLAIN (VERBOSE ON, COSTS OFF) SELECT document FROM documentdb_api_catalog.bson_aggregation_pipeline('db', '{ "aggregate": "dollarBucketAuto", "pipeline": [ { "$bucketAuto": { "groupBy": "$price", "buckets": 3 } } ] }');
+
+/* approximate $bucketAuto */
+SET documentdb.enableApproximateBucketAuto TO on;
+-- 100 values of 10, 101 of 20 and 100 of 30 as int, long and date: the quantiles are exact
+SELECT COUNT(*) FROM (SELECT documentdb_api.insert_one('db','approxBucketAuto', FORMAT('{ "_id": %s, "i": %s, "l": { "$numberLong": "%s" }, "d": { "$date": { "$numberLong": "%s" } } }', i, v, v, 1700000000000 + v)::bson, NULL) FROM (SELECT i, CASE WHEN i <= 100 THEN 10 WHEN i <= 201 THEN 20 ELSE 30 END AS v FROM generate_series(1, 301) i) vals) ins;
+-- the boundaries keep the type of the values
+SELECT document FROM documentdb_api_catalog.bson_aggregation_pipeline('db', '{ "aggregate": "approxBucketAuto", "pipeline": [ { "$bucketAuto": { "groupBy": "$i", "buckets": 2 } }, { "$sort": { "_id.min": 1 } } ] }');
+SELECT document FROM documentdb_api_catalog.bson_aggregation_pipeline('db', '{ "aggregate": "approxBucketAuto", "pipeline": [ { "$bucketAuto": { "groupBy": "$l", "buckets": 2 } }, { "$sort": { "_id.min": 1 } } ] }');
+SELECT document FROM documentdb_api_catalog.bson_aggregation_pipeline('db', '{ "aggregate": "approxBucketAuto", "pipeline": [ { "$bucketAuto": { "groupBy": "$d", "buckets": 2 } }, { "$sort": { "_id.min": 1 } } ] }');
+-- equal quantiles are merged into a single bucket
+SELECT document FROM documentdb_api_catalog.bson_aggregation_pipeline('db', '{ "aggregate": "approxBucketAuto", "pipeline": [ { "$bucketAuto": { "groupBy": "$i", "buckets": 4 } }, { "$sort": { "_id.min": 1 } } ] }');
+SELECT document FROM documentdb_api_catalog.bson_aggregation_pipeline('db', '{ "aggregate": "approxBucketAuto", "pipeline": [ { "$bucketAuto": { "groupBy": { "$literal": 7 }, "buckets": 3 } }, { "$sort": { "_id.min": 1 } } ] }');
+-- null and missing values go into the first bucket
+SELECT documentdb_api.insert_one('db','approxBucketAuto','{ "_id": 302, "i": null }', NULL);
+SELECT documentdb_api.insert_one('db','approxBucketAuto','{ "_id": 303 }', NULL);
+SELECT document FROM documentdb_api_catalog.bson_aggregation_pipeline('db', '{ "aggregate": "approxBucketAuto", "pipeline": [ { "$bucketAuto": { "groupBy": "$i", "buckets": 2 } }, { "$sort": { "_id.min": 1 } } ] }');
+SELECT document FROM documentdb_api_catalog.bson_aggregation_pipeline('db', '{ "aggregate": "approxBucketAuto", "pipeline": [ { "$match": { "i": null } }, { "$bucketAuto": { "groupBy": "$i", "buckets": 2 } } ] }');
+RESET documentdb.enableApproximateBucketAuto;
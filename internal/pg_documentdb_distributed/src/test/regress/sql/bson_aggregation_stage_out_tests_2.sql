@@ -204,4 +204,50 @@ SELECT * FROM aggregate_cursor_first_page('db', '{ "aggregate": "source", "pipel
 
 -- out should fail when query has mutable function, if query non existent collection or query has $sample stage
 SELECT * FROM  aggregate_cursor_first_page('db', '{ "aggregate": "nonImmutable", "pipeline": [ {"$lookup": {"from": "bar", "as": "x", "localField": "f_id", "foreignField": "_id"}}, {"$out" :  "bar" } ], "cursor": { "batchSize": 1 } }', 4294967294);
-SELECT * FROM  aggregate_cursor_first_page('db', '{ "aggregate": "nonImmutable", "pipeline": [ { "$sample": { "size": 1000000 } }, {"$out" :  "bar" } ], "cursor": { "batchSize": 1 } }', 4294967294);
\ No newline at end of file
+SELECT * FROM  aggregate_cursor_first_page('db', '{ "aggregate": "nonImmutable", "pipeline": [ { "$sample": { "size": 1000000 } }, {"$out" :  "bar" } ], "cursor": { "batchSize": 1 } }', 4294967294);
+
+-- $out bulk load: the target keeps its identity, options and indexes, the non-unique secondary indexes are rebuilt after the load
+SET documentdb.enableOutStageBulkLoad TO on;
+SET documentdb.enableSchemaValidation TO on;
+SELECT documentdb_api.insert('outbulkdb', '{"insert":"bulkSource", "documents":[
+   { "_id" : 1, "a" : 1, "b" : "x" },
+   { "_id" : 2, "a" : 2, "b" : "y" },
+   { "_id" : 3, "a" : 3, "b" : "z" }
+]}');
+SELECT documentdb_api.create_collection_view('outbulkdb', '{ "create": "bulkTarget", "validator": { "a": { "$type": "int" } }, "validationLevel": "strict", "validationAction": "error" }');
+SELECT documentdb_api.insert('outbulkdb', '{"insert":"bulkTarget", "documents":[ { "_id" : 100, "a" : 100, "b" : "w" } ]}');
+SELECT documentdb_api_internal.create_indexes_non_concurrently('outbulkdb', '{ "createIndexes": "bulkTarget", "indexes": [{ "key": { "a": 1 }, "name": "a_1" }, { "key": { "b": 1 }, "name": "b_1", "unique": true }] }'::documentdb_core.bson, true);
+
+CREATE TEMP TABLE out_bulk_target_before AS
+    SELECT c.collection_id, c.collection_uuid, c.validator, pg_catalog.pg_get_indexdef(i.indexrelid) AS indexdef
+    FROM documentdb_api_catalog.collections c
+    JOIN pg_catalog.pg_index i ON i.indrelid = ('documentdb_data.documents_' || c.collection_id)::regclass
+    WHERE c.database_name = 'outbulkdb' AND c.collection_name = 'bulkTarget';
+
+SELECT * FROM aggregate_cursor_first_page('outbulkdb', '{ "aggregate": "bulkSource", "pipeline": [ {"$out" : "bulkTarget"} ], "cursor": { "batchSize": 1 } }', 4294967294);
+SELECT document FROM documentdb_api.collection('outbulkdb', 'bulkTarget') ORDER BY object_id;
+
+-- every index of the target is back with the same definition on the same collection
+SELECT COUNT(*) AS indexes, COUNT(i.indexrelid) AS same_indexes,
+       bool_and(c.collection_id = b.collection_id AND c.collection_uuid = b.collection_uuid AND c.validator OPERATOR(documentdb_core.=) b.validator) AS same_collection
+    FROM out_bulk_target_before b
+    JOIN documentdb_api_catalog.collections c ON c.database_name = 'outbulkdb' AND c.collection_name = 'bulkTarget'
+    LEFT JOIN pg_catalog.pg_index i ON i.indrelid = ('documentdb_data.documents_' || c.collection_id)::regclass
+        AND i.indisvalid AND pg_catalog.pg_get_indexdef(i.indexrelid) = b.indexdef;
+
+-- a failure in the middle of the load leaves the target as it was
+SELECT documentdb_api.insert('outbulkdb', '{"insert":"bulkSource", "documents":[ { "_id" : 4, "a" : "not an int", "b" : "v" } ]}');
+SELECT * FROM aggregate_cursor_first_page('outbulkdb', '{ "aggregate": "bulkSource", "pipeline": [ {"$out" : "bulkTarget"} ], "cursor": { "batchSize": 1 } }', 4294967294);
+SELECT document FROM documentdb_api.collection('outbulkdb', 'bulkTarget') ORDER BY object_id;
+SELECT COUNT(*) AS indexes, COUNT(i.indexrelid) AS same_indexes,
+       bool_and(c.collection_id = b.collection_id AND c.collection_uuid = b.collection_uuid AND c.validator OPERATOR(documentdb_core.=) b.validator) AS same_collection
+    FROM out_bulk_target_before b
+    JOIN documentdb_api_catalog.collections c ON c.database_name = 'outbulkdb' AND c.collection_name = 'bulkTarget'
+    LEFT JOIN pg_catalog.pg_index i ON i.indrelid = ('documentdb_data.documents_' || c.collection_id)::regclass
+        AND i.indisvalid AND pg_catalog.pg_get_indexdef(i.indexrelid) = b.indexdef;
+
+RESET documentdb.enableSchemaValidation;
+RESET documentdb.enableOutStageBulkLoad;
+DROP TABLE out_bulk_target_before;
+SELECT documentdb_api.drop_collection('outbulkdb', 'bulkSource');
+SELECT documentdb_api.drop_collection('outbulkdb', 'bulkTarget');
@@ -167,4 +167,34 @@ set local documentdb.forceIndexOnlyScanIfAvailable to on;
 EXPLAIN (ANALYZE ON, COSTS OFF, VERBOSE ON, TIMING OFF, SUMMARY OFF)
     SELECT document FROM bson_aggregation_pipeline('idx_only_scan_db', '{ "aggregate" : "idx_only_scan_sharded", "pipeline" : [{ "$match" : {"shardKey": {"$eq": 5 } } }, { "$count": "c" } ]}');
 
-ROLLBACK;
\ No newline at end of file
+ROLLBACK;
+
+-- covered inclusion projections are rebuilt from the composite index terms (missing paths stay missing)
+SET documentdb.enableCoveredProjectionIndexOnlyScan to on;
+SET citus.next_shard_id TO 691000;
+SELECT COUNT(documentdb_api.insert_one('idx_only_scan_db', 'idx_only_scan_covered', bson_build_document('_id'::text, i, 'a'::text, i % 3, 'b'::text, i, 'c'::text, i * 10))) FROM generate_series(1, 10) i;
+SELECT documentdb_api.insert_one('idx_only_scan_db', 'idx_only_scan_covered', '{"_id": 11, "a": 1, "b": 11 }');
+SELECT documentdb_api_internal.create_indexes_non_concurrently('idx_only_scan_db', '{ "createIndexes": "idx_only_scan_covered", "indexes": [ { "key": { "a": 1, "b": 1, "c": 1 }, "storageEngine": { "enableOrderedIndex": true }, "name": "a_b_c_1" }] }', true);
+VACUUM (ANALYZE ON, FREEZE ON) documentdb_data.documents_69003;
+SELECT document FROM bson_aggregation_pipeline('idx_only_scan_db', '{ "aggregate" : "idx_only_scan_covered", "pipeline" : [{ "$match" : {"a": 1, "b": {"$gt": 2}} }, { "$project": { "_id": 0, "a": 1, "b": 1, "c": 1 } }, { "$sort": { "b": 1 } }]}');
+SELECT document FROM bson_aggregation_pipeline('idx_only_scan_db', '{ "aggregate" : "idx_only_scan_covered", "pipeline" : [{ "$match" : {"a": 2} }, { "$project": { "_id": 0, "b": 1 } }, { "$sort": { "b": 1 } }]}');
+
+-- _id is not in the index, so it can't be covered
+SELECT document FROM bson_aggregation_pipeline('idx_only_scan_db', '{ "aggregate" : "idx_only_scan_covered", "pipeline" : [{ "$match" : {"a": 2} }, { "$project": { "a": 1, "b": 1 } }, { "$sort": { "b": 1 } }]}');
+
+-- the covered projection only reads the index, the others need the document from the heap
+EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_pipeline('idx_only_scan_db', '{ "aggregate" : "idx_only_scan_covered", "pipeline" : [{ "$match" : {"a": 2} }, { "$project": { "_id": 0, "b": 1 } }]}');
+EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_pipeline('idx_only_scan_db', '{ "aggregate" : "idx_only_scan_covered", "pipeline" : [{ "$match" : {"a": 2} }, { "$project": { "a": 1, "b": 1 } }]}');
+EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_pipeline('idx_only_scan_db', '{ "aggregate" : "idx_only_scan_covered", "pipeline" : [{ "$match" : {"a": 2} }, { "$project": { "_id": 0, "b": 1, "d": 1 } }]}');
+SET documentdb.enableCoveredProjectionIndexOnlyScan to off;
+EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_pipeline('idx_only_scan_db', '{ "aggregate" : "idx_only_scan_covered", "pipeline" : [{ "$match" : {"a": 2} }, { "$project": { "_id": 0, "b": 1 } }]}');
+RESET documentdb.enableCoveredProjectionIndexOnlyScan;
+
+-- aggregates don't read the rebuilt document, so documents missing an index path (_id 11 has no c) count the same with and without index only scans
+EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_pipeline('idx_only_scan_db', '{ "aggregate" : "idx_only_scan_covered", "pipeline" : [{ "$match" : {"a": 1} }, { "$count": "count" }]}');
+SELECT document FROM bson_aggregation_pipeline('idx_only_scan_db', '{ "aggregate" : "idx_only_scan_covered", "pipeline" : [{ "$match" : {"a": 1} }, { "$count": "count" }]}');
+SELECT document FROM bson_aggregation_pipeline('idx_only_scan_db', '{ "aggregate" : "idx_only_scan_covered", "pipeline" : [{ "$match" : {"a": 1, "b": {"$gt": 5}} }, { "$group" : { "_id" : "1", "n" : { "$sum" : 1 } } }]}');
+set documentdb.enableIndexOnlyScan to off;
+SELECT document FROM bson_aggregation_pipeline('idx_only_scan_db', '{ "aggregate" : "idx_only_scan_covered", "pipeline" : [{ "$match" : {"a": 1} }, { "$count": "count" }]}');
+SELECT document FROM bson_aggregation_pipeline('idx_only_scan_db', '{ "aggregate" : "idx_only_scan_covered", "pipeline" : [{ "$match" : {"a": 1, "b": {"$gt": 5}} }, { "$group" : { "_id" : "1", "n" : { "$sum" : 1 } } }]}');
+set documentdb.enableIndexOnlyScan to on;
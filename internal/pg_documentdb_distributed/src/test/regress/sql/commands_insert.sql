@@ -145,4 +145,17 @@ select documentdb_api.insert_one('db', 'duplicatetests', '{"_id": "duplicate1",
 select documentdb_api.insert_one('db', 'duplicatetests', '{"_id": "duplicate2", "a": {"$numberInt": "1"}, "a": {"$numberInt": "2"}}');
 select documentdb_api.insert_one('db', 'duplicatetests', '{"_id": "duplicate3", "a": {"$numberInt": "1"}, "b": {"$numberInt": "2"}}');
 -- storage size of duplicate2 and duplicate3 should be same.
-SELECT document FROM documentdb_api_catalog.bson_aggregation_pipeline('db', '{ "aggregate": "duplicatetests", "pipeline": [{"$project": { "storageSize": {"$bsonSize": "$$ROOT"} } }] }');
\ No newline at end of file
+SELECT document FROM documentdb_api_catalog.bson_aggregation_pipeline('db', '{ "aggregate": "duplicatetests", "pipeline": [{"$project": { "storageSize": {"$bsonSize": "$$ROOT"} } }] }');
+
+-- batched inserts into the local table through the table access method
+SET documentdb.enableDirectMultiInsert TO on;
+begin;
+select documentdb_api.insert('db', '{"insert":"into", "documents":[{"_id":1,"a":1},{"_id":2,"a":2},{"_id":3,"a":3}]}');
+select document from documentdb_api.collection('db','into') where document @@ '{}' order by document-> '_id';
+rollback;
+-- a duplicate _id in the batch falls back to inserting one document at a time
+begin;
+select documentdb_api.insert('db', '{"insert":"into", "documents":[{"_id":1,"a":1},{"_id":1,"a":2},{"_id":2,"a":3}],"ordered":false}');
+select document from documentdb_api.collection('db','into') where document @@ '{}' order by document-> '_id';
+rollback;
+SET documentdb.enableDirectMultiInsert TO off;
\ No newline at end of file
@@ -48,6 +48,17 @@ typedef enum QueryCursorType
 	QueryCursorType_Persistent,
 } QueryCursorType;
 
+/*
+ * Deferred work for a $out stage that loads its results into the truncated
+ * target without its non-unique secondary indexes: once the query is drained,
+ * the indexes are created again with their original definitions.
+ */
+typedef struct OutStageBulkLoadState
+{
+	/* The CREATE INDEX commands of the indexes dropped for the load */
+	List *indexCreationCommands;
+} OutStageBulkLoadState;
+
 /*
  * Tracks the overall query spec data
  * that can be extracted from the query.
@@ -82,6 +93,12 @@ typedef struct
 	 * The time system variables ($$NOW, $$CLUSTER_TIME).
 	 */
 	TimeSystemVariables timeSystemVariables;
+
+	/*
+	 * Set if a $out stage loads into a target whose indexes need to be
+	 * rebuilt with CompleteOutStageBulkLoad after the query is drained.
+	 */
+	OutStageBulkLoadState *outStageBulkLoad;
 } QueryData;
 
 
@@ -107,6 +124,8 @@ Query * GenerateAggregationQuery(text *database, pgbson *aggregationSpec,
 								 QueryData *queryData, bool addCursorParams,
 								 bool setStatementTimeout);
 
+void CompleteOutStageBulkLoad(OutStageBulkLoadState *bulkLoadState);
+
 int64_t ParseGetMore(text **databaseName, pgbson *getMoreSpec, QueryData *queryData, bool
 					 setStatementTimeout);
 
@@ -179,6 +179,12 @@ typedef struct
 
 	/*Parent Stage Name*/
 	ParentStageName parentStageName;
+
+	/* Whether the caller completes a $out bulk load after draining the query */
+	bool allowOutStageBulkLoad;
+
+	/* The pending $out bulk load (if any) */
+	OutStageBulkLoadState *outStageBulkLoad;
 } AggregationPipelineBuildContext;
 
 
@@ -35,6 +35,22 @@
 extern PGDLLIMPORT const StringView IdFieldStringView;
 
 
+/* How far clients may relax the durability of writes through writeConcern */
+typedef enum WriteConcernRelaxationPolicy
+{
+	/* writeConcern is ignored, every write waits for the WAL flush */
+	WriteConcernRelaxation_None = 0,
+
+	/* { j: false } and { w: 0 } writes commit asynchronously */
+	WriteConcernRelaxation_Journal = 1,
+
+	/* In addition, the gateway acknowledges { w: 0 } writes before running them */
+	WriteConcernRelaxation_Unacknowledged = 2,
+} WriteConcernRelaxationPolicy;
+
+extern int WriteConcernRelaxation;
+
+
 /*
  * ApiGucPrefix.enable_create_collection_on_insert GUC determines whether
  * an insert into a non-existent collection should create a collection.
@@ -94,10 +110,12 @@ pgbson * RewriteDocumentWithCustomObjectId(pgbson *document,
 
 void ValidateIdField(const bson_value_t *idValue);
 void SetExplicitStatementTimeout(int timeoutMilliseconds);
+bool ApplyWriteConcernDurability(const bson_value_t *writeConcern);
 
 void CommitWriteProcedureAndReacquireCollectionLock(MongoCollection *collection,
 													Oid shardTableOid,
-													bool setSnapshot);
+													bool setSnapshot,
+													bool isAsyncCommit);
 
 extern bool SimulateRecoveryState;
 extern bool DocumentDBPGReadOnlyForDiskFull;
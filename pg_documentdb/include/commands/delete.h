@@ -38,6 +38,9 @@ typedef struct
 
 	/* collation string */
 	const char collationString[MAX_ICU_COLLATION_LENGTH];
+
+	/* whether to skip candidates locked by other transactions */
+	bool skipLockedCandidates;
 } DeleteOneParams;
 
 
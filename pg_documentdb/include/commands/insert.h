@@ -22,4 +22,26 @@ bool InsertOrReplaceDocument(uint64 collectionId, const char *shardTableName, in
 							 shardKeyValue,
 							 pgbson *objectId, pgbson *document,
 							 const bson_value_t *updateSpecValue);
+
+/*
+ * Outcome of InsertOrUpdateDocument.
+ */
+typedef enum InsertOrUpdateResult
+{
+	/* no document had the object_id, the document was inserted */
+	INSERT_OR_UPDATE_INSERTED,
+
+	/* the update modified the conflicting document */
+	INSERT_OR_UPDATE_UPDATED,
+
+	/* the update was a no-op on the conflicting document */
+	INSERT_OR_UPDATE_UNCHANGED
+} InsertOrUpdateResult;
+
+InsertOrUpdateResult InsertOrUpdateDocument(uint64 collectionId,
+											const char *shardTableName,
+											int64 shardKeyValue, pgbson *objectId,
+											pgbson *document,
+											const bson_value_t *updateSpecValue,
+											const bson_value_t *querySpecValue);
 #endif
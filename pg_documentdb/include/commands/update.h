@@ -58,6 +58,9 @@ typedef struct
 
 	/* parsed variable spec */
 	const bson_value_t *variableSpec;
+
+	/* whether to skip candidates locked by other transactions */
+	bool skipLockedCandidates;
 } UpdateOneParams;
 
 
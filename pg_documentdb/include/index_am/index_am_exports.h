@@ -13,6 +13,7 @@
 
 #include <postgres.h>
 #include <utils/rel.h>
+#include <utils/snapshot.h>
 
 struct IndexScanDescData;
 struct ExplainState;
@@ -22,6 +23,18 @@ typedef void (*TryExplainIndexFunc)(struct IndexScanDescData *scan, struct
 
 typedef bool (*GetMultikeyStatusFunc)(Relation indexRelation);
 typedef bool (*GetTruncationStatusFunc)(Relation indexRelation);
+typedef bool (*GetPendingListStatusFunc)(Relation indexRelation);
+
+/*
+ * Called once per distinct index term, in index order. Returning false
+ * stops the enumeration.
+ */
+typedef bool (*IndexTermCallbackFunc)(Datum term, void *state);
+typedef bool (*EnumerateDistinctTermsFunc)(Relation indexRelation,
+										   Relation heapRelation,
+										   Snapshot snapshot,
+										   IndexTermCallbackFunc callback,
+										   void *state);
 
 /*
  * Data structure for an alternative index acess method for indexing bosn.
@@ -63,6 +76,19 @@ typedef struct
 
 	/* Optional function to that returns the truncation status of an index */
 	GetTruncationStatusFunc get_truncation_status;
+
+	/*
+	 * Optional function that returns whether an index can have entries in a
+	 * pending list, which ordered and index only scans can't read.
+	 */
+	GetPendingListStatusFunc get_pending_list_status;
+
+	/*
+	 * Optional function that walks the distinct terms of a single column index
+	 * that still have a tuple visible to the snapshot. Returns false if the
+	 * index can't be enumerated at this time.
+	 */
+	EnumerateDistinctTermsFunc enumerate_distinct_terms;
 } BsonIndexAmEntry;
 
 /*
@@ -42,6 +42,7 @@ bool IsCompositeOpClass(Relation indexRelation);
 
 bool IsCompositeOpFamilyOid(Oid relam, Oid opFamilyOid);
 bool IsCompositeOpFamilyOidWithParallelSupport(Oid relam, Oid opFamilyOid);
+bool IsSinglePathOpFamilyOidWithParallelSupport(Oid relam, Oid opFamilyOid);
 
 /*
  * Whether the Oid of the oprator family points to a single path operator family.
@@ -60,11 +61,14 @@ bool IsHashedPathOpFamilyOid(Oid relam, Oid opFamilyOid);
 bool IsOrderBySupportedOnOpClass(Oid indexAm, Oid IndexPathOpFamilyAm);
 
 GetMultikeyStatusFunc GetMultiKeyStatusByRelAm(Oid relam);
+bool IndexMayHavePendingList(Oid relam, Oid indexOid);
+EnumerateDistinctTermsFunc GetEnumerateDistinctTermsByRelAm(Oid relam);
 bool GetIndexSupportsBackwardsScan(Oid relam);
 
 bool GetIndexAmSupportsIndexOnlyScan(Oid indexAm, Oid opFamilyOid,
 									 GetMultikeyStatusFunc *getMultiKeyStatus,
 									 GetTruncationStatusFunc *getTruncationStatus);
+bool GetIndexAmSupportsSinglePathIndexOnlyScan(Oid indexAm, Oid opFamilyOid);
 
 void TryExplainByIndexAm(struct IndexScanDescData *scan, struct ExplainState *es);
 
@@ -48,6 +48,9 @@
 
 #define QUERY_ID_INSERT_OR_REPLACE (23L << 32)
 #define QUERY_ID_INSERT_OR_REPLACE_NEW (24L << 32)
+#define QUERY_ID_INSERT_OR_UPDATE (25L << 32)
+#define QUERY_ID_INSERT_OR_UPDATE_SELECT_CONFLICT (26L << 32)
+#define QUERY_ID_INSERT_OR_UPDATE_CONFLICT (27L << 32)
 
 #define QUERY_DELETE_WITH_FILTER_LET_AND_COLLATION (30L << 32)
 #define QUERY_DELETE_WITH_FILTER_SHARDKEY_LET_AND_COLLATION (31L << 32)
@@ -57,6 +60,11 @@
 #define QUERY_DELETE_ONE_LET_AND_COLLATION (34L << 32)
 #define QUERY_DELETE_ONE_ID_LET_AND_COLLATION (35L << 32)
 
+#define QUERY_DELETE_BY_OBJECT_ID_ARRAY (39L << 32)
+
+/* variant of a query that skips rows locked by other transactions */
+#define QUERY_VARIANT_SKIP_LOCKED (1L)
+
 
 #define QUERY_UPDATE_SELECT_UPDATE_CANDIDATE_LET_AND_COLLATION (36L << 32)
 #define QUERY_UPDATE_SELECT_UPDATE_CANDIDATE_NON_OBJECT_ID_LET_AND_COLLATION (37L << 32)
@@ -120,6 +128,9 @@
 	QUERY_UPDATE_MANY_WITH_QUERY_FILTER_OPERATOR_WITH_SHARD_KEY_AND_OBJECT_ID + \
 	QUERY_UPDATE_MANY_WITH_NEW_UPDATE_BSON_OFFSET
 
+#define QUERY_UPDATE_SELECT_BY_OBJECT_ID_ARRAY (56L << 32)
+#define QUERY_UPDATE_BY_OBJECT_ID_ARRAY (57L << 32)
+
 
 /* GUC that controls the query plan cache size */
 extern int QueryPlanCacheSizeLimit;
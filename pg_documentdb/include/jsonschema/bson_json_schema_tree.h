@@ -11,6 +11,7 @@
 #ifndef BSON_JSON_SCHEMA_TREE_H
 #define BSON_JSON_SCHEMA_TREE_H
 
+#include <utils/hsearch.h>
 #include "query/bson_compare.h"
 
 #include "types/pcre_regex.h"
@@ -129,6 +130,16 @@ typedef struct ValidationsObject
 	/* List of child field nodes */
 	SchemaFieldNode *properties;
 
+	/* Number of nodes in the properties list */
+	int32_t numProperties;
+
+	/*
+	 * Hash of field name to the matching node of the properties list.
+	 * Only built once the list grows past a few fields, so that large
+	 * schemas don't need a linear scan per document field.
+	 */
+	HTAB *propertiesHash;
+
 	/* Array of required field names */
 	bson_value_t *required;
 } ValidationsObject;
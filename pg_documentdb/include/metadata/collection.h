@@ -15,6 +15,7 @@
 #include <access/attnum.h>
 #include <utils/uuid.h>
 #include <utils/array.h>
+#include <nodes/pg_list.h>
 
 #include "io/bson_core.h"
 
@@ -32,6 +33,9 @@
 #define DOCUMENT_DATA_TABLE_DOCUMENT_VAR_COLLATION (InvalidOid)
 #define DOCUMENT_DATA_TABLE_DOCUMENT_VAR_TYPMOD ((int32) (-1))
 
+/* name of the optional column holding the indexed fields of the document */
+#define DOCUMENT_DATA_TABLE_INDEX_KEY_COLUMN_NAME "index_document"
+
 
 /* Attribute number constants for the layout of the data table */
 #define DOCUMENT_DATA_TABLE_SHARD_KEY_VALUE_VAR_ATTR_NUMBER ((AttrNumber) 1)
@@ -111,6 +115,9 @@ typedef struct
 	/* creation_time column attribute number */
 	AttrNumber mongoDataCreationTimeVarAttrNumber;
 
+	/* index_document column attribute number, -1 if the collection doesn't have one */
+	AttrNumber indexKeyColumnAttrNumber;
+
 	/*
 	 * An optional name for the shardTable if it has a distributed table associated with it
 	 * on the current node or empty string (Default) if unavailable.
@@ -215,6 +222,12 @@ Oid GetRelationIdForCollectionId(uint64 collectionId, LOCKMODE lockMode);
 /* c-wrapper for create_collection() */
 bool CreateCollection(Datum dbNameDatum, Datum collectionNameDatum);
 
+/* adds the index_document column to a newly created collection */
+void AddIndexKeyColumn(uint64 collectionId, List *indexKeyFields);
+
+/* get the top level fields held in the index_document column of a collection */
+List * GetIndexKeyColumnFields(const MongoCollection *collection);
+
 /* c-wrapper for rename_collection() */
 void RenameCollection(Datum dbNameDatum, Datum srcCollectionNameDatum, Datum
 					  destCollectionNameDatum, bool dropTarget);
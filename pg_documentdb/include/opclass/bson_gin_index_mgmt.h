@@ -97,6 +97,8 @@ typedef struct
  * { "$**": 1, { "wildcardProjection": { "a.b": 0, "_id": 1 } } }
  * Holds information on whether it's an inclusion/exclusion index and the set of paths
  * to be considered for indexing.
+ * For inclusion projections, pathPrefix optionally holds the dotted path prefix shared
+ * by all included paths, which is elided from the index terms.
  */
 typedef struct
 {
@@ -104,6 +106,7 @@ typedef struct
 	bool isExclusion;
 	bool includeId;
 	int pathSpec;
+	int pathPrefix;
 } BsonGinWildcardProjectionPathOptions;
 
 /*
@@ -208,6 +211,7 @@ typedef struct SortIndexInputDetails
 
 struct IndexPath;
 bool CompositeIndexSupportsIndexOnlyScan(const struct IndexPath *indexPath);
+bool SinglePathIndexSupportsIndexOnlyScan(const struct IndexPath *indexPath);
 
 int32_t GetCompositeOpClassColumnNumber(const char *currentPath, void *contextOptions,
 										int8_t *sortDirection);
@@ -21,6 +21,12 @@ extern bool EnableSchemaValidation;
 
 ExprEvalState * PrepareForSchemaValidation(pgbson *schemaValidationInfo, MemoryContext
 										   memoryContext);
+ExprEvalState * PrepareForCollectionSchemaValidation(const MongoCollection *collection,
+													 MemoryContext memoryContext);
+void FreeSchemaValidationState(const MongoCollection *collection, ExprEvalState *state,
+							   MemoryContext memoryContext);
+void ResetSchemaValidationCache(void);
+void ReleaseRetiredSchemaValidationStates(void);
 void AssignSchemaValidationState(ExprEvalState *state, pgbson *schemaValidationInfo,
 								 MemoryContext memoryContext);
 void ValidateSchemaOnDocumentInsert(ExprEvalState *evalState, const
@@ -19,7 +19,7 @@
 #include <port/atomics.h>
 
 #define MAX_FEATURE_NAME_LENGTH 255
-#define MAX_FEATURE_COUNT 349
+#define MAX_FEATURE_COUNT 350
 
 /* Internal features that are not exposed */
 #define INTERNAL_FEATURE_TYPE MAX_FEATURE_COUNT
@@ -405,7 +405,12 @@ typedef enum
 	FEATURE_UPDATE_OPERATOR_UNSET,
 
 	/* Feature usage stats */
+	FEATURE_USAGE_DIRECT_MULTI_INSERT,
+	FEATURE_USAGE_DISTINCT_INDEX_TERM_SCAN,
+	FEATURE_USAGE_SET_BASED_DELETE_BY_ID,
+	FEATURE_USAGE_SET_BASED_UPDATE_BY_ID,
 	FEATURE_USAGE_TTL_PURGER_CALLS,
+	FEATURE_USAGE_UPDATE_IN_PLACE_PATCH,
 
 	/* Feature mapping region - User CRUD*/
 	FEATURE_USER_CREATE,
@@ -13,5 +13,6 @@
 
 void set_indexsafe_procflags(void);
 void PopAllActiveSnapshots(void);
+void ValidateReadyIndexConcurrently(Oid heapRelationId, Oid indexRelationId);
 
 #endif
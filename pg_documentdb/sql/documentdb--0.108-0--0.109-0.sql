@@ -7,6 +7,7 @@
 #include "udfs/rum/bson_rum_shard_exclusion_functions--0.109-0.sql"
 #include "schema/unique_shard_path_operator_class--0.109-0.sql"
 #include "udfs/aggregation/bson_aggregation_getmore--0.109-0.sql"
+#include "udfs/aggregation/bson_bucket_auto--0.109-0.sql"
 
 #include "schema/background_index_queue--0.109-0.sql"
 
@@ -4,3 +4,9 @@ CREATE OR REPLACE FUNCTION __API_SCHEMA_INTERNAL_V2__.bson_dollar_bucket_auto(do
  STABLE
  WINDOW
 AS 'MODULE_PATHNAME', $function$bson_dollar_bucket_auto$function$;
+
+CREATE OR REPLACE FUNCTION __API_SCHEMA_INTERNAL_V2__.bson_dollar_bucket_auto_approximate(value __CORE_SCHEMA__.bson, quantiles __CORE_SCHEMA__.bson, min_value __CORE_SCHEMA__.bson, max_value __CORE_SCHEMA__.bson)
+ RETURNS __CORE_SCHEMA__.bson
+ LANGUAGE c
+ IMMUTABLE PARALLEL SAFE STRICT
+AS 'MODULE_PATHNAME', $function$bson_dollar_bucket_auto_approximate$function$;
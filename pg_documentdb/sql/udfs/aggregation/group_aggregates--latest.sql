@@ -31,6 +31,10 @@ CREATE OR REPLACE AGGREGATE __API_CATALOG_SCHEMA__.BSONMAX(__CORE_SCHEMA__.bson)
     FINALFUNC = __API_CATALOG_SCHEMA__.bson_min_max_final,
     stype = __CORE_SCHEMA__.bson,
     COMBINEFUNC = __API_CATALOG_SCHEMA__.bson_max_combine,
+    mstype = bytea,
+    MSFUNC = __API_SCHEMA_INTERNAL_V2__.bson_max_winfunc_transition,
+    MFINALFUNC = __API_SCHEMA_INTERNAL_V2__.bson_min_max_winfunc_final,
+    MINVFUNC = __API_SCHEMA_INTERNAL_V2__.bson_min_max_winfunc_invtransition,
     PARALLEL = SAFE
 );
 
@@ -40,6 +44,10 @@ CREATE OR REPLACE AGGREGATE __API_CATALOG_SCHEMA__.BSONMIN(__CORE_SCHEMA__.bson)
     FINALFUNC = __API_CATALOG_SCHEMA__.bson_min_max_final,
     stype = __CORE_SCHEMA__.bson,
     COMBINEFUNC = __API_CATALOG_SCHEMA__.bson_min_combine,
+    mstype = bytea,
+    MSFUNC = __API_SCHEMA_INTERNAL_V2__.bson_min_winfunc_transition,
+    MFINALFUNC = __API_SCHEMA_INTERNAL_V2__.bson_min_max_winfunc_final,
+    MINVFUNC = __API_SCHEMA_INTERNAL_V2__.bson_min_max_winfunc_invtransition,
     PARALLEL = SAFE
 );
 
@@ -242,6 +250,10 @@ CREATE OR REPLACE AGGREGATE __API_SCHEMA_INTERNAL_V2__.BSON_ADD_TO_SET(__CORE_SC
     SFUNC = __API_SCHEMA_INTERNAL_V2__.bson_add_to_set_transition,
     FINALFUNC = __API_SCHEMA_INTERNAL_V2__.bson_add_to_set_final,
     stype = bytea,
+    mstype = bytea,
+    MSFUNC = __API_SCHEMA_INTERNAL_V2__.bson_add_to_set_transition,
+    MFINALFUNC = __API_SCHEMA_INTERNAL_V2__.bson_add_to_set_final,
+    MINVFUNC = __API_SCHEMA_INTERNAL_V2__.bson_add_to_set_winfunc_invtransition,
     PARALLEL = SAFE
 );
 
@@ -345,6 +357,10 @@ CREATE OR REPLACE AGGREGATE __API_SCHEMA_INTERNAL_V2__.BSONMAXN(__CORE_SCHEMA__.
     FINALFUNC = __API_SCHEMA_INTERNAL_V2__.bson_maxminn_final,
     stype = bytea,
     COMBINEFUNC = __API_SCHEMA_INTERNAL_V2__.bson_maxminn_combine,
+    mstype = bytea,
+    MSFUNC = __API_SCHEMA_INTERNAL_V2__.bson_maxn_winfunc_transition,
+    MFINALFUNC = __API_SCHEMA_INTERNAL_V2__.bson_maxminn_winfunc_final,
+    MINVFUNC = __API_SCHEMA_INTERNAL_V2__.bson_maxminn_winfunc_invtransition,
     PARALLEL = SAFE
 );
 
@@ -354,6 +370,10 @@ CREATE OR REPLACE AGGREGATE __API_SCHEMA_INTERNAL_V2__.BSONMINN(__CORE_SCHEMA__.
     FINALFUNC = __API_SCHEMA_INTERNAL_V2__.bson_maxminn_final,
     stype = bytea,
     COMBINEFUNC = __API_SCHEMA_INTERNAL_V2__.bson_maxminn_combine,
+    mstype = bytea,
+    MSFUNC = __API_SCHEMA_INTERNAL_V2__.bson_minn_winfunc_transition,
+    MFINALFUNC = __API_SCHEMA_INTERNAL_V2__.bson_maxminn_winfunc_final,
+    MINVFUNC = __API_SCHEMA_INTERNAL_V2__.bson_maxminn_winfunc_invtransition,
     PARALLEL = SAFE
 );
 
@@ -70,6 +70,92 @@ typedef struct BsonAddToSetState
 	bool isWindowAggregation;
 } BsonAddToSetState;
 
+/*
+ * Hash entry used by $addToSet in window aggregation. Tracks how many rows
+ * of the current frame produced the value, so that values can be removed
+ * as rows leave a moving frame (counted multiset).
+ */
+typedef struct BsonAddToSetCountedEntry
+{
+	/* key for hash entry; should be the first field */
+	bson_value_t bsonValue;
+
+	/* Number of rows in the frame with this value */
+	int64 count;
+
+	/* The document that backs bsonValue */
+	pgbson *document;
+} BsonAddToSetCountedEntry;
+
+/*
+ * A candidate for the result of a $min/$max moving window aggregate.
+ */
+typedef struct BsonMinMaxWindowEntry
+{
+	/* The position of the row in the frame (in order of the transition) */
+	int64 rowNumber;
+
+	/* The value of the row */
+	pgbson *value;
+} BsonMinMaxWindowEntry;
+
+/*
+ * State for $min/$max over moving window frames. Holds a monotonic deque
+ * (as a circular buffer) of the rows of the frame that can still become
+ * the result: each entry is strictly better than every entry after it.
+ * Rows leave the frame in the order they were added, so the inverse
+ * transition only ever needs to check the head of the deque, giving
+ * amortized O(1) per row instead of recomputing over the whole frame.
+ */
+typedef struct BsonMinMaxWindowState
+{
+	BsonMinMaxWindowEntry *entries;
+	int32 capacity;
+	int32 head;
+	int32 count;
+
+	/* Number of rows added to and removed from the frame so far */
+	int64 rowsAdded;
+	int64 rowsRemoved;
+
+	bool isMax;
+} BsonMinMaxWindowState;
+
+/*
+ * A row of the frame of a $minN/$maxN moving window aggregate.
+ */
+typedef struct BsonMaxMinNWindowEntry
+{
+	/* The position of the row in the frame (in order of the transition) */
+	int64 rowNumber;
+
+	/* The input of the row, and the document that backs it */
+	bson_value_t bsonValue;
+	pgbson *document;
+} BsonMaxMinNWindowEntry;
+
+/*
+ * State for $minN/$maxN over moving window frames. Holds every non null
+ * input of the frame sorted in result order, so that rows can be inserted
+ * and removed by binary search and the result is the first n entries. Ties
+ * are ordered so that later rows come first, like the heap of the regular
+ * transition which replaces its top with an equal later value.
+ */
+typedef struct BsonMaxMinNWindowState
+{
+	BsonMaxMinNWindowEntry *entries;
+	int32 capacity;
+	int32 count;
+
+	int64 n;
+
+	/* Number of rows added to and removed from the frame so far */
+	int64 rowsAdded;
+	int64 rowsRemoved;
+
+	bool isMaxN;
+} BsonMaxMinNWindowState;
+
 /* state used for maxN and minN both */
 typedef struct BinaryHeapState
 {
@@ -91,6 +177,12 @@ static void CreateObjectAggTreeNodes(BsonObjectAggState *currentState,
 static void ValidateMergeObjectsInput(pgbson *input);
 static Datum ParseAndReturnMergeObjectsTree(BsonObjectAggState *state);
 static Datum bson_maxminn_transition(PG_FUNCTION_ARGS, bool isMaxN);
+static int64 ParseMaxMinNArgument(pgbson *argument, bool isMaxN,
+								  bson_value_t *inputBsonValue);
+static Datum BsonMaxMinNWindowTransitionCore(PG_FUNCTION_ARGS, bool isMaxN);
+static int32 FindMaxMinNWindowEntry(BsonMaxMinNWindowState *state,
+									const bson_value_t *value, int64 rowNumber);
+static Datum BsonMinMaxWindowTransitionCore(PG_FUNCTION_ARGS, bool isMax);
 static void BsonArrayAggFinalCore(BsonArrayAggState *state,
 								  pgbson_array_writer *arrayWriter);
 
@@ -112,6 +204,10 @@ PG_FUNCTION_INFO_V1(bson_max_transition);
 PG_FUNCTION_INFO_V1(bson_min_max_final);
 PG_FUNCTION_INFO_V1(bson_min_combine);
 PG_FUNCTION_INFO_V1(bson_max_combine);
+PG_FUNCTION_INFO_V1(bson_max_winfunc_transition);
+PG_FUNCTION_INFO_V1(bson_min_winfunc_transition);
+PG_FUNCTION_INFO_V1(bson_min_max_winfunc_invtransition);
+PG_FUNCTION_INFO_V1(bson_min_max_winfunc_final);
 PG_FUNCTION_INFO_V1(bson_build_distinct_response);
 PG_FUNCTION_INFO_V1(bson_array_agg_transition);
 PG_FUNCTION_INFO_V1(bson_array_agg_minvtransition);
@@ -123,6 +219,7 @@ PG_FUNCTION_INFO_V1(bson_object_agg_final);
 PG_FUNCTION_INFO_V1(bson_out_transition);
 PG_FUNCTION_INFO_V1(bson_out_final);
 PG_FUNCTION_INFO_V1(bson_add_to_set_transition);
+PG_FUNCTION_INFO_V1(bson_add_to_set_winfunc_invtransition);
 PG_FUNCTION_INFO_V1(bson_add_to_set_final);
 PG_FUNCTION_INFO_V1(bson_merge_objects_transition_on_sorted);
 PG_FUNCTION_INFO_V1(bson_merge_objects_transition);
@@ -131,6 +228,10 @@ PG_FUNCTION_INFO_V1(bson_maxn_transition);
 PG_FUNCTION_INFO_V1(bson_maxminn_final);
 PG_FUNCTION_INFO_V1(bson_minn_transition);
 PG_FUNCTION_INFO_V1(bson_maxminn_combine);
+PG_FUNCTION_INFO_V1(bson_maxn_winfunc_transition);
+PG_FUNCTION_INFO_V1(bson_minn_winfunc_transition);
+PG_FUNCTION_INFO_V1(bson_maxminn_winfunc_invtransition);
+PG_FUNCTION_INFO_V1(bson_maxminn_winfunc_final);
 PG_FUNCTION_INFO_V1(bson_count_transition);
 PG_FUNCTION_INFO_V1(bson_count_combine);
 PG_FUNCTION_INFO_V1(bson_count_final);
@@ -836,6 +937,95 @@ bson_min_transition(PG_FUNCTION_ARGS)
 }
 
 
+/*
+ * Applies the "moving-aggregate state transition" (MSFUNC) for max.
+ */
+Datum
+bson_max_winfunc_transition(PG_FUNCTION_ARGS)
+{
+	bool isMax = true;
+	return BsonMinMaxWindowTransitionCore(fcinfo, isMax);
+}
+
+
+/*
+ * Applies the "moving-aggregate state transition" (MSFUNC) for min.
+ */
+Datum
+bson_min_winfunc_transition(PG_FUNCTION_ARGS)
+{
+	bool isMax = false;
+	return BsonMinMaxWindowTransitionCore(fcinfo, isMax);
+}
+
+
+/*
+ * Applies the "inverse state transition" (MINVFUNC) for min and max.
+ * The rows leave the frame in the same order they were added in, so the
+ * row leaving is only relevant if it is still at the head of the deque.
+ */
+Datum
+bson_min_max_winfunc_invtransition(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggregateContext;
+	if (AggCheckCallContext(fcinfo, &aggregateContext) != AGG_CONTEXT_WINDOW)
+	{
+		ereport(ERROR, errmsg(
+					"window aggregate function called in non-window-aggregate context"));
+	}
+
+	if (PG_ARGISNULL(0))
+	{
+		/* Returning NULL is an indication that inverse can't be applied and the aggregation needs to be redone */
+		PG_RETURN_NULL();
+	}
+
+	MaxAlignedVarlena *bytes = GetMaxAlignedVarlena(PG_GETARG_BYTEA_P(0));
+	BsonMinMaxWindowState *currentState = (BsonMinMaxWindowState *) bytes->state;
+
+	int64 rowNumber = currentState->rowsRemoved++;
+	if (currentState->count > 0 &&
+		currentState->entries[currentState->head].rowNumber == rowNumber)
+	{
+		pfree(currentState->entries[currentState->head].value);
+		currentState->head = (currentState->head + 1) % currentState->capacity;
+		currentState->count--;
+	}
+
+	PG_RETURN_POINTER(bytes);
+}
+
+
+/*
+ * Applies the "moving-aggregate final calculation" (MFINALFUNC) for min and max.
+ * Returns the head of the deque, or a null bson for empty frames.
+ */
+Datum
+bson_min_max_winfunc_final(PG_FUNCTION_ARGS)
+{
+	MaxAlignedVarlena *bytes = PG_ARGISNULL(0) ? NULL :
+							   GetMaxAlignedVarlena(PG_GETARG_BYTEA_P(0));
+
+	if (bytes != NULL)
+	{
+		BsonMinMaxWindowState *currentState = (BsonMinMaxWindowState *) bytes->state;
+		if (currentState->count > 0)
+		{
+			PG_RETURN_POINTER(PgbsonCloneFromPgbson(
+								  currentState->entries[currentState->head].value));
+		}
+	}
+
+	/* Mongo returns $null for empty sets */
+	pgbsonelement finalValue;
+	finalValue.path = "";
+	finalValue.pathLength = 0;
+	finalValue.bsonValue.value_type = BSON_TYPE_NULL;
+
+	PG_RETURN_POINTER(PgbsonElementToPgbson(&finalValue));
+}
+
+
 /*
  * Applies the "combine function" (COMBINEFUNC) for sum and average.
  * takes two of the aggregate state structures (bson_numeric_agg_state)
@@ -1097,7 +1287,9 @@ bson_add_to_set_transition(PG_FUNCTION_ARGS)
 
 		currentState = (BsonAddToSetState *) bytes->state;
 		currentState->currentSizeWritten = 0;
-		currentState->set = CreateBsonValueHashSet();
+		currentState->set = isWindowAggregation ?
+							CreateBsonValueHashMap(sizeof(BsonAddToSetCountedEntry)) :
+							CreateBsonValueHashSet();
 		currentState->isWindowAggregation = isWindowAggregation;
 	}
 	else
@@ -1125,8 +1317,8 @@ bson_add_to_set_transition(PG_FUNCTION_ARGS)
 			singleBsonElement.pathLength == 0)
 		{
 			bool found = false;
-			hash_search(currentState->set, &singleBsonElement.bsonValue,
-						HASH_ENTER, &found);
+			void *entry = hash_search(currentState->set, &singleBsonElement.bsonValue,
+									  HASH_ENTER, &found);
 
 			/*
 			 * If the BSON was not found in the hash table, add its size to the current
@@ -1136,6 +1328,27 @@ bson_add_to_set_transition(PG_FUNCTION_ARGS)
 			{
 				currentState->currentSizeWritten += PgbsonGetBsonSize(currentValue);
 			}
+
+			/*
+			 * For window aggregation track the number of rows with the value so that
+			 * the inverse transition can remove it once no row in the frame has it.
+			 */
+			if (currentState->isWindowAggregation)
+			{
+				BsonAddToSetCountedEntry *countedEntry =
+					(BsonAddToSetCountedEntry *) entry;
+				if (!found)
+				{
+					countedEntry->count = 0;
+					countedEntry->document = currentValue;
+				}
+				else
+				{
+					pfree(currentValue);
+				}
+
+				countedEntry->count++;
+			}
 		}
 		else
 		{
@@ -1149,6 +1362,74 @@ bson_add_to_set_transition(PG_FUNCTION_ARGS)
 }
 
 
+/*
+ * Inverse transition function (MINVFUNC) for the BSON_ADD_TO_SET aggregate.
+ * Decrements the count of the value of the row leaving the frame and removes
+ * it from the set once no row in the frame has it anymore.
+ */
+Datum
+bson_add_to_set_winfunc_invtransition(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggregateContext;
+	if (AggCheckCallContext(fcinfo, &aggregateContext) != AGG_CONTEXT_WINDOW)
+	{
+		ereport(ERROR, errmsg(
+					"window aggregate function called in non-window-aggregate context"));
+	}
+
+	if (PG_ARGISNULL(0))
+	{
+		/* Returning NULL is an indication that inverse can't be applied and the aggregation needs to be redone */
+		PG_RETURN_NULL();
+	}
+
+	MaxAlignedVarlena *bytes = GetMaxAlignedVarlena(PG_GETARG_BYTEA_P(0));
+	BsonAddToSetState *currentState = (BsonAddToSetState *) bytes->state;
+
+	if (!currentState->isWindowAggregation)
+	{
+		ereport(ERROR, errmsg(
+					"window aggregate function received an invalid state for $addToSet"));
+	}
+
+	pgbson *currentValue = PG_GETARG_MAYBE_NULL_PGBSON(1);
+	if (currentValue == NULL || IsPgbsonEmptyDocument(currentValue))
+	{
+		PG_RETURN_POINTER(bytes);
+	}
+
+	pgbsonelement singleBsonElement;
+	if (!TryGetSinglePgbsonElementFromPgbson(currentValue, &singleBsonElement) ||
+		singleBsonElement.pathLength != 0)
+	{
+		ereport(ERROR, (errcode(ERRCODE_DOCUMENTDB_INTERNALERROR),
+						errmsg("Bad input format for addToSet inverse transition.")));
+	}
+
+	bool found = false;
+	BsonAddToSetCountedEntry *entry = hash_search(currentState->set,
+												  &singleBsonElement.bsonValue,
+												  HASH_FIND, &found);
+	if (!found)
+	{
+		/* Value is not tracked in the frame, the aggregation needs to be redone */
+		PG_RETURN_NULL();
+	}
+
+	entry->count--;
+	if (entry->count == 0)
+	{
+		pgbson *document = entry->document;
+		currentState->currentSizeWritten -= PgbsonGetBsonSize(document);
+		hash_search(currentState->set, &singleBsonElement.bsonValue, HASH_REMOVE,
+					NULL);
+		pfree(document);
+	}
+
+	PG_RETURN_POINTER(bytes);
+}
+
+
 /*
  * Final function for the BSON_ADD_TO_SET aggregate.
  */
@@ -1217,6 +1498,258 @@ bson_add_to_set_final(PG_FUNCTION_ARGS)
 /* Private helper methods */
 /* --------------------------------------------------------- */
 
+/*
+ * Core of the moving-aggregate transition for $min/$max. Appends the current
+ * row to the deque after dropping every trailing candidate that the new value
+ * supersedes. Newer values win ties, matching bson_min_transition and
+ * bson_max_transition.
+ */
+static Datum
+BsonMinMaxWindowTransitionCore(PG_FUNCTION_ARGS, bool isMax)
+{
+	MemoryContext aggregateContext;
+	if (AggCheckCallContext(fcinfo, &aggregateContext) != AGG_CONTEXT_WINDOW)
+	{
+		ereport(ERROR, errmsg(
+					"window aggregate function called in non-window-aggregate context"));
+	}
+
+	MaxAlignedVarlena *bytes;
+	BsonMinMaxWindowState *currentState;
+	pgbson *currentValue = PG_GETARG_MAYBE_NULL_PGBSON(1);
+
+	/* Create the aggregate state in the aggregate context. */
+	MemoryContext oldContext = MemoryContextSwitchTo(aggregateContext);
+
+	if (PG_ARGISNULL(0))
+	{
+		bytes = AllocateMaxAlignedVarlena(sizeof(BsonMinMaxWindowState));
+		currentState = (BsonMinMaxWindowState *) bytes->state;
+		memset(currentState, 0, sizeof(BsonMinMaxWindowState));
+		currentState->isMax = isMax;
+		currentState->capacity = 8;
+		currentState->entries = palloc(sizeof(BsonMinMaxWindowEntry) *
+									   currentState->capacity);
+	}
+	else
+	{
+		bytes = GetMaxAlignedVarlena(PG_GETARG_BYTEA_P(0));
+		currentState = (BsonMinMaxWindowState *) bytes->state;
+	}
+
+	/* Every row gets a number (even nulls) so the inverse stays in sync */
+	int64 rowNumber = currentState->rowsAdded++;
+
+	if (currentValue != NULL)
+	{
+		while (currentState->count > 0)
+		{
+			int32 tailIndex = (currentState->head + currentState->count - 1) %
+							  currentState->capacity;
+			BsonMinMaxWindowEntry *tail = &currentState->entries[tailIndex];
+			int32_t compResult = ComparePgbson(tail->value, currentValue);
+			if (isMax ? compResult > 0 : compResult < 0)
+			{
+				break;
+			}
+
+			pfree(tail->value);
+			currentState->count--;
+		}
+
+		if (currentState->count == currentState->capacity)
+		{
+			/* Grow the circular buffer, unrolling it so the head is at 0 */
+			int32 newCapacity = currentState->capacity * 2;
+			BsonMinMaxWindowEntry *newEntries =
+				palloc(sizeof(BsonMinMaxWindowEntry) * newCapacity);
+			for (int32 i = 0; i < currentState->count; i++)
+			{
+				newEntries[i] = currentState->entries[(currentState->head + i) %
+													  currentState->capacity];
+			}
+
+			pfree(currentState->entries);
+			currentState->entries = newEntries;
+			currentState->capacity = newCapacity;
+			currentState->head = 0;
+		}
+
+		int32 insertIndex = (currentState->head + currentState->count) %
+							currentState->capacity;
+		currentState->entries[insertIndex].rowNumber = rowNumber;
+		currentState->entries[insertIndex].value =
+			CopyPgbsonIntoMemoryContext(currentValue, aggregateContext);
+		currentState->count++;
+	}
+
+	MemoryContextSwitchTo(oldContext);
+	PG_RETURN_POINTER(bytes);
+}
+
+
+/*
+ * Core implementation of the moving-aggregate transition of maxN and minN.
+ * Inserts the input of the row at its position in the sorted frame.
+ */
+static Datum
+BsonMaxMinNWindowTransitionCore(PG_FUNCTION_ARGS, bool isMaxN)
+{
+	MemoryContext aggregateContext;
+	if (AggCheckCallContext(fcinfo, &aggregateContext) != AGG_CONTEXT_WINDOW)
+	{
+		ereport(ERROR, errmsg(
+					"window aggregate function called in non-window-aggregate context"));
+	}
+
+	bson_value_t inputBsonValue = { 0 };
+	int64 n = ParseMaxMinNArgument(PG_GETARG_PGBSON(1), isMaxN, &inputBsonValue);
+
+	MaxAlignedVarlena *bytes;
+	BsonMaxMinNWindowState *currentState;
+
+	/* Create the aggregate state in the aggregate context. */
+	MemoryContext oldContext = MemoryContextSwitchTo(aggregateContext);
+
+	if (PG_ARGISNULL(0))
+	{
+		bytes = AllocateMaxAlignedVarlena(sizeof(BsonMaxMinNWindowState));
+		currentState = (BsonMaxMinNWindowState *) bytes->state;
+		memset(currentState, 0, sizeof(BsonMaxMinNWindowState));
+		currentState->isMaxN = isMaxN;
+		currentState->n = n;
+		currentState->capacity = 8;
+		currentState->entries = palloc(sizeof(BsonMaxMinNWindowEntry) *
+									   currentState->capacity);
+	}
+	else
+	{
+		bytes = GetMaxAlignedVarlena(PG_GETARG_BYTEA_P(0));
+		currentState = (BsonMaxMinNWindowState *) bytes->state;
+	}
+
+	/* Every row gets a number (even nulls) so the inverse stays in sync */
+	int64 rowNumber = currentState->rowsAdded++;
+
+	/* if the input is null or an undefined path, ignore it */
+	if (!IsExpressionResultNullOrUndefined(&inputBsonValue))
+	{
+		if (currentState->count == currentState->capacity)
+		{
+			currentState->capacity *= 2;
+			currentState->entries = repalloc(currentState->entries,
+											 sizeof(BsonMaxMinNWindowEntry) *
+											 currentState->capacity);
+		}
+
+		int32 index = FindMaxMinNWindowEntry(currentState, &inputBsonValue, rowNumber);
+		memmove(&currentState->entries[index + 1], &currentState->entries[index],
+				sizeof(BsonMaxMinNWindowEntry) * (currentState->count - index));
+
+		BsonMaxMinNWindowEntry *entry = &currentState->entries[index];
+		entry->rowNumber = rowNumber;
+		entry->document = BsonValueToDocumentPgbson(&inputBsonValue);
+
+		pgbsonelement element;
+		PgbsonToSinglePgbsonElement(entry->document, &element);
+		entry->bsonValue = element.bsonValue;
+		currentState->count++;
+	}
+
+	MemoryContextSwitchTo(oldContext);
+	PG_RETURN_POINTER(bytes);
+}
+
+
+/*
+ * Returns the position of the first entry of the frame that does not come
+ * before the given input and row number in result order: descending for
+ * maxN, ascending for minN, and the later row first among equal inputs.
+ */
+static int32
+FindMaxMinNWindowEntry(BsonMaxMinNWindowState *state, const bson_value_t *value,
+					   int64 rowNumber)
+{
+	int32 low = 0;
+	int32 high = state->count;
+	while (low < high)
+	{
+		int32 middle = low + (high - low) / 2;
+		BsonMaxMinNWindowEntry *entry = &state->entries[middle];
+
+		bool ignoreIsComparisonValid = false;
+		int compResult = CompareBsonValueAndType(&entry->bsonValue, value,
+												 &ignoreIsComparisonValid);
+		if (state->isMaxN)
+		{
+			compResult = -compResult;
+		}
+
+		if (compResult < 0 || (compResult == 0 && entry->rowNumber > rowNumber))
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return low;
+}
+
+
+/*
+ * Parses the argument of maxN and minN, { "input": <value>, "n": <value> },
+ * as both are evaluated together. Returns n after validating it.
+ */
+static int64
+ParseMaxMinNArgument(pgbson *argument, bool isMaxN, bson_value_t *inputBsonValue)
+{
+	pgbsonelement currentValueElement;
+	PgbsonToSinglePgbsonElement(argument, &currentValueElement);
+	bson_value_t currentBsonValue = currentValueElement.bsonValue;
+
+	bson_iter_t docIter;
+	BsonValueInitIterator(&currentBsonValue, &docIter);
+	bson_value_t elementBsonValue = { 0 };
+	while (bson_iter_next(&docIter))
+	{
+		const char *key = bson_iter_key(&docIter);
+		if (strcmp(key, "input") == 0)
+		{
+			*inputBsonValue = *bson_iter_value(&docIter);
+		}
+		else if (strcmp(key, "n") == 0)
+		{
+			elementBsonValue = *bson_iter_value(&docIter);
+		}
+	}
+
+	/* Ensure that N is a valid integer value. */
+	ValidateElementForNGroupAccumulators(&elementBsonValue, isMaxN == true ? "maxN" :
+										 "minN");
+	bool throwIfFailed = true;
+	int64_t element = BsonValueAsInt64WithRoundingMode(&elementBsonValue,
+													   ConversionRoundingMode_Floor,
+													   throwIfFailed);
+
+	int64_t totalSize = sizeof(bson_value_t) * element + sizeof(BinaryHeapState) +
+						sizeof(BinaryHeap);
+
+	/* TODO: Support element as int64. */
+	if (element > INT32_MAX || totalSize > BSON_MAX_ALLOWED_SIZE_INTERMEDIATE)
+	{
+		ereport(ERROR, (errcode(ERRCODE_DOCUMENTDB_INTERMEDIATERESULTTOOLARGE),
+						errmsg(
+							"Size is larger than maximum size allowed for an intermediate document %u",
+							BSON_MAX_ALLOWED_SIZE_INTERMEDIATE)));
+	}
+
+	return element;
+}
+
+
 static MaxAlignedVarlena *
 AllocateBsonNumericAggState()
 {
@@ -1469,35 +2002,8 @@ bson_maxminn_transition(PG_FUNCTION_ARGS, bool isMaxN)
 	pgbson *copiedPgbson = PG_GETARG_MAYBE_NULL_PGBSON(1);
 	pgbson *currentValue = CopyPgbsonIntoMemoryContext(copiedPgbson, aggregateContext);
 
-	pgbsonelement currentValueElement;
-	PgbsonToSinglePgbsonElement(currentValue, &currentValueElement);
-	bson_value_t currentBsonValue = currentValueElement.bsonValue;
-
-	/*input and N are both expression, so we evaluate them togather.*/
-	bson_iter_t docIter;
-	BsonValueInitIterator(&currentBsonValue, &docIter);
 	bson_value_t inputBsonValue = { 0 };
-	bson_value_t elementBsonValue = { 0 };
-	while (bson_iter_next(&docIter))
-	{
-		const char *key = bson_iter_key(&docIter);
-		if (strcmp(key, "input") == 0)
-		{
-			inputBsonValue = *bson_iter_value(&docIter);
-		}
-		else if (strcmp(key, "n") == 0)
-		{
-			elementBsonValue = *bson_iter_value(&docIter);
-		}
-	}
-
-	/* Ensure that N is a valid integer value. */
-	ValidateElementForNGroupAccumulators(&elementBsonValue, isMaxN == true ? "maxN" :
-										 "minN");
-	bool throwIfFailed = true;
-	int64_t element = BsonValueAsInt64WithRoundingMode(&elementBsonValue,
-													   ConversionRoundingMode_Floor,
-													   throwIfFailed);
+	int64_t element = ParseMaxMinNArgument(currentValue, isMaxN, &inputBsonValue);
 
 	BinaryHeapState *currentState = (BinaryHeapState *) palloc0(sizeof(BinaryHeapState));
 
@@ -1513,18 +2019,6 @@ bson_maxminn_transition(PG_FUNCTION_ARGS, bool isMaxN)
 		 * For minN, we need to maintain a large root heap.
 		 * When currentValue is less than the top of the heap, we need to remove the top of the heap and insert currentValue.
 		 */
-		int64_t totalSize = sizeof(bson_value_t) * element + sizeof(BinaryHeapState) +
-							sizeof(BinaryHeap);
-
-		/* TODO: Support element as int64. */
-		if (element > INT32_MAX || totalSize > BSON_MAX_ALLOWED_SIZE_INTERMEDIATE)
-		{
-			ereport(ERROR, (errcode(ERRCODE_DOCUMENTDB_INTERMEDIATERESULTTOOLARGE),
-							errmsg(
-								"Size is larger than maximum size allowed for an intermediate document %u",
-								BSON_MAX_ALLOWED_SIZE_INTERMEDIATE)));
-		}
-
 		currentState->heap = AllocateHeap(element, isMaxN == true ?
 										  HeapSortComparatorMaxN :
 										  HeapSortComparatorMinN);
@@ -1826,6 +2320,109 @@ bson_maxminn_combine(PG_FUNCTION_ARGS)
 }
 
 
+/*
+ * Applies the "moving-aggregate state transition" (MSFUNC) for maxN.
+ */
+Datum
+bson_maxn_winfunc_transition(PG_FUNCTION_ARGS)
+{
+	bool isMaxN = true;
+	return BsonMaxMinNWindowTransitionCore(fcinfo, isMaxN);
+}
+
+
+/*
+ * Applies the "moving-aggregate state transition" (MSFUNC) for minN.
+ */
+Datum
+bson_minn_winfunc_transition(PG_FUNCTION_ARGS)
+{
+	bool isMaxN = false;
+	return BsonMaxMinNWindowTransitionCore(fcinfo, isMaxN);
+}
+
+
+/*
+ * Applies the "inverse state transition" (MINVFUNC) for maxN and minN.
+ * The rows leave the frame in the same order they were added in, so the row
+ * leaving is found by its input and its row number.
+ */
+Datum
+bson_maxminn_winfunc_invtransition(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggregateContext;
+	if (AggCheckCallContext(fcinfo, &aggregateContext) != AGG_CONTEXT_WINDOW)
+	{
+		ereport(ERROR, errmsg(
+					"window aggregate function called in non-window-aggregate context"));
+	}
+
+	if (PG_ARGISNULL(0))
+	{
+		/* Returning NULL is an indication that inverse can't be applied and the aggregation needs to be redone */
+		PG_RETURN_NULL();
+	}
+
+	MaxAlignedVarlena *bytes = GetMaxAlignedVarlena(PG_GETARG_BYTEA_P(0));
+	BsonMaxMinNWindowState *currentState = (BsonMaxMinNWindowState *) bytes->state;
+
+	bson_value_t inputBsonValue = { 0 };
+	ParseMaxMinNArgument(PG_GETARG_PGBSON(1), currentState->isMaxN, &inputBsonValue);
+
+	int64 rowNumber = currentState->rowsRemoved++;
+	if (IsExpressionResultNullOrUndefined(&inputBsonValue))
+	{
+		PG_RETURN_POINTER(bytes);
+	}
+
+	int32 index = FindMaxMinNWindowEntry(currentState, &inputBsonValue, rowNumber);
+	if (index >= currentState->count ||
+		currentState->entries[index].rowNumber != rowNumber)
+	{
+		/* The row is not in the state, aggregate the frame again */
+		PG_RETURN_NULL();
+	}
+
+	pfree(currentState->entries[index].document);
+	memmove(&currentState->entries[index], &currentState->entries[index + 1],
+			sizeof(BsonMaxMinNWindowEntry) * (currentState->count - index - 1));
+	currentState->count--;
+
+	PG_RETURN_POINTER(bytes);
+}
+
+
+/*
+ * Applies the "moving-aggregate final calculation" (MFINALFUNC) for maxN and
+ * minN. Writes the first n entries of the frame, which are in result order.
+ */
+Datum
+bson_maxminn_winfunc_final(PG_FUNCTION_ARGS)
+{
+	MaxAlignedVarlena *bytes = PG_ARGISNULL(0) ? NULL :
+							   GetMaxAlignedVarlena(PG_GETARG_BYTEA_P(0));
+
+	pgbson_writer writer;
+	pgbson_array_writer arrayWriter;
+	PgbsonWriterInit(&writer);
+	PgbsonWriterStartArray(&writer, "", 0, &arrayWriter);
+
+	if (bytes != NULL)
+	{
+		BsonMaxMinNWindowState *currentState = (BsonMaxMinNWindowState *) bytes->state;
+		int64 numEntries = Min(currentState->n, currentState->count);
+		for (int64 i = 0; i < numEntries; i++)
+		{
+			PgbsonArrayWriterWriteValue(&arrayWriter,
+										&currentState->entries[i].bsonValue);
+		}
+	}
+
+	PgbsonWriterEndArray(&writer, &arrayWriter);
+	PG_RETURN_POINTER(PgbsonWriterGetPgbson(&writer));
+}
+
+
 Datum
 bson_count_transition(PG_FUNCTION_ARGS)
 {
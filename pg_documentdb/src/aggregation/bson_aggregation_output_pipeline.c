@@ -14,6 +14,7 @@
 #include <fmgr.h>
 #include <miscadmin.h>
 #include <utils/lsyscache.h>
+#include <access/sysattr.h>
 #include <access/xact.h>
 #include <catalog/pg_operator.h>
 #include <optimizer/planner.h>
@@ -29,6 +30,7 @@
 #include <parser/parse_oper.h>
 #include <utils/ruleutils.h>
 #include <utils/builtins.h>
+#include <utils/array.h>
 #include <catalog/pg_aggregate.h>
 #include <catalog/pg_class.h>
 #include <catalog/namespace.h>
@@ -43,6 +45,7 @@
 #include "planner/documentdb_planner.h"
 #include "aggregation/bson_aggregation_pipeline.h"
 #include "commands/insert.h"
+#include "commands/create_indexes.h"
 #include "commands/parse_error.h"
 #include "commands/commands_common.h"
 #include "utils/feature_counter.h"
@@ -123,6 +126,9 @@ extern bool EnableCollation;
 /* GUC to enable schema validation */
 extern bool EnableSchemaValidation;
 
+/* GUC to load $out without the target's non-unique secondary indexes */
+extern bool EnableOutStageBulkLoad;
+
 static void ParseMergeStage(const bson_value_t *existingValue, const
 							char *currentNameSpace, MergeArgs *args);
 static void ParseOutStage(const bson_value_t *existingValue, const char *currentNameSpace,
@@ -183,6 +189,10 @@ static inline TargetEntry * MakeExtractFuncExprForMergeTE(const char *onField, u
 														  length, Var *sourceDocument,
 														  const int resNum);
 static void TruncateDataTable(int collectionId);
+static bool CanUseOutStageBulkLoad(MongoCollection *targetCollection,
+								   AggregationPipelineBuildContext *context);
+static OutStageBulkLoadState * CreateOutStageBulkLoadState(
+	MongoCollection *targetCollection);
 static inline bool CheckSchemaValidationEnabledForDollarMergeOut(void);
 static inline void ValidateTargetNameSpaceForOutputStage(const StringView *targetDB,
 														 const StringView *
@@ -1385,6 +1395,25 @@ AddTargetCollectionRTEDollarMerge(Query *query, MongoCollection *targetCollectio
 #else
 	rte->requiredPerms = ACL_SELECT;
 #endif
+
+	/*
+	 * The query doesn't go through the rewriter, so record that the update
+	 * changes the document: the executor only recomputes the generated
+	 * index_document column for updates of the columns it depends on.
+	 */
+	if (targetCollection->indexKeyColumnAttrNumber != -1)
+	{
+#if PG_VERSION_NUM >= 160000
+		permInfo->updatedCols = bms_make_singleton(
+			DOCUMENT_DATA_TABLE_DOCUMENT_VAR_ATTR_NUMBER -
+			FirstLowInvalidHeapAttributeNumber);
+#else
+		rte->extraUpdatedCols = bms_make_singleton(
+			targetCollection->indexKeyColumnAttrNumber -
+			FirstLowInvalidHeapAttributeNumber);
+#endif
+	}
+
 	RangeTblEntry *existingrte = list_nth(query->rtable, 0);
 	query->rtable = list_make2(rte, existingrte);
 	query->resultRelation = 1;
@@ -2001,6 +2030,20 @@ HandleOut(const bson_value_t *existingValue, Query *query,
 
 		/* Truncate the target data table to delete all entries. This allows us to write new data into it */
 		TruncateDataTable(targetCollection->collectionId);
+
+		if (CanUseOutStageBulkLoad(targetCollection, context))
+		{
+			/*
+			 * Load into the truncated target without its non-unique secondary
+			 * indexes: they are built once over the loaded data after the query
+			 * is drained (see CompleteOutStageBulkLoad). The collection itself,
+			 * its options and its unique indexes are left as they are. Like the
+			 * TRUNCATE above, dropping the indexes holds an ACCESS EXCLUSIVE
+			 * lock on the target until the aggregate's transaction ends.
+			 */
+			context->outStageBulkLoad =
+				CreateOutStageBulkLoadState(targetCollection);
+		}
 	}
 	else
 	{
@@ -2081,6 +2124,103 @@ HandleOut(const bson_value_t *existingValue, Query *query,
 }
 
 
+/*
+ * Completes a $out stage that was loaded without the target's non-unique
+ * secondary indexes by creating them again over the loaded data. Runs in the
+ * same transaction as the load so a failure restores the target as it was.
+ */
+void
+CompleteOutStageBulkLoad(OutStageBulkLoadState *bulkLoadState)
+{
+	ListCell *commandCell;
+	foreach(commandCell, bulkLoadState->indexCreationCommands)
+	{
+		bool isNull = false;
+		bool readOnly = false;
+		ExtensionExecuteQueryViaSPI((const char *) lfirst(commandCell), readOnly,
+									SPI_OK_UTILITY, &isNull);
+	}
+}
+
+
+/*
+ * Whether the $out stage can load into the target without its secondary
+ * indexes. This pays off only when the target has secondary indexes that
+ * would otherwise be maintained row by row.
+ */
+static bool
+CanUseOutStageBulkLoad(MongoCollection *targetCollection,
+					   AggregationPipelineBuildContext *context)
+{
+	if (!EnableOutStageBulkLoad || !context->allowOutStageBulkLoad)
+	{
+		return false;
+	}
+
+	return CollectionIdGetIndexCount(targetCollection->collectionId) > 1;
+}
+
+
+/*
+ * Creates the bulk load state for the (already truncated) $out target: saves
+ * the definitions of its valid non-unique secondary indexes and drops them.
+ * The _id index and the unique indexes are kept so that duplicates are still
+ * reported per document while loading; the index metadata is not touched.
+ */
+static OutStageBulkLoadState *
+CreateOutStageBulkLoadState(MongoCollection *targetCollection)
+{
+	OutStageBulkLoadState *bulkLoadState = palloc0(sizeof(OutStageBulkLoadState));
+
+	const char *cmdStr =
+		"SELECT array_agg(i.indexrelid::regclass::text ORDER BY i.indexrelid), "
+		" array_agg(pg_catalog.pg_get_indexdef(i.indexrelid) ORDER BY i.indexrelid) "
+		" FROM pg_catalog.pg_index i WHERE i.indrelid = $1 AND i.indisvalid "
+		" AND i.indisready AND NOT i.indisunique AND NOT i.indisprimary "
+		" AND NOT i.indisexclusion";
+
+	int argCount = 1;
+	Oid argTypes[1] = { OIDOID };
+	Datum argValues[1] = { ObjectIdGetDatum(targetCollection->relationId) };
+
+	Datum results[2] = { 0 };
+	bool isNulls[2] = { false, false };
+	bool readOnly = true;
+	ExtensionExecuteMultiValueQueryWithArgsViaSPI(cmdStr, argCount, argTypes,
+												  argValues, NULL, readOnly,
+												  SPI_OK_SELECT, results, isNulls, 2);
+	if (isNulls[0] || isNulls[1])
+	{
+		return bulkLoadState;
+	}
+
+	Datum *indexNames = NULL;
+	Datum *indexDefinitions = NULL;
+	int numIndexes = 0;
+	deconstruct_array(DatumGetArrayTypeP(results[0]), TEXTOID, -1, false,
+					  TYPALIGN_INT, &indexNames, NULL, &numIndexes);
+	deconstruct_array(DatumGetArrayTypeP(results[1]), TEXTOID, -1, false,
+					  TYPALIGN_INT, &indexDefinitions, NULL, &numIndexes);
+
+	/* Drop the indexes one by one, a distributed table can't drop several at once */
+	for (int i = 0; i < numIndexes; i++)
+	{
+		bulkLoadState->indexCreationCommands =
+			lappend(bulkLoadState->indexCreationCommands,
+					TextDatumGetCString(indexDefinitions[i]));
+
+		char *dropCmdStr = psprintf("DROP INDEX %s",
+									TextDatumGetCString(indexNames[i]));
+		bool isNull = false;
+		bool dropReadOnly = false;
+		ExtensionExecuteQueryViaSPI(dropCmdStr, dropReadOnly, SPI_OK_UTILITY,
+									&isNull);
+	}
+
+	return bulkLoadState;
+}
+
+
 /*
  * Truncate data table corresponding to the input collection id.
  */
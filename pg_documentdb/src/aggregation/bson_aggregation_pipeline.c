@@ -82,6 +82,7 @@ extern bool EnableConversionStreamableToSingleBatch;
 extern bool EnableFindProjectionAfterOffset;
 extern bool EnableNewCountAggregates;
 extern bool EnableUseLookupNewProjectInlineMethod;
+extern bool EnableFilteredSampleScan;
 
 /* GUC to config tdigest compression */
 extern int TdigestCompressionAccuracy;
@@ -167,6 +168,8 @@ static void SetBatchSize(const char *fieldName, const bson_value_t *value,
 
 static int CompareStageByStageName(const void *a, const void *b);
 static bool IsDefaultJoinTree(Node *node);
+static bool IsSimpleFilteredBaseScan(Query *query);
+static bool HasIndexRequiredQueryOperatorWalker(Node *node, void *context);
 static List * AddShardKeyAndIdFilters(const bson_value_t *existingValue, Query *query,
 									  AggregationPipelineBuildContext *context,
 									  TargetEntry *entry, List *existingQuals);
@@ -1360,6 +1363,9 @@ GenerateAggregationQuery(text *database, pgbson *aggregationSpec, QueryData *que
 
 	context.variableSpec = (Expr *) MakeBsonConst(parsedVariables);
 
+	/* Only cursor requests drain the query and can complete a $out bulk load */
+	context.allowOutStageBulkLoad = addCursorParams && !explain;
+
 	List *aggregationStages = ExtractAggregationStages(&pipelineValue,
 													   &context);
 
@@ -1379,6 +1385,7 @@ GenerateAggregationQuery(text *database, pgbson *aggregationSpec, QueryData *que
 	Query *baseQuery = query;
 
 	query = MutateQueryWithPipeline(query, aggregationStages, &context);
+	queryData->outStageBulkLoad = context.outStageBulkLoad;
 
 	if (context.requiresTailableCursor)
 	{
@@ -7322,7 +7329,12 @@ AddQualifierForTailableQuery(Query *query, Query *baseQuery,
 /*
  * Processes the Sample stage for the aggregation pipeline.
  * If the sample is against the base RTE - injects the Sample TSM.
+ * If the sample follows a $match on the base RTE (and the feature is enabled),
+ * injects an uncapped Sample TSM with a LIMIT so that the scan visits random
+ * blocks and stops as soon as enough rows pass the filter.
  * If it's on a downstream stage, injects an ORDER BY Random().
+ * Note that the ORDER BY Random() LIMIT N is executed as a bounded (top-N)
+ * sort, so it is a single pass over the input with O(N) memory.
  */
 static Query *
 HandleSample(const bson_value_t *existingValue, Query *query,
@@ -7412,6 +7424,41 @@ HandleSample(const bson_value_t *existingValue, Query *query,
 			rte->tablesample = tablesample_sys_rows;
 		}
 	}
+	else if (EnableFilteredSampleScan && rte->rtekind == RTE_RELATION &&
+			 rte->tablesample == NULL && IsSimpleFilteredBaseScan(query))
+	{
+		/*
+		 * The filter has to be applied before picking rows, so system_rows(N)
+		 * can't be used directly. Instead walk the blocks in random order
+		 * without a row cap and put the LIMIT below the random sort: the scan
+		 * then stops once N rows have passed the filter, making the cost
+		 * proportional to N / selectivity rather than to the match count.
+		 *
+		 * Note that the sample is clustered by block: every matching row of
+		 * a visited block is picked before the next block is read. Each row
+		 * is still equally likely to be picked, but rows that share a block
+		 * (e.g. documents inserted together) tend to be picked together,
+		 * unlike with the ORDER BY random() sample.
+		 */
+		TableSampleClause *tablesample_sys_rows = makeNode(TableSampleClause);
+		tablesample_sys_rows->tsmhandler = ExtensionTableSampleSystemRowsFunctionId();
+
+		Node *rowCountArg = (Node *) makeConst(INT8OID, -1, InvalidOid,
+											   sizeof(int64_t),
+											   Int64GetDatum(PG_INT64_MAX), false,
+											   true);
+
+		tablesample_sys_rows->args = list_make1(rowCountArg);
+		rte->tablesample = tablesample_sys_rows;
+
+		query->limitCount = (Node *) makeConst(INT8OID, -1, InvalidOid,
+											   sizeof(int64_t),
+											   Int64GetDatum(sizeDouble), false,
+											   true);
+
+		/* Shuffle the picked rows in an outer query */
+		query = MigrateQueryToSubQuery(query, context);
+	}
 
 	/* Add an order by Random(), Limit N */
 	ParseState *parseState = make_parsestate(NULL);
@@ -7493,6 +7540,67 @@ IsDefaultJoinTree(Node *node)
 }
 
 
+/*
+ * Whether the query is a plain (filtered) scan of its single base RTE
+ * with no row-changing clauses applied on top of it, so that rows can
+ * be sampled directly out of the base table.
+ */
+static bool
+IsSimpleFilteredBaseScan(Query *query)
+{
+	return list_length(query->rtable) == 1 &&
+		   query->sortClause == NIL &&
+		   query->limitCount == NULL &&
+		   query->limitOffset == NULL &&
+		   query->groupClause == NIL &&
+		   query->distinctClause == NIL &&
+		   !query->hasAggs &&
+		   !query->hasWindowFuncs &&
+		   !query->hasTargetSRFs &&
+		   !HasIndexRequiredQueryOperatorWalker(query->jointree->quals, NULL);
+}
+
+
+/*
+ * Whether the filter has an operator that can only be evaluated with an
+ * index ($text) or is expected to be served by one ($geoWithin, $near, ...).
+ * These can't be applied on top of a sampled heap scan.
+ */
+static bool
+HasIndexRequiredQueryOperatorWalker(Node *node, void *context)
+{
+	if (node == NULL)
+	{
+		return false;
+	}
+
+	if (IsA(node, OpExpr) || IsA(node, FuncExpr))
+	{
+		List *args;
+		const MongoQueryOperator *operator = GetMongoQueryOperatorFromExpr(node, &args);
+		switch (operator->operatorType)
+		{
+			case QUERY_OPERATOR_TEXT:
+			case QUERY_OPERATOR_GEOWITHIN:
+			case QUERY_OPERATOR_GEOINTERSECTS:
+			case QUERY_OPERATOR_NEAR:
+			case QUERY_OPERATOR_NEARSPHERE:
+			case QUERY_OPERATOR_GEONEAR:
+			{
+				return true;
+			}
+
+			default:
+			{
+				break;
+			}
+		}
+	}
+
+	return expression_tree_walker(node, HasIndexRequiredQueryOperatorWalker, context);
+}
+
+
 /*
  * Default helper for a stage that can always be inlined for a $lookup such as $match
  */
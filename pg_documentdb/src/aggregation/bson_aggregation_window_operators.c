@@ -3008,9 +3008,8 @@ HandleDollarConstFillWindowOperator(const bson_value_t *opValue,
 /*
  * Handle the $min window operator. This uses the existing
  * `bsonmin` aggregate function.
- *
- * TODO: This is just a quick implementation. Later add inverse transition
- * to make it performant for moving windows
+ * The aggregate carries a moving-aggregate implementation (monotonic
+ * deque) so that sliding frames are evaluated in amortized O(1) per row.
  */
 static WindowFunc *
 HandleDollarMinWindowOperator(const bson_value_t *opValue,
@@ -3025,9 +3024,8 @@ HandleDollarMinWindowOperator(const bson_value_t *opValue,
 /*
  * Handle the $max window operator. This uses the existing
  * `bsonmax` aggregate function.
- *
- * TODO: This is just a quick implementation. Later add inverse transition
- * to make it performant for moving windows
+ * The aggregate carries a moving-aggregate implementation (monotonic
+ * deque) so that sliding frames are evaluated in amortized O(1) per row.
  */
 static WindowFunc *
 HandleDollarMaxWindowOperator(const bson_value_t *opValue,
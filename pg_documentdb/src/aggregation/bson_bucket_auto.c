@@ -9,7 +9,9 @@
  */
 
 #include <postgres.h>
+#include <math.h>
 #include <nodes/execnodes.h>
+#include <nodes/makefuncs.h>
 #include <parser/parse_clause.h>
 #include <parser/parse_node.h>
 #include <windowapi.h>
@@ -25,6 +27,15 @@
 
 #include "aggregation/bson_bucket_auto.h"
 
+extern bool EnableApproximateBucketAuto;
+extern int TdigestCompressionAccuracy;
+
+/*
+ * Upper limit on the number of buckets that the approximate mode computes
+ * quantiles for; larger requests use the exact (sort based) path.
+ */
+#define MAX_APPROXIMATE_BUCKETAUTO_BUCKETS 10000
+
 /*
  * Structure for $bucketAuto specs.
  */
@@ -84,6 +95,28 @@ typedef struct
 	MemoryContext mcxt;
 } BucketAutoState;
 
+/*
+ * Parsed bucket boundaries for the approximate $bucketAuto, cached across
+ * calls since the boundaries are computed once per query.
+ */
+typedef struct
+{
+	/* The quantiles document the cache was built from */
+	pgbson *quantilesDocument;
+
+	/* The type the boundaries are converted to (that of the max groupBy value) */
+	bson_type_t boundaryType;
+
+	/* Strictly increasing boundaries of type boundaryType */
+	bson_value_t *boundaries;
+
+	/* The boundaries as doubles to search with */
+	double *boundaryDoubles;
+
+	/* Number of entries in boundaries */
+	int numBoundaries;
+} ApproximateBucketAutoBoundaries;
+
 static const char *BUCKETAUTO_BUCKET_ID_FIELD = "bucket_id";
 static const StringView BUCKETAUTO_GRANULARITY_SUPPORTED_TYPES[] = {
 	{ "POWERSOF2", 9 },
@@ -110,8 +143,24 @@ static Query * BuildBucketAutoQuery(Query *query,
 									bson_value_t *groupBy, const
 									bson_value_t *bucketAutoSpec);
 
+static Query * BuildApproximateBucketAutoQuery(Query *query,
+											   AggregationPipelineBuildContext *context,
+											   const bson_value_t *groupBy,
+											   int32 numBuckets);
+
+static Expr * MakeBucketAutoGroupByExpr(Expr *documentExpr, const bson_value_t *groupBy,
+										const char *path,
+										AggregationPipelineBuildContext *context);
+
+static bson_value_t MakeBucketAutoQuantileInput(const bson_value_t *groupBy);
+
 static void BuildBucketAutoGroupSpec(const bson_value_t *output, bson_value_t *groupSpec);
 
+static ApproximateBucketAutoBoundaries * GetApproximateBucketAutoBoundaries(
+	FunctionCallInfo fcinfo, pgbson *quantilesDocument, bson_type_t boundaryType);
+
+static double BucketAutoValueAsDouble(const bson_value_t *value);
+
 static void SetLowerBound(const pgbson *currentValue, const BucketAutoArguments *args,
 						  BucketAutoState *state);
 
@@ -136,6 +185,7 @@ static double FindClosestRenardOrEseries(double n, bool findLarger, const
 /* --------------------------------------------------------- */
 
 PG_FUNCTION_INFO_V1(bson_dollar_bucket_auto);
+PG_FUNCTION_INFO_V1(bson_dollar_bucket_auto_approximate);
 
 /*
  * Assign a bucket id for each document with a window function. Similar to ntile(n) window function of Postgres.
@@ -261,11 +311,100 @@ bson_dollar_bucket_auto(PG_FUNCTION_ARGS)
 }
 
 
+/*
+ * Assign a bucket id for a groupBy value given the approximate bucket
+ * boundaries computed by the t-digest (an array of quantiles) and the min
+ * and max groupBy values.
+ * The value goes into the bucket [boundaries[i], boundaries[i + 1]) that
+ * contains it, values outside the boundaries are clamped to the first or
+ * last bucket and the last bucket includes its upper bound. null and missing
+ * values sort first and go into the first bucket.
+ * The inner boundaries are converted to the type of the max value (int, long,
+ * date or double), the outer ones are the min and max values themselves.
+ * result format: {"bucket_id" : {"min" : <lower_bound>, "max" : <upper_bound>}}.
+ */
+Datum
+bson_dollar_bucket_auto_approximate(PG_FUNCTION_ARGS)
+{
+	pgbson *currentValue = PG_GETARG_PGBSON(0);
+	pgbson *quantilesDocument = PG_GETARG_PGBSON(1);
+	pgbson *minValue = PG_GETARG_PGBSON(2);
+	pgbson *maxValue = PG_GETARG_PGBSON(3);
+
+	pgbsonelement currentElement;
+	PgbsonToSinglePgbsonElement(currentValue, &currentElement);
+
+	pgbsonelement minElement;
+	PgbsonToSinglePgbsonElement(minValue, &minElement);
+
+	pgbsonelement maxElement;
+	PgbsonToSinglePgbsonElement(maxValue, &maxElement);
+
+	bson_type_t valueType = currentElement.bsonValue.value_type;
+	if (valueType != BSON_TYPE_NULL && valueType != BSON_TYPE_UNDEFINED &&
+		valueType != BSON_TYPE_DATE_TIME &&
+		!BsonValueIsNumber(&currentElement.bsonValue))
+	{
+		ereport(ERROR, (errcode(ERRCODE_DOCUMENTDB_BADVALUE),
+						errmsg(
+							"Approximate $bucketAuto only supports numeric, date or null 'groupBy' values, but encountered a value of type: %s",
+							BsonTypeName(valueType))));
+	}
+
+	ApproximateBucketAutoBoundaries *boundaries =
+		GetApproximateBucketAutoBoundaries(fcinfo, quantilesDocument,
+										   maxElement.bsonValue.value_type);
+
+	/* Find the last boundary that is <= the value, null and NaN sort first */
+	int lowerIndex = 0;
+	if (valueType != BSON_TYPE_NULL && valueType != BSON_TYPE_UNDEFINED &&
+		!IsBsonValueNaN(&currentElement.bsonValue))
+	{
+		double value = BucketAutoValueAsDouble(&currentElement.bsonValue);
+		int low = 0;
+		int high = boundaries->numBoundaries - 2;
+		while (low <= high)
+		{
+			int mid = low + (high - low) / 2;
+			if (boundaries->boundaryDoubles[mid] <= value)
+			{
+				lowerIndex = mid;
+				low = mid + 1;
+			}
+			else
+			{
+				high = mid - 1;
+			}
+		}
+	}
+
+	const bson_value_t *lowerBound = lowerIndex == 0 ?
+									 &minElement.bsonValue :
+									 &boundaries->boundaries[lowerIndex];
+	const bson_value_t *upperBound = lowerIndex + 1 >= boundaries->numBoundaries - 1 ?
+									 &maxElement.bsonValue :
+									 &boundaries->boundaries[lowerIndex + 1];
+
+	pgbson_writer writer;
+	PgbsonWriterInit(&writer);
+	pgbson_writer innerWriter;
+	PgbsonWriterStartDocument(&writer, "bucket_id", 9, &innerWriter);
+	PgbsonWriterAppendValue(&innerWriter, "min", 3, lowerBound);
+	PgbsonWriterAppendValue(&innerWriter, "max", 3, upperBound);
+	PgbsonWriterEndDocument(&writer, &innerWriter);
+	PG_RETURN_POINTER(PgbsonWriterGetPgbson(&writer));
+}
+
+
 /*
  * Handles the $bucketAuto stage.
  * Validate the arguments and check required fields.
  * The conversion to postgresql query will be done in 2 parts:
  * 1. Function bson_dollar_bucket_auto() to calculate the bucket id for each row.
+ *    When the approximate mode is enabled, the boundaries are instead computed
+ *    as quantiles by a t-digest aggregate over the input, cross joined back with
+ *    it, and bson_dollar_bucket_auto_approximate() assigns the bucket id for each
+ *    row, which avoids sorting the input.
  * 2. Call HandleGroup() to group the data by the bucket id.
  */
 Query *
@@ -381,10 +520,22 @@ HandleBucketAuto(const bson_value_t *existingValue, Query *query,
 							BsonValueToJsonForLogging(&groupBy))));
 	}
 
+	/* The approximate mode doesn't round boundaries to a granularity series */
+	bool useApproximateBucketAuto = EnableApproximateBucketAuto &&
+									granularity == NULL &&
+									numBuckets <= MAX_APPROXIMATE_BUCKETAUTO_BUCKETS;
+
 	/* step 1: ntile window function to assign bucket_id for each row. */
-	query = BuildBucketAutoQuery(query, context,
-								 &groupBy,
-								 existingValue);
+	if (useApproximateBucketAuto)
+	{
+		query = BuildApproximateBucketAutoQuery(query, context, &groupBy, numBuckets);
+	}
+	else
+	{
+		query = BuildBucketAutoQuery(query, context,
+									 &groupBy,
+									 existingValue);
+	}
 
 	/* step 2: Group by bucket id and add output fields. */
 	bson_value_t groupSpec = { 0 };
@@ -409,31 +560,9 @@ BuildBucketAutoQuery(Query *query,
 					 bson_value_t *groupBy, const
 					 bson_value_t *bucketAutoSpec)
 {
-	/* get groupBy field function expression.
-	 * About let variables support, arguments "buckets" and "granularity" are constants, "output" with let will be handled by HandleGroup, we only need to take care of variableSpec when evaluating groupBy field.
-	 */
-	pgbson *groupByDoc = BsonValueToDocumentPgbson(groupBy);
 	TargetEntry *origEntry = linitial(query->targetList);
-
-	List *args;
-	Oid bsonExpressionGetFunction;
-	if (context->variableSpec != NULL)
-	{
-		bsonExpressionGetFunction = BsonExpressionGetWithLetFunctionOid();
-		args = list_make4(origEntry->expr, MakeBsonConst(groupByDoc),
-						  MakeBoolValueConst(true), context->variableSpec);
-	}
-	else
-	{
-		bsonExpressionGetFunction = BsonExpressionGetFunctionOid();
-		args = list_make3(origEntry->expr, MakeBsonConst(groupByDoc),
-						  MakeBoolValueConst(true));
-	}
-
-	FuncExpr *getGroupbyFieldExpr = makeFuncExpr(bsonExpressionGetFunction,
-												 BsonTypeId(), args,
-												 InvalidOid, InvalidOid,
-												 COERCE_EXPLICIT_CALL);
+	Expr *getGroupbyFieldExpr = MakeBucketAutoGroupByExpr(origEntry->expr, groupBy, "",
+														  context);
 
 	Index winRef = 1;
 	ParseState *parseState = make_parsestate(NULL);
@@ -525,6 +654,226 @@ BuildBucketAutoQuery(Query *query,
 }
 
 
+/* Build the approximate $bucketAuto query: the bucket boundaries are the quantiles of the groupBy
+ * values computed by the t-digest. The quantiles, the min and the max are computed by one plain
+ * aggregate over the input, which produces a single row that is cross joined back with the input
+ * to assign each row to its bucket by a binary search over the boundaries. The input is read twice
+ * but never sorted nor stored, and the groupBy is evaluated once per row on each side.
+ * Result query:
+ * SELECT bson_dollar_add_fields(agg_stage.document, bson_dollar_bucket_auto_approximate(
+ *          bson_expression_get(agg_stage.document, '{ "" : "<groupByField>" }'::bson, true),
+ *          bucket_stats.bucket_quantiles, bucket_stats.bucket_min, bucket_stats.bucket_max)) AS document
+ *  FROM (<input>) AS agg_stage,
+ *   (
+ *     SELECT bsonpercentile(bson_expression_get(bucket_value, '{ "" : <$v as a number> }'::bson, true), <compression>, '{ "" : [ 0, 1/n, ..., 1 ] }'::bson) AS bucket_quantiles,
+ *       bsonmin(bucket_value) AS bucket_min,
+ *       bsonmax(bucket_value) AS bucket_max
+ *     FROM (
+ *        SELECT bson_expression_get(document, '{ "v" : "<groupByField>" }'::bson, true) AS bucket_value
+ *        FROM (<input>)
+ *     ) AS bucket_values
+ *   ) AS bucket_stats;
+ */
+static Query *
+BuildApproximateBucketAutoQuery(Query *query, AggregationPipelineBuildContext *context,
+								const bson_value_t *groupBy, int32 numBuckets)
+{
+	/*
+	 * The groupBy values of the input, named so that the quantile input can refer to them
+	 */
+	Query *valuesQuery = copyObject(query);
+	TargetEntry *valuesEntry = linitial(valuesQuery->targetList);
+
+	valuesEntry->expr = MakeBucketAutoGroupByExpr(valuesEntry->expr, groupBy, "v",
+												  context);
+	valuesEntry->resname = pstrdup("bucket_value");
+
+	/*
+	 * One aggregate over the groupBy values computes the quantiles, min and max
+	 */
+	bson_value_t valuePath = {
+		.value_type = BSON_TYPE_UTF8,
+		.value.v_utf8.str = "$v",
+		.value.v_utf8.len = 2
+	};
+	bson_value_t quantileInput = MakeBucketAutoQuantileInput(&valuePath);
+
+	Index childIndex = 1;
+	Var *valueVar = makeVar(childIndex, valuesEntry->resno, BsonTypeId(), -1,
+							InvalidOid, 0);
+	Expr *quantileInputExpr = (Expr *) makeFuncExpr(BsonExpressionGetFunctionOid(),
+													BsonTypeId(),
+													list_make3(valueVar,
+															   MakeBsonConst(
+																   BsonValueToDocumentPgbson(
+																	   &quantileInput)),
+															   MakeBoolValueConst(true)),
+													InvalidOid, InvalidOid,
+													COERCE_EXPLICIT_CALL);
+
+	pgbson_writer writer;
+	PgbsonWriterInit(&writer);
+	pgbson_array_writer arrayWriter;
+	PgbsonWriterStartArray(&writer, "", 0, &arrayWriter);
+	for (int i = 0; i <= numBuckets; i++)
+	{
+		bson_value_t percentile = {
+			.value_type = BSON_TYPE_DOUBLE,
+			.value.v_double = (double) i / numBuckets
+		};
+		PgbsonArrayWriterWriteValue(&arrayWriter, &percentile);
+	}
+	PgbsonWriterEndArray(&writer, &arrayWriter);
+	Const *percentilesConst = MakeBsonConst(PgbsonWriterGetPgbson(&writer));
+
+	Const *accuracyConstValue = makeConst(INT4OID, -1, InvalidOid, sizeof(int32_t),
+										  Int32GetDatum(TdigestCompressionAccuracy),
+										  false, true);
+
+	ParseState *parseState = make_parsestate(NULL);
+	Aggref *quantilesAggref = CreateMultiArgAggregate(
+		BsonPercentileAggregateFunctionOid(),
+		list_make3(quantileInputExpr, accuracyConstValue, percentilesConst),
+		list_make3_oid(BsonTypeId(), INT4OID, BsonTypeId()),
+		parseState);
+	Aggref *minAggref = CreateMultiArgAggregate(BsonMinAggregateFunctionOid(),
+												list_make1(copyObject(valueVar)),
+												list_make1_oid(BsonTypeId()),
+												parseState);
+	Aggref *maxAggref = CreateMultiArgAggregate(BsonMaxAggregateFunctionOid(),
+												list_make1(copyObject(valueVar)),
+												list_make1_oid(BsonTypeId()),
+												parseState);
+	free_parsestate(parseState);
+
+	bool resjunk = false;
+	Query *statsQuery = makeNode(Query);
+	statsQuery->commandType = CMD_SELECT;
+	statsQuery->querySource = query->querySource;
+	statsQuery->canSetTag = true;
+	statsQuery->hasAggs = true;
+	statsQuery->rtable = list_make1(MakeSubQueryRte(valuesQuery, context->stageNum,
+													context->nestedPipelineLevel,
+													"bucket_values", false));
+	RangeTblRef *valuesRef = makeNode(RangeTblRef);
+	valuesRef->rtindex = childIndex;
+	statsQuery->jointree = makeFromExpr(list_make1(valuesRef), NULL);
+
+	TargetEntry *quantilesEntry = makeTargetEntry((Expr *) quantilesAggref, 1,
+												  pstrdup("bucket_quantiles"), resjunk);
+	TargetEntry *minEntry = makeTargetEntry((Expr *) minAggref, 2,
+											pstrdup("bucket_min"), resjunk);
+	TargetEntry *maxEntry = makeTargetEntry((Expr *) maxAggref, 3,
+											pstrdup("bucket_max"), resjunk);
+	statsQuery->targetList = list_make3(quantilesEntry, minEntry, maxEntry);
+
+	/*
+	 * Cross join the single row of the stats with the input and merge the bucket id into
+	 * the document
+	 */
+	Index statsIndex = 2;
+	query = MigrateQueryToSubQuery(query, context);
+	query->rtable = lappend(query->rtable,
+							MakeSubQueryRte(statsQuery, context->stageNum,
+											context->nestedPipelineLevel,
+											"bucket_stats", true));
+	RangeTblRef *statsRef = makeNode(RangeTblRef);
+	statsRef->rtindex = statsIndex;
+	query->jointree->fromlist = lappend(query->jointree->fromlist, statsRef);
+
+	TargetEntry *docEntry = linitial(query->targetList);
+	Expr *groupByExpr = MakeBucketAutoGroupByExpr(copyObject(docEntry->expr), groupBy, "",
+												  context);
+	FuncExpr *bucketIdExpr = makeFuncExpr(BsonDollarBucketAutoApproximateFunctionOid(),
+										  BsonTypeId(),
+										  list_make4(
+											  groupByExpr,
+											  makeVarFromTargetEntry(statsIndex,
+																	 quantilesEntry),
+											  makeVarFromTargetEntry(statsIndex,
+																	 minEntry),
+											  makeVarFromTargetEntry(statsIndex,
+																	 maxEntry)),
+										  InvalidOid, InvalidOid,
+										  COERCE_EXPLICIT_CALL);
+
+	docEntry->expr = (Expr *) makeFuncExpr(BsonDollarAddFieldsFunctionOid(),
+										   BsonTypeId(),
+										   list_make2(docEntry->expr, bucketIdExpr),
+										   InvalidOid, InvalidOid,
+										   COERCE_EXPLICIT_CALL);
+
+	/* Push everything to subquery after this */
+	context->requiresSubQuery = true;
+
+	return query;
+}
+
+
+/*
+ * The expression the quantiles are computed over: the t-digest only digests
+ * numbers, so dates are converted into their epoch milliseconds.
+ * { "$let": { "vars": { "value": <groupBy> }, "in": { "$cond": [ { "$eq": [ { "$type": "$$value" }, "date" ] }, { "$toLong": "$$value" }, "$$value" ] } } }
+ */
+static bson_value_t
+MakeBucketAutoQuantileInput(const bson_value_t *groupBy)
+{
+	pgbson *inExpression = PgbsonInitFromJson(
+		"{ \"$cond\": [ { \"$eq\": [ { \"$type\": \"$$value\" }, \"date\" ] }, "
+		"{ \"$toLong\": \"$$value\" }, \"$$value\" ] }");
+
+	pgbson_writer writer;
+	PgbsonWriterInit(&writer);
+
+	pgbson_writer letWriter;
+	PgbsonWriterStartDocument(&writer, "$let", 4, &letWriter);
+
+	pgbson_writer varsWriter;
+	PgbsonWriterStartDocument(&letWriter, "vars", 4, &varsWriter);
+	PgbsonWriterAppendValue(&varsWriter, "value", 5, groupBy);
+	PgbsonWriterEndDocument(&letWriter, &varsWriter);
+
+	PgbsonWriterAppendDocument(&letWriter, "in", 2, inExpression);
+	PgbsonWriterEndDocument(&writer, &letWriter);
+
+	return ConvertPgbsonToBsonValue(PgbsonWriterGetPgbson(&writer));
+}
+
+
+/* get groupBy field function expression, the value is returned in a document under the given path.
+ * About let variables support, arguments "buckets" and "granularity" are constants, "output" with let will be handled by HandleGroup, we only need to take care of variableSpec when evaluating groupBy field.
+ */
+static Expr *
+MakeBucketAutoGroupByExpr(Expr *documentExpr, const bson_value_t *groupBy,
+						  const char *path, AggregationPipelineBuildContext *context)
+{
+	pgbson_writer writer;
+	PgbsonWriterInit(&writer);
+	PgbsonWriterAppendValue(&writer, path, strlen(path), groupBy);
+	pgbson *groupByDoc = PgbsonWriterGetPgbson(&writer);
+
+	List *args;
+	Oid bsonExpressionGetFunction;
+	if (context->variableSpec != NULL)
+	{
+		bsonExpressionGetFunction = BsonExpressionGetWithLetFunctionOid();
+		args = list_make4(documentExpr, MakeBsonConst(groupByDoc),
+						  MakeBoolValueConst(true), context->variableSpec);
+	}
+	else
+	{
+		bsonExpressionGetFunction = BsonExpressionGetFunctionOid();
+		args = list_make3(documentExpr, MakeBsonConst(groupByDoc),
+						  MakeBoolValueConst(true));
+	}
+
+	return (Expr *) makeFuncExpr(bsonExpressionGetFunction,
+								 BsonTypeId(), args,
+								 InvalidOid, InvalidOid,
+								 COERCE_EXPLICIT_CALL);
+}
+
+
 /*
  * build group spec to call HandleGroup.
  * 1. Add '_id' field to group spec, which is the bucket id generated by window function.
@@ -765,6 +1114,139 @@ SetUpperBound(WindowObject winobj, const BucketAutoArguments *args,
 }
 
 
+/*
+ * Returns the parsed (deduplicated) boundaries for the approximate $bucketAuto.
+ * The quantiles are converted to boundaryType: int, long and date boundaries are
+ * rounded to whole values, other types keep the double quantiles.
+ * The quantiles and the max value are the same for every row, so the parsed form
+ * is cached in fn_extra and only rebuilt if they change.
+ */
+static ApproximateBucketAutoBoundaries *
+GetApproximateBucketAutoBoundaries(FunctionCallInfo fcinfo, pgbson *quantilesDocument,
+								   bson_type_t boundaryType)
+{
+	ApproximateBucketAutoBoundaries *cached =
+		(ApproximateBucketAutoBoundaries *) fcinfo->flinfo->fn_extra;
+	if (cached != NULL && cached->boundaryType == boundaryType &&
+		VARSIZE(cached->quantilesDocument) == VARSIZE(quantilesDocument) &&
+		memcmp(cached->quantilesDocument, quantilesDocument,
+			   VARSIZE(quantilesDocument)) == 0)
+	{
+		return cached;
+	}
+
+	MemoryContext oldContext = MemoryContextSwitchTo(fcinfo->flinfo->fn_mcxt);
+	if (cached == NULL)
+	{
+		cached = palloc0(sizeof(ApproximateBucketAutoBoundaries));
+		fcinfo->flinfo->fn_extra = cached;
+	}
+	else
+	{
+		pfree(cached->quantilesDocument);
+		pfree(cached->boundaries);
+		pfree(cached->boundaryDoubles);
+	}
+
+	pgbsonelement quantilesElement;
+	PgbsonToSinglePgbsonElement(quantilesDocument, &quantilesElement);
+
+	int maxBoundaries = Max(BsonDocumentValueCountKeys(&quantilesElement.bsonValue), 1);
+	bson_value_t *boundaries = palloc0(sizeof(bson_value_t) * maxBoundaries);
+	double *boundaryDoubles = palloc(sizeof(double) * maxBoundaries);
+	int numBoundaries = 0;
+
+	bson_iter_t quantilesIter;
+	BsonValueInitIterator(&quantilesElement.bsonValue, &quantilesIter);
+	while (bson_iter_next(&quantilesIter))
+	{
+		const bson_value_t *value = bson_iter_value(&quantilesIter);
+		if (!BsonValueIsNumber(value))
+		{
+			/* No numeric values were seen by the t-digest (e.g. only nulls) */
+			continue;
+		}
+
+		double quantile = BsonValueAsDoubleQuiet(value);
+		bson_value_t boundary = { 0 };
+		switch (boundaryType)
+		{
+			case BSON_TYPE_INT32:
+			{
+				double rounded = rint(quantile);
+				if (rounded >= PG_INT32_MIN && rounded <= PG_INT32_MAX)
+				{
+					boundary.value_type = BSON_TYPE_INT32;
+					boundary.value.v_int32 = (int32_t) rounded;
+				}
+				else
+				{
+					boundary.value_type = BSON_TYPE_INT64;
+					boundary.value.v_int64 = (int64_t) rounded;
+				}
+				break;
+			}
+
+			case BSON_TYPE_INT64:
+			{
+				boundary.value_type = BSON_TYPE_INT64;
+				boundary.value.v_int64 = (int64_t) rint(quantile);
+				break;
+			}
+
+			case BSON_TYPE_DATE_TIME:
+			{
+				boundary.value_type = BSON_TYPE_DATE_TIME;
+				boundary.value.v_datetime = (int64_t) rint(quantile);
+				break;
+			}
+
+			default:
+			{
+				boundary.value_type = BSON_TYPE_DOUBLE;
+				boundary.value.v_double = quantile;
+				break;
+			}
+		}
+
+		/* Heavy duplicates (or rounding) produce equal boundaries: merge those buckets */
+		double boundaryDouble = BucketAutoValueAsDouble(&boundary);
+		if (numBoundaries == 0 || boundaryDouble > boundaryDoubles[numBoundaries - 1])
+		{
+			boundaries[numBoundaries] = boundary;
+			boundaryDoubles[numBoundaries] = boundaryDouble;
+			numBoundaries++;
+		}
+	}
+
+	cached->quantilesDocument = CopyPgbsonIntoMemoryContext(quantilesDocument,
+															fcinfo->flinfo->fn_mcxt);
+	cached->boundaryType = boundaryType;
+	cached->boundaries = boundaries;
+	cached->boundaryDoubles = boundaryDoubles;
+	cached->numBoundaries = numBoundaries;
+	MemoryContextSwitchTo(oldContext);
+
+	return cached;
+}
+
+
+/*
+ * The position of a numeric or date groupBy value on the quantile scale:
+ * dates are digested as their epoch milliseconds.
+ */
+static double
+BucketAutoValueAsDouble(const bson_value_t *value)
+{
+	if (value->value_type == BSON_TYPE_DATE_TIME)
+	{
+		return (double) value->value.v_datetime;
+	}
+
+	return BsonValueAsDoubleQuiet(value);
+}
+
+
 static void
 InitializeBucketAutoArguments(BucketAutoArguments *args, const pgbson *spec)
 {
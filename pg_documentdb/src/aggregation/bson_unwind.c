@@ -15,6 +15,8 @@
 #include "io/bson_set_returning_functions.h"
 #include "io/bson_traversal.h"
 
+extern bool EnableStreamingUnwind;
+
 /* --------------------------------------------------------- */
 /* Forward declaration */
 /* --------------------------------------------------------- */
@@ -30,6 +32,51 @@ typedef struct DistinctTraverseState
 } DistinctTraverseState;
 
 
+/*
+ * State carried across calls of the value-per-call (streaming) variants
+ * of $unwind and the lookup unwind. Lives in the multi-call memory context
+ * of the SRF so that only the current output document is materialized
+ * at any given time.
+ */
+typedef struct UnwindStreamingState
+{
+	/* The (detoasted) source document being unwound */
+	pgbson *document;
+
+	/* The path being unwound (without the '$' prefix) */
+	char *path;
+
+	/* optional name for the index field to be added */
+	char *indexFieldName;
+
+	/* Whether to keep null and empty unwind values */
+	bool preserveNullAndEmpty;
+
+	/* Whether the unwind target is an array that is being iterated */
+	bool isArrayTarget;
+
+	/* The iterator on the array at the unwind target */
+	bson_iter_t arrayIterator;
+
+	/* The index of the next element returned from the array */
+	long index;
+
+	/*
+	 * Whether there is a single (non-array) result that is still
+	 * pending to be returned.
+	 */
+	bool hasPendingSingleResult;
+
+	/*
+	 * When true, the single pending result is the source document as is.
+	 */
+	bool pendingResultIsSourceDocument;
+
+	/* The value to unwind for the pending single result */
+	bson_value_t pendingSingleValue;
+} UnwindStreamingState;
+
+
 static pgbson * BsonUnwindElement(pgbson *document, char *path, char *indexFieldName,
 								  long index, const bson_value_t *element);
 static pgbson * BsonUnwindEmptyArray(pgbson *document, char *path, char *indexFieldName);
@@ -37,6 +84,13 @@ static Datum BsonUnwindArray(PG_FUNCTION_ARGS, Tuplestorestate *tupleState,
 							 TupleDesc *tupleDescriptor,
 							 char *path, char *indexFieldName, bool
 							 preserveNullAndEmpty);
+static void ParseUnwindOptions(pgbson *spec, char **path, char **indexFieldName,
+							   bool *preserveNullAndEmpty);
+static char * GetUnwindTargetPath(char *path);
+static void InitUnwindStreamingState(PG_FUNCTION_ARGS, char *path, char *indexFieldName,
+									 bool preserveNullAndEmpty);
+static Datum BsonUnwindArrayNextValue(PG_FUNCTION_ARGS);
+static Datum BsonLookupUnwindNextValue(PG_FUNCTION_ARGS);
 static bool DistinctContinueProcessIntermediateArray(void *state, const
 													 bson_value_t *value, bool
 													 isArrayIndexSearch);
@@ -69,60 +123,26 @@ PG_FUNCTION_INFO_V1(bson_lookup_unwind);
 Datum
 bson_dollar_unwind_with_options(PG_FUNCTION_ARGS)
 {
-	pgbson *spec = PG_GETARG_PGBSON_PACKED(1);
-
 	char *path = NULL;
 	bool preserveNullAndEmpty = false;
 	char *indexFieldName = NULL;
 
-	bson_iter_t specIter;
-	PgbsonInitIterator(spec, &specIter);
-	while (bson_iter_next(&specIter))
+	if (EnableStreamingUnwind)
 	{
-		if (strcmp(bson_iter_key(&specIter), "path") == 0)
+		if (SRF_IS_FIRSTCALL())
 		{
-			const bson_value_t *pathValue = bson_iter_value(&specIter);
-			if (pathValue->value_type != BSON_TYPE_UTF8)
-			{
-				ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg(
-									"$unwind path must be a text value")));
-			}
-
-			path = pathValue->value.v_utf8.str;
-		}
-		else if (strcmp(bson_iter_key(&specIter), "preserveNullAndEmptyArrays") == 0)
-		{
-			const bson_value_t *preserveNullAndEmptyValue = bson_iter_value(&specIter);
-			if (preserveNullAndEmptyValue->value_type != BSON_TYPE_BOOL)
-			{
-				ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg(
-									"$unwind preserveNullAndEmptyArrays must be a bool value")));
-			}
-			preserveNullAndEmpty = preserveNullAndEmptyValue->value.v_bool;
+			ParseUnwindOptions(PG_GETARG_PGBSON_PACKED(1), &path, &indexFieldName,
+							   &preserveNullAndEmpty);
+			InitUnwindStreamingState(fcinfo, path, indexFieldName,
+									 preserveNullAndEmpty);
 		}
-		else if (strcmp(bson_iter_key(&specIter), "includeArrayIndex") == 0)
-		{
-			const bson_value_t *arrayIndex = bson_iter_value(&specIter);
-			if (arrayIndex->value_type != BSON_TYPE_UTF8)
-			{
-				ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg(
-									"$unwind includeArrayIndex must be a text value")));
-			}
-			indexFieldName = arrayIndex->value.v_utf8.str;
-		}
-		else
-		{
-			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg(
-								"option not recognized during unwind stage")));
-		}
-	}
 
-	if (path == NULL)
-	{
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg(
-							"$unwind requires a path")));
+		return BsonUnwindArrayNextValue(fcinfo);
 	}
 
+	ParseUnwindOptions(PG_GETARG_PGBSON_PACKED(1), &path, &indexFieldName,
+					   &preserveNullAndEmpty);
+
 	TupleDesc descriptor;
 	Tuplestorestate *tupleStore = SetupBsonTuplestore(fcinfo, &descriptor);
 
@@ -144,6 +164,17 @@ bson_dollar_unwind(PG_FUNCTION_ARGS)
 	char *indexFieldName = NULL;
 	bool preserveNullAndEmpty = false;
 
+	if (EnableStreamingUnwind)
+	{
+		if (SRF_IS_FIRSTCALL())
+		{
+			InitUnwindStreamingState(fcinfo, text_to_cstring(PG_GETARG_TEXT_PP(1)),
+									 indexFieldName, preserveNullAndEmpty);
+		}
+
+		return BsonUnwindArrayNextValue(fcinfo);
+	}
+
 	TupleDesc descriptor;
 	Tuplestorestate *tupleStore = SetupBsonTuplestore(fcinfo, &descriptor);
 
@@ -203,6 +234,11 @@ bson_distinct_unwind(PG_FUNCTION_ARGS)
 Datum
 bson_lookup_unwind(PG_FUNCTION_ARGS)
 {
+	if (EnableStreamingUnwind)
+	{
+		return BsonLookupUnwindNextValue(fcinfo);
+	}
+
 	TupleDesc descriptor;
 	Tuplestorestate *tupleStore = SetupBsonTuplestore(fcinfo, &descriptor);
 	pgbson *document = PG_GETARG_PGBSON(0);
@@ -260,18 +296,7 @@ BsonUnwindArray(PG_FUNCTION_ARGS, Tuplestorestate *tupleStore, TupleDesc *tupleD
 	pgbson *document = PG_GETARG_PGBSON_PACKED(0);
 
 	/* Strip the $ prefix from the path */
-	if (strlen(path) <= 1)
-	{
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg(
-							"$unwind path should have at least two characters")));
-	}
-
-	if (path[0] != '$')
-	{
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg(
-							"$unwind path must be prefixed by $")));
-	}
-	path = path + 1;
+	path = GetUnwindTargetPath(path);
 
 	/* Start the iterator at the provided path */
 	bson_iter_t documentIterator;
@@ -386,6 +411,251 @@ BsonUnwindArray(PG_FUNCTION_ARGS, Tuplestorestate *tupleStore, TupleDesc *tupleD
 }
 
 
+
+
+/*
+ * Parses the options document of the $unwind stage into its components.
+ * The returned strings point into the spec.
+ */
+static void
+ParseUnwindOptions(pgbson *spec, char **path, char **indexFieldName,
+				   bool *preserveNullAndEmpty)
+{
+	bson_iter_t specIter;
+	PgbsonInitIterator(spec, &specIter);
+	while (bson_iter_next(&specIter))
+	{
+		if (strcmp(bson_iter_key(&specIter), "path") == 0)
+		{
+			const bson_value_t *pathValue = bson_iter_value(&specIter);
+			if (pathValue->value_type != BSON_TYPE_UTF8)
+			{
+				ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg(
+									"$unwind path must be a text value")));
+			}
+
+			*path = pathValue->value.v_utf8.str;
+		}
+		else if (strcmp(bson_iter_key(&specIter), "preserveNullAndEmptyArrays") == 0)
+		{
+			const bson_value_t *preserveNullAndEmptyValue = bson_iter_value(&specIter);
+			if (preserveNullAndEmptyValue->value_type != BSON_TYPE_BOOL)
+			{
+				ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg(
+									"$unwind preserveNullAndEmptyArrays must be a bool value")));
+			}
+			*preserveNullAndEmpty = preserveNullAndEmptyValue->value.v_bool;
+		}
+		else if (strcmp(bson_iter_key(&specIter), "includeArrayIndex") == 0)
+		{
+			const bson_value_t *arrayIndex = bson_iter_value(&specIter);
+			if (arrayIndex->value_type != BSON_TYPE_UTF8)
+			{
+				ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg(
+									"$unwind includeArrayIndex must be a text value")));
+			}
+			*indexFieldName = arrayIndex->value.v_utf8.str;
+		}
+		else
+		{
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg(
+								"option not recognized during unwind stage")));
+		}
+	}
+
+	if (*path == NULL)
+	{
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg(
+							"$unwind requires a path")));
+	}
+}
+
+
+/*
+ * Validates the $unwind path and returns the path with the '$' prefix stripped.
+ */
+static char *
+GetUnwindTargetPath(char *path)
+{
+	if (strlen(path) <= 1)
+	{
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg(
+							"$unwind path should have at least two characters")));
+	}
+
+	if (path[0] != '$')
+	{
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg(
+							"$unwind path must be prefixed by $")));
+	}
+
+	return path + 1;
+}
+
+
+/*
+ * Sets up the multi-call state for the streaming $unwind on the first call.
+ * This mirrors BsonUnwindArray: the shape of the unwind target is resolved
+ * once here, and BsonUnwindArrayNextValue then produces one output document
+ * per call instead of writing every unwound element into a tuplestore.
+ */
+static void
+InitUnwindStreamingState(PG_FUNCTION_ARGS, char *path, char *indexFieldName,
+						 bool preserveNullAndEmpty)
+{
+	FuncCallContext *functionContext = SRF_FIRSTCALL_INIT();
+	MemoryContext oldContext = MemoryContextSwitchTo(
+		functionContext->multi_call_memory_ctx);
+
+	UnwindStreamingState *state = palloc0(sizeof(UnwindStreamingState));
+	state->document = PG_GETARG_PGBSON_PACKED(0);
+	state->path = pstrdup(GetUnwindTargetPath(path));
+	state->indexFieldName = indexFieldName != NULL ? pstrdup(indexFieldName) : NULL;
+	state->preserveNullAndEmpty = preserveNullAndEmpty;
+	state->index = 0;
+
+	bson_iter_t documentIterator;
+	if (!PgbsonInitIteratorAtPath(state->document, state->path, &documentIterator))
+	{
+		/* No field was found, undefined elements are preserved if requested */
+		state->hasPendingSingleResult = preserveNullAndEmpty;
+		state->pendingSingleValue.value_type = BSON_TYPE_EOD;
+	}
+	else if (BSON_ITER_HOLDS_ARRAY(&documentIterator))
+	{
+		state->isArrayTarget = true;
+		bson_iter_recurse(&documentIterator, &state->arrayIterator);
+	}
+	else if (!BSON_ITER_HOLDS_NULL(&documentIterator))
+	{
+		/* Single non-null elements are always preserved */
+		state->hasPendingSingleResult = true;
+		state->pendingResultIsSourceDocument = indexFieldName == NULL;
+		state->pendingSingleValue = *bson_iter_value(&documentIterator);
+	}
+	else
+	{
+		/* Nulls are persisted if the document is preserved in the output */
+		state->hasPendingSingleResult = preserveNullAndEmpty;
+		state->pendingSingleValue.value_type = BSON_TYPE_NULL;
+	}
+
+	functionContext->user_fctx = state;
+	MemoryContextSwitchTo(oldContext);
+}
+
+
+/*
+ * Returns the next output document of the streaming $unwind. Output documents
+ * are allocated in the per-call memory context of the caller, so the memory
+ * held at any time is bounded by a single unwound document.
+ */
+static Datum
+BsonUnwindArrayNextValue(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *functionContext = SRF_PERCALL_SETUP();
+	UnwindStreamingState *state = (UnwindStreamingState *) functionContext->user_fctx;
+
+	if (state->hasPendingSingleResult)
+	{
+		state->hasPendingSingleResult = false;
+		if (state->pendingResultIsSourceDocument)
+		{
+			/* This is just the source doc */
+			SRF_RETURN_NEXT(functionContext, PG_GETARG_DATUM(0));
+		}
+
+		SRF_RETURN_NEXT(functionContext, PointerGetDatum(
+							BsonUnwindElement(state->document, state->path,
+											  state->indexFieldName, -1,
+											  &state->pendingSingleValue)));
+	}
+
+	if (!state->isArrayTarget)
+	{
+		SRF_RETURN_DONE(functionContext);
+	}
+
+	if (bson_iter_next(&state->arrayIterator))
+	{
+		/* Project normal array elements */
+		pgbson *result = BsonUnwindElement(state->document, state->path,
+										   state->indexFieldName, state->index,
+										   bson_iter_value(&state->arrayIterator));
+		state->index++;
+		SRF_RETURN_NEXT(functionContext, PointerGetDatum(result));
+	}
+
+	state->isArrayTarget = false;
+	if (state->index == 0 && state->preserveNullAndEmpty)
+	{
+		/* Empty arrays are removed if the document is preserved in the output */
+		SRF_RETURN_NEXT(functionContext, PointerGetDatum(
+							BsonUnwindEmptyArray(state->document, state->path,
+												 state->indexFieldName)));
+	}
+
+	SRF_RETURN_DONE(functionContext);
+}
+
+
+/*
+ * Value-per-call implementation of bson_lookup_unwind: returns one document
+ * of the (bson_array_agg) array at the given path per call.
+ */
+static Datum
+BsonLookupUnwindNextValue(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *functionContext;
+	UnwindStreamingState *state;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		functionContext = SRF_FIRSTCALL_INIT();
+		MemoryContext oldContext = MemoryContextSwitchTo(
+			functionContext->multi_call_memory_ctx);
+
+		state = palloc0(sizeof(UnwindStreamingState));
+		state->document = PG_GETARG_PGBSON(0);
+		state->path = text_to_cstring(PG_GETARG_TEXT_P(1));
+
+		bson_iter_t documentIterator;
+		if (PgbsonInitIteratorAtPath(state->document, state->path, &documentIterator))
+		{
+			if (!BSON_ITER_HOLDS_ARRAY(&documentIterator) ||
+				!bson_iter_recurse(&documentIterator, &state->arrayIterator))
+			{
+				ereport(ERROR, (errmsg(
+									"Lookup unwind expecting field to contain an array")));
+			}
+
+			state->isArrayTarget = true;
+		}
+
+		functionContext->user_fctx = state;
+		MemoryContextSwitchTo(oldContext);
+	}
+
+	functionContext = SRF_PERCALL_SETUP();
+	state = (UnwindStreamingState *) functionContext->user_fctx;
+
+	if (state->isArrayTarget && bson_iter_next(&state->arrayIterator))
+	{
+		if (!BSON_ITER_HOLDS_DOCUMENT(&state->arrayIterator))
+		{
+			ereport(ERROR, (errmsg(
+								"Lookup unwind array expecting entries to contain documents")));
+		}
+
+		SRF_RETURN_NEXT(functionContext, PointerGetDatum(
+							PgbsonInitFromDocumentBsonValue(
+								bson_iter_value(&state->arrayIterator))));
+	}
+
+	SRF_RETURN_DONE(functionContext);
+}
+
+
 /*
  * BsonUnwindElement produces the output document when element
  * at the unwind target
@@ -16,6 +16,11 @@
 #include <access/xact.h>
 #include <storage/proc.h>
 #include <utils/backend_status.h>
+#include <utils/snapmgr.h>
+#include <access/genam.h>
+#include <access/table.h>
+#include <access/htup_details.h>
+#include <catalog/pg_index.h>
 
 #include <metadata/metadata_cache.h>
 #include <utils/documentdb_errors.h>
@@ -27,11 +32,17 @@
 #include <aggregation/bson_aggregation_pipeline.h>
 #include "aggregation/aggregation_commands.h"
 #include "infrastructure/cursor_store.h"
+#include "commands/commands_common.h"
+#include "metadata/collection.h"
+#include "index_am/index_am_utils.h"
+#include "opclass/bson_gin_index_mgmt.h"
+#include "opclass/bson_gin_index_term.h"
 
 
 extern bool EnableNowSystemVariable;
 extern bool UseFileBasedPersistedCursors;
 extern bool EnableDelayedHoldPortal;
+extern bool EnableDistinctIndexTermScan;
 
 /* --------------------------------------------------------- */
 /* Data types */
@@ -133,6 +144,23 @@ typedef struct
 	bytea *cursorFileState;
 } QueryGetMoreInfo;
 
+
+/*
+ * State used while reading the distinct values of a key off the terms
+ * of a single path index.
+ */
+typedef struct DistinctIndexTermState
+{
+	/* The writer for the "values" array of the response */
+	pgbson_array_writer *arrayWriter;
+
+	/*
+	 * Set if a term can't be converted back to the value it was
+	 * generated from (e.g. it was truncated).
+	 */
+	bool hasUnsupportedTerm;
+} DistinctIndexTermState;
+
 /* --------------------------------------------------------- */
 /* Forward declaration */
 /* --------------------------------------------------------- */
@@ -166,6 +194,12 @@ static Datum HandleFirstPageRequest(pgbson *querySpec, int64_t cursorId,
 
 static int64_t GenerateCursorId(int64_t inputValue);
 
+static pgbson * TryGetDistinctFromIndexTerms(text *database, pgbson *distinctSpec);
+static Relation GetDistinctKeyIndexRelation(Relation collectionRelation,
+											const StringView *distinctKey,
+											EnumerateDistinctTermsFunc *enumerateFunc);
+static bool WriteDistinctIndexTerm(Datum term, void *state);
+
 
 /* --------------------------------------------------------- */
 /* Top level exports */
@@ -559,7 +593,16 @@ command_distinct_query(PG_FUNCTION_ARGS)
 	bool setStatementTimeout = true;
 	Query *query = GenerateDistinctQuery(database, distinctSpec, setStatementTimeout);
 
-	pgbson *response = DrainSingleResultQuery(query);
+	pgbson *response = NULL;
+	if (EnableDistinctIndexTermScan)
+	{
+		response = TryGetDistinctFromIndexTerms(database, distinctSpec);
+	}
+
+	if (response == NULL)
+	{
+		response = DrainSingleResultQuery(query);
+	}
 
 	if (response == NULL)
 	{
@@ -751,6 +794,15 @@ HandleFirstPageRequest(pgbson *querySpec, int64_t cursorId,
 	pgbson *continuationDoc;
 	bool persistConnection = false;
 	pgbson *postBatchResumeToken = NULL;
+
+	/* The indexes dropped for a $out bulk load are rebuilt once the single batch is drained */
+	if (queryData->outStageBulkLoad != NULL &&
+		queryData->cursorKind != QueryCursorType_SingleBatch)
+	{
+		ereport(ERROR, (errcode(ERRCODE_DOCUMENTDB_INTERNALERROR),
+						errmsg("Unexpected cursor type for a $out stage")));
+	}
+
 	switch (queryData->cursorKind)
 	{
 		case QueryCursorType_SingleBatch:
@@ -760,6 +812,12 @@ HandleFirstPageRequest(pgbson *querySpec, int64_t cursorId,
 										   queryData->batchSize,
 										   &numIterations,
 										   accumulatedSize, &arrayWriter);
+
+			if (queryData->outStageBulkLoad != NULL)
+			{
+				CompleteOutStageBulkLoad(queryData->outStageBulkLoad);
+			}
+
 			queryFullyDrained = true;
 			continuationDoc = NULL;
 			cursorId = 0;
@@ -1238,3 +1296,239 @@ GenerateCursorId(int64_t inputValue)
 	int64_t cursorId = *(int64_t *) cursorBuffer;
 	return (cursorId & CursorAcceptableBitsMask);
 }
+
+
+/*
+ * Tries to answer a distinct without a query filter by walking the distinct
+ * terms of a single path index on the distinct key instead of aggregating
+ * over every document in the collection. The spec is already validated by
+ * GenerateDistinctQuery at this point.
+ *
+ * Returns NULL if the index can't produce the result in which case the
+ * caller runs the regular distinct query.
+ */
+static pgbson *
+TryGetDistinctFromIndexTerms(text *database, pgbson *distinctSpec)
+{
+	bson_iter_t distinctIter;
+	PgbsonInitIterator(distinctSpec, &distinctIter);
+
+	StringView collectionName = { 0 };
+	StringView distinctKey = { 0 };
+	while (bson_iter_next(&distinctIter))
+	{
+		const char *key = bson_iter_key(&distinctIter);
+		if (strcmp(key, "distinct") == 0)
+		{
+			collectionName.string = bson_iter_utf8(&distinctIter,
+												   &collectionName.length);
+		}
+		else if (strcmp(key, "key") == 0)
+		{
+			distinctKey.string = bson_iter_utf8(&distinctIter, &distinctKey.length);
+		}
+		else if (strcmp(key, "query") == 0)
+		{
+			if (BSON_ITER_HOLDS_DOCUMENT(&distinctIter))
+			{
+				bson_iter_t queryIter;
+				bson_iter_recurse(&distinctIter, &queryIter);
+				if (bson_iter_next(&queryIter))
+				{
+					return NULL;
+				}
+			}
+		}
+		else if (strcmp(key, "collation") == 0)
+		{
+			return NULL;
+		}
+	}
+
+	/* _id is unique per document so there's nothing to gain from the index */
+	if (distinctKey.string[0] == '$' ||
+		StringViewEqualsCString(&distinctKey, "_id"))
+	{
+		return NULL;
+	}
+
+	Datum collectionNameDatum = PointerGetDatum(
+		cstring_to_text_with_len(collectionName.string, collectionName.length));
+	MongoCollection *collection =
+		GetMongoCollectionByNameDatum(PointerGetDatum(database), collectionNameDatum,
+									  AccessShareLock);
+	if (collection == NULL || collection->viewDefinition != NULL ||
+		collection->shardKey != NULL || collection->isShardRemote)
+	{
+		return NULL;
+	}
+
+	Oid collectionRelationId = collection->relationId;
+	if (collection->shardTableName[0] != '\0')
+	{
+		collectionRelationId = TryGetCollectionShardTable(collection, AccessShareLock);
+		if (collectionRelationId == InvalidOid)
+		{
+			return NULL;
+		}
+	}
+
+	Relation collectionRelation = table_open(collectionRelationId, AccessShareLock);
+
+	EnumerateDistinctTermsFunc enumerateFunc = NULL;
+	Relation indexRelation = GetDistinctKeyIndexRelation(collectionRelation,
+														 &distinctKey,
+														 &enumerateFunc);
+	if (indexRelation == NULL)
+	{
+		table_close(collectionRelation, AccessShareLock);
+		return NULL;
+	}
+
+	pgbson_writer writer;
+	pgbson_array_writer arrayWriter;
+	PgbsonWriterInit(&writer);
+	PgbsonWriterStartArray(&writer, "values", 6, &arrayWriter);
+
+	DistinctIndexTermState state = {
+		.arrayWriter = &arrayWriter,
+		.hasUnsupportedTerm = false
+	};
+
+	bool enumerated = enumerateFunc(indexRelation, collectionRelation,
+									GetActiveSnapshot(), WriteDistinctIndexTerm,
+									&state);
+
+	index_close(indexRelation, AccessShareLock);
+	table_close(collectionRelation, AccessShareLock);
+
+	if (!enumerated || state.hasUnsupportedTerm)
+	{
+		return NULL;
+	}
+
+	ReportFeatureUsage(FEATURE_USAGE_DISTINCT_INDEX_TERM_SCAN);
+
+	PgbsonWriterEndArray(&writer, &arrayWriter);
+	PgbsonWriterAppendDouble(&writer, "ok", 2, 1);
+	return PgbsonWriterGetPgbson(&writer);
+}
+
+
+/*
+ * Finds a valid, non partial index on exactly the distinct key (single path
+ * or an ordered index with just that path) that has never seen an array
+ * along that path. The terms of such an index are exactly the values of the
+ * key across the collection. Returns the opened index or NULL if there
+ * isn't one.
+ */
+static Relation
+GetDistinctKeyIndexRelation(Relation collectionRelation, const StringView *distinctKey,
+							EnumerateDistinctTermsFunc *enumerateFunc)
+{
+	List *indexIdList = RelationGetIndexList(collectionRelation);
+
+	ListCell *indexId;
+	foreach(indexId, indexIdList)
+	{
+		Relation indexRelation = index_open(lfirst_oid(indexId), AccessShareLock);
+		Oid relam = indexRelation->rd_rel->relam;
+
+		*enumerateFunc = GetEnumerateDistinctTermsByRelAm(relam);
+		GetMultikeyStatusFunc getMultiKeyStatus = GetMultiKeyStatusByRelAm(relam);
+
+		bool isCandidate = *enumerateFunc != NULL && getMultiKeyStatus != NULL &&
+						   indexRelation->rd_index->indisvalid &&
+						   indexRelation->rd_index->indisready &&
+						   IndexRelationGetNumberOfKeyAttributes(indexRelation) == 1 &&
+						   heap_attisnull(indexRelation->rd_indextuple,
+										  Anum_pg_index_indpred, NULL) &&
+						   indexRelation->rd_opcoptions[0] != NULL;
+
+		StringView indexPath = { 0 };
+		if (isCandidate && IsSinglePathOpFamilyOid(relam, indexRelation->rd_opfamily[0]))
+		{
+			BsonGinSinglePathOptions *options =
+				(BsonGinSinglePathOptions *) indexRelation->rd_opcoptions[0];
+			if (options->base.type == IndexOptionsType_SinglePath && !options->isWildcard)
+			{
+				Get_Index_Path_Option(options, path, indexPath.string,
+									  indexPath.length);
+			}
+		}
+		else if (isCandidate &&
+				 IsCompositeOpFamilyOid(relam, indexRelation->rd_opfamily[0]) &&
+				 GetCompositeOpClassPathCount(indexRelation->rd_opcoptions[0]) == 1)
+		{
+			indexPath = CreateStringViewFromString(
+				GetCompositeFirstIndexPath(indexRelation->rd_opcoptions[0]));
+		}
+
+		if (indexPath.string != NULL &&
+			StringViewEquals(&indexPath, distinctKey) &&
+			!getMultiKeyStatus(indexRelation))
+		{
+			list_free(indexIdList);
+			return indexRelation;
+		}
+
+		index_close(indexRelation, AccessShareLock);
+	}
+
+	list_free(indexIdList);
+	*enumerateFunc = NULL;
+	return NULL;
+}
+
+
+/*
+ * Index term callback that appends the value of a term to the distinct
+ * values. Stops the enumeration on a term whose value can't be recovered.
+ */
+static bool
+WriteDistinctIndexTerm(Datum term, void *state)
+{
+	DistinctIndexTermState *distinctState = (DistinctIndexTermState *) state;
+
+	bytea *serializedTerm = DatumGetByteaPP(term);
+	if (IsSerializedIndexTermComposite(serializedTerm))
+	{
+		distinctState->hasUnsupportedTerm = true;
+		return false;
+	}
+
+	BsonIndexTerm indexTerm;
+	InitializeBsonIndexTerm(serializedTerm, &indexTerm);
+
+	/* Root and path not found terms aren't values of the key */
+	if (IsIndexTermMetadata(&indexTerm) || IsIndexTermValueUndefined(&indexTerm) ||
+		IsIndexTermMaybeUndefined(&indexTerm))
+	{
+		return true;
+	}
+
+	/*
+	 * Truncated terms only have a prefix of the value. Arrays would need to be
+	 * unwound and MinKey can't be told apart from the legacy root term.
+	 */
+	bson_type_t valueType = indexTerm.element.bsonValue.value_type;
+	if (IsIndexTermTruncated(&indexTerm) || valueType == BSON_TYPE_ARRAY ||
+		valueType == BSON_TYPE_MINKEY)
+	{
+		distinctState->hasUnsupportedTerm = true;
+		return false;
+	}
+
+	PgbsonArrayWriterWriteValue(distinctState->arrayWriter, &indexTerm.element.bsonValue);
+
+	uint32_t size = PgbsonArrayWriterGetSize(distinctState->arrayWriter);
+	if (size > BSON_MAX_ALLOWED_SIZE_INTERMEDIATE)
+	{
+		ereport(ERROR, (errcode(ERRCODE_DOCUMENTDB_INTERMEDIATERESULTTOOLARGE),
+						errmsg(
+							"Size %u is larger than maximum size allowed for an intermediate document %u",
+							size, BSON_MAX_ALLOWED_SIZE_INTERMEDIATE)));
+	}
+
+	return true;
+}
@@ -27,6 +27,7 @@
 #include "metadata/metadata_cache.h"
 #include "planner/documentdb_planner.h"
 #include "utils/timeout.h"
+#include "utils/guc_utils.h"
 
 
 extern bool ThrowDeadlockOnCrud;
@@ -290,6 +291,60 @@ SetExplicitStatementTimeout(int timeoutMilliseconds)
 }
 
 
+/*
+ * ApplyWriteConcernDurability turns the current transaction into an asynchronous
+ * commit when the writeConcern of a write command does not wait for the journal
+ * ({ w: 0 } or { w: 1, j: false }, w defaulting to 1) and the server policy
+ * allows it, and returns whether it did. Write concerns that wait for other
+ * nodes keep the synchronous commit since asynchronous commit would skip
+ * waiting for the synchronous standbys as well.
+ * Writes inside a transaction block are left alone: the setting would relax
+ * the commit of every other statement of the transaction too. This includes
+ * the transaction block that the gateway opens around a write with maxTimeMS.
+ */
+bool
+ApplyWriteConcernDurability(const bson_value_t *writeConcern)
+{
+	if (WriteConcernRelaxation == WriteConcernRelaxation_None ||
+		writeConcern->value_type != BSON_TYPE_DOCUMENT ||
+		IsTransactionBlock())
+	{
+		return false;
+	}
+
+	bool isUnacknowledged = false;
+	bool isLocalAcknowledged = true;
+	bool skipJournal = false;
+
+	bson_iter_t writeConcernIter;
+	BsonValueInitIterator(writeConcern, &writeConcernIter);
+	while (bson_iter_next(&writeConcernIter))
+	{
+		const char *key = bson_iter_key(&writeConcernIter);
+		const bson_value_t *value = bson_iter_value(&writeConcernIter);
+		if (strcmp(key, "w") == 0)
+		{
+			/* "majority" and tag sets wait for other nodes */
+			int64_t numNodes = BsonValueIsNumber(value) ? BsonValueAsInt64(value) : -1;
+			isUnacknowledged = numNodes == 0;
+			isLocalAcknowledged = numNodes == 1;
+		}
+		else if (strcmp(key, "j") == 0 && BsonValueIsNumberOrBool(value))
+		{
+			skipJournal = !BsonValueAsBool(value);
+		}
+	}
+
+	if (isUnacknowledged || (isLocalAcknowledged && skipJournal))
+	{
+		SetGUCLocally("synchronous_commit", "off");
+		return true;
+	}
+
+	return false;
+}
+
+
 pgbson *
 GetObjectIdFilterFromQueryDocumentValue(const bson_value_t *queryDoc,
 										bool *queryHasNonIdFilters,
@@ -571,11 +626,16 @@ RewriteDocumentWithCustomObjectId(pgbson *document,
 
 /*
  * For write procedures, commits and re-acquires the collection lock.
+ *
+ * The commit restores synchronous_commit. isAsyncCommit relaxes it again for
+ * the new transaction when the writeConcern of the command being run allowed
+ * it (see ApplyWriteConcernDurability).
  */
 void
 CommitWriteProcedureAndReacquireCollectionLock(MongoCollection *collection,
 											   Oid shardTableOid,
-											   bool setSnapshot)
+											   bool setSnapshot,
+											   bool isAsyncCommit)
 {
 	ereport(DEBUG1, (errmsg("Commiting intermediate state and "
 							"reacquiring collection lock")));
@@ -591,6 +651,11 @@ CommitWriteProcedureAndReacquireCollectionLock(MongoCollection *collection,
 	/* Initiate a new transaction */
 	StartTransactionCommand();
 
+	if (isAsyncCommit)
+	{
+		SetGUCLocally("synchronous_commit", "off");
+	}
+
 	/* Push the active snapshot if commands need it (Portals do) */
 	if (setSnapshot)
 	{
@@ -25,6 +25,7 @@
 
 extern bool EnableNativeColocation;
 extern bool EnableDataTableWithoutCreationTime;
+extern bool EnableRetryTableWithoutObjectIdIndex;
 
 static bool CanColocateAtDatabaseLevel(text *databaseDatum);
 static const char * CreatePostgresDataTable(uint64_t collectionId,
@@ -277,6 +278,50 @@ CreatePostgresDataTable(uint64_t collectionId, const char *colocateWith, const
 }
 
 
+/*
+ * Adds the index_document column to the data table of a collection created
+ * with "indexKeyFields". The column is generated from the document as the
+ * projection of the given top level fields (and _id): Postgres recomputes it on
+ * every insert and update, and regular indexes on those fields are built on it
+ * instead of the document (see CreatePostgresIndexCreationCmd). An update that
+ * doesn't change these fields writes the same index_document, so when no index
+ * reads the document it is a HOT update and skips the index insertions.
+ *
+ * Must be called right after the data table is created: the table is empty and
+ * the column is added after all the others.
+ */
+void
+AddIndexKeyColumn(uint64 collectionId, List *indexKeyFields)
+{
+	pgbson_writer projectionWriter;
+	PgbsonWriterInit(&projectionWriter);
+
+	ListCell *fieldCell;
+	foreach(fieldCell, indexKeyFields)
+	{
+		const char *field = lfirst(fieldCell);
+		PgbsonWriterAppendInt32(&projectionWriter, field, strlen(field), 1);
+	}
+
+	pgbson *projection = PgbsonWriterGetPgbson(&projectionWriter);
+
+	StringInfo queryInfo = makeStringInfo();
+	appendStringInfo(queryInfo,
+					 "ALTER TABLE %s." DOCUMENT_DATA_TABLE_NAME_FORMAT
+					 " ADD COLUMN %s %s.bson GENERATED ALWAYS AS"
+					 " (%s.bson_dollar_project(document, %s::%s)) STORED",
+					 ApiDataSchemaName, collectionId,
+					 DOCUMENT_DATA_TABLE_INDEX_KEY_COLUMN_NAME, CoreSchemaName,
+					 ApiCatalogSchemaName,
+					 quote_literal_cstr(PgbsonToHexadecimalString(projection)),
+					 FullBsonTypeName);
+
+	bool readOnly = false;
+	bool isNull = false;
+	ExtensionExecuteQueryViaSPI(queryInfo->data, readOnly, SPI_OK_UTILITY, &isNull);
+}
+
+
 void
 CreateRetryTable(char *retryTableName, char *colocateWith, const
 				 char *distributionColumnUsed, int shardCount)
@@ -325,11 +370,18 @@ CreateRetryTable(char *retryTableName, char *colocateWith, const
 	ExtensionExecuteQueryViaSPI(queryStringInfo->data, readOnly, SPI_OK_UTILITY,
 								&isNull);
 
-	resetStringInfo(queryStringInfo);
-	appendStringInfo(queryStringInfo,
-					 "CREATE INDEX ON %s (object_id)", retryTableName);
-	ExtensionExecuteQueryViaSPI(queryStringInfo->data, readOnly, SPI_OK_UTILITY,
-								&isNull);
+	/*
+	 * Retry records are only ever looked up by transaction_id, so the index
+	 * on object_id just adds an index insertion to every retryable write.
+	 */
+	if (!EnableRetryTableWithoutObjectIdIndex)
+	{
+		resetStringInfo(queryStringInfo);
+		appendStringInfo(queryStringInfo,
+						 "CREATE INDEX ON %s (object_id)", retryTableName);
+		ExtensionExecuteQueryViaSPI(queryStringInfo->data, readOnly, SPI_OK_UTILITY,
+									&isNull);
+	}
 
 	DistributePostgresTable(retryTableName, distributionColumnUsed,
 							colocateWith,
@@ -57,6 +57,9 @@ typedef struct CreateSpec
 
 	/* idIndex */
 	bson_value_t idIndex;
+
+	/* indexKeyFields: list of top level field names (char *) */
+	List *indexKeyFields;
 } CreateSpec;
 
 static const StringView SystemPrefix = { .string = "system.", .length = 7 };
@@ -76,9 +79,14 @@ static void WalkPipelineForViewCycles(Datum databaseDatum, const char *viewName,
 static bool CreateView(Datum databaseDatum, const char *viewName,
 					   const char *viewSource, const bson_value_t *pipeline);
 
+static List * ParseIndexKeyFields(bson_iter_t *createIter);
+
+static bool IndexKeyFieldsEquivalent(List *existingFields, List *requestedFields);
+
 PG_FUNCTION_INFO_V1(command_create_collection_view);
 
 extern bool EnableSchemaValidation;
+extern bool EnableIndexKeyColumn;
 
 /*
  * command_create_collection_view represents the wire
@@ -120,7 +128,15 @@ command_create_collection_view(PG_FUNCTION_ARGS)
 	{
 		/* It's a collection: create it */
 		ReportFeatureUsage(FEATURE_COMMAND_CREATE_COLLECTION);
-		CreateCollection(databaseDatum, createDatum);
+		bool created = CreateCollection(databaseDatum, createDatum);
+
+		if (created && createDefinition->indexKeyFields != NIL)
+		{
+			collection = GetMongoCollectionByNameDatum(databaseDatum, createDatum,
+													   AccessExclusiveLock);
+			AddIndexKeyColumn(collection->collectionId,
+							  createDefinition->indexKeyFields);
+		}
 
 		if (hasSchemaValidationSpec)
 		{
@@ -383,6 +399,16 @@ ParseCreateSpec(Datum databaseDatum, pgbson *createSpec, bool *hasSchemaValidati
 		{
 			/* ignore */
 		}
+		else if (strcmp(key, "indexKeyFields") == 0)
+		{
+			if (!EnableIndexKeyColumn)
+			{
+				ereport(ERROR, (errcode(ERRCODE_DOCUMENTDB_COMMANDNOTSUPPORTED),
+								errmsg("indexKeyFields not supported yet")));
+			}
+
+			spec->indexKeyFields = ParseIndexKeyFields(&createIter);
+		}
 		else if (!IsCommonSpecIgnoredField(key))
 		{
 			ereport(ERROR, (errcode(ERRCODE_DOCUMENTDB_UNKNOWNBSONFIELD),
@@ -412,6 +438,12 @@ ParseCreateSpec(Datum databaseDatum, pgbson *createSpec, bool *hasSchemaValidati
 						errmsg("'viewOn' and 'idIndex' cannot both be specified")));
 	}
 
+	if (spec->viewOn != NULL && spec->indexKeyFields != NIL)
+	{
+		ereport(ERROR, (errcode(ERRCODE_DOCUMENTDB_INVALIDOPTIONS),
+						errmsg("'viewOn' and 'indexKeyFields' cannot both be specified")));
+	}
+
 	if (*hasSchemaValidationSpec)
 	{
 		spec->validationAction = spec->validationAction == NULL ? "error" :
@@ -424,6 +456,62 @@ ParseCreateSpec(Datum databaseDatum, pgbson *createSpec, bool *hasSchemaValidati
 }
 
 
+/*
+ * Parses the "indexKeyFields" field of a create() specification: a non-empty
+ * array of distinct top level field names. These are the fields kept in the
+ * index_document column (see AddIndexKeyColumn), so they can't be dotted
+ * paths or start with '$'.
+ */
+static List *
+ParseIndexKeyFields(bson_iter_t *createIter)
+{
+	EnsureTopLevelFieldType("create.indexKeyFields", createIter, BSON_TYPE_ARRAY);
+
+	List *fields = NIL;
+	bson_iter_t fieldsIter;
+	bson_iter_recurse(createIter, &fieldsIter);
+	while (bson_iter_next(&fieldsIter))
+	{
+		if (!BSON_ITER_HOLDS_UTF8(&fieldsIter))
+		{
+			ereport(ERROR, (errcode(ERRCODE_DOCUMENTDB_TYPEMISMATCH),
+							errmsg("Every item of 'indexKeyFields' must be a string")));
+		}
+
+		uint32_t fieldLength = 0;
+		const char *field = bson_iter_utf8(&fieldsIter, &fieldLength);
+		if (fieldLength == 0 || strlen(field) != (size_t) fieldLength ||
+			field[0] == '$' || strchr(field, '.') != NULL)
+		{
+			ereport(ERROR, (errcode(ERRCODE_DOCUMENTDB_BADVALUE),
+							errmsg("'%s' is not a valid top level field for "
+								   "'indexKeyFields'", field)));
+		}
+
+		ListCell *fieldCell;
+		foreach(fieldCell, fields)
+		{
+			if (strcmp(lfirst(fieldCell), field) == 0)
+			{
+				ereport(ERROR, (errcode(ERRCODE_DOCUMENTDB_BADVALUE),
+								errmsg("Field '%s' appears more than once in "
+									   "'indexKeyFields'", field)));
+			}
+		}
+
+		fields = lappend(fields, pstrdup(field));
+	}
+
+	if (fields == NIL)
+	{
+		ereport(ERROR, (errcode(ERRCODE_DOCUMENTDB_BADVALUE),
+						errmsg("'indexKeyFields' must not be empty")));
+	}
+
+	return fields;
+}
+
+
 /*
  * Checks the pipeline from a 'view' definition for any
  * unsupported pipeline stages ($out and $merge).
@@ -552,6 +640,41 @@ CreateView(Datum databaseDatum, const char *viewName,
 }
 
 
+/*
+ * Whether two lists of index key fields hold the same fields, in any order.
+ */
+static bool
+IndexKeyFieldsEquivalent(List *existingFields, List *requestedFields)
+{
+	if (list_length(existingFields) != list_length(requestedFields))
+	{
+		return false;
+	}
+
+	ListCell *requestedCell;
+	foreach(requestedCell, requestedFields)
+	{
+		bool found = false;
+		ListCell *existingCell;
+		foreach(existingCell, existingFields)
+		{
+			if (strcmp(lfirst(existingCell), lfirst(requestedCell)) == 0)
+			{
+				found = true;
+				break;
+			}
+		}
+
+		if (!found)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
 /*
  * Checks if an existent collection and view (or new collection) are equivalent
  * and throws the appropriate error code.
@@ -600,6 +723,17 @@ ValidateCollectionOptionsEquivalent(CreateSpec *createDefinition,
 		}
 	}
 
+	if (collection->viewDefinition == NULL &&
+		!IndexKeyFieldsEquivalent(GetIndexKeyColumnFields(collection),
+								  createDefinition->indexKeyFields))
+	{
+		ereport(ERROR, (errcode(ERRCODE_DOCUMENTDB_NAMESPACEEXISTS),
+						errmsg(
+							"Namespace %s.%s already exists but with different configuration options: {}",
+							collection->name.databaseName,
+							collection->name.collectionName)));
+	}
+
 	if (!EnableSchemaValidation)
 	{
 		return;
@@ -161,6 +161,7 @@ extern int MaxWildcardIndexKeySize;
 extern bool DefaultEnableLargeUniqueIndexKeys;
 extern bool SkipFailOnCollation;
 extern bool ForceWildcardReducedTerm;
+extern bool EnableWildcardProjectionPathPrefixElision;
 extern bool EnableCompositeUniqueHash;
 
 extern char *AlternateIndexHandler;
@@ -288,7 +289,9 @@ static void ResolveWPPathOpsFromTreeInternal(const BsonIntermediatePathNode *tre
 											 nonIdFieldInclusion,
 											 WildcardProjFieldInclusionMode *
 											 idFieldInclusion);
+static char * GetWPCommonPathPrefix(List *nonIdFieldPathList);
 static char * GenerateIndexExprStr(const char *indexAmSuffix,
+								   const char *indexColumnName,
 								   bool unique, bool buildAsUnique, bool sparse, bool
 								   enableCompositeOpClass,
 								   IndexDefKey *indexDefKey,
@@ -300,6 +303,8 @@ static char * GenerateIndexExprStr(const char *indexAmSuffix,
 								   bool useReducedWildcardTerms,
 								   const char *indexAmOpClassCatalogSchema,
 								   const char *indexAmOpClassInternalCatalogSchema);
+static const char * GetIndexColumnName(uint64 collectionId, const IndexDef *indexDef,
+									   bool isTempCollection);
 static char * Generate2dsphereIndexExprStr(const IndexDefKey *indexDefKey);
 static char * Generate2dsphereSparseExprStr(const IndexDefKey *indexDefKey);
 static char * GenerateIndexFilterStr(uint64 collectionId, Expr *indexDefPartFilterExpr);
@@ -4859,7 +4864,7 @@ CreatePostgresIndexCreationCmd(uint64 collectionId, IndexDef *indexDef, int inde
 						 " ADD CONSTRAINT " DOCUMENT_DATA_TABLE_INDEX_NAME_FORMAT
 						 " EXCLUDE USING %s_%s (%s) %s%s%s",
 						 indexId, ExtensionObjectPrefix, indexAm->am_name,
-						 GenerateIndexExprStr(indexAm->am_name, unique,
+						 GenerateIndexExprStr(indexAm->am_name, "document", unique,
 											  buildAsUnique,
 											  sparse, enableNewIndexOpClass,
 											  indexDef->key,
@@ -5009,6 +5014,8 @@ CreatePostgresIndexCreationCmd(uint64 collectionId, IndexDef *indexDef, int inde
 						 ExtensionObjectPrefix,
 						 indexAm->am_name,
 						 GenerateIndexExprStr(indexAm->am_name,
+											  GetIndexColumnName(collectionId, indexDef,
+																 isTempCollection),
 											  unique, buildAsUnique,
 											  sparse, enableNewIndexOpClass,
 											  indexDef->key,
@@ -5031,6 +5038,66 @@ CreatePostgresIndexCreationCmd(uint64 collectionId, IndexDef *indexDef, int inde
 }
 
 
+/*
+ * Returns the column that a regular (not unique) index is built on. Collections
+ * created with "indexKeyFields" hold those fields in the index_document column
+ * (see AddIndexKeyColumn): an index whose paths all start with one of them
+ * generates the same terms from that column as from the document, so it is
+ * built there and updates of other fields don't need to touch it. Indexes that
+ * read other paths, wildcard and text indexes, and partial indexes (whose
+ * filter reads the document) are built on the document.
+ */
+static const char *
+GetIndexColumnName(uint64 collectionId, const IndexDef *indexDef,
+				   bool isTempCollection)
+{
+	if (isTempCollection || indexDef->buildAsUnique == BoolIndexOption_True ||
+		indexDef->partialFilterExpr != NULL || indexDef->key->isWildcard ||
+		indexDef->key->hasTextIndexes || indexDef->key->keyPathList == NIL)
+	{
+		return "document";
+	}
+
+	MongoCollection *collection = GetMongoCollectionByColId(collectionId, NoLock);
+	if (collection == NULL || collection->indexKeyColumnAttrNumber == -1)
+	{
+		return "document";
+	}
+
+	List *indexKeyFields = GetIndexKeyColumnFields(collection);
+
+	ListCell *keyPathCell;
+	foreach(keyPathCell, indexDef->key->keyPathList)
+	{
+		IndexDefKeyPath *keyPath = lfirst(keyPathCell);
+		const char *dot = strchr(keyPath->path, '.');
+		size_t fieldLength = dot != NULL ? (size_t) (dot - keyPath->path) :
+							 strlen(keyPath->path);
+
+		/* The projection keeps _id even when it isn't listed */
+		bool isCovered = fieldLength == 3 && strncmp(keyPath->path, "_id", 3) == 0;
+		ListCell *fieldCell;
+		foreach(fieldCell, indexKeyFields)
+		{
+			const char *field = lfirst(fieldCell);
+			if (!isCovered && strlen(field) == fieldLength &&
+				strncmp(field, keyPath->path, fieldLength) == 0)
+			{
+				isCovered = true;
+				break;
+			}
+		}
+
+		if (!isCovered)
+		{
+			return "document";
+		}
+	}
+
+	return DOCUMENT_DATA_TABLE_INDEX_KEY_COLUMN_NAME;
+}
+
+
 /*
  * ExecuteCreatePostgresIndexCmd executes the index creation postgres command.
  */
@@ -5339,6 +5406,56 @@ ResolveWPPathOpsFromTreeInternal(const BsonIntermediatePathNode *treeParentNode,
 }
 
 
+/*
+ * GetWPCommonPathPrefix returns the longest dotted path prefix shared by all
+ * the paths of an inclusion "wildcardProjection" or NULL if there is none.
+ * e.g. for { "a.b.c": 1, "a.b.d.e": 1 } this is "a.b".
+ */
+static char *
+GetWPCommonPathPrefix(List *nonIdFieldPathList)
+{
+	if (list_length(nonIdFieldPathList) == 0)
+	{
+		return NULL;
+	}
+
+	const char *firstPath = linitial(nonIdFieldPathList);
+	int prefixLength = strlen(firstPath);
+
+	ListCell *pathCell = NULL;
+	for_each_from(pathCell, nonIdFieldPathList, 1)
+	{
+		const char *path = lfirst(pathCell);
+		int pathLength = strlen(path);
+
+		int matchLength = 0;
+		while (matchLength < prefixLength && matchLength < pathLength &&
+			   firstPath[matchLength] == path[matchLength])
+		{
+			matchLength++;
+		}
+
+		/* Only keep whole path components */
+		bool endsOnComponent =
+			(matchLength == prefixLength || firstPath[matchLength] == '.') &&
+			(matchLength == pathLength || path[matchLength] == '.');
+		while (!endsOnComponent && matchLength > 0)
+		{
+			matchLength--;
+			endsOnComponent = firstPath[matchLength] == '.';
+		}
+
+		prefixLength = matchLength;
+		if (prefixLength == 0)
+		{
+			return NULL;
+		}
+	}
+
+	return pnstrdup(firstPath, prefixLength);
+}
+
+
 inline static void
 AppendUniqueColumnExpr(StringInfo indexExprStr, IndexDefKey *indexDefKey,
 					   bool sparse, const char *indexAmSuffix, const
@@ -5368,13 +5485,13 @@ AppendUniqueColumnExpr(StringInfo indexExprStr, IndexDefKey *indexDefKey,
 /*
  * GenerateIndexExprStr returns column expression string to be used when
  * creating the index whose "key" and "wildcardProjection" specifications
- * are determined by given objects.
+ * are determined by given objects, on the column named indexColumnName.
  *
  * indexDefWildcardProjTree should be passed to be NULL if index doesn't
  * have a "wildcardProjection" specification.
  */
 static char *
-GenerateIndexExprStr(const char *indexAmSuffix,
+GenerateIndexExprStr(const char *indexAmSuffix, const char *indexColumnName,
 					 bool unique, bool buildAsUnique, bool sparse, bool
 					 enableCompositeOpClass,
 					 IndexDefKey *indexDefKey,
@@ -5457,8 +5574,9 @@ GenerateIndexExprStr(const char *indexAmSuffix,
 		if (indexDefKey->hasTextIndexes)
 		{
 			appendStringInfo(indexExprStr,
-							 "%s document %s.bson_%s_text_path_ops(weights=%s%s%s%s%s%s)",
+							 "%s %s %s.bson_%s_text_path_ops(weights=%s%s%s%s%s%s)",
 							 firstColumnWritten ? "," : "",
+							 indexColumnName,
 							 indexAmOpClassCatalogSchema,
 							 indexAmSuffix,
 							 quote_literal_cstr(SerializeWeightedPaths(
@@ -5478,9 +5596,10 @@ GenerateIndexExprStr(const char *indexAmSuffix,
 			}
 
 			appendStringInfo(indexExprStr,
-							 "%s document %s.bson_%s_single_path_ops"
+							 "%s %s %s.bson_%s_single_path_ops"
 							 "(path='', iswildcard=true%s%s%s)",
 							 firstColumnWritten ? "," : "",
+							 indexColumnName,
 							 indexAmOpClassCatalogSchema,
 							 indexAmSuffix,
 							 indexTermSizeLimitArg,
@@ -5507,15 +5626,34 @@ GenerateIndexExprStr(const char *indexAmSuffix,
 			 */
 			bool includeId = wpPathOps->idFieldInclusion == WP_IM_INCLUDE;
 			appendStringInfo(indexExprStr,
-							 "%s document %s.bson_%s_wildcard_project_path_ops"
+							 "%s %s %s.bson_%s_wildcard_project_path_ops"
 							 "(includeid=%s%s%s",
 							 firstColumnWritten ? "," : "",
+							 indexColumnName,
 							 indexAmOpClassCatalogSchema,
 							 indexAmSuffix,
 							 includeId ? "true" : "false",
 							 indexTermSizeLimitArg,
 							 wildcardIndexTruncatedPathLimit);
 
+			/*
+			 * When every indexed path lives under a common prefix, elide it from
+			 * the index terms so that adjacent entries don't repeat it. This
+			 * relies on the wildcard term path handling that only applies with
+			 * truncation enabled.
+			 */
+			if (EnableWildcardProjectionPathPrefixElision && enableTruncation &&
+				!includeId && wpPathOps->nonIdFieldInclusion == WP_IM_INCLUDE)
+			{
+				char *commonPathPrefix =
+					GetWPCommonPathPrefix(wpPathOps->nonIdFieldPathList);
+				if (commonPathPrefix != NULL)
+				{
+					appendStringInfo(indexExprStr, ", pathprefix=%s",
+									 quote_literal_cstr(commonPathPrefix));
+				}
+			}
+
 			firstColumnWritten = true;
 
 			if (wpPathOps->nonIdFieldInclusion != WP_IM_INVALID)
@@ -5623,8 +5761,9 @@ GenerateIndexExprStr(const char *indexAmSuffix,
 		sprintf(indexTermSizeLimitArg, ",tl=%u", ComputeIndexTermLimit(
 					COMPOUND_INDEX_TERM_SIZE_LIMIT));
 		appendStringInfo(indexExprStr,
-						 "%s document %s.bson_%s_composite_path_ops(pathspec=%s%s)",
+						 "%s %s %s.bson_%s_composite_path_ops(pathspec=%s%s)",
 						 firstColumnWritten ? "," : "",
+						 indexColumnName,
 						 indexAmOpClassInternalCatalogSchema,
 						 indexAmSuffix,
 						 quote_literal_cstr(BsonValueToJsonForLogging(&arrayValue)),
@@ -5725,8 +5864,9 @@ GenerateIndexExprStr(const char *indexAmSuffix,
 					}
 
 					appendStringInfo(indexExprStr,
-									 "%s document %s.bson_%s_single_path_ops(path=%s%s%s%s%s)",
+									 "%s %s %s.bson_%s_single_path_ops(path=%s%s%s%s%s)",
 									 firstColumnWritten ? "," : "",
+									 indexColumnName,
 									 indexAmOpClassCatalogSchema,
 									 indexAmSuffix,
 									 quote_literal_cstr(keyPath),
@@ -5766,8 +5906,9 @@ GenerateIndexExprStr(const char *indexAmSuffix,
 					}
 
 					appendStringInfo(indexExprStr,
-									 "%s document %s.%s_%s_hashed_ops(path=%s)",
+									 "%s %s %s.%s_%s_hashed_ops(path=%s)",
 									 firstColumnWritten ? "," : "",
+									 indexColumnName,
 									 indexAmOpClassCatalogSchema,
 									 ExtensionObjectPrefix,
 									 indexAmSuffix,
@@ -5785,8 +5926,9 @@ GenerateIndexExprStr(const char *indexAmSuffix,
 					}
 
 					appendStringInfo(indexExprStr,
-									 "%s document %s.bson_%s_text_path_ops(weights=%s%s%s%s%s%s)",
+									 "%s %s %s.bson_%s_text_path_ops(weights=%s%s%s%s%s%s)",
 									 firstColumnWritten ? "," : "",
+									 indexColumnName,
 									 indexAmOpClassCatalogSchema,
 									 indexAmSuffix,
 									 quote_literal_cstr(SerializeWeightedPaths(
@@ -5835,8 +5977,9 @@ GenerateIndexExprStr(const char *indexAmSuffix,
 		if (indexDefKey->hasTextIndexes && !textOptionsIndexWritten)
 		{
 			appendStringInfo(indexExprStr,
-							 "%s document %s.bson_%s_text_path_ops(weights=%s%s%s%s%s%s)",
+							 "%s %s %s.bson_%s_text_path_ops(weights=%s%s%s%s%s%s)",
 							 firstColumnWritten ? "," : "",
+							 indexColumnName,
 							 indexAmOpClassCatalogSchema,
 							 indexAmSuffix,
 							 quote_literal_cstr(SerializeWeightedPaths(
@@ -12,8 +12,10 @@
 #include <funcapi.h>
 #include <math.h>
 #include <miscadmin.h>
+#include <access/htup_details.h>
 #include <access/xact.h>
 #include <catalog/namespace.h>
+#include <catalog/pg_index.h>
 #include <executor/executor.h>
 #include <executor/spi.h>
 #include <lib/stringinfo.h>
@@ -62,6 +64,8 @@
 
 #define FinishKey "finish"
 #define FinishKeyLength 6
+#define ResumableKey "resumable"
+#define ResumableKeyLength 9
 
 
 /*
@@ -110,6 +114,8 @@ typedef enum BackgroundIndexRunStatus
 bool ShouldSetupIndexQueueInUdf = true;
 extern int MaxIndexBuildAttempts;
 extern int IndexQueueEvictionIntervalInSec;
+extern bool EnableResumableIndexBuild;
+extern bool DefaultInlineWriteOperations;
 
 /* Do not retry the index build if error code belongs to following list. */
 static const SkippableError SkippableErrors[] = {
@@ -165,6 +171,7 @@ static Datum ComposeBuildIndexResponse(FunctionCallInfo fcinfo, pgbson *buildInd
 static Datum ComposeCheckIndexStatusResponse(FunctionCallInfo fcinfo, pgbson *bson, bool
 											 ok, bool finish);
 static void TryDropCollectionIndex(int indexId);
+static Oid GetResumableIndexOid(IndexCmdRequest *indexCmdRequest, Oid *heapOid);
 static bool PruneSkippableIndexes(MemoryContext mcxt);
 static BackgroundIndexRunStatus build_index_concurrently_from_indexqueue_core(
 	MemoryContext stableContext);
@@ -368,10 +375,18 @@ build_index_concurrently_from_indexqueue_core(MemoryContext stableContext)
 	char *shardKeyStr = ExtensionExecuteQueryOnLocalhostViaLibPQ(queryStringInfo->data);
 	bool useSerialExecution = shardKeyStr == NULL || strlen(shardKeyStr) == 0;
 
+	/*
+	 * If a previous attempt got through the build phase before failing, the
+	 * index it left behind only needs to be validated: resume from there.
+	 */
+	Oid resumeHeapOid = InvalidOid;
+	Oid resumeIndexOid = GetResumableIndexOid(indexCmdRequest, &resumeHeapOid);
+
 	/* In case of abrupt kill of the cron job running this, we may end up with the state as "InProgress" for index.
 	 * To handle such request, we are cleaning the partial index state first.
 	 */
-	if (indexCmdRequest->status == IndexCmdStatus_Inprogress)
+	if (indexCmdRequest->status == IndexCmdStatus_Inprogress &&
+		!OidIsValid(resumeIndexOid))
 	{
 		elog_unredacted(
 			"Try dropping old index entry before CreateIndex for index_id: %d and collectionId: "
@@ -401,19 +416,29 @@ build_index_concurrently_from_indexqueue_core(MemoryContext stableContext)
 	{
 		char *cmd = indexCmdRequest->cmd;
 
-		/*
-		 * Tell other backends to ignore us, even if we grab any
-		 * snapshots later.
-		 */
-		set_indexsafe_procflags();
+		if (OidIsValid(resumeIndexOid))
+		{
+			elog_unredacted(
+				"Resuming index build from validation for index_id: %d and collectionId: "
+				UINT64_FORMAT, indexCmdRequest->indexId, collectionId);
+			ValidateReadyIndexConcurrently(resumeHeapOid, resumeIndexOid);
+		}
+		else
+		{
+			/*
+			 * Tell other backends to ignore us, even if we grab any
+			 * snapshots later.
+			 */
+			set_indexsafe_procflags();
 
-		elog_unredacted(
-			"Trying to create index with serial %d for index_id: %d and collectionId: "
-			UINT64_FORMAT, useSerialExecution,
-			indexCmdRequest->indexId, collectionId);
-		bool concurrently = true;
-		ExecuteCreatePostgresIndexCmd(cmd, concurrently, indexCmdRequest->userOid,
-									  useSerialExecution);
+			elog_unredacted(
+				"Trying to create index with serial %d for index_id: %d and collectionId: "
+				UINT64_FORMAT, useSerialExecution,
+				indexCmdRequest->indexId, collectionId);
+			bool concurrently = true;
+			ExecuteCreatePostgresIndexCmd(cmd, concurrently, indexCmdRequest->userOid,
+										  useSerialExecution);
+		}
 		indexCreated = true;
 	}
 	PG_CATCH();
@@ -533,7 +558,16 @@ build_index_concurrently_from_indexqueue_core(MemoryContext stableContext)
 			UINT64_FORMAT,
 			indexCmdRequest->indexId, collectionId);
 
-		if (indexCmdRequest->cmdType == CREATE_INDEX_COMMAND_TYPE)
+		/*
+		 * An index that got through the build phase is kept for the next
+		 * attempt to resume from, unless the request won't be retried.
+		 */
+		bool keepBuiltIndex =
+			indexCmdRequest->attemptCount <= MaxIndexBuildAttempts &&
+			!IsSkippableError(errorCode, (char *) errorMessage) &&
+			OidIsValid(GetResumableIndexOid(indexCmdRequest, &resumeHeapOid));
+
+		if (indexCmdRequest->cmdType == CREATE_INDEX_COMMAND_TYPE && !keepBuiltIndex)
 		{
 			TryDropCollectionIndex(indexCmdRequest->indexId);
 		}
@@ -550,6 +584,10 @@ build_index_concurrently_from_indexqueue_core(MemoryContext stableContext)
 		PgbsonWriterAppendUtf8(&writer, ErrMsgKey, ErrMsgLength,
 							   (char *) errorMessage);
 		PgbsonWriterAppendInt32(&writer, ErrCodeKey, ErrCodeLength, errorCode);
+		if (keepBuiltIndex)
+		{
+			PgbsonWriterAppendBool(&writer, ResumableKey, ResumableKeyLength, true);
+		}
 		pgbson *newComment = PgbsonWriterGetPgbson(&writer);
 
 		if (indexCmdRequest->attemptCount > MaxIndexBuildAttempts)
@@ -1812,6 +1850,57 @@ TryDropCollectionIndex(int indexId)
 }
 
 
+/*
+ * GetResumableIndexOid returns the postgres index left behind by a previous
+ * attempt of the create index request if that attempt completed the build
+ * phase (the index is ready for inserts but not valid), along with the oid
+ * of its table. Returns InvalidOid if the request has to be built again.
+ */
+static Oid
+GetResumableIndexOid(IndexCmdRequest *indexCmdRequest, Oid *heapOid)
+{
+	/* Only single node deployments (which always inline writes) are resumed:
+	 * distributed indexes are built on the shards, which may not be local */
+	if (!EnableResumableIndexBuild ||
+		indexCmdRequest->cmdType != CREATE_INDEX_COMMAND_TYPE ||
+		!DefaultInlineWriteOperations)
+	{
+		return InvalidOid;
+	}
+
+	/* Unique indexes are backed by a constraint, those are always rebuilt */
+	IndexDetails *indexDetails = IndexIdGetIndexDetails(indexCmdRequest->indexId);
+	if (indexDetails == NULL ||
+		GetBoolFromBoolIndexOptionDefaultFalse(indexDetails->indexSpec.indexUnique))
+	{
+		return InvalidOid;
+	}
+
+	char indexName[NAMEDATALEN];
+	snprintf(indexName, NAMEDATALEN, DOCUMENT_DATA_TABLE_INDEX_NAME_FORMAT,
+			 indexCmdRequest->indexId);
+	Oid indexOid = get_relname_relid(indexName, ApiDataNamespaceOid());
+	if (!OidIsValid(indexOid))
+	{
+		return InvalidOid;
+	}
+
+	HeapTuple indexTuple = SearchSysCache1(INDEXRELID, ObjectIdGetDatum(indexOid));
+	if (!HeapTupleIsValid(indexTuple))
+	{
+		return InvalidOid;
+	}
+
+	Form_pg_index indexForm = (Form_pg_index) GETSTRUCT(indexTuple);
+	bool isResumable = indexForm->indislive && indexForm->indisready &&
+					   !indexForm->indisvalid;
+	*heapOid = indexForm->indrelid;
+	ReleaseSysCache(indexTuple);
+
+	return isResumable ? indexOid : InvalidOid;
+}
+
+
 /*
  * RunIndexCommandOnMetadataCoordinator runs the passed in query on coordinator only.
  */
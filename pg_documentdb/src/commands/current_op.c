@@ -1379,9 +1379,15 @@ AddIndexBuilds(TupleDesc descriptor, Tuplestorestate *tupleStore)
 			if (PgbsonInitIteratorAtPath(bsonDoc, path, &pathIterator))
 			{
 				const bson_value_t *value = bson_iter_value(&pathIterator);
-				msg = psprintf(
-					"Index build failed with error '%s', Index build will be retried",
-					value->value.v_utf8.str);
+				bson_iter_t resumableIterator;
+				bool isResumable = PgbsonInitIteratorAtPath(bsonDoc, "resumable",
+															&resumableIterator) &&
+								   BsonValueAsBool(bson_iter_value(&resumableIterator));
+				const char *retryMessage = isResumable ?
+										   "Index build will resume from validation" :
+										   "Index build will be retried";
+				msg = psprintf("Index build failed with error '%s', %s",
+							   value->value.v_utf8.str, retryMessage);
 			}
 		}
 		else if (status == IndexCmdStatus_Inprogress)
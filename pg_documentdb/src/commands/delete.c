@@ -15,6 +15,7 @@
 #include "access/xact.h"
 #include "executor/spi.h"
 #include "lib/stringinfo.h"
+#include "utils/array.h"
 #include "utils/builtins.h"
 
 #include "io/bson_core.h"
@@ -94,6 +95,7 @@ typedef struct
 
 extern bool UseLocalExecutionShardQueries;
 extern bool EnableVariablesSupportForWriteCommands;
+extern bool EnableSetBasedDeleteById;
 
 PG_FUNCTION_INFO_V1(command_delete);
 PG_FUNCTION_INFO_V1(command_delete_one);
@@ -116,6 +118,13 @@ static void ProcessBatchDeletion(MongoCollection *collection,
 static pgbson * ProcessBatchDeleteUnsharded(MongoCollection *collection,
 											BatchDeletionSpec *batchSpec,
 											text *transactionId);
+static int GetSetBasedDeletionCount(MongoCollection *collection, List *deletions,
+									int startIndex, text *transactionId);
+static bool IsSetBasedDeletionCandidate(DeletionSpec *deletionSpec, text *transactionId);
+static bool TryDeleteByObjectIds(MongoCollection *collection, List *deletions,
+								 int startIndex, int deletionCount, uint64 *rowsDeleted);
+static uint64 DeleteByObjectIds(MongoCollection *collection, List *deletions,
+								int startIndex, int deletionCount);
 static uint64 ProcessDeletion(MongoCollection *collection, DeletionSpec *deletionSpec,
 							  bool forceInlineWrites, text *transactionId);
 static uint64 DeleteAllMatchingDocuments(MongoCollection *collection, pgbson *query,
@@ -348,14 +357,16 @@ BuildBatchDeletionSpec(bson_iter_t *deleteCommandIter, pgbsonsequence *deleteDoc
 								errmsg("'delete.let' is not yet supported")));
 			}
 		}
+		else if (strcmp(field, "writeConcern") == 0)
+		{
+			ApplyWriteConcernDurability(bson_iter_value(deleteCommandIter));
+		}
 		else if (IsCommonSpecIgnoredField(field))
 		{
 			elog(DEBUG1, "Command field not recognized: delete.%s", field);
 
 			/*
 			 *  Silently ignore now, so that clients don't break
-			 *  TODO: implement me
-			 *      writeConcern
 			 */
 		}
 		else
@@ -607,6 +618,9 @@ BuildDeletionSpec(bson_iter_t *deletionIter, const bson_value_t *variableSpec)
  *
  * We Use subtransactions which effectively
  * does each delete operation in a separate transaction.
+ *
+ * With documentdb.enableSetBasedDeleteById, consecutive deletions by _id are
+ * run together in a single subtransaction (see DeleteByObjectIds).
  */
 static void
 ProcessBatchDeletion(MongoCollection *collection, BatchDeletionSpec *batchSpec,
@@ -631,12 +645,39 @@ ProcessBatchDeletion(MongoCollection *collection, BatchDeletionSpec *batchSpec,
 	/* declared volatile because of the longjmp in PG_CATCH */
 	volatile int deleteIndex = 0;
 
-	ListCell *deletionCell = NULL;
-	foreach(deletionCell, deletions)
+	/* deletions before this index are processed one by one */
+	int perSpecDeletionsEnd = 0;
+
+	int deletionCount = list_length(deletions);
+	while (deleteIndex < deletionCount)
 	{
 		CHECK_FOR_INTERRUPTS();
 
-		DeletionSpec *deletionSpec = lfirst(deletionCell);
+		if (EnableSetBasedDeleteById && deleteIndex >= perSpecDeletionsEnd)
+		{
+			int setBasedCount = GetSetBasedDeletionCount(collection, deletions,
+														 deleteIndex, transactionId);
+			if (setBasedCount > 1)
+			{
+				uint64 setRowsDeleted = 0;
+				if (TryDeleteByObjectIds(collection, deletions, deleteIndex,
+										 setBasedCount, &setRowsDeleted))
+				{
+					batchResult->rowsDeleted += setRowsDeleted;
+					deleteIndex += setBasedCount;
+					continue;
+				}
+
+				/*
+				 * Nothing was deleted by the failed statement: run the same
+				 * deletions one by one so that the error is reported for the
+				 * right deletion and ordered batches stop there.
+				 */
+				perSpecDeletionsEnd = deleteIndex + setBasedCount;
+			}
+		}
+
+		DeletionSpec *deletionSpec = list_nth(deletions, deleteIndex);
 
 		/* declared volatile because of the longjmp in PG_CATCH */
 		volatile uint64 rowsDeleted = 0;
@@ -692,6 +733,213 @@ ProcessBatchDeletion(MongoCollection *collection, BatchDeletionSpec *batchSpec,
 }
 
 
+/*
+ * GetSetBasedDeletionCount returns the number of consecutive deletions starting
+ * at startIndex that can be executed together as a single DELETE by _id.
+ */
+static int
+GetSetBasedDeletionCount(MongoCollection *collection, List *deletions,
+						 int startIndex, text *transactionId)
+{
+	if (collection->shardKey != NULL)
+	{
+		/* documents with the given _id values may live on any shard */
+		return 0;
+	}
+
+	int deletionCount = 0;
+	for (int i = startIndex; i < list_length(deletions); i++)
+	{
+		if (!IsSetBasedDeletionCandidate(list_nth(deletions, i), transactionId))
+		{
+			break;
+		}
+
+		deletionCount++;
+	}
+
+	return deletionCount;
+}
+
+
+/*
+ * IsSetBasedDeletionCandidate returns whether the deletion only filters on a
+ * single _id value. Since _id is unique within an unsharded collection, such a
+ * deletion removes at most one document regardless of its limit, and the same
+ * document as DELETE .. WHERE object_id = ANY(..) would.
+ */
+static bool
+IsSetBasedDeletionCandidate(DeletionSpec *deletionSpec, text *transactionId)
+{
+	DeleteOneParams *deleteOneParams = &deletionSpec->deleteOneParams;
+	if (deleteOneParams->returnDeletedDocument ||
+		IsCollationApplicable(deleteOneParams->collationString))
+	{
+		return false;
+	}
+
+	if (deletionSpec->limit != 0 && transactionId != NULL)
+	{
+		/* retryable deletes with limit 1 record their own result */
+		return false;
+	}
+
+	bson_iter_t queryIterator;
+	BsonValueInitIterator(deleteOneParams->query, &queryIterator);
+
+	bson_value_t idValue = { 0 };
+	bool errorOnConflict = false;
+	bool queryHasNonIdFilters = false;
+	bool isIdValueCollationAware = false;
+	bool hasObjectIdFilter =
+		TraverseQueryDocumentAndGetId(&queryIterator, &idValue, errorOnConflict,
+									  &queryHasNonIdFilters, &isIdValueCollationAware);
+
+	return hasObjectIdFilter && !queryHasNonIdFilters;
+}
+
+
+/*
+ * TryDeleteByObjectIds runs DeleteByObjectIds in a subtransaction and returns
+ * whether it succeeded. On failure, none of the deletions took effect and the
+ * caller is expected to run them one by one.
+ */
+static bool
+TryDeleteByObjectIds(MongoCollection *collection, List *deletions,
+					 int startIndex, int deletionCount, uint64 *rowsDeleted)
+{
+	MemoryContext oldContext = CurrentMemoryContext;
+	ResourceOwner oldOwner = CurrentResourceOwner;
+
+	/* declared volatile because of the longjmp in PG_CATCH */
+	volatile bool isSuccess = false;
+
+	BeginInternalSubTransaction(NULL);
+
+	PG_TRY();
+	{
+		*rowsDeleted = DeleteByObjectIds(collection, deletions, startIndex,
+										 deletionCount);
+		ReportFeatureUsage(FEATURE_USAGE_SET_BASED_DELETE_BY_ID);
+
+		/* Commit the inner transaction, return to outer xact context */
+		ReleaseCurrentSubTransaction();
+		MemoryContextSwitchTo(oldContext);
+		CurrentResourceOwner = oldOwner;
+
+		isSuccess = true;
+	}
+	PG_CATCH();
+	{
+		MemoryContextSwitchTo(oldContext);
+		ErrorData *errorData = CopyErrorDataAndFlush();
+
+		/* Abort inner transaction */
+		RollbackAndReleaseCurrentSubTransaction();
+		MemoryContextSwitchTo(oldContext);
+		CurrentResourceOwner = oldOwner;
+
+		if (IsOperatorInterventionError(errorData))
+		{
+			ReThrowError(errorData);
+		}
+
+		FreeErrorData(errorData);
+	}
+	PG_END_TRY();
+
+	return isSuccess;
+}
+
+
+/*
+ * DeleteByObjectIds deletes the documents of deletionCount deletions starting
+ * at startIndex with a single statement, instead of one statement (and one
+ * subtransaction) per deletion. All the deletions must satisfy
+ * IsSetBasedDeletionCandidate.
+ *
+ * Returns the number of documents deleted. A document whose _id appears in
+ * several deletions is deleted (and counted) once, as it would be by running
+ * the deletions one after the other.
+ */
+static uint64
+DeleteByObjectIds(MongoCollection *collection, List *deletions, int startIndex,
+				  int deletionCount)
+{
+	Datum *objectIdDatums = palloc(sizeof(Datum) * deletionCount);
+	for (int i = 0; i < deletionCount; i++)
+	{
+		DeletionSpec *deletionSpec = list_nth(deletions, startIndex + i);
+
+		bool queryHasNonIdFilters = false;
+		bool isIdFilterCollationAware = false;
+		pgbson *objectIdFilter =
+			GetObjectIdFilterFromQueryDocumentValue(deletionSpec->deleteOneParams.query,
+													&queryHasNonIdFilters,
+													&isIdFilterCollationAware);
+		Assert(objectIdFilter != NULL && !queryHasNonIdFilters);
+
+		objectIdDatums[i] = PointerGetDatum(objectIdFilter);
+	}
+
+	ArrayType *objectIdArray = construct_array(objectIdDatums, deletionCount,
+											   BsonTypeId(), -1, false,
+											   TYPALIGN_INT);
+
+	SPI_connect();
+
+	StringInfoData deleteQuery;
+	initStringInfo(&deleteQuery);
+	appendStringInfo(&deleteQuery, "DELETE FROM ");
+
+	if (collection->shardTableName[0] != '\0')
+	{
+		appendStringInfo(&deleteQuery, " %s.%s", ApiDataSchemaName,
+						 collection->shardTableName);
+	}
+	else
+	{
+		appendStringInfo(&deleteQuery, " %s.documents_" UINT64_FORMAT, ApiDataSchemaName,
+						 collection->collectionId);
+	}
+
+	appendStringInfo(&deleteQuery,
+					 " WHERE shard_key_value = $1"
+					 " AND object_id OPERATOR(%s.=) ANY($2::%s[])",
+					 CoreSchemaName, FullBsonTypeName);
+
+	int argCount = 2;
+	Oid argTypes[2] = { INT8OID, GetBsonArrayTypeOid() };
+
+	/* since this is unsharded, the shard key value is the collection id */
+	Datum argValues[2] = {
+		Int64GetDatum(collection->collectionId),
+		PointerGetDatum(objectIdArray)
+	};
+	char argNulls[2] = { ' ', ' ' };
+
+	bool readOnly = false;
+	long maxTupleCount = 0;
+	SPIPlanPtr plan = GetSPIQueryPlanWithLocalShard(collection->collectionId,
+													collection->shardTableName,
+													QUERY_DELETE_BY_OBJECT_ID_ARRAY,
+													deleteQuery.data, argTypes,
+													argCount);
+
+	SPI_execute_plan(plan, argValues, argNulls, readOnly, maxTupleCount);
+	uint64 rowsDeleted = SPI_processed;
+
+	pfree(deleteQuery.data);
+
+	SPI_finish();
+
+	pfree(objectIdArray);
+	pfree(objectIdDatums);
+
+	return rowsDeleted;
+}
+
+
 static pgbson *
 ProcessBatchDeleteUnsharded(MongoCollection *collection, BatchDeletionSpec *batchSpec,
 							text *transactionId)
@@ -1422,7 +1670,8 @@ DeleteOneInternal(MongoCollection *collection, DeleteOneParams *deleteOneParams,
 	}
 
 	appendStringInfo(&selectQuery,
-					 " LIMIT 1 FOR UPDATE)");
+					 " LIMIT 1 FOR UPDATE%s)",
+					 deleteOneParams->skipLockedCandidates ? " SKIP LOCKED" : "");
 
 	StringInfoData deleteQuery;
 	initStringInfo(&deleteQuery);
@@ -1449,6 +1698,11 @@ DeleteOneInternal(MongoCollection *collection, DeleteOneParams *deleteOneParams,
 		appendStringInfo(&deleteQuery, ", document");
 	}
 
+	if (deleteOneParams->skipLockedCandidates)
+	{
+		planId += QUERY_VARIANT_SKIP_LOCKED;
+	}
+
 	bool readOnly = false;
 	long maxTupleCount = 0;
 
@@ -1579,6 +1833,11 @@ SerializeDeleteOneParams(const DeleteOneParams *deleteParams)
 							   deleteParams->collationString);
 	}
 
+	if (deleteParams->skipLockedCandidates)
+	{
+		PgbsonWriterAppendBool(&writer, "skipLockedCandidates", 20, true);
+	}
+
 	PgbsonWriterEndDocument(&commandWriter, &writer);
 	return PgbsonWriterGetPgbson(&commandWriter);
 }
@@ -1624,6 +1883,10 @@ DeserializeDeleteWorkerSpecForDeleteOne(const bson_value_t *workerSpecValue,
 					bson_iter_utf8(&commandIter, NULL),
 					sizeof(deleteOneParams->collationString));
 		}
+		else if (strcmp(key, "skipLockedCandidates") == 0)
+		{
+			deleteOneParams->skipLockedCandidates = bson_iter_bool(&commandIter);
+		}
 	}
 }
 
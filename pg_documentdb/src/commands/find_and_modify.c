@@ -126,11 +126,13 @@ static FindAndModifyResult ProcessFindAndModifySpec(MongoCollection *collection,
 													FindAndModifySpec *spec,
 													text *transactionId);
 static pgbson * BuildResponseMessage(FindAndModifyResult *result);
+static bool ShouldSkipLockedCandidates(FindAndModifySpec *spec);
 
 extern bool SkipFailOnCollation;
 extern bool EnableBypassDocumentValidation;
 extern bool EnableSchemaValidation;
 extern bool EnableVariablesSupportForWriteCommands;
+extern bool EnableFindAndModifySkipLocked;
 
 /*
  * command_find_and_modify implements findAndModify command.
@@ -526,7 +528,8 @@ ProcessFindAndModifySpec(MongoCollection *collection, FindAndModifySpec *spec,
 			.returnFields = spec->returnFields,
 			.returnDeletedDocument = true,
 			.sort = spec->sort,
-			.variableSpec = &spec->variableSpec
+			.variableSpec = &spec->variableSpec,
+			.skipLockedCandidates = ShouldSkipLockedCandidates(spec)
 		};
 
 		DeleteOneResult deleteOneResult = { 0 };
@@ -567,7 +570,8 @@ ProcessFindAndModifySpec(MongoCollection *collection, FindAndModifySpec *spec,
 			.returnFields = spec->returnFields,
 			.sort = spec->sort,
 			.update = spec->update,
-			.variableSpec = &spec->variableSpec
+			.variableSpec = &spec->variableSpec,
+			.skipLockedCandidates = ShouldSkipLockedCandidates(spec)
 		};
 
 		UpdateOneResult updateOneResult = { 0 };
@@ -576,8 +580,8 @@ ProcessFindAndModifySpec(MongoCollection *collection, FindAndModifySpec *spec,
 		ExprEvalState *evalState = NULL;
 		if (CheckSchemaValidationEnabled(collection, spec->bypassDocumentValidation))
 		{
-			evalState = PrepareForSchemaValidation(collection->schemaValidator.validator,
-												   CurrentMemoryContext);
+			evalState = PrepareForCollectionSchemaValidation(collection,
+															 CurrentMemoryContext);
 		}
 
 		UpdateOne(collection, &updateOneParams, shardKeyHash, transactionId,
@@ -619,12 +623,40 @@ ProcessFindAndModifySpec(MongoCollection *collection, FindAndModifySpec *spec,
 			}
 		};
 
-		FreeExprEvalState(evalState, CurrentMemoryContext);
+		FreeSchemaValidationState(collection, evalState, CurrentMemoryContext);
 		return result;
 	}
 }
 
 
+/*
+ * ShouldSkipLockedCandidates returns whether findAndModify skips documents
+ * locked by other transactions when selecting the document to modify.
+ *
+ * This only applies to queue-shaped commands, a sort over a query that can
+ * match several documents, where the next matching document is as good as
+ * the locked one. A query on _id matches a single document, so skipping it
+ * would report no match for a document that exists. An upsert must not skip
+ * a matching document either, or it would insert a second one.
+ */
+static bool
+ShouldSkipLockedCandidates(FindAndModifySpec *spec)
+{
+	if (!EnableFindAndModifySkipLocked || spec->upsert || spec->sort == NULL ||
+		IsBsonValueEmptyDocument(spec->sort))
+	{
+		return false;
+	}
+
+	bool queryHasNonIdFilters = false;
+	bool isIdFilterCollationAwareIgnore = false;
+	pgbson *objectIdFilter =
+		GetObjectIdFilterFromQueryDocumentValue(spec->query, &queryHasNonIdFilters,
+												&isIdFilterCollationAwareIgnore);
+	return objectIdFilter == NULL;
+}
+
+
 /*
  * BuildResponseMessage returns a bson object that can be sent to the client
  * based on given FindAndModifyResult.
@@ -22,6 +22,12 @@
 #include <catalog/pg_class.h>
 #include <parser/parse_relation.h>
 #include <utils/lsyscache.h>
+#include <utils/acl.h>
+#include <access/heapam.h>
+#include <access/table.h>
+#include <access/tableam.h>
+#include <catalog/objectaddress.h>
+#include <executor/executor.h>
 
 #include "access/xact.h"
 #include "executor/spi.h"
@@ -48,6 +54,7 @@
 #include "operators/bson_expr_eval.h"
 #include "planner/documentdb_planner.h"
 #include "optimizer/plancat.h"
+#include "update/bson_update.h"
 
 /*
  * BatchInsertionSpec describes a batch of insert operations.
@@ -68,6 +75,9 @@ typedef struct BatchInsertionSpec
 
 	/* if true, bypass document validation */
 	bool bypassDocumentValidation;
+
+	/* whether the writeConcern of the command relaxed its commits */
+	bool isAsyncCommit;
 } BatchInsertionSpec;
 
 /*
@@ -145,6 +155,11 @@ static inline RangeTblEntry * CreateBaseTableRteForInsert(MongoCollection *colle
 														  shardOid,
 														  List **optionalPermInfos);
 static inline void ReportInsertFeatureUsage(int batchSize);
+static bool TryMultiInsertIntoLocalTable(MongoCollection *collection, Oid tableOid,
+										 int rowCount, int64 *shardKeyValues,
+										 pgbson **objectIds, pgbson **documents);
+static bool CanMultiInsertIntoLocalTable(Relation relation,
+										 ResultRelInfo *resultRelInfo);
 
 /*
  * ApiGucPrefix.enable_create_collection_on_insert GUC determines whether
@@ -155,6 +170,7 @@ extern bool UseLocalExecutionShardQueries;
 extern bool EnableBypassDocumentValidation;
 extern bool EnableSchemaValidation;
 extern bool EnableUpdateBsonDocument;
+extern bool EnableDirectMultiInsert;
 
 /*
  * command_insert handles the insert command invocation through a PostgreSQL function.
@@ -268,6 +284,7 @@ BuildBatchInsertionSpec(bson_iter_t *insertCommandIter, pgbsonsequence *insertDo
 	bool hasDocuments = false;
 	bool hasSkippedDocuments = false;
 	bool bypassDocumentValidation = false;
+	bool isAsyncCommit = false;
 
 	while (bson_iter_next(insertCommandIter))
 	{
@@ -329,6 +346,11 @@ BuildBatchInsertionSpec(bson_iter_t *insertCommandIter, pgbsonsequence *insertDo
 			SetExplicitStatementTimeout(BsonValueAsInt32(bson_iter_value(
 															 insertCommandIter)));
 		}
+		else if (strcmp(field, "writeConcern") == 0)
+		{
+			isAsyncCommit =
+				ApplyWriteConcernDurability(bson_iter_value(insertCommandIter));
+		}
 		else if (IsCommonSpecIgnoredField(field))
 		{
 			elog(DEBUG1, "Command field not recognized: insert.%s", field);
@@ -336,7 +358,6 @@ BuildBatchInsertionSpec(bson_iter_t *insertCommandIter, pgbsonsequence *insertDo
 			/*
 			 *  Silently ignore now, so that clients don't break
 			 *  TODO: implement me
-			 *      writeConcern
 			 *      comment
 			 */
 		}
@@ -386,6 +407,7 @@ BuildBatchInsertionSpec(bson_iter_t *insertCommandIter, pgbsonsequence *insertDo
 	batchSpec->documents = documents;
 	batchSpec->isOrdered = isOrdered;
 	batchSpec->bypassDocumentValidation = bypassDocumentValidation;
+	batchSpec->isAsyncCommit = isAsyncCommit;
 
 	return batchSpec;
 }
@@ -557,70 +579,105 @@ DoMultiInsertWithoutTransactionId(MongoCollection *collection, List *inserts, Oi
 
 	PG_TRY();
 	{
-		List *valuesList = NIL;
 		ListCell *insertCell;
 
-		/* Make params for all the BSONs - we have 2 per insert - objectId/insertDoc */
-		int expectedNumParams = Min(list_length(inserts), BatchWriteSubTransactionCount);
-		ParamListInfo paramListInfo = makeParamList(expectedNumParams * 2);
-		int paramIndex = 0;
+		/* Preprocess the documents of the sub-batch */
+		int maxInsertCount = Min(list_length(inserts) - insertIndex,
+								 BatchWriteSubTransactionCount);
+		int64 *shardKeyValues = palloc(sizeof(int64) * maxInsertCount);
+		pgbson **objectIds = palloc(sizeof(pgbson *) * maxInsertCount);
+		pgbson **insertDocs = palloc(sizeof(pgbson *) * maxInsertCount);
 		while (insertInnerIndex < list_length(inserts) &&
 			   insertCount < BatchWriteSubTransactionCount)
 		{
 			insertCell = list_nth_cell(inserts, insertInnerIndex);
 			const bson_value_t *documentValue = lfirst(insertCell);
 
-			int64_t shardKeyValue;
-			pgbson *objectId;
-			pgbson *insertDoc =
-				PreprocessInsertionDoc(documentValue, collection, &shardKeyValue,
-									   &objectId, evalState);
-
-			/* Generate a values lists for the insert as
-			 * VALUES(shard_key_value, object_id, document, creationTime)
-			 */
-			Const *shardKeyConst = makeConst(INT8OID, -1, InvalidOid, 8,
-											 Int64GetDatum(shardKeyValue), false, true);
-			Expr *objectidParam = CreateBsonParam(paramIndex, paramListInfo, objectId);
-			paramIndex++;
-
-			Expr *documentParam = CreateBsonParam(paramIndex, paramListInfo, insertDoc);
-			paramIndex++;
-
-			List *values = CreateValuesListForInsert(shardKeyConst, objectidParam,
-													 documentParam,
-													 collection->
-													 mongoDataCreationTimeVarAttrNumber);
-
-			valuesList = lappend(valuesList, values);
+			insertDocs[insertCount] =
+				PreprocessInsertionDoc(documentValue, collection,
+									   &shardKeyValues[insertCount],
+									   &objectIds[insertCount], evalState);
 			insertCount++;
 			insertInnerIndex++;
 		}
 
-		paramListInfo->numParams = paramIndex;
+		/*
+		 * The table is local when we have its shard, or when the collection is
+		 * not distributed at all.
+		 */
+		Oid localTableOid = shardOid != InvalidOid ? shardOid :
+							DefaultInlineWriteOperations ? collection->relationId :
+							InvalidOid;
 
 		uint64_t rowsProcessed = 0;
-		if (shardOid == InvalidOid)
+		if (EnableDirectMultiInsert && localTableOid != InvalidOid &&
+			TryMultiInsertIntoLocalTable(collection, localTableOid, insertCount,
+										 shardKeyValues, objectIds, insertDocs))
 		{
-			Query *query = CreateInsertQuery(collection, shardOid,
-											 valuesList);
-			rowsProcessed = RunInsertQuery(query, paramListInfo);
+			ReportFeatureUsage(FEATURE_USAGE_DIRECT_MULTI_INSERT);
+			rowsProcessed = insertCount;
 		}
 		else
 		{
-			ThrowIfWriteCommandNotAllowed();
+			List *valuesList = NIL;
 
-			PlannedStmt *queryPlan = CreateLocalShardInsertPlan(collection,
-																shardOid, valuesList);
-			rowsProcessed = ExecuteLocalShardInsertPlan(queryPlan, paramListInfo);
+			/* Make params for all the BSONs - we have 2 per insert - objectId/insertDoc */
+			ParamListInfo paramListInfo = makeParamList(insertCount * 2);
+			int paramIndex = 0;
+			for (int i = 0; i < insertCount; i++)
+			{
+				/* Generate a values lists for the insert as
+				 * VALUES(shard_key_value, object_id, document, creationTime)
+				 */
+				Const *shardKeyConst = makeConst(INT8OID, -1, InvalidOid, 8,
+												 Int64GetDatum(shardKeyValues[i]), false,
+												 true);
+				Expr *objectidParam = CreateBsonParam(paramIndex, paramListInfo,
+													  objectIds[i]);
+				paramIndex++;
+
+				Expr *documentParam = CreateBsonParam(paramIndex, paramListInfo,
+													  insertDocs[i]);
+				paramIndex++;
+
+				List *values = CreateValuesListForInsert(shardKeyConst, objectidParam,
+														 documentParam,
+														 collection->
+														 mongoDataCreationTimeVarAttrNumber);
+
+				valuesList = lappend(valuesList, values);
+			}
+
+			paramListInfo->numParams = paramIndex;
+
+			if (shardOid == InvalidOid || collection->indexKeyColumnAttrNumber != -1)
+			{
+				/* The local shard plan has no target entry for index_document */
+				Query *query = CreateInsertQuery(collection, shardOid,
+												 valuesList);
+				rowsProcessed = RunInsertQuery(query, paramListInfo);
+			}
+			else
+			{
+				ThrowIfWriteCommandNotAllowed();
+
+				PlannedStmt *queryPlan = CreateLocalShardInsertPlan(collection,
+																	shardOid,
+																	valuesList);
+				rowsProcessed = ExecuteLocalShardInsertPlan(queryPlan, paramListInfo);
+			}
+
+			list_free_deep(valuesList);
+			pfree(paramListInfo);
 		}
 
 		/* Merge inner batchResult with outer batchResult */
 		batchResult->rowsInserted += rowsProcessed;
 		*insertCountResult = rowsProcessed;
 		insertCount = rowsProcessed;
-		list_free_deep(valuesList);
-		pfree(paramListInfo);
+		pfree(shardKeyValues);
+		pfree(objectIds);
+		pfree(insertDocs);
 
 		/* Commit the inner transaction, return to outer xact context */
 		ReleaseCurrentSubTransaction();
@@ -749,8 +806,8 @@ ProcessBatchInsertion(MongoCollection *collection, BatchInsertionSpec *batchSpec
 	 */
 	if (CheckSchemaValidationEnabled(collection, batchSpec->bypassDocumentValidation))
 	{
-		evalState = PrepareForSchemaValidation(collection->schemaValidator.validator,
-											   batchResult->resultMemoryContext);
+		evalState = PrepareForCollectionSchemaValidation(collection,
+														 batchResult->resultMemoryContext);
 	}
 
 	/*
@@ -775,10 +832,7 @@ ProcessBatchInsertion(MongoCollection *collection, BatchInsertionSpec *batchSpec
 									 isTransactional);
 	}
 
-	if (evalState != NULL)
-	{
-		FreeExprEvalState(evalState, batchResult->resultMemoryContext);
-	}
+	FreeSchemaValidationState(collection, evalState, batchResult->resultMemoryContext);
 }
 
 
@@ -807,7 +861,8 @@ DoBatchInsertNoTransactionId(MongoCollection *collection, BatchInsertionSpec *ba
 			bool setSnapshot = true;
 			CommitWriteProcedureAndReacquireCollectionLock(collection,
 														   batchSpec->insertShardOid,
-														   setSnapshot);
+														   setSnapshot,
+														   batchSpec->isAsyncCommit);
 		}
 
 		if (list_length(insertions) > 1 && !hasBatchedInsertFailed)
@@ -911,7 +966,8 @@ ProcessInsertion(MongoCollection *collection,
 													 collection->
 													 mongoDataCreationTimeVarAttrNumber);
 
-		if (optionalInsertShardOid == InvalidOid)
+		if (optionalInsertShardOid == InvalidOid ||
+			collection->indexKeyColumnAttrNumber != -1)
 		{
 			Query *query = CreateInsertQuery(collection, optionalInsertShardOid,
 											 list_make1(
@@ -1354,6 +1410,130 @@ InsertOrReplaceDocument(uint64 collectionId, const char *shardTableName, int64
 }
 
 
+/*
+ * Inserts a document with the given shardKeyValue and object_id, and on conflict
+ * with the _id index applies the update to the conflicting document. Unlike
+ * InsertOrReplaceDocument, the update sees the query of the original update, and
+ * the result tells whether the document was inserted, updated or left unchanged.
+ */
+InsertOrUpdateResult
+InsertOrUpdateDocument(uint64 collectionId, const char *shardTableName,
+					   int64 shardKeyValue, pgbson *objectId, pgbson *document,
+					   const bson_value_t *updateSpecValue,
+					   const bson_value_t *querySpecValue)
+{
+	const int argCount = 3;
+	Oid argTypes[3];
+	Datum argValues[3];
+
+	SPI_connect();
+
+	const char *tableName = shardTableName;
+	if (tableName == NULL || tableName[0] == '\0')
+	{
+		tableName = psprintf("documents_" UINT64_FORMAT, collectionId);
+	}
+
+	/* The primary key is collection_pk_ followed by the suffix of documents_ */
+	const int prefixLength = 10;
+	const char *tableSuffix = tableName + prefixLength;
+
+	/*
+	 * ON CONFLICT DO UPDATE locks the conflicting row even when its WHERE clause
+	 * is false, so the insert either returns the inserted row or leaves the
+	 * document with the same _id locked for the update below. The update is then
+	 * applied once, here, rather than in both the SET list and the WHERE clause.
+	 */
+	StringInfoData query;
+	initStringInfo(&query);
+	appendStringInfo(&query,
+					 "INSERT INTO %s.%s (shard_key_value, object_id, document)"
+					 " VALUES ($1, %s.bson_from_bytea($2), %s.bson_from_bytea($3))"
+					 " ON CONFLICT ON CONSTRAINT collection_pk_%s"
+					 " DO UPDATE SET document = %s.%s.document WHERE false"
+					 " RETURNING 1",
+					 ApiDataSchemaName, tableName,
+					 CoreSchemaName, CoreSchemaName,
+					 tableSuffix,
+					 ApiDataSchemaName, tableName);
+
+	argTypes[0] = INT8OID;
+	argValues[0] = Int64GetDatum(shardKeyValue);
+	argTypes[1] = BYTEAOID;
+	argValues[1] = PointerGetDatum(CastPgbsonToBytea(objectId));
+	argTypes[2] = BYTEAOID;
+	argValues[2] = PointerGetDatum(CastPgbsonToBytea(document));
+
+	SPIPlanPtr plan = GetSPIQueryPlanWithLocalShard(collectionId, shardTableName,
+													QUERY_ID_INSERT_OR_UPDATE,
+													query.data, argTypes, argCount);
+
+	int spiStatus PG_USED_FOR_ASSERTS_ONLY = SPI_execute_plan(plan, argValues, NULL,
+															  false, 1);
+	Assert(spiStatus == SPI_OK_INSERT_RETURNING && SPI_processed <= 1);
+
+	if (SPI_processed == 1)
+	{
+		pfree(query.data);
+		SPI_finish();
+		return INSERT_OR_UPDATE_INSERTED;
+	}
+
+	/*
+	 * The conflicting document is locked by this transaction. The select is not
+	 * read only so that it takes a new snapshot, which sees a conflicting document
+	 * committed after the insert's snapshot was taken.
+	 */
+	resetStringInfo(&query);
+	appendStringInfo(&query,
+					 "SELECT document FROM %s.%s"
+					 " WHERE shard_key_value = $1 AND object_id = %s.bson_from_bytea($2)",
+					 ApiDataSchemaName, tableName, CoreSchemaName);
+
+	plan = GetSPIQueryPlanWithLocalShard(collectionId, shardTableName,
+										 QUERY_ID_INSERT_OR_UPDATE_SELECT_CONFLICT,
+										 query.data, argTypes, 2);
+
+	spiStatus = SPI_execute_plan(plan, argValues, NULL, false, 1);
+	Assert(spiStatus == SPI_OK_SELECT && SPI_processed == 1);
+
+	bool isNull = false;
+	Datum existingDatum = SPI_getbinval(SPI_tuptable->vals[0], SPI_tuptable->tupdesc,
+										1, &isNull);
+	pgbson *existingDocument = DatumGetPgBson(existingDatum);
+
+	pgbson *updatedDocument = BsonUpdateDocument(existingDocument, updateSpecValue,
+												 querySpecValue, NULL, NULL);
+
+	/* a no-op update leaves no new row version (and no dead tuple) behind */
+	InsertOrUpdateResult result = INSERT_OR_UPDATE_UNCHANGED;
+	if (updatedDocument != NULL)
+	{
+		resetStringInfo(&query);
+		appendStringInfo(&query,
+						 "UPDATE %s.%s SET document = %s.bson_from_bytea($3)"
+						 " WHERE shard_key_value = $1 AND object_id = %s.bson_from_bytea($2)",
+						 ApiDataSchemaName, tableName, CoreSchemaName, CoreSchemaName);
+
+		argValues[2] = PointerGetDatum(CastPgbsonToBytea(updatedDocument));
+
+		plan = GetSPIQueryPlanWithLocalShard(collectionId, shardTableName,
+											 QUERY_ID_INSERT_OR_UPDATE_CONFLICT,
+											 query.data, argTypes, argCount);
+
+		spiStatus = SPI_execute_plan(plan, argValues, NULL, false, 1);
+		Assert(spiStatus == SPI_OK_UPDATE && SPI_processed == 1);
+
+		result = INSERT_OR_UPDATE_UPDATED;
+	}
+
+	pfree(query.data);
+	SPI_finish();
+
+	return result;
+}
+
+
 /*
  * BuildResponseMessage builds the response BSON for an insert command.
  */
@@ -1624,6 +1804,172 @@ ExecuteLocalShardInsertPlan(PlannedStmt *queryPlan, ParamListInfo paramListInfo)
 }
 
 
+/*
+ * TryMultiInsertIntoLocalTable inserts a batch of documents into a table that is
+ * local to this node (an unsharded collection's shard, or the collection table
+ * when not distributed) without building and executing an INSERT plan: the rows
+ * are written with the table access method's multi-insert, which fills pages
+ * and WAL records for many rows at once, and their index entries are inserted
+ * afterwards as the executor would.
+ *
+ * Returns false without inserting anything if the table needs executor features
+ * this does not implement (triggers, row level security, defaults, deferred
+ * constraints).
+ */
+static bool
+TryMultiInsertIntoLocalTable(MongoCollection *collection, Oid tableOid, int rowCount,
+							 int64 *shardKeyValues, pgbson **objectIds,
+							 pgbson **documents)
+{
+	AclResult aclResult = pg_class_aclcheck(tableOid, GetUserId(), ACL_INSERT);
+	if (aclResult != ACLCHECK_OK)
+	{
+		aclcheck_error(aclResult, get_relkind_objtype(get_rel_relkind(tableOid)),
+					   get_rel_name(tableOid));
+	}
+
+	ThrowIfWriteCommandNotAllowed();
+
+	Relation relation = table_open(tableOid, RowExclusiveLock);
+
+	EState *estate = CreateExecutorState();
+	ResultRelInfo *resultRelInfo = makeNode(ResultRelInfo);
+	InitResultRelInfo(resultRelInfo, relation, 0, NULL, 0);
+	ExecOpenIndices(resultRelInfo, false);
+
+	if (!CanMultiInsertIntoLocalTable(relation, resultRelInfo))
+	{
+		ExecCloseIndices(resultRelInfo);
+		FreeExecutorState(estate);
+		table_close(relation, RowExclusiveLock);
+		return false;
+	}
+
+	/*
+	 * The slots belong to the executor state of this sub-batch: sub-batches run
+	 * in their own sub-transaction, and outside of a transaction the work is
+	 * committed between them, so they are not kept for the next sub-batch.
+	 */
+	TupleDesc tupleDescriptor = RelationGetDescr(relation);
+	TupleTableSlot **slots = palloc(sizeof(TupleTableSlot *) * rowCount);
+	for (int i = 0; i < rowCount; i++)
+	{
+		slots[i] = ExecInitExtraTupleSlot(estate, tupleDescriptor,
+										  table_slot_callbacks(relation));
+
+		TupleTableSlot *slot = slots[i];
+		ExecClearTuple(slot);
+		memset(slot->tts_isnull, true, sizeof(bool) * tupleDescriptor->natts);
+
+		slot->tts_values[DOCUMENT_DATA_TABLE_SHARD_KEY_VALUE_VAR_ATTR_NUMBER - 1] =
+			Int64GetDatum(shardKeyValues[i]);
+		slot->tts_isnull[DOCUMENT_DATA_TABLE_SHARD_KEY_VALUE_VAR_ATTR_NUMBER - 1] = false;
+		slot->tts_values[DOCUMENT_DATA_TABLE_OBJECT_ID_VAR_ATTR_NUMBER - 1] =
+			PointerGetDatum(objectIds[i]);
+		slot->tts_isnull[DOCUMENT_DATA_TABLE_OBJECT_ID_VAR_ATTR_NUMBER - 1] = false;
+		slot->tts_values[DOCUMENT_DATA_TABLE_DOCUMENT_VAR_ATTR_NUMBER - 1] =
+			PointerGetDatum(documents[i]);
+		slot->tts_isnull[DOCUMENT_DATA_TABLE_DOCUMENT_VAR_ATTR_NUMBER - 1] = false;
+
+		/* Same value as CreateValuesListForInsert */
+		if (collection->mongoDataCreationTimeVarAttrNumber != -1)
+		{
+			AttrNumber creationTimeIndex =
+				collection->mongoDataCreationTimeVarAttrNumber - 1;
+			slot->tts_values[creationTimeIndex] = TimestampTzGetDatum(0);
+			slot->tts_isnull[creationTimeIndex] = false;
+		}
+
+		ExecStoreVirtualTuple(slot);
+
+		/* not null and check constraints (e.g. shard_key_value_check) */
+		if (tupleDescriptor->constr != NULL)
+		{
+			ExecConstraints(resultRelInfo, slot, estate);
+		}
+	}
+
+	CommandId commandId = GetCurrentCommandId(true);
+	int insertOptions = 0;
+	BulkInsertState bulkInsertState = GetBulkInsertState();
+	table_multi_insert(relation, slots, rowCount, commandId, insertOptions,
+					   bulkInsertState);
+	FreeBulkInsertState(bulkInsertState);
+
+	for (int i = 0; i < rowCount && resultRelInfo->ri_NumIndices > 0; i++)
+	{
+		bool isUpdate = false;
+		bool noDupError = false;
+		List *arbiterIndexes = NIL;
+#if PG_VERSION_NUM >= 160000
+		bool onlySummarizing = false;
+		List *recheckIndexes = ExecInsertIndexTuples(resultRelInfo, slots[i], estate,
+													 isUpdate, noDupError, NULL,
+													 arbiterIndexes, onlySummarizing);
+#else
+		List *recheckIndexes = ExecInsertIndexTuples(resultRelInfo, slots[i], estate,
+													 isUpdate, noDupError, NULL,
+													 arbiterIndexes);
+#endif
+		list_free(recheckIndexes);
+		ResetPerTupleExprContext(estate);
+	}
+
+	ExecCloseIndices(resultRelInfo);
+	ExecResetTupleTable(estate->es_tupleTable, false);
+	FreeExecutorState(estate);
+	pfree(slots);
+
+	/* Keep the lock until the end of the transaction, as the executor does */
+	table_close(relation, NoLock);
+	return true;
+}
+
+
+/*
+ * Whether TryMultiInsertIntoLocalTable can insert into the relation: it has no
+ * insert triggers, no row level security, no column defaults or generated
+ * columns, and all its unique and exclusion constraints are checked immediately.
+ */
+static bool
+CanMultiInsertIntoLocalTable(Relation relation, ResultRelInfo *resultRelInfo)
+{
+	if (relation->rd_rel->relkind != RELKIND_RELATION ||
+		relation->rd_rel->relrowsecurity)
+	{
+		return false;
+	}
+
+	TriggerDesc *triggerDesc = relation->trigdesc;
+	if (triggerDesc != NULL &&
+		(triggerDesc->trig_insert_before_row || triggerDesc->trig_insert_after_row ||
+		 triggerDesc->trig_insert_instead_row ||
+		 triggerDesc->trig_insert_before_statement ||
+		 triggerDesc->trig_insert_after_statement ||
+		 triggerDesc->trig_insert_new_table))
+	{
+		return false;
+	}
+
+	TupleConstr *constraints = RelationGetDescr(relation)->constr;
+	if (constraints != NULL &&
+		(constraints->num_defval > 0 || constraints->has_generated_stored))
+	{
+		return false;
+	}
+
+	for (int i = 0; i < resultRelInfo->ri_NumIndices; i++)
+	{
+		if (!resultRelInfo->ri_IndexRelationDescs[i]->rd_index->indimmediate)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
 /* indicates the presence of a creation_time column in the table, either at attribute number 4 or 5 */
 static inline List *
 CreateValuesListForInsert(Const *shardKey, Expr *objectId, Expr *document, AttrNumber
@@ -1663,6 +2009,12 @@ CreateBaseTableRteForInsert(MongoCollection *collection, Oid shardOid,
 		colNames = ModifyTableColumnNames(colNames);
 	}
 
+	if (collection->indexKeyColumnAttrNumber == list_length(colNames) + 1)
+	{
+		colNames = lappend(colNames,
+						   makeString(DOCUMENT_DATA_TABLE_INDEX_KEY_COLUMN_NAME));
+	}
+
 	rte->rtekind = RTE_RELATION;
 	rte->relid = collection->relationId;
 
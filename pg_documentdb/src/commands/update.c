@@ -72,6 +72,7 @@
 #include "access/xact.h"
 #include "executor/spi.h"
 #include "lib/stringinfo.h"
+#include "utils/array.h"
 #include "utils/builtins.h"
 #include "utils/typcache.h"
 
@@ -86,6 +87,7 @@
 #include "metadata/collection.h"
 #include "metadata/metadata_cache.h"
 #include "infrastructure/documentdb_plan_cache.h"
+#include "query/bson_compare.h"
 #include "query/query_operator.h"
 #include "sharding/sharding.h"
 #include "commands/retryable_writes.h"
@@ -113,6 +115,8 @@ extern bool EnableSchemaValidation;
 
 /* This GUC determines whether to use update_bson_document instead of the bson_update_document command. */
 extern bool EnableUpdateBsonDocument;
+extern bool EnableUpsertOnConflict;
+extern bool EnableSetBasedUpdateById;
 
 /*
  * UpdateSpec describes a single update operation.
@@ -178,6 +182,23 @@ typedef struct
 	pgbson *objectId;
 } UpsertResult;
 
+
+/*
+ * UpdateStatementResult represents the result of a single update of a batch,
+ * added to the final output when the command asks for it.
+ */
+typedef struct
+{
+	/* index of the update in the batch */
+	int index;
+
+	/* number of rows that matched the update (matched + upserted) */
+	uint64 rowsMatched;
+
+	/* number of rows modified by the update */
+	uint64 rowsModified;
+} UpdateStatementResult;
+
 /*
  * UpdateAllMAtchingDocsResult represents the result of updating
  * multiple documents in a single operation.
@@ -225,6 +246,12 @@ typedef struct
 
 	/* parsed variable spec */
 	bson_value_t variableSpec;
+
+	/* whether the response reports the result of each update */
+	bool returnStatementResults;
+
+	/* whether the writeConcern of the command relaxed its commits */
+	bool isAsyncCommit;
 } BatchUpdateSpec;
 
 
@@ -249,6 +276,12 @@ typedef struct
 	/* list of upserts */
 	List *upserted;
 
+	/* whether to track the result of each update in statementResults */
+	bool trackStatementResults;
+
+	/* list of the results of the updates that succeeded, if tracked */
+	List *statementResults;
+
 	/* Memory context to write results/errors to */
 	MemoryContext resultMemoryContext;
 } BatchUpdateResult;
@@ -297,7 +330,18 @@ static void ProcessBatchUpdateCore(MongoCollection *collection, List *updates,
 								   BatchUpdateResult *batchResult,
 								   bool isOrdered, bool forceInlineWrites,
 								   ExprEvalState *stateForSchemaValidation,
-								   bool isTransactional);
+								   bool isTransactional, bool isAsyncCommit);
+static int GetSetBasedUpdateCount(MongoCollection *collection, List *updates,
+								  int startIndex, text *transactionId,
+								  ExprEvalState *stateForSchemaValidation);
+static bool IsSetBasedUpdateCandidate(UpdateSpec *updateSpec);
+static bool TryUpdateByObjectIds(MongoCollection *collection, List *updates,
+								 int startIndex, int updateCount,
+								 BatchUpdateResult *batchResult);
+static void UpdateByObjectIds(MongoCollection *collection, List *updates,
+							  int startIndex, int updateCount, UpdateResult *results);
+static int FindObjectIdInSortedArray(pgbson **objectIds, int objectIdCount,
+									 pgbson *objectId);
 static pgbson * ProcessBatchUpdateUnsharded(MongoCollection *collection,
 											BatchUpdateSpec *batchSpec,
 											text *transactionId, bool *hasWriteErrors);
@@ -355,6 +399,13 @@ static void UpdateOneObjectId(MongoCollection *collection,
 							  text *transactionId,
 							  UpdateOneResult *result,
 							  ExprEvalState *stateForSchemaValidation);
+static bool CanUpsertDocumentOnConflict(MongoCollection *collection,
+										UpdateOneParams *updateOneParams,
+										ExprEvalState *stateForSchemaValidation);
+static void UpsertDocumentOnConflict(MongoCollection *collection,
+									 UpdateOneParams *updateOneParams,
+									 int64 shardKeyHash, UpdateOneResult *result);
+static bool UpdateSpecHasPositionalPaths(const bson_value_t *update);
 static pgbson * UpsertDocument(MongoCollection *collection, const bson_value_t *update,
 							   const bson_value_t *query, const
 							   bson_value_t *arrayFilters,
@@ -549,6 +600,7 @@ PerformUpdateCore(Datum databaseNameDatum, pgbson *updateSpec,
 		GetMongoCollectionByNameDatum(databaseNameDatum, collectionNameDatum,
 									  RowExclusiveLock);
 	MemoryContextSwitchTo(oldContext);
+	batchResult.trackStatementResults = batchSpec->returnStatementResults;
 
 	Datum values[2];
 	bool isNulls[2] = { false, false };
@@ -610,7 +662,8 @@ PerformUpdateCore(Datum databaseNameDatum, pgbson *updateSpec,
 	 */
 	bool hasWriteErrors = false;
 	pgbson *result = NULL;
-	if (DefaultInlineWriteOperations || !IsUnshardedRemoteCollection(collection))
+	if (DefaultInlineWriteOperations || !IsUnshardedRemoteCollection(collection) ||
+		batchSpec->returnStatementResults)
 	{
 		/* Document validation occurs regardless of whether the validation action is set to error or warn.
 		 * If validation fails and the action is error, an error is thrown; if the action is warn, a warning is logged.
@@ -618,8 +671,7 @@ PerformUpdateCore(Datum databaseNameDatum, pgbson *updateSpec,
 		 */
 		if (CheckSchemaValidationEnabled(collection, batchSpec->bypassDocumentValidation))
 		{
-			state = PrepareForSchemaValidation(collection->schemaValidator.validator,
-											   allocContext);
+			state = PrepareForCollectionSchemaValidation(collection, allocContext);
 		}
 
 		ProcessBatchUpdate(collection, batchSpec, transactionId,
@@ -647,7 +699,7 @@ PerformUpdateCore(Datum databaseNameDatum, pgbson *updateSpec,
 
 	if (EnableSchemaValidation && state != NULL)
 	{
-		FreeExprEvalState(state, allocContext);
+		FreeSchemaValidationState(collection, state, allocContext);
 	}
 
 	values[0] = PointerGetDatum(result);
@@ -741,6 +793,8 @@ BuildBatchUpdateSpec(bson_iter_t *updateCommandIter, pgbsonsequence *updateDocs)
 	const char *collectionName = NULL;
 	bool isOrdered = true;
 	bool bypassDocumentValidation = false;
+	bool returnStatementResults = false;
+	bool isAsyncCommit = false;
 	bool applyVariables = EnableVariablesSupportForWriteCommands &&
 						  IsClusterVersionAtleast(DocDB_V0, 106, 0);
 
@@ -819,14 +873,24 @@ BuildBatchUpdateSpec(bson_iter_t *updateCommandIter, pgbsonsequence *updateDocs)
 								errmsg("update.let is not yet supported")));
 			}
 		}
+		else if (strcmp(field, "writeConcern") == 0)
+		{
+			isAsyncCommit =
+				ApplyWriteConcernDurability(bson_iter_value(updateCommandIter));
+		}
+		else if (strcmp(field, "returnStatementResults") == 0)
+		{
+			EnsureTopLevelFieldType("update.returnStatementResults", updateCommandIter,
+									BSON_TYPE_BOOL);
+
+			returnStatementResults = bson_iter_bool(updateCommandIter);
+		}
 		else if (IsCommonSpecIgnoredField(field))
 		{
 			elog(DEBUG1, "Unrecognized command field: update.%s", field);
 
 			/*
 			 *  Silently ignore now, so that clients don't break
-			 *  TODO: implement me
-			 *      writeConcern
 			 */
 		}
 		else
@@ -849,6 +913,8 @@ BuildBatchUpdateSpec(bson_iter_t *updateCommandIter, pgbsonsequence *updateDocs)
 	batchSpec->updateValue = updateValue;
 	batchSpec->updateSequence = updateDocs;
 	batchSpec->isOrdered = isOrdered;
+	batchSpec->returnStatementResults = returnStatementResults;
+	batchSpec->isAsyncCommit = isAsyncCommit;
 	batchSpec->bypassDocumentValidation = bypassDocumentValidation;
 
 	/* parse and set let and time system variables */
@@ -1077,6 +1143,20 @@ UpdateResultInBatch(BatchUpdateResult *batchResult, UpdateResult *updateResult,
 		batchResult->upserted = lappend(batchResult->upserted, upsertResult);
 		MemoryContextSwitchTo(currentContext);
 	}
+
+	if (batchResult->trackStatementResults)
+	{
+		MemoryContext currentContext = MemoryContextSwitchTo(context);
+		UpdateStatementResult *statementResult = palloc0(sizeof(UpdateStatementResult));
+		statementResult->index = updateIndex;
+		statementResult->rowsMatched = updateResult->rowsMatched +
+									   (updateResult->performedUpsert ? 1 : 0);
+		statementResult->rowsModified = updateResult->rowsModified;
+
+		batchResult->statementResults = lappend(batchResult->statementResults,
+												statementResult);
+		MemoryContextSwitchTo(currentContext);
+	}
 }
 
 
@@ -1104,6 +1184,7 @@ DoMultiUpdate(MongoCollection *collection, List *updates, text *transactionId,
 
 	BatchUpdateResult batchResultInner;
 	memset(&batchResultInner, 0, sizeof(batchResultInner));
+	batchResultInner.trackStatementResults = batchResult->trackStatementResults;
 
 	BeginInternalSubTransaction(NULL);
 
@@ -1137,8 +1218,11 @@ DoMultiUpdate(MongoCollection *collection, List *updates, text *transactionId,
 
 		batchResult->upserted = list_concat(batchResult->upserted,
 											batchResultInner.upserted);
+		batchResult->statementResults = list_concat(batchResult->statementResults,
+													batchResultInner.statementResults);
 		MemoryContextSwitchTo(oldContext);
 		list_free(batchResultInner.upserted);
+		list_free(batchResultInner.statementResults);
 		*recordsUpdated = updateCount;
 	}
 	PG_CATCH();
@@ -1371,7 +1455,8 @@ ProcessBatchUpdateNonTransactionalUnsharded(MongoCollection *collection,
 			bool setSnapshot = false;
 			CommitWriteProcedureAndReacquireCollectionLock(collection,
 														   spec->shardTableOid,
-														   setSnapshot);
+														   setSnapshot,
+														   spec->isAsyncCommit);
 		}
 
 		DoUnshardedMultiUpdateViaUpdateWorker(collection, updates, subTransactionId,
@@ -1391,13 +1476,14 @@ static void
 ProcessBatchUpdateCore(MongoCollection *collection, List *updates, text *transactionId,
 					   BatchUpdateResult *batchResult, bool isOrdered,
 					   bool forceInlineWrites, ExprEvalState *stateForSchemaValidation,
-					   bool isTransactional)
+					   bool isTransactional, bool isAsyncCommit)
 {
 	batchResult->ok = 1;
 	batchResult->rowsMatched = 0;
 	batchResult->rowsModified = 0;
 	batchResult->writeErrors = NIL;
 	batchResult->upserted = NIL;
+	batchResult->statementResults = NIL;
 
 	text *subTransactionId = transactionId;
 	if (list_length(updates) > 1)
@@ -1414,6 +1500,9 @@ ProcessBatchUpdateCore(MongoCollection *collection, List *updates, text *transac
 	int nextBatchAttemptIndex = -1;
 	bool hasBatchUpdateFailed = false;
 
+	/* updates before this index are not run by _id as a set */
+	int perSpecUpdatesEnd = 0;
+
 	ListCell *updateCell = NULL;
 	while (updateIndex < list_length(updates))
 	{
@@ -1424,7 +1513,30 @@ ProcessBatchUpdateCore(MongoCollection *collection, List *updates, text *transac
 			bool setSnapshot = false;
 			Oid shardTableOid = InvalidOid;
 			CommitWriteProcedureAndReacquireCollectionLock(collection, shardTableOid,
-														   setSnapshot);
+														   setSnapshot, isAsyncCommit);
+		}
+
+		if (EnableSetBasedUpdateById && updateIndex >= perSpecUpdatesEnd)
+		{
+			int setBasedCount = GetSetBasedUpdateCount(collection, updates,
+													   updateIndex, subTransactionId,
+													   stateForSchemaValidation);
+			if (setBasedCount > 1)
+			{
+				if (TryUpdateByObjectIds(collection, updates, updateIndex,
+										 setBasedCount, batchResult))
+				{
+					updateIndex += setBasedCount;
+					continue;
+				}
+
+				/*
+				 * Nothing was updated by the failed statements: run the same
+				 * updates through the regular path so that the error is
+				 * reported for the right update and ordered batches stop there.
+				 */
+				perSpecUpdatesEnd = updateIndex + setBasedCount;
+			}
 		}
 
 		bool isSuccess = false;
@@ -1474,6 +1586,371 @@ ProcessBatchUpdateCore(MongoCollection *collection, List *updates, text *transac
 }
 
 
+/*
+ * GetSetBasedUpdateCount returns the number of consecutive updates starting
+ * at startIndex that can be executed together by UpdateByObjectIds, capped
+ * at the number of updates committed together by a batch.
+ */
+static int
+GetSetBasedUpdateCount(MongoCollection *collection, List *updates, int startIndex,
+					   text *transactionId, ExprEvalState *stateForSchemaValidation)
+{
+	if (collection->shardKey != NULL || transactionId != NULL ||
+		stateForSchemaValidation != NULL)
+	{
+		/*
+		 * Documents with the given _id values may live on any shard, retryable
+		 * updates record their own result and validation needs the per
+		 * document checks of UpdateOneInternal.
+		 */
+		return 0;
+	}
+
+	int updateCount = 0;
+	for (int i = startIndex; i < list_length(updates) &&
+		 updateCount < BatchWriteSubTransactionCount; i++)
+	{
+		if (!IsSetBasedUpdateCandidate(list_nth(updates, i)))
+		{
+			break;
+		}
+
+		updateCount++;
+	}
+
+	return updateCount;
+}
+
+
+/*
+ * IsSetBasedUpdateCandidate returns whether the update modifies at most the
+ * document with a single _id value, without upserting or returning it. Since
+ * _id is unique within an unsharded collection, the update then applies to the
+ * document that SELECT .. WHERE object_id = ANY(..) returns for its _id.
+ */
+static bool
+IsSetBasedUpdateCandidate(UpdateSpec *updateSpec)
+{
+	UpdateOneParams *updateOneParams = &updateSpec->updateOneParams;
+	if (updateSpec->isMulti || updateOneParams->isUpsert ||
+		updateOneParams->sort != NULL ||
+		updateOneParams->returnDocument != UPDATE_RETURNS_NONE ||
+		updateOneParams->returnFields != NULL ||
+		updateOneParams->skipLockedCandidates)
+	{
+		return false;
+	}
+
+	bson_iter_t queryIterator;
+	BsonValueInitIterator(updateOneParams->query, &queryIterator);
+
+	bson_value_t idValue = { 0 };
+	bool errorOnConflict = false;
+	bool queryHasNonIdFilters = false;
+	bool isIdValueCollationAware = false;
+	bool hasObjectIdFilter =
+		TraverseQueryDocumentAndGetId(&queryIterator, &idValue, errorOnConflict,
+									  &queryHasNonIdFilters, &isIdValueCollationAware);
+
+	return hasObjectIdFilter && !queryHasNonIdFilters;
+}
+
+
+/*
+ * TryUpdateByObjectIds runs UpdateByObjectIds in a subtransaction and adds the
+ * result of each update to batchResult if it succeeded. On failure, none of
+ * the updates took effect and the caller is expected to run them one by one.
+ */
+static bool
+TryUpdateByObjectIds(MongoCollection *collection, List *updates, int startIndex,
+					 int updateCount, BatchUpdateResult *batchResult)
+{
+	MemoryContext oldContext = CurrentMemoryContext;
+	ResourceOwner oldOwner = CurrentResourceOwner;
+
+	/* declared volatile because of the longjmp in PG_CATCH */
+	volatile bool isSuccess = false;
+
+	UpdateResult *results = palloc0(sizeof(UpdateResult) * updateCount);
+
+	BeginInternalSubTransaction(NULL);
+
+	PG_TRY();
+	{
+		UpdateByObjectIds(collection, updates, startIndex, updateCount, results);
+		ReportFeatureUsage(FEATURE_USAGE_SET_BASED_UPDATE_BY_ID);
+
+		/* Commit the inner transaction, return to outer xact context */
+		ReleaseCurrentSubTransaction();
+		MemoryContextSwitchTo(oldContext);
+		CurrentResourceOwner = oldOwner;
+
+		isSuccess = true;
+	}
+	PG_CATCH();
+	{
+		MemoryContextSwitchTo(oldContext);
+		ErrorData *errorData = CopyErrorDataAndFlush();
+
+		/* Abort inner transaction */
+		RollbackAndReleaseCurrentSubTransaction();
+		MemoryContextSwitchTo(oldContext);
+		CurrentResourceOwner = oldOwner;
+
+		if (IsOperatorInterventionError(errorData))
+		{
+			ReThrowError(errorData);
+		}
+
+		FreeErrorData(errorData);
+	}
+	PG_END_TRY();
+
+	if (isSuccess)
+	{
+		for (int i = 0; i < updateCount; i++)
+		{
+			UpdateResultInBatch(batchResult, &results[i],
+								batchResult->resultMemoryContext, startIndex + i);
+		}
+	}
+
+	pfree(results);
+	return isSuccess;
+}
+
+
+/*
+ * UpdateByObjectIds applies updateCount updates starting at startIndex with
+ * two statements instead of one SELECT and one UPDATE (and one subtransaction)
+ * per update. All the updates must satisfy IsSetBasedUpdateCandidate.
+ *
+ * The documents of all the _id values are selected (and locked) at once, the
+ * updates are applied in order to their document, and the documents that
+ * changed are written back with a single UPDATE. A document whose _id appears
+ * in several updates gets each of them in turn, as it would by running the
+ * updates one after the other.
+ *
+ * The result of each update is written to the matching entry of results.
+ */
+static void
+UpdateByObjectIds(MongoCollection *collection, List *updates, int startIndex,
+				  int updateCount, UpdateResult *results)
+{
+	SPI_connect();
+
+	/* Do these under the SPI Context so that they get deleted automatically at the end */
+	pgbson **objectIdFilters = palloc(sizeof(pgbson *) * updateCount);
+	Datum *objectIdDatums = palloc(sizeof(Datum) * updateCount);
+	for (int i = 0; i < updateCount; i++)
+	{
+		UpdateSpec *updateSpec = list_nth(updates, startIndex + i);
+
+		bool queryHasNonIdFilters = false;
+		bool isIdFilterCollationAware = false;
+		objectIdFilters[i] =
+			GetObjectIdFilterFromQueryDocumentValue(updateSpec->updateOneParams.query,
+													&queryHasNonIdFilters,
+													&isIdFilterCollationAware);
+		Assert(objectIdFilters[i] != NULL && !queryHasNonIdFilters);
+
+		objectIdDatums[i] = PointerGetDatum(objectIdFilters[i]);
+	}
+
+	const char *tableName = NULL;
+	if (collection->shardTableName[0] != '\0')
+	{
+		tableName = collection->shardTableName;
+	}
+	else
+	{
+		tableName = psprintf("documents_" UINT64_FORMAT, collection->collectionId);
+	}
+
+	/*
+	 * Lock the documents in object_id order so that the document of each
+	 * update can be found by a binary search on the same ordering as the
+	 * object_id equality used to select them.
+	 */
+	StringInfoData selectQuery;
+	initStringInfo(&selectQuery);
+	appendStringInfo(&selectQuery,
+					 "SELECT object_id, document FROM %s.%s"
+					 " WHERE shard_key_value = $1"
+					 " AND object_id OPERATOR(%s.=) ANY($2::%s[])"
+					 " ORDER BY object_id FOR UPDATE",
+					 ApiDataSchemaName, tableName, CoreSchemaName, FullBsonTypeName);
+
+	int argCount = 2;
+	Oid selectArgTypes[2] = { INT8OID, GetBsonArrayTypeOid() };
+
+	/* since this is unsharded, the shard key value is the collection id */
+	Datum selectArgValues[2] = {
+		Int64GetDatum(collection->collectionId),
+		PointerGetDatum(construct_array(objectIdDatums, updateCount, BsonTypeId(),
+										-1, false, TYPALIGN_INT))
+	};
+	char argNulls[2] = { ' ', ' ' };
+
+	bool readOnly = false;
+	long maxTupleCount = 0;
+	SPIPlanPtr plan = GetSPIQueryPlanWithLocalShard(collection->collectionId,
+													collection->shardTableName,
+													QUERY_UPDATE_SELECT_BY_OBJECT_ID_ARRAY,
+													selectQuery.data, selectArgTypes,
+													argCount);
+
+	SPI_execute_plan(plan, selectArgValues, argNulls, readOnly, maxTupleCount);
+
+	int documentCount = (int) SPI_processed;
+	pgbson **objectIds = palloc(sizeof(pgbson *) * Max(documentCount, 1));
+	pgbson **documents = palloc(sizeof(pgbson *) * Max(documentCount, 1));
+	bool *isDocumentUpdated = palloc0(sizeof(bool) * Max(documentCount, 1));
+	for (int rowIndex = 0; rowIndex < documentCount; rowIndex++)
+	{
+		bool isNull = false;
+		Datum objectIdDatum = SPI_getbinval(SPI_tuptable->vals[rowIndex],
+											SPI_tuptable->tupdesc, 1, &isNull);
+		Assert(!isNull);
+		objectIds[rowIndex] = DatumGetPgBson(objectIdDatum);
+
+		Datum documentDatum = SPI_getbinval(SPI_tuptable->vals[rowIndex],
+											SPI_tuptable->tupdesc, 2, &isNull);
+		Assert(!isNull);
+		documents[rowIndex] = DatumGetPgBson(documentDatum);
+	}
+
+	int updatedDocumentCount = 0;
+	for (int i = 0; i < updateCount; i++)
+	{
+		UpdateSpec *updateSpec = list_nth(updates, startIndex + i);
+		UpdateOneParams *updateOneParams = &updateSpec->updateOneParams;
+
+		results[i].rowsMatched = 0;
+		results[i].rowsModified = 0;
+		results[i].performedUpsert = false;
+		results[i].upsertedObjectId = NULL;
+
+		int documentIndex = FindObjectIdInSortedArray(objectIds, documentCount,
+													  objectIdFilters[i]);
+		if (documentIndex < 0)
+		{
+			/* still report errors due to invalid update documents */
+			ValidateUpdateDocument(updateOneParams->update, updateOneParams->query,
+								   updateOneParams->arrayFilters,
+								   updateOneParams->variableSpec);
+			continue;
+		}
+
+		/* returns NULL if the update is a no-op on the current document */
+		pgbson *updatedDocument = BsonUpdateDocument(documents[documentIndex],
+													 updateOneParams->update,
+													 updateOneParams->query,
+													 updateOneParams->arrayFilters,
+													 updateOneParams->variableSpec);
+
+		results[i].rowsMatched = 1;
+		if (updatedDocument != NULL)
+		{
+			results[i].rowsModified = 1;
+			documents[documentIndex] = updatedDocument;
+
+			if (!isDocumentUpdated[documentIndex])
+			{
+				isDocumentUpdated[documentIndex] = true;
+				updatedDocumentCount++;
+			}
+		}
+	}
+
+	if (updatedDocumentCount > 0)
+	{
+		Datum *updatedObjectIdDatums = palloc(sizeof(Datum) * updatedDocumentCount);
+		Datum *updatedDocumentDatums = palloc(sizeof(Datum) * updatedDocumentCount);
+
+		int updatedIndex = 0;
+		for (int documentIndex = 0; documentIndex < documentCount; documentIndex++)
+		{
+			if (isDocumentUpdated[documentIndex])
+			{
+				updatedObjectIdDatums[updatedIndex] =
+					PointerGetDatum(objectIds[documentIndex]);
+				updatedDocumentDatums[updatedIndex] =
+					PointerGetDatum(documents[documentIndex]);
+				updatedIndex++;
+			}
+		}
+
+		StringInfoData updateQuery;
+		initStringInfo(&updateQuery);
+		appendStringInfo(&updateQuery,
+						 "UPDATE %s.%s SET document = v.document"
+						 " FROM unnest($2::%s[], $3::%s[]) AS v(object_id, document)"
+						 " WHERE %s.%s.shard_key_value = $1"
+						 " AND %s.%s.object_id OPERATOR(%s.=) v.object_id",
+						 ApiDataSchemaName, tableName, FullBsonTypeName,
+						 FullBsonTypeName, ApiDataSchemaName, tableName,
+						 ApiDataSchemaName, tableName, CoreSchemaName);
+
+		argCount = 3;
+		Oid updateArgTypes[3] = {
+			INT8OID, GetBsonArrayTypeOid(), GetBsonArrayTypeOid()
+		};
+		Datum updateArgValues[3] = {
+			Int64GetDatum(collection->collectionId),
+			PointerGetDatum(construct_array(updatedObjectIdDatums, updatedDocumentCount,
+											BsonTypeId(), -1, false, TYPALIGN_INT)),
+			PointerGetDatum(construct_array(updatedDocumentDatums, updatedDocumentCount,
+											BsonTypeId(), -1, false, TYPALIGN_INT))
+		};
+		char updateArgNulls[3] = { ' ', ' ', ' ' };
+
+		plan = GetSPIQueryPlanWithLocalShard(collection->collectionId,
+											 collection->shardTableName,
+											 QUERY_UPDATE_BY_OBJECT_ID_ARRAY,
+											 updateQuery.data, updateArgTypes,
+											 argCount);
+
+		SPI_execute_plan(plan, updateArgValues, updateArgNulls, readOnly,
+						 maxTupleCount);
+		Assert(SPI_processed == (uint64) updatedDocumentCount);
+	}
+
+	SPI_finish();
+}
+
+
+/*
+ * FindObjectIdInSortedArray returns the index of objectId in objectIds, which
+ * is sorted by ComparePgbson, or -1 if it is not there.
+ */
+static int
+FindObjectIdInSortedArray(pgbson **objectIds, int objectIdCount, pgbson *objectId)
+{
+	int low = 0;
+	int high = objectIdCount - 1;
+	while (low <= high)
+	{
+		int middle = low + (high - low) / 2;
+		int compareResult = ComparePgbson(objectIds[middle], objectId);
+		if (compareResult == 0)
+		{
+			return middle;
+		}
+		else if (compareResult < 0)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle - 1;
+		}
+	}
+
+	return -1;
+}
+
+
 /*
  * ProcessBatchUpdate iterates over the updates array and executes each
  * update in a subtransaction, to allow us to continue after an error.
@@ -1484,6 +1961,9 @@ ProcessBatchUpdateCore(MongoCollection *collection, List *updates, text *transac
  * Using subtransactions is slightly different from Mongo, which effectively
  * does each update operation in a separate transaction, but it has roughly
  * the same overall UX.
+ *
+ * With documentdb.enableSetBasedUpdateById, consecutive updates by _id are
+ * run together in a single subtransaction (see UpdateByObjectIds).
  */
 static void
 ProcessBatchUpdate(MongoCollection *collection, BatchUpdateSpec *batchSpec,
@@ -1512,7 +1992,7 @@ ProcessBatchUpdate(MongoCollection *collection, BatchUpdateSpec *batchSpec,
 	bool forceInlineWrites = false;
 	ProcessBatchUpdateCore(collection, updates, transactionId, batchResult, isOrdered,
 						   forceInlineWrites, stateForSchemaValidation,
-						   isTransactional);
+						   isTransactional, batchSpec->isAsyncCommit);
 }
 
 
@@ -2393,9 +2873,8 @@ command_update_worker(PG_FUNCTION_ARGS)
 
 	if (CheckSchemaValidationEnabled(mongoCollection, params.bypassDocumentValidation))
 	{
-		stateForSchemaValidation = PrepareForSchemaValidation(
-			mongoCollection->schemaValidator.validator,
-			CurrentMemoryContext);
+		stateForSchemaValidation = PrepareForCollectionSchemaValidation(
+			mongoCollection, CurrentMemoryContext);
 	}
 
 	if (params.isUpdateOne)
@@ -2422,7 +2901,8 @@ command_update_worker(PG_FUNCTION_ARGS)
 
 		if (EnableSchemaValidation && stateForSchemaValidation != NULL)
 		{
-			FreeExprEvalState(stateForSchemaValidation, CurrentMemoryContext);
+			FreeSchemaValidationState(mongoCollection, stateForSchemaValidation,
+									  CurrentMemoryContext);
 		}
 
 		PG_RETURN_POINTER(serializedResult);
@@ -2452,7 +2932,8 @@ command_update_worker(PG_FUNCTION_ARGS)
 
 	if (EnableSchemaValidation && stateForSchemaValidation != NULL)
 	{
-		FreeExprEvalState(stateForSchemaValidation, CurrentMemoryContext);
+		FreeSchemaValidationState(mongoCollection, stateForSchemaValidation,
+								  CurrentMemoryContext);
 	}
 
 	PG_RETURN_POINTER(result);
@@ -2489,9 +2970,10 @@ ProcessUnshardedUpdateBatchWorker(MongoCollection *collection, List *updates,
 
 	/* In the worker we're always transactional */
 	bool isTransactional = true;
+	bool isAsyncCommit = false;
 	ProcessBatchUpdateCore(collection, updates, transactionId, &batchUpdateResult,
 						   isOrdered, forceInlineWrites, stateForSchemaValidation,
-						   isTransactional);
+						   isTransactional, isAsyncCommit);
 
 	return SerializeBatchUpdateResult(&batchUpdateResult);
 }
@@ -2655,6 +3137,11 @@ SerializeUpdateOneParams(UpdateOneParams *params, pgbson *shardKeyBson)
 	PgbsonWriterAppendBool(&writer, "bypassDocumentValidation", -1,
 						   params->bypassDocumentValidation);
 
+	if (params->skipLockedCandidates)
+	{
+		PgbsonWriterAppendBool(&writer, "skipLockedCandidates", -1, true);
+	}
+
 	if (params->sort != NULL)
 	{
 		PgbsonWriterAppendValue(&writer, "sort", 4, params->sort);
@@ -2847,6 +3334,10 @@ DeserializeUpdateWorkerSpec(pgbson *updateInternalSpec,
 			updateOneParams->variableSpec = CreateBsonValueCopy(bson_iter_value(
 																	&internalIter));
 		}
+		else if (strcmp(key, "skipLockedCandidates") == 0)
+		{
+			updateOneParams->skipLockedCandidates = bson_iter_bool(&internalIter);
+		}
 	}
 }
 
@@ -3117,6 +3608,14 @@ UpdateOneInternal(MongoCollection *collection, UpdateOneParams *updateOneParams,
 	result->resultDocument = NULL;
 	result->upsertedObjectId = NULL;
 
+	if (EnableUpsertOnConflict &&
+		CanUpsertDocumentOnConflict(collection, updateOneParams,
+									stateForSchemaValidation))
+	{
+		UpsertDocumentOnConflict(collection, updateOneParams, shardKeyHash, result);
+		return;
+	}
+
 	UpdateCandidate updateCandidate = { 0 };
 
 	bool getExistingDoc = updateOneParams->returnDocument != UPDATE_RETURNS_NONE ||
@@ -3484,6 +3983,21 @@ SelectUpdateCandidate(MongoCollection *collection, int64 shardKeyHash,
 	appendStringInfo(&updateQuery,
 					 " LIMIT 1 FOR UPDATE");
 
+	if (updateOneParams->skipLockedCandidates)
+	{
+		/*
+		 * Move on to the next matching document rather than waiting for the
+		 * transaction that holds the lock on this one. Concurrent callers
+		 * selecting from the same set of documents (e.g. a queue) then each
+		 * get a different document instead of serializing on the first.
+		 */
+		appendStringInfo(&updateQuery, " SKIP LOCKED");
+		if (planId != 0)
+		{
+			planId += QUERY_VARIANT_SKIP_LOCKED;
+		}
+	}
+
 	bool readOnly = false;
 	long maxTupleCount = 1;
 
@@ -3775,6 +4289,145 @@ UpdateOneObjectId(MongoCollection *collection, UpdateOneParams *updateOneParams,
 }
 
 
+/*
+ * Whether an upsert can skip the search for a matching document and run as a
+ * single insert that updates the existing document on conflict with the _id
+ * index (see UpsertDocumentOnConflict).
+ *
+ * This requires the query to only filter on _id, so that a conflict is
+ * equivalent to a match, and the update to apply both to an empty document
+ * and to the existing document, since the document to insert is built before
+ * knowing whether there is one. Upserts that need the existing document
+ * (returned documents, schema validation) or that may move it to another
+ * shard keep the regular path.
+ */
+static bool
+CanUpsertDocumentOnConflict(MongoCollection *collection,
+							UpdateOneParams *updateOneParams,
+							ExprEvalState *stateForSchemaValidation)
+{
+	if (!updateOneParams->isUpsert ||
+		updateOneParams->returnDocument != UPDATE_RETURNS_NONE ||
+		updateOneParams->returnFields != NULL ||
+		updateOneParams->sort != NULL ||
+		updateOneParams->arrayFilters != NULL ||
+		updateOneParams->variableSpec != NULL ||
+		updateOneParams->skipLockedCandidates)
+	{
+		return false;
+	}
+
+	if (collection->shardKey != NULL ||
+		(EnableSchemaValidation && stateForSchemaValidation != NULL))
+	{
+		return false;
+	}
+
+	if (!EnableUpdateBsonDocument || !IsClusterVersionAtleast(DocDB_V0, 109, 0))
+	{
+		return false;
+	}
+
+	bool queryHasNonIdFilters = false;
+	bool isIdFilterCollationAwareIgnore = false;
+	pgbson *objectIdFilter =
+		GetObjectIdFilterFromQueryDocumentValue(updateOneParams->query,
+												&queryHasNonIdFilters,
+												&isIdFilterCollationAwareIgnore);
+	if (objectIdFilter == NULL || queryHasNonIdFilters)
+	{
+		return false;
+	}
+
+	/* positional paths need an existing array and fail on the empty document */
+	return !UpdateSpecHasPositionalPaths(updateOneParams->update);
+}
+
+
+/*
+ * UpsertDocumentOnConflict builds the document to upsert and inserts it in a
+ * single statement that applies the update to the existing document with the
+ * same _id on conflict. Concurrent upserts of the same _id serialize on the
+ * _id index instead of searching, failing on the unique violation, and being
+ * retried.
+ */
+static void
+UpsertDocumentOnConflict(MongoCollection *collection, UpdateOneParams *updateOneParams,
+						 int64 shardKeyHash, UpdateOneResult *result)
+{
+	pgbson *emptyDocument = PgbsonInitEmpty();
+	pgbson *newDoc = BsonUpdateDocument(emptyDocument, updateOneParams->update,
+										updateOneParams->query,
+										updateOneParams->arrayFilters,
+										updateOneParams->variableSpec);
+
+	pgbson *objectId = PgbsonGetDocumentId(newDoc);
+
+	InsertOrUpdateResult upsertResult =
+		InsertOrUpdateDocument(collection->collectionId, collection->shardTableName,
+							   shardKeyHash, objectId, newDoc,
+							   updateOneParams->update, updateOneParams->query);
+
+	switch (upsertResult)
+	{
+		case INSERT_OR_UPDATE_INSERTED:
+		{
+			result->upsertedObjectId = objectId;
+			break;
+		}
+
+		case INSERT_OR_UPDATE_UPDATED:
+		{
+			result->isRowUpdated = true;
+			break;
+		}
+
+		case INSERT_OR_UPDATE_UNCHANGED:
+		{
+			result->updateSkipped = true;
+			break;
+		}
+	}
+}
+
+
+/*
+ * Whether an operator style update spec has a path with a positional
+ * ($, $[] or $[<identifier>]) component.
+ */
+static bool
+UpdateSpecHasPositionalPaths(const bson_value_t *update)
+{
+	if (DetermineUpdateType(update) != UpdateType_Operator)
+	{
+		return false;
+	}
+
+	bson_iter_t updateIter;
+	BsonValueInitIterator(update, &updateIter);
+	while (bson_iter_next(&updateIter))
+	{
+		bson_iter_t operatorIter;
+		if (!BSON_ITER_HOLDS_DOCUMENT(&updateIter) ||
+			!bson_iter_recurse(&updateIter, &operatorIter))
+		{
+			continue;
+		}
+
+		while (bson_iter_next(&operatorIter))
+		{
+			const char *path = bson_iter_key(&operatorIter);
+			if (strncmp(path, "$", 1) == 0 || strstr(path, ".$") != NULL)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+
 /*
  * UpsertDocument performs an insert when an update did not match any rows
  * and returns the inserted object ID.
@@ -3940,6 +4593,32 @@ BuildResponseMessage(BatchUpdateResult *batchResult)
 		PgbsonWriterEndArray(&resultWriter, &writeErrorsArrayWriter);
 	}
 
+	if (batchResult->trackStatementResults)
+	{
+		pgbson_array_writer statementResultsWriter;
+		PgbsonWriterStartArray(&resultWriter, "statementResults", 16,
+							   &statementResultsWriter);
+
+		ListCell *statementResultCell = NULL;
+		foreach(statementResultCell, batchResult->statementResults)
+		{
+			UpdateStatementResult *statementResult = lfirst(statementResultCell);
+
+			pgbson_writer statementResultWriter;
+			PgbsonArrayWriterStartDocument(&statementResultsWriter,
+										   &statementResultWriter);
+			PgbsonWriterAppendInt32(&statementResultWriter, "index", 5,
+									statementResult->index);
+			PgbsonWriterAppendInt(&statementResultWriter, "n", 1,
+								  statementResult->rowsMatched);
+			PgbsonWriterAppendInt(&statementResultWriter, "nModified", 9,
+								  statementResult->rowsModified);
+			PgbsonArrayWriterEndDocument(&statementResultsWriter, &statementResultWriter);
+		}
+
+		PgbsonWriterEndArray(&resultWriter, &statementResultsWriter);
+	}
+
 	return PgbsonWriterGetPgbson(&resultWriter);
 }
 
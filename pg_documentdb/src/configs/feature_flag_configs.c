@@ -26,6 +26,9 @@ bool EnableSchemaValidation =
 bool EnableBypassDocumentValidation =
 	DEFAULT_ENABLE_BYPASSDOCUMENTVALIDATION;
 
+#define DEFAULT_ENABLE_SCHEMA_VALIDATOR_CACHE false
+bool EnableSchemaValidatorCache = DEFAULT_ENABLE_SCHEMA_VALIDATOR_CACHE;
+
 #define DEFAULT_ENABLE_USERNAME_PASSWORD_CONSTRAINTS true
 bool EnableUsernamePasswordConstraints = DEFAULT_ENABLE_USERNAME_PASSWORD_CONSTRAINTS;
 
@@ -94,6 +97,13 @@ bool EnableIndexOrderByReverse = DEFAULT_ENABLE_INDEX_ORDERBY_REVERSE;
 #define DEFAULT_ENABLE_INDEX_ONLY_SCAN false
 bool EnableIndexOnlyScan = DEFAULT_ENABLE_INDEX_ONLY_SCAN;
 
+#define DEFAULT_ENABLE_COVERED_PROJECTION_INDEX_ONLY_SCAN false
+bool EnableCoveredProjectionIndexOnlyScan =
+	DEFAULT_ENABLE_COVERED_PROJECTION_INDEX_ONLY_SCAN;
+
+#define DEFAULT_ENABLE_SINGLE_PATH_INDEX_ONLY_SCAN false
+bool EnableSinglePathIndexOnlyScan = DEFAULT_ENABLE_SINGLE_PATH_INDEX_ONLY_SCAN;
+
 #define DEFAULT_ENABLE_ID_INDEX_CUSTOM_COST_FUNCTION true
 bool EnableIdIndexCustomCostFunction = DEFAULT_ENABLE_ID_INDEX_CUSTOM_COST_FUNCTION;
 
@@ -103,6 +113,12 @@ bool EnableOrderByIdOnCostFunction = DEFAULT_ENABLE_ORDER_BY_ID_ON_COST;
 #define DEFAULT_ENABLE_COMPOSITE_PARALLEL_INDEX_SCAN false
 bool EnableCompositeParallelIndexScan = DEFAULT_ENABLE_COMPOSITE_PARALLEL_INDEX_SCAN;
 
+#define DEFAULT_ENABLE_SINGLE_PATH_PARALLEL_INDEX_SCAN false
+bool EnableSinglePathParallelIndexScan = DEFAULT_ENABLE_SINGLE_PATH_PARALLEL_INDEX_SCAN;
+
+#define DEFAULT_ENABLE_RESUMABLE_INDEX_BUILD false
+bool EnableResumableIndexBuild = DEFAULT_ENABLE_RESUMABLE_INDEX_BUILD;
+
 /* Note: this is a long term feature flag since we need to validate compatiblity
  * in mixed mode for older indexes - once this is
  * enabled by default - please move this to testing_configs.
@@ -110,6 +126,13 @@ bool EnableCompositeParallelIndexScan = DEFAULT_ENABLE_COMPOSITE_PARALLEL_INDEX_
 #define DEFAULT_ENABLE_VALUE_ONLY_INDEX_TERMS true
 bool EnableValueOnlyIndexTerms = DEFAULT_ENABLE_VALUE_ONLY_INDEX_TERMS;
 
+/* Note: Like value only terms, this only affects indexes created while it is
+ * enabled since the elided prefix is persisted in the index options.
+ */
+#define DEFAULT_ENABLE_WILDCARD_PROJECTION_PATH_PREFIX_ELISION false
+bool EnableWildcardProjectionPathPrefixElision =
+	DEFAULT_ENABLE_WILDCARD_PROJECTION_PATH_PREFIX_ELISION;
+
 #define DEFAULT_USE_NEW_UNIQUE_HASH_EQUALITY_FUNCTION true
 bool UseNewUniqueHashEqualityFunction = DEFAULT_USE_NEW_UNIQUE_HASH_EQUALITY_FUNCTION;
 
@@ -157,6 +180,24 @@ bool EnableUnifyPfeOnIndexInfo = DEFAULT_ENABLE_UNIFY_PFE_ON_INDEXINFO;
 #define DEFAULT_ENABLE_UPDATE_BSON_DOCUMENT true
 bool EnableUpdateBsonDocument = DEFAULT_ENABLE_UPDATE_BSON_DOCUMENT;
 
+#define DEFAULT_ENABLE_SET_BASED_DELETE_BY_ID false
+bool EnableSetBasedDeleteById = DEFAULT_ENABLE_SET_BASED_DELETE_BY_ID;
+
+#define DEFAULT_ENABLE_SET_BASED_UPDATE_BY_ID false
+bool EnableSetBasedUpdateById = DEFAULT_ENABLE_SET_BASED_UPDATE_BY_ID;
+
+#define DEFAULT_ENABLE_FIND_AND_MODIFY_SKIP_LOCKED false
+bool EnableFindAndModifySkipLocked = DEFAULT_ENABLE_FIND_AND_MODIFY_SKIP_LOCKED;
+
+#define DEFAULT_ENABLE_UPDATE_IN_PLACE_PATCH false
+bool EnableUpdateInPlacePatch = DEFAULT_ENABLE_UPDATE_IN_PLACE_PATCH;
+
+#define DEFAULT_ENABLE_UPSERT_ON_CONFLICT false
+bool EnableUpsertOnConflict = DEFAULT_ENABLE_UPSERT_ON_CONFLICT;
+
+#define DEFAULT_ENABLE_DIRECT_MULTI_INSERT false
+bool EnableDirectMultiInsert = DEFAULT_ENABLE_DIRECT_MULTI_INSERT;
+
 #define DEFAULT_ENABLE_NEW_COUNT_AGGREGATES true
 bool EnableNewCountAggregates = DEFAULT_ENABLE_NEW_COUNT_AGGREGATES;
 
@@ -180,6 +221,21 @@ bool EnableConversionStreamableToSingleBatch =
 #define DEFAULT_ENABLE_FIND_PROJECTION_AFTER_OFFSET true
 bool EnableFindProjectionAfterOffset = DEFAULT_ENABLE_FIND_PROJECTION_AFTER_OFFSET;
 
+#define DEFAULT_ENABLE_STREAMING_UNWIND true
+bool EnableStreamingUnwind = DEFAULT_ENABLE_STREAMING_UNWIND;
+
+#define DEFAULT_ENABLE_FILTERED_SAMPLE_SCAN false
+bool EnableFilteredSampleScan = DEFAULT_ENABLE_FILTERED_SAMPLE_SCAN;
+
+#define DEFAULT_ENABLE_APPROXIMATE_BUCKET_AUTO false
+bool EnableApproximateBucketAuto = DEFAULT_ENABLE_APPROXIMATE_BUCKET_AUTO;
+
+#define DEFAULT_ENABLE_OUT_STAGE_BULK_LOAD false
+bool EnableOutStageBulkLoad = DEFAULT_ENABLE_OUT_STAGE_BULK_LOAD;
+
+#define DEFAULT_ENABLE_DISTINCT_INDEX_TERM_SCAN false
+bool EnableDistinctIndexTermScan = DEFAULT_ENABLE_DISTINCT_INDEX_TERM_SCAN;
+
 /* Remove after v109 */
 #define DEFAULT_ENABLE_DELAYED_HOLD_PORTAL true
 bool EnableDelayedHoldPortal = DEFAULT_ENABLE_DELAYED_HOLD_PORTAL;
@@ -243,6 +299,13 @@ bool RecreateRetryTableOnSharding = DEFAULT_RECREATE_RETRY_TABLE_ON_SHARDING;
 bool EnableDataTableWithoutCreationTime =
 	DEFAULT_ENABLE_DATA_TABLES_WITHOUT_CREATION_TIME;
 
+#define DEFAULT_ENABLE_RETRY_TABLE_WITHOUT_OBJECT_ID_INDEX false
+bool EnableRetryTableWithoutObjectIdIndex =
+	DEFAULT_ENABLE_RETRY_TABLE_WITHOUT_OBJECT_ID_INDEX;
+
+#define DEFAULT_ENABLE_INDEX_KEY_COLUMN false
+bool EnableIndexKeyColumn = DEFAULT_ENABLE_INDEX_KEY_COLUMN;
+
 #define DEFAULT_ENABLE_SCHEMA_ENFORCEMENT_FOR_CSFLE true
 bool EnableSchemaEnforcementForCSFLE = DEFAULT_ENABLE_SCHEMA_ENFORCEMENT_FOR_CSFLE;
 
@@ -356,6 +419,13 @@ InitializeFeatureFlagConfigurations(const char *prefix, const char *newGucPrefix
 		0,
 		NULL, NULL, NULL);
 
+	DefineCustomBoolVariable(
+		psprintf("%s.enableSchemaValidatorCache", newGucPrefix),
+		gettext_noop(
+			"Whether or not to cache the compiled schema validator of a collection across commands."),
+		NULL, &EnableSchemaValidatorCache, DEFAULT_ENABLE_SCHEMA_VALIDATOR_CACHE,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
 	DefineCustomBoolVariable(
 		psprintf("%s.recreate_retry_table_on_shard", prefix),
 		gettext_noop(
@@ -434,6 +504,23 @@ InitializeFeatureFlagConfigurations(const char *prefix, const char *newGucPrefix
 		DEFAULT_ENABLE_DATA_TABLES_WITHOUT_CREATION_TIME,
 		PGC_USERSET, 0, NULL, NULL, NULL);
 
+	DefineCustomBoolVariable(
+		psprintf("%s.enableRetryTableWithoutObjectIdIndex", newGucPrefix),
+		gettext_noop(
+			"Create retry table without the index on object_id."),
+		NULL, &EnableRetryTableWithoutObjectIdIndex,
+		DEFAULT_ENABLE_RETRY_TABLE_WITHOUT_OBJECT_ID_INDEX,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
+	DefineCustomBoolVariable(
+		psprintf("%s.enableIndexKeyColumn", newGucPrefix),
+		gettext_noop(
+			"Allow creating collections whose indexes are built on a separate column "
+			"holding the fields given in indexKeyFields."),
+		NULL, &EnableIndexKeyColumn,
+		DEFAULT_ENABLE_INDEX_KEY_COLUMN,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
 	DefineCustomBoolVariable(
 		psprintf("%s.useFileBasedPersistedCursors", newGucPrefix),
 		gettext_noop(
@@ -549,6 +636,48 @@ InitializeFeatureFlagConfigurations(const char *prefix, const char *newGucPrefix
 		DEFAULT_ENABLE_FIND_PROJECTION_AFTER_OFFSET,
 		PGC_USERSET, 0, NULL, NULL, NULL);
 
+	DefineCustomBoolVariable(
+		psprintf("%s.enableStreamingUnwind", newGucPrefix),
+		gettext_noop(
+			"Whether to return $unwind results one value per call instead of materializing them per document."),
+		NULL, &EnableStreamingUnwind,
+		DEFAULT_ENABLE_STREAMING_UNWIND,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
+	DefineCustomBoolVariable(
+		psprintf("%s.enableFilteredSampleScan", newGucPrefix),
+		gettext_noop(
+			"Whether to sample random blocks and stop early for $sample following a $match on the base collection."),
+		NULL, &EnableFilteredSampleScan,
+		DEFAULT_ENABLE_FILTERED_SAMPLE_SCAN,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
+	DefineCustomBoolVariable(
+		psprintf("%s.enableApproximateBucketAuto", newGucPrefix),
+		gettext_noop(
+			"Whether to compute numeric and date $bucketAuto boundaries approximately with a t-digest instead of sorting the input."),
+		NULL, &EnableApproximateBucketAuto,
+		DEFAULT_ENABLE_APPROXIMATE_BUCKET_AUTO,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
+	DefineCustomBoolVariable(
+		psprintf("%s.enableOutStageBulkLoad", newGucPrefix),
+		gettext_noop(
+			"Whether $out into an indexed collection drops its non-unique secondary indexes for the load and rebuilds them once afterwards."),
+		gettext_noop(
+			"The indexes are dropped and rebuilt in the transaction of the aggregate, which holds an ACCESS EXCLUSIVE lock on the target collection until it ends: reads and writes of the target wait for the whole load and index build."),
+		&EnableOutStageBulkLoad,
+		DEFAULT_ENABLE_OUT_STAGE_BULK_LOAD,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
+	DefineCustomBoolVariable(
+		psprintf("%s.enableDistinctIndexTermScan", newGucPrefix),
+		gettext_noop(
+			"Whether unfiltered distinct queries read the distinct values off the terms of a single path index."),
+		NULL, &EnableDistinctIndexTermScan,
+		DEFAULT_ENABLE_DISTINCT_INDEX_TERM_SCAN,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
 	DefineCustomBoolVariable(
 		psprintf("%s.enableRoleCrud", newGucPrefix),
 		gettext_noop(
@@ -578,6 +707,22 @@ InitializeFeatureFlagConfigurations(const char *prefix, const char *newGucPrefix
 		NULL, &EnableIndexOnlyScan, DEFAULT_ENABLE_INDEX_ONLY_SCAN,
 		PGC_USERSET, 0, NULL, NULL, NULL);
 
+	DefineCustomBoolVariable(
+		psprintf("%s.enableCoveredProjectionIndexOnlyScan", newGucPrefix),
+		gettext_noop(
+			"Whether to allow index only scans for inclusion projections covered by a composite index."),
+		NULL, &EnableCoveredProjectionIndexOnlyScan,
+		DEFAULT_ENABLE_COVERED_PROJECTION_INDEX_ONLY_SCAN,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
+	DefineCustomBoolVariable(
+		psprintf("%s.enableSinglePathIndexOnlyScan", newGucPrefix),
+		gettext_noop(
+			"Whether to allow index only scans on single path indexes for aggregates that don't need the document such as count."),
+		NULL, &EnableSinglePathIndexOnlyScan,
+		DEFAULT_ENABLE_SINGLE_PATH_INDEX_ONLY_SCAN,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
 	DefineCustomBoolVariable(
 		psprintf("%s.usePgStatsLiveTuplesForCount", newGucPrefix),
 		gettext_noop(
@@ -649,6 +794,48 @@ InitializeFeatureFlagConfigurations(const char *prefix, const char *newGucPrefix
 		NULL, &EnableUpdateBsonDocument, DEFAULT_ENABLE_UPDATE_BSON_DOCUMENT,
 		PGC_USERSET, 0, NULL, NULL, NULL);
 
+	DefineCustomBoolVariable(
+		psprintf("%s.enableSetBasedDeleteById", newGucPrefix),
+		gettext_noop(
+			"Whether to run consecutive deletes by _id of a batch as a single statement."),
+		NULL, &EnableSetBasedDeleteById, DEFAULT_ENABLE_SET_BASED_DELETE_BY_ID,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
+	DefineCustomBoolVariable(
+		psprintf("%s.enableSetBasedUpdateById", newGucPrefix),
+		gettext_noop(
+			"Whether to run consecutive updates by _id of a batch as a single statement."),
+		NULL, &EnableSetBasedUpdateById, DEFAULT_ENABLE_SET_BASED_UPDATE_BY_ID,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
+	DefineCustomBoolVariable(
+		psprintf("%s.enableFindAndModifySkipLocked", newGucPrefix),
+		gettext_noop(
+			"Whether sorted findAndModify commands that do not query by _id skip documents locked by other transactions when selecting the document to modify."),
+		NULL, &EnableFindAndModifySkipLocked, DEFAULT_ENABLE_FIND_AND_MODIFY_SKIP_LOCKED,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
+	DefineCustomBoolVariable(
+		psprintf("%s.enableUpdateInPlacePatch", newGucPrefix),
+		gettext_noop(
+			"Whether operator updates that only change existing fixed width values patch a copy of the document instead of rebuilding it."),
+		NULL, &EnableUpdateInPlacePatch, DEFAULT_ENABLE_UPDATE_IN_PLACE_PATCH,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
+	DefineCustomBoolVariable(
+		psprintf("%s.enableUpsertOnConflict", newGucPrefix),
+		gettext_noop(
+			"Whether single document upserts filtering only on _id are executed as a single insert that updates the existing document on conflict."),
+		NULL, &EnableUpsertOnConflict, DEFAULT_ENABLE_UPSERT_ON_CONFLICT,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
+	DefineCustomBoolVariable(
+		psprintf("%s.enableDirectMultiInsert", newGucPrefix),
+		gettext_noop(
+			"Whether batched inserts into a local table use the table access method's multi-insert instead of planning an INSERT."),
+		NULL, &EnableDirectMultiInsert, DEFAULT_ENABLE_DIRECT_MULTI_INSERT,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
 	DefineCustomBoolVariable(
 		psprintf("%s.enableIdIndexCustomCostFunction", newGucPrefix),
 		gettext_noop(
@@ -672,6 +859,22 @@ InitializeFeatureFlagConfigurations(const char *prefix, const char *newGucPrefix
 		DEFAULT_ENABLE_COMPOSITE_PARALLEL_INDEX_SCAN,
 		PGC_USERSET, 0, NULL, NULL, NULL);
 
+	DefineCustomBoolVariable(
+		psprintf("%s.enableSinglePathParallelIndexScan", newGucPrefix),
+		gettext_noop(
+			"Whether to enable parallel index scans for single path indexes."),
+		NULL, &EnableSinglePathParallelIndexScan,
+		DEFAULT_ENABLE_SINGLE_PATH_PARALLEL_INDEX_SCAN,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
+	DefineCustomBoolVariable(
+		psprintf("%s.enableResumableIndexBuild", newGucPrefix),
+		gettext_noop(
+			"Whether background index builds resume from validation when a previous attempt completed the build phase."),
+		NULL, &EnableResumableIndexBuild,
+		DEFAULT_ENABLE_RESUMABLE_INDEX_BUILD,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
 	DefineCustomBoolVariable(
 		psprintf("%s.enableValueOnlyIndexTerms", newGucPrefix),
 		gettext_noop(
@@ -679,6 +882,14 @@ InitializeFeatureFlagConfigurations(const char *prefix, const char *newGucPrefix
 		NULL, &EnableValueOnlyIndexTerms, DEFAULT_ENABLE_VALUE_ONLY_INDEX_TERMS,
 		PGC_USERSET, 0, NULL, NULL, NULL);
 
+	DefineCustomBoolVariable(
+		psprintf("%s.enableWildcardProjectionPathPrefixElision", newGucPrefix),
+		gettext_noop(
+			"Whether new wildcard projection indexes elide the path prefix shared by all included paths from their index terms."),
+		NULL, &EnableWildcardProjectionPathPrefixElision,
+		DEFAULT_ENABLE_WILDCARD_PROJECTION_PATH_PREFIX_ELISION,
+		PGC_USERSET, 0, NULL, NULL, NULL);
+
 	DefineCustomBoolVariable(
 		psprintf("%s.enablePrepareUnique", newGucPrefix),
 		gettext_noop(
@@ -15,6 +15,7 @@
 #include "configs/config_initialization.h"
 #include "vector/vector_configs.h"
 #include "index_am/documentdb_rum.h"
+#include "commands/commands_common.h"
 
 /*
  * Externally defined GUC constants
@@ -166,6 +167,29 @@ RumLibraryLoadOptions DocumentDBRumLibraryLoadOption = DEFAULT_RUM_LIBRARY_LOAD_
 #define DEFAULT_ENABLE_STATEMENT_TIMEOUT true
 bool EnableBackendStatementTimeout = DEFAULT_ENABLE_STATEMENT_TIMEOUT;
 
+#define DEFAULT_WRITE_CONCERN_RELAXATION WriteConcernRelaxation_None
+int WriteConcernRelaxation = DEFAULT_WRITE_CONCERN_RELAXATION;
+
+/* Grouping of concurrent single statement writes, read by the gateway */
+#define DEFAULT_ENABLE_GROUP_INSERTS false
+static bool EnableGroupInserts = DEFAULT_ENABLE_GROUP_INSERTS;
+
+#define DEFAULT_ENABLE_GROUP_UPDATES false
+static bool EnableGroupUpdates = DEFAULT_ENABLE_GROUP_UPDATES;
+
+#define DEFAULT_GROUP_WRITE_WINDOW_IN_MICRO_SEC 200
+static int GroupWriteWindowInMicroSec = DEFAULT_GROUP_WRITE_WINDOW_IN_MICRO_SEC;
+
+#define DEFAULT_GROUP_WRITE_MAX_DOCUMENTS 100
+static int GroupWriteMaxDocuments = DEFAULT_GROUP_WRITE_MAX_DOCUMENTS;
+
+static struct config_enum_entry write_concern_relaxation_options[4] = {
+	{ "none", WriteConcernRelaxation_None, false },
+	{ "journal", WriteConcernRelaxation_Journal, false },
+	{ "unacknowledged", WriteConcernRelaxation_Unacknowledged, false },
+	{ NULL, 0, false }
+};
+
 static struct config_enum_entry rum_load_options[4] = {
 	{ "none", RumLibraryLoadOption_None, false },
 	{ "prefer_documentdb_extended_rum", RumLibraryLoadOption_PreferDocumentDBRum, false },
@@ -468,4 +492,45 @@ InitializeSystemConfigurations(const char *prefix, const char *newGucPrefix)
 			"Whether to enable per statement backend timeout override in the backend."),
 		NULL, &EnableBackendStatementTimeout, DEFAULT_ENABLE_STATEMENT_TIMEOUT,
 		PGC_USERSET, 0, NULL, NULL, NULL);
+
+	DefineCustomEnumVariable(
+		psprintf("%s.writeConcernRelaxation", newGucPrefix),
+		gettext_noop(
+			"Caps how far the writeConcern of write commands may relax durability. "
+			"'journal' lets { j: false } and { w: 0 } writes commit asynchronously, "
+			"'unacknowledged' also lets the gateway acknowledge { w: 0 } writes before running them."),
+		NULL, &WriteConcernRelaxation, DEFAULT_WRITE_CONCERN_RELAXATION,
+		write_concern_relaxation_options,
+		PGC_SUSET, 0, NULL, NULL, NULL);
+
+	DefineCustomBoolVariable(
+		psprintf("%s.enableGroupInserts", newGucPrefix),
+		gettext_noop(
+			"Whether the gateway writes concurrent single document inserts into the same "
+			"collection together, sharing one commit."),
+		NULL, &EnableGroupInserts, DEFAULT_ENABLE_GROUP_INSERTS,
+		PGC_SUSET, 0, NULL, NULL, NULL);
+
+	DefineCustomBoolVariable(
+		psprintf("%s.enableGroupUpdates", newGucPrefix),
+		gettext_noop(
+			"Whether the gateway runs concurrent single statement updates of the same "
+			"collection in one transaction, sharing one commit."),
+		NULL, &EnableGroupUpdates, DEFAULT_ENABLE_GROUP_UPDATES,
+		PGC_SUSET, 0, NULL, NULL, NULL);
+
+	DefineCustomIntVariable(
+		psprintf("%s.groupWriteWindowInMicroSec", newGucPrefix),
+		gettext_noop(
+			"How long the gateway waits for other writes to join a write group."),
+		gettext_noop(
+			"Windows shorter than a millisecond are waited by yielding to the other requests rather than with a timer, whose resolution is a millisecond."),
+		&GroupWriteWindowInMicroSec, DEFAULT_GROUP_WRITE_WINDOW_IN_MICRO_SEC,
+		0, 1000000, PGC_SUSET, 0, NULL, NULL, NULL);
+
+	DefineCustomIntVariable(
+		psprintf("%s.groupWriteMaxDocuments", newGucPrefix),
+		gettext_noop("The maximum number of writes in a gateway write group."),
+		NULL, &GroupWriteMaxDocuments, DEFAULT_GROUP_WRITE_MAX_DOCUMENTS,
+		1, 100000, PGC_SUSET, 0, NULL, NULL, NULL);
 }
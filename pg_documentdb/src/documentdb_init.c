@@ -30,6 +30,7 @@
 #include "infrastructure/cursor_store.h"
 #include "background_worker/background_worker_job.h"
 #include "index_am/roaring_bitmap_adapter.h"
+#include "schema_validation/schema_validation.h"
 
 /* --------------------------------------------------------- */
 /* Data Types & Enum values */
@@ -237,6 +238,14 @@ DocumentDBTransactionCallback(XactEvent event, void *arg)
 		{
 			ConnMgrTryCancelActiveConnection();
 			DeletePendingCursorFiles();
+			ReleaseRetiredSchemaValidationStates();
+			break;
+		}
+
+		case XACT_EVENT_COMMIT:
+		case XACT_EVENT_PARALLEL_COMMIT:
+		{
+			ReleaseRetiredSchemaValidationStates();
 			break;
 		}
 
@@ -11,6 +11,7 @@
 
 #include "index_am/index_am_utils.h"
 #include "utils/feature_counter.h"
+#include "access/genam.h"
 #include "access/relscan.h"
 #include "index_am/documentdb_rum.h"
 
@@ -47,6 +48,8 @@ BsonIndexAmEntry RumIndexAmEntry = {
 	.get_opclass_internal_catalog_schema = GetRumInternalSchemaV2,
 	.get_multikey_status = NULL,
 	.get_truncation_status = RumGetTruncationStatus,
+	.get_pending_list_status = NULL,
+	.enumerate_distinct_terms = NULL,
 };
 
 /*
@@ -125,6 +128,25 @@ GetIndexAmSupportsIndexOnlyScan(Oid indexAm, Oid opFamilyOid,
 }
 
 
+/*
+ * Whether the index AM can run index only scans on its single path
+ * opclass. Unlike the composite opclass, those can't return the document
+ * and so are only usable when no index column is needed.
+ */
+bool
+GetIndexAmSupportsSinglePathIndexOnlyScan(Oid indexAm, Oid opFamilyOid)
+{
+	const BsonIndexAmEntry *amEntry = GetBsonIndexAmEntryByIndexOid(indexAm);
+	if (amEntry == NULL)
+	{
+		return false;
+	}
+
+	return amEntry->is_index_only_scan_supported &&
+		   opFamilyOid == amEntry->get_single_path_op_family_oid();
+}
+
+
 /* Sets the Oid of the registered alternate indexAms into an input array starting at a given index */
 int
 SetDynamicIndexAmOidsAndGetCount(Datum *indexAmArray, int32_t indexAmArraySize)
@@ -349,6 +371,20 @@ IsCompositeOpFamilyOidWithParallelSupport(Oid relam, Oid opFamilyOid)
 }
 
 
+bool
+IsSinglePathOpFamilyOidWithParallelSupport(Oid relam, Oid opFamilyOid)
+{
+	const BsonIndexAmEntry *amEntry = GetBsonIndexAmEntryByIndexOid(relam);
+	if (amEntry == NULL)
+	{
+		return false;
+	}
+
+	return amEntry->get_single_path_op_family_oid() == opFamilyOid &&
+		   amEntry->can_support_parallel_scans;
+}
+
+
 /*
  * Whether order by is supported for a opclass of an index Am.
  */
@@ -380,6 +416,40 @@ GetMultiKeyStatusByRelAm(Oid relam)
 }
 
 
+/*
+ * Whether the index can have entries in a pending list that only bitmap
+ * and unordered index scans read (see get_pending_list_status).
+ */
+bool
+IndexMayHavePendingList(Oid relam, Oid indexOid)
+{
+	const BsonIndexAmEntry *amEntry = GetBsonIndexAmEntryByIndexOid(relam);
+	if (amEntry == NULL || amEntry->get_pending_list_status == NULL)
+	{
+		return false;
+	}
+
+	Relation indexRelation = index_open(indexOid, NoLock);
+	bool mayHavePendingList = amEntry->get_pending_list_status(indexRelation);
+	index_close(indexRelation, NoLock);
+
+	return mayHavePendingList;
+}
+
+
+EnumerateDistinctTermsFunc
+GetEnumerateDistinctTermsByRelAm(Oid relam)
+{
+	const BsonIndexAmEntry *amEntry = GetBsonIndexAmEntryByIndexOid(relam);
+	if (amEntry == NULL)
+	{
+		return NULL;
+	}
+
+	return amEntry->enumerate_distinct_terms;
+}
+
+
 bool
 GetIndexSupportsBackwardsScan(Oid relam)
 {
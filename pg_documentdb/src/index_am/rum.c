@@ -671,8 +671,44 @@ CompositeIndexSupportsIndexOnlyScan(const IndexPath *indexPath)
 	bool hasTruncatedTerms = getTruncationStatusFunc(indexRelation);
 	index_close(indexRelation, NoLock);
 
-	/* can only support index only scan if the index is not multikey and there are no truncated terms. */
-	return !multiKeyStatus && !hasTruncatedTerms;
+	/* can only support index only scan if the index is not multikey, there are no truncated terms
+	 * and no entries can be sitting in a pending list. */
+	return !multiKeyStatus && !hasTruncatedTerms &&
+		   !IndexMayHavePendingList(indexPath->indexinfo->relam,
+									indexPath->indexinfo->indexoid);
+}
+
+
+/*
+ * Check if a single path index supports index-only scans. Those return no
+ * index column so every match must be exact: the index can't have truncated
+ * terms or arrays along its path (tracked by the root multi-key term), and
+ * no entries can be sitting in a pending list.
+ */
+bool
+SinglePathIndexSupportsIndexOnlyScan(const IndexPath *indexPath)
+{
+	if (!GetIndexAmSupportsSinglePathIndexOnlyScan(indexPath->indexinfo->relam,
+												   indexPath->indexinfo->opfamily[0]))
+	{
+		return false;
+	}
+
+	if (IndexMayHavePendingList(indexPath->indexinfo->relam,
+								indexPath->indexinfo->indexoid))
+	{
+		return false;
+	}
+
+	EnsureRumLibLoaded();
+
+	Relation indexRelation = index_open(indexPath->indexinfo->indexoid, NoLock);
+	bool hasArrayPaths = CheckIndexHasArrays(indexRelation, &rum_index_routine) ==
+						 IndexMultiKeyStatus_HasArrays;
+	bool hasTruncatedTerms = !hasArrayPaths && RumGetTruncationStatus(indexRelation);
+	index_close(indexRelation, NoLock);
+
+	return !hasArrayPaths && !hasTruncatedTerms;
 }
 
 
@@ -1315,7 +1351,9 @@ RumGetTruncationStatus(Relation indexRelation)
 {
 	EnsureRumLibLoaded();
 
-	if (!IsCompositeOpClass(indexRelation))
+	if (!IsCompositeOpClass(indexRelation) &&
+		!IsSinglePathOpFamilyOid(indexRelation->rd_rel->relam,
+								 indexRelation->rd_opfamily[0]))
 	{
 		return false;
 	}
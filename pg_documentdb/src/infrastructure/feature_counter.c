@@ -419,7 +419,12 @@ static char FeatureMapping[MAX_FEATURE_COUNT][MAX_FEATURE_NAME_LENGTH] = {
 	[FEATURE_UPDATE_OPERATOR_UNSET] = "update_operator_unset",
 
 	/* Feature usage stats */
+	[FEATURE_USAGE_DIRECT_MULTI_INSERT] = "direct_multi_insert",
+	[FEATURE_USAGE_DISTINCT_INDEX_TERM_SCAN] = "distinct_index_term_scan",
+	[FEATURE_USAGE_SET_BASED_DELETE_BY_ID] = "set_based_delete_by_id",
+	[FEATURE_USAGE_SET_BASED_UPDATE_BY_ID] = "set_based_update_by_id",
 	[FEATURE_USAGE_TTL_PURGER_CALLS] = "ttl_purger_calls",
+	[FEATURE_USAGE_UPDATE_IN_PLACE_PATCH] = "update_in_place_patch",
 
 	/* Feature mapping region - User CRUD*/
 	[FEATURE_USER_CREATE] = "user_create",
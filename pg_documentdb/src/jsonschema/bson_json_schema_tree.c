@@ -18,6 +18,21 @@
 #include "utils/string_view.h"
 #include "commands/parse_error.h"
 
+/*
+ * Number of properties of an object node past which field lookups go
+ * through a hash instead of the properties list.
+ */
+#define SCHEMA_PROPERTIES_HASH_THRESHOLD 8
+
+/* Entry of the field name -> field node hash of an object node */
+typedef struct SchemaFieldNodeHashEntry
+{
+	/* key for hash entry; should be the first field */
+	StringView field;
+
+	SchemaFieldNode *fieldNode;
+} SchemaFieldNodeHashEntry;
+
 /* --------------------------------------------------------- */
 /*              Forward Declerations                         */
 /* --------------------------------------------------------- */
@@ -52,6 +67,8 @@ static SchemaFieldNode * InitFieldNode(const char *field);
 static SchemaKeywordNode * InitNonFieldNode(SchemaNodeType type);
 static SchemaFieldNode * FindOrAddEmptyFieldNode(const char *field,
 												 SchemaNode *node);
+static void AddFieldNodeToPropertiesHash(HTAB *propertiesHash,
+										 SchemaFieldNode *fieldNode);
 static void AppendNodeToLinkedList(SchemaNode **head, SchemaNode *node);
 static inline void AppendKeywordNodeToLinkedList(SchemaKeywordNode **head,
 												 SchemaKeywordNode *node);
@@ -82,9 +99,8 @@ BuildSchemaTree(SchemaTreeState *treeState, bson_iter_t *schemaIter)
 
 /*
  * For a given field name, this function searches and returns the matching field node,
- * from the "properties" Linked List.
+ * from the "properties" hash when the node has one, or the "properties" Linked List.
  * Returns null if such child node does not exist.
- * TODO: Optimize this function by storing field nodes as BST (instead of Linked List)
  */
 SchemaFieldNode *
 FindFieldNodeByName(const SchemaNode *node, const char *field)
@@ -94,6 +110,16 @@ FindFieldNodeByName(const SchemaNode *node, const char *field)
 		return NULL;
 	}
 
+	if (node->validations.object->propertiesHash != NULL)
+	{
+		StringView fieldView = CreateStringViewFromString(field);
+		bool found = false;
+		SchemaFieldNodeHashEntry *entry =
+			hash_search(node->validations.object->propertiesHash, &fieldView,
+						HASH_FIND, &found);
+		return found ? entry->fieldNode : NULL;
+	}
+
 	SchemaFieldNode *fieldNode = node->validations.object->properties;
 	while (fieldNode != NULL)
 	{
@@ -984,7 +1010,8 @@ GetBsonTypeEnumFromBsonTypeString(const char *bsonTypeStr)
  * from the "properties" Linked List.
  * if the field node does not exist, it creates an empty node with given field name,
  * and appends it to end of the 'properties' list.
- * TODO: Optimize this function by storing field nodes as BST (instead of Linked List)
+ * Once the list grows past SCHEMA_PROPERTIES_HASH_THRESHOLD nodes, the nodes are
+ * also tracked in the properties hash of the node.
  */
 static SchemaFieldNode *
 FindOrAddEmptyFieldNode(const char *field, SchemaNode *node)
@@ -992,14 +1019,47 @@ FindOrAddEmptyFieldNode(const char *field, SchemaNode *node)
 	SchemaFieldNode *fieldNode = FindFieldNodeByName(node, field);
 	if (fieldNode == NULL)
 	{
+		ValidationsObject *object = node->validations.object;
 		fieldNode = InitFieldNode(field);
-		AppendNodeToLinkedList((SchemaNode **) &node->validations.object->properties,
+		AppendNodeToLinkedList((SchemaNode **) &object->properties,
 							   (SchemaNode *) fieldNode);
+		object->numProperties++;
+
+		if (object->propertiesHash != NULL)
+		{
+			AddFieldNodeToPropertiesHash(object->propertiesHash, fieldNode);
+		}
+		else if (object->numProperties > SCHEMA_PROPERTIES_HASH_THRESHOLD)
+		{
+			object->propertiesHash = CreateStringViewHashMap(
+				sizeof(SchemaFieldNodeHashEntry));
+
+			SchemaFieldNode *currentNode = object->properties;
+			while (currentNode != NULL)
+			{
+				AddFieldNodeToPropertiesHash(object->propertiesHash, currentNode);
+				currentNode = (SchemaFieldNode *) currentNode->base.next;
+			}
+		}
 	}
 	return fieldNode;
 }
 
 
+/*
+ * AddFieldNodeToPropertiesHash tracks the given field node in the properties hash
+ * of its parent node.
+ */
+static void
+AddFieldNodeToPropertiesHash(HTAB *propertiesHash, SchemaFieldNode *fieldNode)
+{
+	bool found = false;
+	SchemaFieldNodeHashEntry *entry = hash_search(propertiesHash, &(fieldNode->field),
+												  HASH_ENTER, &found);
+	entry->fieldNode = fieldNode;
+}
+
+
 /*
  * AppendKeywordNodeToLinkedList function adds a Keyword type Node to a given Linked List
  */
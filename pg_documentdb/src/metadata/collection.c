@@ -11,6 +11,7 @@
 #include "fmgr.h"
 #include "miscadmin.h"
 
+#include "access/table.h"
 #include "access/xact.h"
 #include "catalog/pg_attribute.h"
 #include "commands/extension.h"
@@ -19,6 +20,7 @@
 #include "nodes/makefuncs.h"
 #include "nodes/pg_list.h"
 #include "parser/parse_func.h"
+#include "rewrite/rewriteHandler.h"
 #include "storage/lmgr.h"
 #include "funcapi.h"
 #include "utils/builtins.h"
@@ -41,6 +43,7 @@
 #include "commands/parse_error.h"
 #include "utils/feature_counter.h"
 #include "jsonschema/bson_json_schema_tree.h"
+#include "schema_validation/schema_validation.h"
 
 #define CREATE_COLLECTION_FUNC_NARGS 2
 
@@ -126,6 +129,7 @@ static bool GetMongoCollectionFromCatalogByNameDatum(Datum databaseNameDatum,
 static Oid GetRelationIdForCollectionTableName(char *collectionTableName,
 											   LOCKMODE lockMode);
 static AttrNumber GetMongoDataCreationTimeVarAttrNumber(Oid collectionOid);
+static AttrNumber GetIndexKeyColumnAttrNumber(Oid collectionOid);
 static MongoCollection * GetMongoCollectionByNameDatumCore(Datum databaseNameDatum,
 														   Datum collectionNameDatum,
 														   LOCKMODE lockMode);
@@ -217,6 +221,9 @@ void
 ResetCollectionsCache(void)
 {
 	CollectionCacheIsValid = false;
+
+	/* compiled validators may refer to the functions of the previous extension */
+	ResetSchemaValidationCache();
 }
 
 
@@ -394,6 +401,8 @@ GetMongoCollectionByColId(uint64 collectionId, LOCKMODE lockMode)
 
 	collection.mongoDataCreationTimeVarAttrNumber =
 		GetMongoDataCreationTimeVarAttrNumber(collection.relationId);
+	collection.indexKeyColumnAttrNumber =
+		GetIndexKeyColumnAttrNumber(collection.relationId);
 
 	if (collection.schemaValidator.validator != NULL)
 	{
@@ -749,6 +758,8 @@ GetMongoCollectionByNameDatumCore(Datum databaseNameDatum, Datum collectionNameD
 	{
 		collection.mongoDataCreationTimeVarAttrNumber =
 			GetMongoDataCreationTimeVarAttrNumber(collection.relationId);
+		collection.indexKeyColumnAttrNumber =
+			GetIndexKeyColumnAttrNumber(collection.relationId);
 	}
 
 	/* get schema validation meta*/
@@ -818,6 +829,7 @@ GetTempMongoCollectionByNameDatum(Datum databaseNameDatum, Datum collectionNameD
 	collection->relationId = InvalidOid; /* unused */
 	sprintf(collection->tableName, "documents_temp");
 	collection->shardTableName[0] = '\0';
+	collection->indexKeyColumnAttrNumber = -1;
 
 	return collection;
 }
@@ -1189,6 +1201,73 @@ GetMongoDataCreationTimeVarAttrNumber(Oid collectionOid)
 }
 
 
+/*
+ * GetIndexKeyColumnAttrNumber returns the attribute number of the index_document
+ * column, or -1 if the collection was created without "indexKeyFields".
+ */
+static AttrNumber
+GetIndexKeyColumnAttrNumber(Oid collectionOid)
+{
+	HeapTuple tuple = SearchSysCacheAttName(collectionOid,
+											DOCUMENT_DATA_TABLE_INDEX_KEY_COLUMN_NAME);
+
+	if (!HeapTupleIsValid(tuple))
+	{
+		return (AttrNumber) - 1;
+	}
+
+	Form_pg_attribute targetatt = (Form_pg_attribute) GETSTRUCT(tuple);
+	int16 attnum = targetatt->attnum;
+	ReleaseSysCache(tuple);
+
+	return attnum;
+}
+
+
+/*
+ * GetIndexKeyColumnFields returns the top level fields that the index_document
+ * column of the collection holds, as the list of keys of the projection in its
+ * generation expression (see AddIndexKeyColumn). Returns NIL if the collection
+ * has no such column.
+ */
+List *
+GetIndexKeyColumnFields(const MongoCollection *collection)
+{
+	if (collection->indexKeyColumnAttrNumber == -1)
+	{
+		return NIL;
+	}
+
+	Relation relation = table_open(collection->relationId, AccessShareLock);
+	Node *generationExpr = build_column_default(relation,
+												collection->indexKeyColumnAttrNumber);
+	table_close(relation, NoLock);
+
+	if (generationExpr == NULL || !IsA(generationExpr, FuncExpr) ||
+		list_length(((FuncExpr *) generationExpr)->args) != 2 ||
+		!IsA(lsecond(((FuncExpr *) generationExpr)->args), Const))
+	{
+		ereport(ERROR, (errcode(ERRCODE_DOCUMENTDB_INTERNALERROR),
+						errmsg("Unexpected definition of the %s column of %s",
+							   DOCUMENT_DATA_TABLE_INDEX_KEY_COLUMN_NAME,
+							   collection->tableName)));
+	}
+
+	Const *projectionConst = lsecond(((FuncExpr *) generationExpr)->args);
+	pgbson *projection = DatumGetPgBson(projectionConst->constvalue);
+
+	List *fields = NIL;
+	bson_iter_t projectionIter;
+	PgbsonInitIterator(projection, &projectionIter);
+	while (bson_iter_next(&projectionIter))
+	{
+		fields = lappend(fields, pstrdup(bson_iter_key(&projectionIter)));
+	}
+
+	return fields;
+}
+
+
 /*
  * Check if DB exists. Check is done case insensitively. If exists, return
  * TRUE and populates the output parameter dbNameInTable with the db name
@@ -1003,6 +1003,9 @@ typedef struct DocumentDBApiOidCacheData
 	/* OID of the ApiInternalSchemaName.bson_dollar_bucket_auto function */
 	Oid BsonDollarBucketAutoFunctionOid;
 
+	/* OID of the ApiInternalSchemaName.bson_dollar_bucket_auto_approximate function */
+	Oid BsonDollarBucketAutoApproximateFunctionOid;
+
 	/* Postgis box2df type id */
 	Oid Box2dfTypeId;
 
@@ -4665,6 +4668,27 @@ BsonDollarBucketAutoFunctionOid(void)
 }
 
 
+Oid
+BsonDollarBucketAutoApproximateFunctionOid(void)
+{
+	InitializeDocumentDBApiExtensionCache();
+
+	if (Cache.BsonDollarBucketAutoApproximateFunctionOid == InvalidOid)
+	{
+		List *functionNameList = list_make2(makeString(DocumentDBApiInternalSchemaName),
+											makeString(
+												"bson_dollar_bucket_auto_approximate"));
+		Oid paramOids[4] = { BsonTypeId(), BsonTypeId(), BsonTypeId(), BsonTypeId() };
+		bool missingOK = false;
+
+		Cache.BsonDollarBucketAutoApproximateFunctionOid =
+			LookupFuncName(functionNameList, 4, paramOids, missingOK);
+	}
+
+	return Cache.BsonDollarBucketAutoApproximateFunctionOid;
+}
+
+
 Oid
 BsonRepathAndBuildFunctionOid(void)
 {
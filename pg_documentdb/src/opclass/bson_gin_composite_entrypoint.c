@@ -1130,6 +1130,17 @@ gin_bson_composite_ordering_transform(PG_FUNCTION_ARGS)
 		for (int i = 0; i < numPaths; i++)
 		{
 			BsonIndexTerm *term = &compareTerm[i];
+
+			/*
+			 * Paths missing in the document are left out (as a projection would).
+			 * Only covered projections read the rebuilt document: aggregate index
+			 * only scans never reference it and all their filters are non-lossy.
+			 */
+			if (IsIndexTermValueUndefined(term))
+			{
+				continue;
+			}
+
 			PgbsonHeapWriterAppendValue(writer, indexPaths[i], indexPathLengths[i],
 										&term->element.bsonValue);
 		}
@@ -161,6 +161,26 @@ gin_bson_extract_query(PG_FUNCTION_ARGS)
 			PG_RETURN_POINTER(GinBsonExtractQueryOrderBy(fcinfo));
 		}
 
+		case BSON_INDEX_STRATEGY_IS_MULTIKEY:
+		case BSON_INDEX_STRATEGY_HAS_TRUNCATED_TERMS:
+		{
+			/* Index status lookups: match just the root multi-key (arrays along the
+			 * path) or root truncated term of the documents. */
+			if (!PG_HAS_OPCLASS_OPTIONS())
+			{
+				ereport(ERROR, (errmsg("Index does not have options")));
+			}
+
+			IndexTermCreateMetadata termMetadata = GetIndexTermMetadata(
+				PG_GET_OPCLASS_OPTIONS());
+			Datum *entries = (Datum *) palloc(sizeof(Datum));
+			entries[0] = strategy == BSON_INDEX_STRATEGY_IS_MULTIKEY ?
+						 GenerateRootMultiKeyTerm(&termMetadata) :
+						 GenerateRootTruncatedTerm(&termMetadata);
+			*nentries = 1;
+			PG_RETURN_POINTER(entries);
+		}
+
 		default:
 		{
 			break;
@@ -370,6 +390,13 @@ gin_bson_consistent(PG_FUNCTION_ARGS)
 		PG_RETURN_BOOL(check[0] || check[1] || check[2]);
 	}
 
+	if (strategy == BSON_INDEX_STRATEGY_IS_MULTIKEY ||
+		strategy == BSON_INDEX_STRATEGY_HAS_TRUNCATED_TERMS)
+	{
+		*recheck = false;
+		PG_RETURN_BOOL(check[0]);
+	}
+
 	bytea *options = (bytea *) PG_GET_OPCLASS_OPTIONS();
 	bool isPreconsistent = false;
 	res = GinBsonConsistentCore(strategy,
@@ -483,6 +510,15 @@ gin_bson_get_single_path_generated_terms(PG_FUNCTION_ARGS)
  * option specification.
  * The function gets a document, a set of paths, and if it's an exclusion, and sets up the index structures
  * to call 'generateTerms' and returns it as a SETOF records.
+ *
+ * gin_bson_get_wildcard_project_generated_terms(
+ *      document bson,
+ *      pathSpec text,
+ *      isExclusion bool,
+ *      includeId bool,
+ *      addMetadata bool default false,
+ *      termLength int default -1,
+ *      pathPrefix text default '')
  */
 Datum
 gin_bson_get_wildcard_project_generated_terms(PG_FUNCTION_ARGS)
@@ -501,14 +537,26 @@ gin_bson_get_wildcard_project_generated_terms(PG_FUNCTION_ARGS)
 		context = (GenerateTermsContext *) palloc0(sizeof(GenerateTermsContext));
 
 		const char *prefixStr = text_to_cstring(PG_GETARG_TEXT_P(1));
+		const char *pathPrefixStr = PG_NARGS() > 6 ?
+									text_to_cstring(PG_GETARG_TEXT_P(6)) : "";
 		Size fieldSize = FillWildcardProjectPathSpec(prefixStr, NULL);
+		Size pathPrefixSize = strlen(pathPrefixStr) > 0 ?
+							  FillSinglePathSpec(pathPrefixStr, NULL) : 0;
 		BsonGinWildcardProjectionPathOptions *options =
-			(BsonGinWildcardProjectionPathOptions *) palloc0(fieldSize +
+			(BsonGinWildcardProjectionPathOptions *) palloc0(MAXALIGN(fieldSize) +
+															 pathPrefixSize +
 															 sizeof(
 																 BsonGinWildcardProjectionPathOptions));
 		FillWildcardProjectPathSpec(prefixStr, ((char *) options) +
 									sizeof(BsonGinWildcardProjectionPathOptions));
 		options->pathSpec = sizeof(BsonGinWildcardProjectionPathOptions);
+
+		if (pathPrefixSize > 0)
+		{
+			options->pathPrefix = sizeof(BsonGinWildcardProjectionPathOptions) +
+								  MAXALIGN(fieldSize);
+			FillSinglePathSpec(pathPrefixStr, ((char *) options) + options->pathPrefix);
+		}
 		options->isExclusion = PG_GETARG_BOOL(2);
 		options->includeId = PG_GETARG_BOOL(3);
 		options->base.type = IndexOptionsType_Wildcard;
@@ -692,6 +740,11 @@ gin_bson_wildcard_project_options(PG_FUNCTION_ARGS)
 							   &FillWildcardProjectPathSpec,
 							   offsetof(BsonGinWildcardProjectionPathOptions,
 										pathSpec));
+	add_local_string_reloption(relopts, "pathprefix",
+							   "The path prefix shared by all included paths that is elided from index terms",
+							   NULL, &ValidateSinglePathSpec, &FillSinglePathSpec,
+							   offsetof(BsonGinWildcardProjectionPathOptions,
+										pathPrefix));
 	add_local_string_reloption(relopts, "indexname",
 							   "[deprecated] The mongo specific name for the index",
 							   NULL, NULL, &FillDeprecatedStringSpec,
@@ -1186,6 +1239,12 @@ GetIndexTermMetadata(void *indexOptions)
 		}
 		else if (options->type == IndexOptionsType_Wildcard)
 		{
+			/* Inclusion projections may elide the prefix shared by all included paths */
+			BsonGinWildcardProjectionPathOptions *wildcardOptions =
+				(BsonGinWildcardProjectionPathOptions *) options;
+			Get_Index_Path_Option(wildcardOptions, pathPrefix, pathPrefix.string,
+								  pathPrefix.length);
+
 			isWildcard = true;
 			isWildcardProjection = true;
 		}
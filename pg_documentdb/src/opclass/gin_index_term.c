@@ -74,6 +74,8 @@ static bool SerializeTermToWriter(pgbson_writer *writer, pgbsonelement *indexEle
 								  const IndexTermCreateMetadata *termMetadata,
 								  bool allowValueOnly, bool *isValueOnly);
 
+static bool IsPathUnderWildcardPathPrefix(const StringView *path,
+										  const StringView *pathPrefix);
 static BsonIndexTermSerialized SerializeBsonIndexTermCore(pgbsonelement *indexElement,
 														  const IndexTermCreateMetadata *
 														  createMetadata,
@@ -1005,6 +1007,22 @@ TruncateDocumentTerm(int32_t existingTermSize, int32_t softLimit, int32_t hardLi
 }
 
 
+/*
+ * Whether the path is the given dotted path prefix or a descendant of it.
+ */
+static bool
+IsPathUnderWildcardPathPrefix(const StringView *path, const StringView *pathPrefix)
+{
+	if (!StringViewStartsWithStringView(path, pathPrefix))
+	{
+		return false;
+	}
+
+	return path->length == pathPrefix->length ||
+		   path->string[pathPrefix->length] == '.';
+}
+
+
 /*
  * Serializes a given term to a pgbson writer honoring the truncation limits.
  * Returns whether the term was truncated or not.
@@ -1049,9 +1067,13 @@ SerializeTermToWriter(pgbson_writer *writer, pgbsonelement *indexElement,
 	}
 	else if (termMetadata->indexTermSizeLimit > 0 && termMetadata->isWildcard)
 	{
-		/* If it is a single path wildcard index with a non root projection we can trim down the key by removing the prefix. */
-		if (!termMetadata->isWildcardProjection && termMetadata->pathPrefix.length > 0 &&
-			indexPath.length > 0)
+		/* If it is a single path wildcard index with a non root projection we can trim down the key by removing the prefix.
+		 * Wildcard projection indexes carry the prefix shared by their included paths, and any path
+		 * outside of it is left as is.
+		 */
+		if (termMetadata->pathPrefix.length > 0 && indexPath.length > 0 &&
+			(!termMetadata->isWildcardProjection ||
+			 IsPathUnderWildcardPathPrefix(&indexPath, &termMetadata->pathPrefix)))
 		{
 			int32_t newIndexPathLength = indexPath.length -
 										 termMetadata->pathPrefix.length;
@@ -201,7 +201,9 @@ static OpExpr * CreateExistsTrueOpExpr(Expr *documentExpr, const char *sourcePat
 static List * GetSortDetails(PlannerInfo *root, Index rti,
 							 bool *hasOrderBy, bool *hasGroupby, bool *isOrderById);
 static bool IsValidIndexPathForIdOrderBy(IndexPath *indexPath, List *sortDetails);
-static bool IsValidForIndexOnlyScans(PlannerInfo *root);
+static bool IsValidForIndexOnlyScans(PlannerInfo *root, List **coveredProjectionPaths);
+static bool IndexCoversProjectionPaths(IndexPath *indexPath,
+									   List *coveredProjectionPaths);
 
 /*-------------------------------*/
 /* Force index support functions */
@@ -322,6 +324,8 @@ extern bool EnableIdIndexPushdown;
 extern bool ForceIndexOnlyScanIfAvailable;
 extern bool EnableIdIndexCustomCostFunction;
 extern bool EnableIndexOnlyScan;
+extern bool EnableCoveredProjectionIndexOnlyScan;
+extern bool EnableSinglePathIndexOnlyScan;
 extern bool EnableOrderByIdOnCostFunction;
 extern bool EnablePrimaryKeyCursorScan;
 
@@ -1531,20 +1535,156 @@ PlanHasAggregates(PlannerInfo *root)
 }
 
 
+/*
+ * Walker state for collecting the paths of projections that can be
+ * answered from the index terms alone.
+ */
+typedef struct CoveredProjectionContext
+{
+	/* Set to false once the target list needs something other than a covered projection */
+	bool isCovered;
+
+	/* The (char *) top level paths included by the covered projections */
+	List *projectedPaths;
+} CoveredProjectionContext;
+
+
+/*
+ * Adds the paths included by an inclusion projection spec to the covered paths.
+ * Returns false if the spec can't be answered from index terms: the _id must be
+ * excluded (it isn't part of the composite term), and every other field must be
+ * a plain top level inclusion (no dotted paths, positional, operators or
+ * expressions).
+ */
 static bool
-IsValidForIndexOnlyScans(PlannerInfo *root)
+TryAddCoveredProjectionPaths(pgbson *projectionSpec, List **projectedPaths)
 {
-	if (!PlanHasAggregates(root) ||
-		root->hasJoinRTEs)
+	bool idExcluded = false;
+	List *paths = NIL;
+
+	bson_iter_t projectionIter;
+	PgbsonInitIterator(projectionSpec, &projectionIter);
+	while (bson_iter_next(&projectionIter))
+	{
+		const char *path = bson_iter_key(&projectionIter);
+		const bson_value_t *value = bson_iter_value(&projectionIter);
+		if (!BsonValueIsNumberOrBool(value))
+		{
+			return false;
+		}
+
+		if (strcmp(path, "_id") == 0)
+		{
+			idExcluded = !BsonValueAsBool(value);
+			continue;
+		}
+
+		if (!BsonValueAsBool(value) || path[0] == '$' || strchr(path, '.') != NULL)
+		{
+			return false;
+		}
+
+		paths = lappend(paths, pstrdup(path));
+	}
+
+	if (!idExcluded || paths == NIL)
+	{
+		return false;
+	}
+
+	*projectedPaths = list_concat(*projectedPaths, paths);
+	return true;
+}
+
+
+/*
+ * Walks the target list and checks that the document is only referenced as the
+ * source of a constant inclusion projection ($project or find projection without
+ * let/collation) that may be covered by an index.
+ */
+static bool
+CollectCoveredProjectionPaths(Node *node, CoveredProjectionContext *context)
+{
+	CHECK_FOR_INTERRUPTS();
+
+	if (node == NULL)
 	{
-		/* Don't handle simple queries for now - only things with aggregates
-		 * Note: Things like GroupBy with no aggregates will not work here, but
-		 * that's okay. We also only consider base tables for index only scans.
-		 * TODO: This can also be extended to handle covered indexes later.
-		 */
 		return false;
 	}
 
+	if (IsA(node, Var) || IsA(node, Query))
+	{
+		context->isCovered = false;
+		return true;
+	}
+
+	if (IsA(node, FuncExpr))
+	{
+		FuncExpr *funcExpr = (FuncExpr *) node;
+		bool isProjectFunction = funcExpr->funcid == BsonDollarProjectFunctionOid() ||
+								 funcExpr->funcid == BsonDollarProjectFindFunctionOid();
+		if (isProjectFunction)
+		{
+			Node *documentArg = linitial(funcExpr->args);
+			Node *specArg = lsecond(funcExpr->args);
+			if (!IsA(documentArg, Var) || ((Var *) documentArg)->varlevelsup != 0 ||
+				!IsA(specArg, Const) || ((Const *) specArg)->constisnull ||
+				!TryAddCoveredProjectionPaths(
+					DatumGetPgBson(((Const *) specArg)->constvalue),
+					&context->projectedPaths))
+			{
+				context->isCovered = false;
+				return true;
+			}
+
+			/* The find query spec (for positional projections) is not needed here */
+			return false;
+		}
+	}
+
+	return expression_tree_walker(node, CollectCoveredProjectionPaths, context);
+}
+
+
+/*
+ * Whether the query's output may be produced by an index only scan. This is
+ * the case for aggregates that don't reference the document, or (if enabled)
+ * when the document is only used by inclusion projections over top level paths:
+ * the document rebuilt from the composite index terms then produces the same
+ * projection. In the latter case, coveredProjectionPaths is set to the projected
+ * paths that the index must cover.
+ */
+static bool
+IsValidForIndexOnlyScans(PlannerInfo *root, List **coveredProjectionPaths)
+{
+	*coveredProjectionPaths = NIL;
+	if (root->hasJoinRTEs)
+	{
+		/* We only consider base tables for index only scans. */
+		return false;
+	}
+
+	if (!PlanHasAggregates(root))
+	{
+		/* Note: Things like GroupBy with no aggregates will not work here, but
+		 * that's okay - other than aggregates only covered projections are handled.
+		 */
+		if (!EnableCoveredProjectionIndexOnlyScan)
+		{
+			return false;
+		}
+
+		CoveredProjectionContext context = { .isCovered = true, .projectedPaths = NIL };
+		CollectCoveredProjectionPaths((Node *) root->processed_tlist, &context);
+		if (!context.isCovered || context.projectedPaths == NIL)
+		{
+			return false;
+		}
+
+		*coveredProjectionPaths = context.projectedPaths;
+		return true;
+	}
+
 	bool projectionHasVarOrQuery = false;
 	expression_tree_walker((Node *) root->processed_tlist,
 						   ProjectionReferencesDocumentVar,
@@ -1561,16 +1701,46 @@ IsValidForIndexOnlyScans(PlannerInfo *root)
 }
 
 
+/*
+ * Whether every projected path is a path of the composite index, so that the
+ * document rebuilt from the index terms has all the fields the projection needs.
+ */
+static bool
+IndexCoversProjectionPaths(IndexPath *indexPath, List *coveredProjectionPaths)
+{
+	bytea *indexOptions = indexPath->indexinfo->opclassoptions != NULL ?
+						  indexPath->indexinfo->opclassoptions[0] : NULL;
+	if (indexOptions == NULL)
+	{
+		return false;
+	}
+
+	ListCell *pathCell;
+	foreach(pathCell, coveredProjectionPaths)
+	{
+		const char *path = (const char *) lfirst(pathCell);
+		int8_t sortDirection;
+		if (GetCompositeOpClassColumnNumber(path, indexOptions, &sortDirection) < 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
 /*
  * Check whether we can handle index scans as index only scans.
  * This is possible if:
  * 1) The query is against a base table
  * 2) There are no joins
- * 3) Projection is covered (Today this requires projection to be a constant but
- *    this can be extended in the future)
+ * 3) Projection is covered (Today this requires projection to be a constant, or
+ *    an inclusion projection of top level paths that are all in the index)
  * 4) Filters are covered by the index.
  * 5) The index filters are are not lossy operators.
- * 6) The index is a composite index.
+ * 6) The index is a composite index, or (if enabled) a single path index
+ *    when the projection doesn't need the document.
  */
 void
 ConsiderIndexOnlyScan(PlannerInfo *root, RelOptInfo *rel, RangeTblEntry *rte,
@@ -1581,7 +1751,8 @@ ConsiderIndexOnlyScan(PlannerInfo *root, RelOptInfo *rel, RangeTblEntry *rte,
 		return;
 	}
 
-	if (!IsValidForIndexOnlyScans(root))
+	List *coveredProjectionPaths = NIL;
+	if (!IsValidForIndexOnlyScans(root, &coveredProjectionPaths))
 	{
 		return;
 	}
@@ -1624,6 +1795,12 @@ ConsiderIndexOnlyScan(PlannerInfo *root, RelOptInfo *rel, RangeTblEntry *rte,
 		if (IsBtreePrimaryKeyIndex(indexPath->indexinfo) &&
 			EnableIdIndexPushdown)
 		{
+			if (coveredProjectionPaths != NIL)
+			{
+				/* The _id index can't rebuild the projected fields */
+				continue;
+			}
+
 			if (EnableIdIndexCustomCostFunction && !ForceIndexOnlyScanIfAvailable)
 			{
 				continue;
@@ -1651,15 +1828,26 @@ ConsiderIndexOnlyScan(PlannerInfo *root, RelOptInfo *rel, RangeTblEntry *rte,
 		}
 		else
 		{
-			if (indexPath->indexinfo->nkeycolumns < 1 ||
-				!IsOrderBySupportedOnOpClass(indexPath->indexinfo->relam,
-											 indexPath->indexinfo->opfamily[0]))
+			if (indexPath->indexinfo->nkeycolumns < 1)
 			{
 				continue;
 			}
 
-			if (!CompositeIndexSupportsIndexOnlyScan(indexPath))
+			if (IsOrderBySupportedOnOpClass(indexPath->indexinfo->relam,
+											indexPath->indexinfo->opfamily[0]))
 			{
+				if (!CompositeIndexSupportsIndexOnlyScan(indexPath))
+				{
+					continue;
+				}
+			}
+			else if (!EnableSinglePathIndexOnlyScan || coveredProjectionPaths != NIL ||
+					 !SinglePathIndexSupportsIndexOnlyScan(indexPath))
+			{
+				/* Single path indexes only cover queries that don't need the document
+				 * (e.g. counts): the index returns an empty tuple, so indexes whose
+				 * matches may need a recheck (arrays along the path, truncated terms
+				 * or a pending list) are not considered. */
 				continue;
 			}
 
@@ -1667,6 +1855,12 @@ ConsiderIndexOnlyScan(PlannerInfo *root, RelOptInfo *rel, RangeTblEntry *rte,
 			{
 				continue;
 			}
+
+			if (coveredProjectionPaths != NIL &&
+				!IndexCoversProjectionPaths(indexPath, coveredProjectionPaths))
+			{
+				continue;
+			}
 		}
 
 		/* we need to copy the index path and set it as index only scan.
@@ -1792,8 +1986,10 @@ documentdb_btcostestimate(PlannerInfo *root, IndexPath *path, double loop_count,
 		ConsiderBtreeOrderByPushdown(root, path);
 	}
 
+	List *coveredProjectionPaths = NIL;
 	if (EnableIdIndexCustomCostFunction && EnableIndexOnlyScan &&
-		IsValidForIndexOnlyScans(root))
+		IsValidForIndexOnlyScans(root, &coveredProjectionPaths) &&
+		coveredProjectionPaths == NIL)
 	{
 		bool hasOtherQuals = false;
 		IndexPath *modified = TrimIndexRestrictInfoForBtreePath(root, path,
@@ -2457,10 +2653,14 @@ TraverseIndexPathForCompositeIndex(struct IndexPath *indexPath, struct PlannerIn
 	GetMultikeyStatusFunc getMultiKeyStatusFunc = GetMultiKeyStatusByRelAm(
 		indexPath->indexinfo->relam);
 
+	/* Entries in a pending list are not in index order, so an index that
+	 * can have one doesn't push down the order by. */
 	if (getMultiKeyStatusFunc != NULL &&
 		indexPath->indexinfo->amcanorderbyop &&
 		EnableIndexOrderbyPushdown &&
-		list_length(root->query_pathkeys) > 0)
+		list_length(root->query_pathkeys) > 0 &&
+		!IndexMayHavePendingList(indexPath->indexinfo->relam,
+								 indexPath->indexinfo->indexoid))
 	{
 		indexCanOrder = true;
 		Relation indexRel = index_open(indexPath->indexinfo->indexoid, NoLock);
@@ -138,6 +138,7 @@ extern bool EnableIndexOnlyScan;
 extern bool EnableCursorsOnAggregationQueryRewrite;
 extern bool EnableIdIndexCustomCostFunction;
 extern bool EnableCompositeParallelIndexScan;
+extern bool EnableSinglePathParallelIndexScan;
 extern bool ForceParallelScanIfAvailable;
 
 planner_hook_type ExtensionPreviousPlannerHook = NULL;
@@ -771,6 +772,50 @@ LogRelationIndexesOrder(const RelOptInfo *rel)
 }
 
 
+/*
+ * Indexes of collections created with "indexKeyFields" may be built on the
+ * index_document column (see GetIndexColumnName in create_indexes.c), which
+ * holds the indexed fields of the document unchanged. Queries only ever filter
+ * and sort on the document, so present these index columns as the document:
+ * quals and orderings on the document then match the index exactly as they
+ * would if it were built on the document, and rechecks evaluate the document.
+ */
+static void
+MapIndexKeyColumnToDocument(Oid relationObjectId, RelOptInfo *rel)
+{
+	ListCell *cell;
+	foreach(cell, rel->indexlist)
+	{
+		IndexOptInfo *index = lfirst(cell);
+		for (int i = 0; i < index->ncolumns; i++)
+		{
+			if (index->indexkeys[i] <= DOCUMENT_DATA_TABLE_DOCUMENT_VAR_ATTR_NUMBER)
+			{
+				continue;
+			}
+
+			char *attName = get_attname(relationObjectId, index->indexkeys[i], false);
+			if (strcmp(attName, DOCUMENT_DATA_TABLE_INDEX_KEY_COLUMN_NAME) != 0)
+			{
+				continue;
+			}
+
+			index->indexkeys[i] = DOCUMENT_DATA_TABLE_DOCUMENT_VAR_ATTR_NUMBER;
+
+			/* Index only scans map the document Var through the index tlist */
+			TargetEntry *indexTle = list_nth(index->indextlist, i);
+			if (IsA(indexTle->expr, Var))
+			{
+				Var *documentVar = copyObject((Var *) indexTle->expr);
+				documentVar->varattno = DOCUMENT_DATA_TABLE_DOCUMENT_VAR_ATTR_NUMBER;
+				documentVar->varattnosyn = DOCUMENT_DATA_TABLE_DOCUMENT_VAR_ATTR_NUMBER;
+				indexTle->expr = (Expr *) documentVar;
+			}
+		}
+	}
+}
+
+
 /*
  * ExtensionGetRelationInfoHookCore is the core implementation of the get_relation_info
  * hook for the DocumentDB API extension. It modifies the relation info based on the
@@ -794,6 +839,11 @@ ExtensionGetRelationInfoHookCore(PlannerInfo *root, Oid relationObjectId,
 		return;
 	}
 
+	if (rel->indexlist != NIL)
+	{
+		MapIndexKeyColumnToDocument(relationObjectId, rel);
+	}
+
 	if (EnableIndexPriorityOrdering && rel->indexlist != NIL)
 	{
 		list_sort(rel->indexlist, CompareIndexOptionsFunc);
@@ -816,6 +866,12 @@ ExtensionGetRelationInfoHookCore(PlannerInfo *root, Oid relationObjectId,
 			{
 				firstIndex->amcanparallel = EnableCompositeParallelIndexScan;
 			}
+			else if (firstIndex->ncolumns == 1 &&
+					 IsSinglePathOpFamilyOidWithParallelSupport(firstIndex->relam,
+																firstIndex->opfamily[0]))
+			{
+				firstIndex->amcanparallel = EnableSinglePathParallelIndexScan;
+			}
 		}
 	}
 
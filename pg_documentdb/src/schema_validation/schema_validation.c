@@ -9,13 +9,50 @@
  */
 
 #include <postgres.h>
+#include <utils/hsearch.h>
+#include <utils/memutils.h>
 #include "utils/feature_counter.h"
 #include "operators/bson_expr_eval.h"
 #include "schema_validation/schema_validation.h"
 #include "metadata/collection.h"
 #include "utils/documentdb_errors.h"
 
+/*
+ * Entry of the backend local cache of compiled schema validators.
+ */
+typedef struct SchemaValidationCacheEntry
+{
+	/* key for hash entry; should be the first field */
+	uint64 collectionId;
+
+	/* the validator the state was compiled from */
+	pgbson *validator;
+
+	/* memory context holding the validator copy and the state */
+	MemoryContext context;
+
+	/* the compiled validator */
+	ExprEvalState *state;
+} SchemaValidationCacheEntry;
+
 extern bool EnableSchemaValidation;
+extern bool EnableSchemaValidatorCache;
+
+/* collection id -> compiled validator */
+static HTAB *SchemaValidationCacheHash = NULL;
+
+/* set to false on collection cache resets (e.g. drop+create extension) */
+static bool SchemaValidationCacheIsValid = false;
+
+/*
+ * Memory contexts of replaced cache entries. Their states may still be in use
+ * by the running command, so they are only deleted at the end of the transaction.
+ */
+static List *RetiredSchemaValidationContexts = NIL;
+
+static void InitializeSchemaValidationCache(void);
+static void RetireSchemaValidationContext(MemoryContext context);
+
 PG_FUNCTION_INFO_V1(command_schema_validation_against_update);
 
 /*
@@ -92,6 +129,124 @@ PrepareForSchemaValidation(pgbson *schemaValidationInfo, MemoryContext memoryCon
 }
 
 
+/*
+ * Prepare for schema validation of writes to the given collection.
+ * When the schema validator cache is enabled, the state compiled for the
+ * collection is kept in a backend local cache and reused by the following
+ * commands as long as the validator of the collection doesn't change (e.g.
+ * through collMod). Otherwise, this is the same as PrepareForSchemaValidation.
+ * The state must be released with FreeSchemaValidationState.
+ */
+ExprEvalState *
+PrepareForCollectionSchemaValidation(const MongoCollection *collection,
+									 MemoryContext memoryContext)
+{
+	pgbson *validator = collection->schemaValidator.validator;
+	if (!EnableSchemaValidatorCache)
+	{
+		return PrepareForSchemaValidation(validator, memoryContext);
+	}
+
+	InitializeSchemaValidationCache();
+
+	bool found = false;
+	SchemaValidationCacheEntry *entry = hash_search(SchemaValidationCacheHash,
+													&(collection->collectionId),
+													HASH_ENTER, &found);
+	if (found)
+	{
+		if (PgbsonEquals(entry->validator, validator))
+		{
+			return entry->state;
+		}
+
+		RetireSchemaValidationContext(entry->context);
+	}
+
+	/* make sure a failure below doesn't leave a half built entry behind */
+	entry->context = NULL;
+	entry->validator = NULL;
+	entry->state = NULL;
+
+	MemoryContext entryContext = AllocSetContextCreate(CacheMemoryContext,
+													   "Schema validator cache entry",
+													   ALLOCSET_SMALL_SIZES);
+	PG_TRY();
+	{
+		entry->state = PrepareForSchemaValidation(validator, entryContext);
+		entry->validator = CopyPgbsonIntoMemoryContext(validator, entryContext);
+	}
+	PG_CATCH();
+	{
+		hash_search(SchemaValidationCacheHash, &(collection->collectionId),
+					HASH_REMOVE, NULL);
+		MemoryContextDelete(entryContext);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+
+	entry->context = entryContext;
+	return entry->state;
+}
+
+
+/*
+ * Frees a state returned by PrepareForCollectionSchemaValidation unless
+ * it is owned by the schema validator cache.
+ */
+void
+FreeSchemaValidationState(const MongoCollection *collection, ExprEvalState *state,
+						  MemoryContext memoryContext)
+{
+	if (state == NULL)
+	{
+		return;
+	}
+
+	if (SchemaValidationCacheIsValid)
+	{
+		SchemaValidationCacheEntry *entry = hash_search(SchemaValidationCacheHash,
+														&(collection->collectionId),
+														HASH_FIND, NULL);
+		if (entry != NULL && entry->state == state)
+		{
+			return;
+		}
+	}
+
+	FreeExprEvalState(state, memoryContext);
+}
+
+
+/*
+ * Marks the schema validator cache as invalid, called when the collections
+ * cache is reset. The cache is rebuilt on the next use.
+ */
+void
+ResetSchemaValidationCache(void)
+{
+	SchemaValidationCacheIsValid = false;
+}
+
+
+/*
+ * Deletes the memory contexts of the cache entries that were replaced
+ * or invalidated during the transaction. Called at the end of the transaction.
+ */
+void
+ReleaseRetiredSchemaValidationStates(void)
+{
+	ListCell *cell;
+	foreach(cell, RetiredSchemaValidationContexts)
+	{
+		MemoryContextDelete((MemoryContext) lfirst(cell));
+	}
+
+	list_free(RetiredSchemaValidationContexts);
+	RetiredSchemaValidationContexts = NIL;
+}
+
+
 void
 AssignSchemaValidationState(ExprEvalState *stateForSchemaValidation,
 							pgbson *schemaValidationInfo, MemoryContext memoryContext)
@@ -157,3 +312,58 @@ ValidateSchemaOnDocumentUpdate(ValidationLevels validationLevel,
 		}
 	}
 }
+
+
+/*
+ * (Re)creates the schema validator cache if it is not valid. The states of
+ * the previous entries are retired, since they may still be in use.
+ */
+static void
+InitializeSchemaValidationCache(void)
+{
+	if (SchemaValidationCacheIsValid)
+	{
+		return;
+	}
+
+	if (SchemaValidationCacheHash != NULL)
+	{
+		HASH_SEQ_STATUS status;
+		SchemaValidationCacheEntry *entry;
+		hash_seq_init(&status, SchemaValidationCacheHash);
+		while ((entry = hash_seq_search(&status)) != NULL)
+		{
+			if (entry->context != NULL)
+			{
+				RetireSchemaValidationContext(entry->context);
+			}
+		}
+
+		hash_destroy(SchemaValidationCacheHash);
+		SchemaValidationCacheHash = NULL;
+	}
+
+	HASHCTL info;
+	memset(&info, 0, sizeof(info));
+	info.keysize = sizeof(uint64);
+	info.entrysize = sizeof(SchemaValidationCacheEntry);
+	info.hcxt = CacheMemoryContext;
+
+	SchemaValidationCacheHash = hash_create("Schema Validator Cache", 32, &info,
+											HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	SchemaValidationCacheIsValid = true;
+}
+
+
+/*
+ * Queues the memory context of a cache entry for deletion at the end
+ * of the transaction.
+ */
+static void
+RetireSchemaValidationContext(MemoryContext context)
+{
+	MemoryContext oldContext = MemoryContextSwitchTo(CacheMemoryContext);
+	RetiredSchemaValidationContexts = lappend(RetiredSchemaValidationContexts,
+											  context);
+	MemoryContextSwitchTo(oldContext);
+}
@@ -0,0 +1,46 @@
+SET search_path TO documentdb_api_catalog, documentdb_core, public;
+SET documentdb.next_collection_id TO 1100;
+SET documentdb.next_collection_index_id TO 1100;
+
+SELECT documentdb_api.create_collection('union_db', 'entry_union');
+
+SELECT documentdb_api_internal.create_indexes_non_concurrently(
+    'union_db',
+    '{ "createIndexes": "entry_union", "indexes": [ { "key": { "a": 1 }, "name": "a_1", "enableCompositeTerm": false } ] }', TRUE);
+
+SELECT COUNT(documentdb_api.insert_one('union_db', 'entry_union',  FORMAT('{ "_id": %s, "a": %s }', i, i % 50)::bson)) FROM generate_series(1, 200) AS i;
+SELECT COUNT(documentdb_api.insert_one('union_db', 'entry_union',  FORMAT('{ "_id": %s, "a": [ 1, 2 ] }', i)::bson)) FROM generate_series(201, 210) AS i;
+
+set documentdb.forceDisableSeqScan to on;
+set enable_indexscan to off;
+set documentdb.enableExtendedExplainPlans to on;
+
+-- bitmap scans merging the entries item by item
+SELECT COUNT(*) FROM bson_aggregation_find('union_db', '{ "find": "entry_union", "filter": { "a": { "$in": [ 1, 2, 3, 7, 100 ] } } }');
+SELECT COUNT(*) FROM bson_aggregation_find('union_db', '{ "find": "entry_union", "filter": { "a": { "$in": [ 1, "abc", 49 ] } } }');
+SELECT COUNT(*) FROM bson_aggregation_find('union_db', '{ "find": "entry_union", "filter": { "a": { "$in": [ null, 3 ] } } }');
+SELECT COUNT(*) FROM bson_aggregation_find('union_db', '{ "find": "entry_union", "filter": { "a": { "$in": [ 5 ] } } }');
+-- the entries are merged item by item
+SELECT line FROM documentdb_test_helpers.run_explain_and_trim($cmd$ EXPLAIN (COSTS OFF, ANALYZE ON, VERBOSE OFF, BUFFERS OFF, SUMMARY OFF, TIMING OFF)
+    SELECT document FROM bson_aggregation_find('union_db', '{ "find": "entry_union", "filter": { "a": { "$in": [ 1, 2, 3, 7, 100 ] } } }') $cmd$) AS line
+    WHERE line ~ 'scanType|bitmapEntryUnion';
+
+-- bitmap scans adding each entry to the bitmap
+set documentdb_rum.enable_bitmap_entry_union to on;
+SELECT COUNT(*) FROM bson_aggregation_find('union_db', '{ "find": "entry_union", "filter": { "a": { "$in": [ 1, 2, 3, 7, 100 ] } } }');
+SELECT COUNT(*) FROM bson_aggregation_find('union_db', '{ "find": "entry_union", "filter": { "a": { "$in": [ 1, "abc", 49 ] } } }');
+SELECT COUNT(*) FROM bson_aggregation_find('union_db', '{ "find": "entry_union", "filter": { "a": { "$in": [ null, 3 ] } } }');
+SELECT COUNT(*) FROM bson_aggregation_find('union_db', '{ "find": "entry_union", "filter": { "a": { "$in": [ 5 ] } } }');
+-- every entry is added to the bitmap on its own, but not for a single entry
+SELECT line FROM documentdb_test_helpers.run_explain_and_trim($cmd$ EXPLAIN (COSTS OFF, ANALYZE ON, VERBOSE OFF, BUFFERS OFF, SUMMARY OFF, TIMING OFF)
+    SELECT document FROM bson_aggregation_find('union_db', '{ "find": "entry_union", "filter": { "a": { "$in": [ 1, 2, 3, 7, 100 ] } } }') $cmd$) AS line
+    WHERE line ~ 'scanType|bitmapEntryUnion';
+SELECT line FROM documentdb_test_helpers.run_explain_and_trim($cmd$ EXPLAIN (COSTS OFF, ANALYZE ON, VERBOSE OFF, BUFFERS OFF, SUMMARY OFF, TIMING OFF)
+    SELECT document FROM bson_aggregation_find('union_db', '{ "find": "entry_union", "filter": { "a": { "$in": [ 5 ] } } }') $cmd$) AS line
+    WHERE line ~ 'scanType|bitmapEntryUnion';
+
+reset documentdb_rum.enable_bitmap_entry_union;
+reset documentdb.enableExtendedExplainPlans;
+reset enable_indexscan;
+reset documentdb.forceDisableSeqScan;
+SELECT documentdb_api.drop_collection('union_db', 'entry_union');
@@ -0,0 +1,179 @@
+SET search_path TO documentdb_api_catalog, documentdb_core, public;
+SET documentdb.next_collection_id TO 1400;
+SET documentdb.next_collection_index_id TO 1400;
+
+-- reset the feature counters, the index term scans are counted from here on
+SELECT COUNT(*) * 0 AS count FROM documentdb_api_internal.command_feature_counter_stats(true);
+
+-- null and missing values, numerically equal values and one of every other kind are served from the index
+SELECT documentdb_api.create_collection('distinct_db', 'distinct_values');
+SELECT documentdb_api_internal.create_indexes_non_concurrently(
+    'distinct_db', '{ "createIndexes": "distinct_values", "indexes": [ { "key": { "a": 1 }, "name": "a_1" } ] }', TRUE);
+SELECT COUNT(documentdb_api.insert_one('distinct_db', 'distinct_values', doc::bson)) FROM (VALUES
+    ('{ "_id": 1, "a": 1 }'),
+    ('{ "_id": 2, "a": 1.0 }'),
+    ('{ "_id": 3, "a": { "$numberLong": "1" } }'),
+    ('{ "_id": 4, "a": null }'),
+    ('{ "_id": 5, "b": 1 }'),
+    ('{ "_id": 6, "a": "one" }'),
+    ('{ "_id": 7, "a": { "b": 1 } }'),
+    ('{ "_id": 8, "a": 2.5 }'),
+    ('{ "_id": 9, "a": true }')) AS v(doc);
+set documentdb.enableDistinctIndexTermScan to on;
+CREATE TEMP TABLE distinct_on AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_values", "key": "a" }');
+set documentdb.enableDistinctIndexTermScan to off;
+CREATE TEMP TABLE distinct_off AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_values", "key": "a" }');
+SELECT document FROM distinct_on;
+WITH values_on AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_on),
+    values_off AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_off)
+SELECT (SELECT COUNT(*) FROM values_on) AS count_on, (SELECT COUNT(*) FROM values_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM values_on EXCEPT ALL SELECT * FROM values_off) UNION ALL (SELECT * FROM values_off EXCEPT ALL SELECT * FROM values_on)) AS same_values;
+SELECT COALESCE(SUM(usage_count), 0) AS index_term_scans FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'distinct_index_term_scan';
+DROP TABLE distinct_on, distinct_off;
+
+-- only missing values leave no term to serve
+SELECT documentdb_api.delete('distinct_db', '{ "delete": "distinct_values", "deletes": [ { "q": { "a": { "$exists": true } }, "limit": 0 } ] }');
+set documentdb.enableDistinctIndexTermScan to on;
+CREATE TEMP TABLE distinct_on AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_values", "key": "a" }');
+set documentdb.enableDistinctIndexTermScan to off;
+CREATE TEMP TABLE distinct_off AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_values", "key": "a" }');
+SELECT document FROM distinct_on;
+WITH values_on AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_on),
+    values_off AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_off)
+SELECT (SELECT COUNT(*) FROM values_on) AS count_on, (SELECT COUNT(*) FROM values_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM values_on EXCEPT ALL SELECT * FROM values_off) UNION ALL (SELECT * FROM values_off EXCEPT ALL SELECT * FROM values_on)) AS same_values;
+SELECT COALESCE(SUM(usage_count), 0) AS index_term_scans FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'distinct_index_term_scan';
+DROP TABLE distinct_on, distinct_off;
+
+-- an array makes the index multikey, the regular distinct unwinds it
+SELECT documentdb_api.create_collection('distinct_db', 'distinct_multikey');
+SELECT documentdb_api_internal.create_indexes_non_concurrently(
+    'distinct_db', '{ "createIndexes": "distinct_multikey", "indexes": [ { "key": { "a": 1 }, "name": "a_1" } ] }', TRUE);
+SELECT COUNT(documentdb_api.insert_one('distinct_db', 'distinct_multikey', doc::bson)) FROM (VALUES
+    ('{ "_id": 1, "a": 1 }'),
+    ('{ "_id": 2, "a": [ 1, 2, { "$numberLong": "3" } ] }'),
+    ('{ "_id": 3, "a": "three" }')) AS v(doc);
+set documentdb.enableDistinctIndexTermScan to on;
+CREATE TEMP TABLE distinct_on AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_multikey", "key": "a" }');
+set documentdb.enableDistinctIndexTermScan to off;
+CREATE TEMP TABLE distinct_off AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_multikey", "key": "a" }');
+WITH values_on AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_on),
+    values_off AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_off)
+SELECT (SELECT COUNT(*) FROM values_on) AS count_on, (SELECT COUNT(*) FROM values_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM values_on EXCEPT ALL SELECT * FROM values_off) UNION ALL (SELECT * FROM values_off EXCEPT ALL SELECT * FROM values_on)) AS same_values;
+SELECT COALESCE(SUM(usage_count), 0) AS index_term_scans FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'distinct_index_term_scan';
+DROP TABLE distinct_on, distinct_off;
+
+-- truncated terms only have a prefix of the value
+SELECT documentdb_api.create_collection('distinct_db', 'distinct_truncated');
+SET documentdb.indexTermLimitOverride TO 100;
+SELECT documentdb_api_internal.create_indexes_non_concurrently(
+    'distinct_db', '{ "createIndexes": "distinct_truncated", "indexes": [ { "key": { "a": 1 }, "name": "a_1" } ] }', TRUE);
+RESET documentdb.indexTermLimitOverride;
+SELECT COUNT(documentdb_api.insert_one('distinct_db', 'distinct_truncated', FORMAT('{ "_id": %s, "a": "%s" }', i, repeat('a', 150) || i)::bson)) FROM generate_series(1, 3) AS i;
+SELECT documentdb_api.insert_one('distinct_db', 'distinct_truncated', '{ "_id": 4, "a": "short" }');
+set documentdb.enableDistinctIndexTermScan to on;
+CREATE TEMP TABLE distinct_on AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_truncated", "key": "a" }');
+set documentdb.enableDistinctIndexTermScan to off;
+CREATE TEMP TABLE distinct_off AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_truncated", "key": "a" }');
+WITH values_on AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_on),
+    values_off AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_off)
+SELECT (SELECT COUNT(*) FROM values_on) AS count_on, (SELECT COUNT(*) FROM values_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM values_on EXCEPT ALL SELECT * FROM values_off) UNION ALL (SELECT * FROM values_off EXCEPT ALL SELECT * FROM values_on)) AS same_values;
+SELECT COALESCE(SUM(usage_count), 0) AS index_term_scans FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'distinct_index_term_scan';
+DROP TABLE distinct_on, distinct_off;
+
+-- keys in the pending list aren't in the entry tree yet, once vacuum moves them there the index is used
+SELECT documentdb_api.create_collection('distinct_db', 'distinct_pending');
+SELECT documentdb_api_internal.create_indexes_non_concurrently(
+    'distinct_db', '{ "createIndexes": "distinct_pending", "indexes": [ { "key": { "a": 1 }, "name": "a_1" } ] }', TRUE);
+ALTER TABLE documentdb_data.documents_1404 SET (autovacuum_enabled = off);
+ALTER INDEX documentdb_data.documents_rum_index_1408 SET (fastupdate = on);
+SELECT COUNT(documentdb_api.insert_one('distinct_db', 'distinct_pending', FORMAT('{ "_id": %s, "a": %s }', i, i % 5)::bson)) FROM generate_series(1, 20) AS i;
+set documentdb.enableDistinctIndexTermScan to on;
+CREATE TEMP TABLE distinct_on AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_pending", "key": "a" }');
+set documentdb.enableDistinctIndexTermScan to off;
+CREATE TEMP TABLE distinct_off AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_pending", "key": "a" }');
+WITH values_on AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_on),
+    values_off AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_off)
+SELECT (SELECT COUNT(*) FROM values_on) AS count_on, (SELECT COUNT(*) FROM values_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM values_on EXCEPT ALL SELECT * FROM values_off) UNION ALL (SELECT * FROM values_off EXCEPT ALL SELECT * FROM values_on)) AS same_values;
+SELECT COALESCE(SUM(usage_count), 0) AS index_term_scans FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'distinct_index_term_scan';
+DROP TABLE distinct_on, distinct_off;
+VACUUM documentdb_data.documents_1404;
+set documentdb.enableDistinctIndexTermScan to on;
+CREATE TEMP TABLE distinct_on AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_pending", "key": "a" }');
+set documentdb.enableDistinctIndexTermScan to off;
+CREATE TEMP TABLE distinct_off AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_pending", "key": "a" }');
+SELECT document FROM distinct_on;
+WITH values_on AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_on),
+    values_off AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_off)
+SELECT (SELECT COUNT(*) FROM values_on) AS count_on, (SELECT COUNT(*) FROM values_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM values_on EXCEPT ALL SELECT * FROM values_off) UNION ALL (SELECT * FROM values_off EXCEPT ALL SELECT * FROM values_on)) AS same_values;
+SELECT COALESCE(SUM(usage_count), 0) AS index_term_scans FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'distinct_index_term_scan';
+DROP TABLE distinct_on, distinct_off;
+
+-- keys with posting trees release the entry page while the tree is walked, restart from the root after each of them
+SELECT documentdb_api.create_collection('distinct_db', 'distinct_restart');
+ALTER TABLE documentdb_data.documents_1405 SET (autovacuum_enabled = off);
+SELECT COUNT(documentdb_api.insert_one('distinct_db', 'distinct_restart', FORMAT('{ "_id": %s, "a": %s }', i, CASE WHEN i % 1000 = 0 THEN 100 + i / 1000 ELSE i % 3 END)::bson)) FROM generate_series(1, 10000) AS i;
+SELECT documentdb_api_internal.create_indexes_non_concurrently(
+    'distinct_db', '{ "createIndexes": "distinct_restart", "indexes": [ { "key": { "a": 1 }, "name": "a_1" } ] }', TRUE);
+SELECT COUNT(*) > 0 AS has_posting_tree_leaves FROM generate_series(1, (pg_relation_size('documentdb_data.documents_rum_index_1410') / 8192)::int - 1) AS blkno
+    WHERE documentdb_api_internal.documentdb_rum_page_get_stats(public.get_raw_page('documentdb_data.documents_rum_index_1410', blkno))->>'flagsStr' LIKE '%LEAF%DATA%';
+set documentdb.enableDistinctIndexTermScan to on;
+CREATE TEMP TABLE distinct_on AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_restart", "key": "a" }');
+set documentdb.enableDistinctIndexTermScan to off;
+CREATE TEMP TABLE distinct_off AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_restart", "key": "a" }');
+SELECT document FROM distinct_on;
+WITH values_on AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_on),
+    values_off AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_off)
+SELECT (SELECT COUNT(*) FROM values_on) AS count_on, (SELECT COUNT(*) FROM values_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM values_on EXCEPT ALL SELECT * FROM values_off) UNION ALL (SELECT * FROM values_off EXCEPT ALL SELECT * FROM values_on)) AS same_values;
+SELECT COALESCE(SUM(usage_count), 0) AS index_term_scans FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'distinct_index_term_scan';
+DROP TABLE distinct_on, distinct_off;
+set documentdb_rum.enable_inject_distinct_entry_restart to on;
+set documentdb.enableDistinctIndexTermScan to on;
+CREATE TEMP TABLE distinct_on AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_restart", "key": "a" }');
+set documentdb.enableDistinctIndexTermScan to off;
+CREATE TEMP TABLE distinct_off AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_restart", "key": "a" }');
+SELECT document FROM distinct_on;
+WITH values_on AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_on),
+    values_off AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_off)
+SELECT (SELECT COUNT(*) FROM values_on) AS count_on, (SELECT COUNT(*) FROM values_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM values_on EXCEPT ALL SELECT * FROM values_off) UNION ALL (SELECT * FROM values_off EXCEPT ALL SELECT * FROM values_on)) AS same_values;
+SELECT COALESCE(SUM(usage_count), 0) AS index_term_scans FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'distinct_index_term_scan';
+DROP TABLE distinct_on, distinct_off;
+
+-- a key whose documents are all deleted is skipped, including across a restart
+SELECT documentdb_api.delete('distinct_db', '{ "delete": "distinct_restart", "deletes": [ { "q": { "a": 1 }, "limit": 0 } ] }');
+set documentdb.enableDistinctIndexTermScan to on;
+CREATE TEMP TABLE distinct_on AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_restart", "key": "a" }');
+set documentdb.enableDistinctIndexTermScan to off;
+CREATE TEMP TABLE distinct_off AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_restart", "key": "a" }');
+SELECT document FROM distinct_on;
+WITH values_on AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_on),
+    values_off AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_off)
+SELECT (SELECT COUNT(*) FROM values_on) AS count_on, (SELECT COUNT(*) FROM values_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM values_on EXCEPT ALL SELECT * FROM values_off) UNION ALL (SELECT * FROM values_off EXCEPT ALL SELECT * FROM values_on)) AS same_values;
+SELECT COALESCE(SUM(usage_count), 0) AS index_term_scans FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'distinct_index_term_scan';
+DROP TABLE distinct_on, distinct_off;
+reset documentdb_rum.enable_inject_distinct_entry_restart;
+set documentdb.enableDistinctIndexTermScan to on;
+CREATE TEMP TABLE distinct_on AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_restart", "key": "a" }');
+set documentdb.enableDistinctIndexTermScan to off;
+CREATE TEMP TABLE distinct_off AS SELECT document FROM documentdb_api.distinct_query('distinct_db', '{ "distinct": "distinct_restart", "key": "a" }');
+SELECT document FROM distinct_on;
+WITH values_on AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_on),
+    values_off AS (SELECT bson_dollar_unwind(document, '$values') AS value FROM distinct_off)
+SELECT (SELECT COUNT(*) FROM values_on) AS count_on, (SELECT COUNT(*) FROM values_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM values_on EXCEPT ALL SELECT * FROM values_off) UNION ALL (SELECT * FROM values_off EXCEPT ALL SELECT * FROM values_on)) AS same_values;
+SELECT COALESCE(SUM(usage_count), 0) AS index_term_scans FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'distinct_index_term_scan';
+DROP TABLE distinct_on, distinct_off;
+reset documentdb.enableDistinctIndexTermScan;
+
+SELECT documentdb_api.drop_collection('distinct_db', 'distinct_values');
+SELECT documentdb_api.drop_collection('distinct_db', 'distinct_multikey');
+SELECT documentdb_api.drop_collection('distinct_db', 'distinct_truncated');
+SELECT documentdb_api.drop_collection('distinct_db', 'distinct_pending');
+SELECT documentdb_api.drop_collection('distinct_db', 'distinct_restart');
@@ -0,0 +1,29 @@
+SET search_path TO documentdb_api_catalog, documentdb_core, public;
+SET documentdb.next_collection_id TO 1200;
+SET documentdb.next_collection_index_id TO 1200;
+
+
+SELECT documentdb_api.create_collection('presence_db', 'sparse_path');
+
+SELECT documentdb_api_internal.create_indexes_non_concurrently(
+    'presence_db',
+    '{ "createIndexes": "sparse_path", "indexes": [ { "key": { "b": 1 }, "name": "b_1", "enableCompositeTerm": false } ] }', TRUE);
+
+SELECT COUNT(documentdb_api.insert_one('presence_db', 'sparse_path',  FORMAT('{ "_id": %s, "a": %s }', i, i)::bson)) FROM generate_series(1, 500) AS i WHERE i % 50 != 0;
+SELECT COUNT(documentdb_api.insert_one('presence_db', 'sparse_path',  FORMAT('{ "_id": %s, "a": %s, "b": %s }', i, i, i / 50)::bson)) FROM generate_series(1, 500) AS i WHERE i % 50 = 0;
+
+ANALYZE documentdb_data.documents_1201;
+set enable_bitmapscan to off;
+
+-- costed with the table statistics only: the sparse path looks like a full scan
+EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('presence_db', '{ "find": "sparse_path", "filter": { "b": { "$exists": true } } }');
+EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('presence_db', '{ "find": "sparse_path", "filter": { "b": { "$exists": false } } }');
+
+-- costed with the posting sizes of the index entries: only 10 documents have the path
+set documentdb_rum.enable_entry_presence_cost_estimate to on;
+EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('presence_db', '{ "find": "sparse_path", "filter": { "b": { "$exists": true } } }');
+EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('presence_db', '{ "find": "sparse_path", "filter": { "b": { "$exists": false } } }');
+
+reset documentdb_rum.enable_entry_presence_cost_estimate;
+reset enable_bitmapscan;
+SELECT documentdb_api.drop_collection('presence_db', 'sparse_path');
@@ -60,4 +60,38 @@ SELECT documentdb_test_helpers.run_explain_and_trim(
 
 SELECT documentdb_test_helpers.run_explain_and_trim(
     $cmd$ EXPLAIN (COSTS OFF, ANALYZE ON, VERBOSE OFF, BUFFERS OFF, SUMMARY OFF, TIMING OFF) SELECT document FROM bson_aggregation_find('p_ixscan',
-        '{ "find": "parallel_scan", "filter": { "b": { "$gt": 10, "$lt": 50 } }, "sort": { "b": 1 } }') $cmd$);
\ No newline at end of file
+        '{ "find": "parallel_scan", "filter": { "b": { "$gt": 10, "$lt": 50 } }, "sort": { "b": 1 } }') $cmd$);
+
+-- parallel regular scans on single path indexes
+set documentdb.enableSinglePathParallelIndexScan to on;
+set documentdb_rum.enable_parallel_regular_scan to on;
+SELECT document FROM bson_aggregation_count('p_ixscan', '{ "count": "parallel_scan", "query": { "b": { "$gt": 10, "$lt": 50 } } }');
+SELECT document FROM bson_aggregation_count('p_ixscan', '{ "count": "parallel_scan", "query": { "b": { "$in": [ 5, 500, 995 ] } } }');
+SELECT document FROM bson_aggregation_count('p_ixscan', '{ "count": "parallel_scan", "query": { "b": { "$gte": 1 } } }');
+SELECT document FROM bson_aggregation_count('p_ixscan', '{ "count": "parallel_scan", "query": { "b": { "$gt": 10 }, "_id": { "$lt": 100 } } }');
+
+-- regular scans hand out the heap in ranges of 64 blocks: the table spans several ranges
+-- and the matches are spread over all of them
+SELECT documentdb_api.create_collection('p_ixscan', 'parallel_ranges');
+ALTER TABLE documentdb_data.documents_902 SET (autovacuum_enabled = off, parallel_workers = 2);
+SELECT COUNT(documentdb_api.insert_one('p_ixscan', 'parallel_ranges', FORMAT('{ "_id": %s, "b": %s, "c": "%s" }', i, i % 100, repeat('c', 500))::bson)) FROM generate_series(1, 10000) AS i;
+SELECT documentdb_api_internal.create_indexes_non_concurrently(
+    'p_ixscan',
+    '{ "createIndexes": "parallel_ranges", "indexes": [ { "key": { "b": 1 }, "name": "b_1", "enableCompositeTerm": false } ] }', TRUE);
+SELECT pg_relation_size('documentdb_data.documents_902') / 8192 > 4 * 64 AS spans_several_ranges;
+SELECT documentdb_test_helpers.run_explain_and_trim(
+    $cmd$ EXPLAIN (COSTS OFF, ANALYZE ON, VERBOSE OFF, BUFFERS OFF, SUMMARY OFF, TIMING OFF) SELECT document FROM bson_aggregation_find('p_ixscan',
+        '{ "find": "parallel_ranges", "filter": { "b": { "$lt": 10 } } }') $cmd$);
+-- every match is returned by exactly one worker
+SELECT COUNT(*) AS matches, COUNT(DISTINCT document::text) AS distinct_matches FROM bson_aggregation_find('p_ixscan',
+    '{ "find": "parallel_ranges", "filter": { "b": { "$lt": 10 } } }');
+
+-- matches in the pending list are only known to the thread that started the scan, which then
+-- runs it alone: workers never read or clean up the pending list
+ALTER INDEX documentdb_data.documents_rum_index_905 SET (fastupdate = on);
+SELECT COUNT(documentdb_api.insert_one('p_ixscan', 'parallel_ranges', FORMAT('{ "_id": %s, "b": %s }', i, i % 100)::bson)) FROM generate_series(10001, 10100) AS i;
+SELECT documentdb_test_helpers.run_explain_and_trim(
+    $cmd$ EXPLAIN (COSTS OFF, ANALYZE ON, VERBOSE OFF, BUFFERS OFF, SUMMARY OFF, TIMING OFF) SELECT document FROM bson_aggregation_find('p_ixscan',
+        '{ "find": "parallel_ranges", "filter": { "b": { "$lt": 10 } } }') $cmd$);
+SELECT COUNT(*) AS matches, COUNT(DISTINCT document::text) AS distinct_matches FROM bson_aggregation_find('p_ixscan',
+    '{ "find": "parallel_ranges", "filter": { "b": { "$lt": 10 } } }');
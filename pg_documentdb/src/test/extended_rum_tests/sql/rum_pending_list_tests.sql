@@ -0,0 +1,55 @@
+SET search_path TO documentdb_api_catalog, documentdb_core, public;
+SET documentdb.next_collection_id TO 1000;
+SET documentdb.next_collection_index_id TO 1000;
+
+SELECT documentdb_api.create_collection('pending_db', 'pending_list');
+
+SELECT documentdb_api_internal.create_indexes_non_concurrently(
+    'pending_db',
+    '{ "createIndexes": "pending_list", "indexes": [ { "key": { "a": 1 }, "name": "a_1", "enableCompositeTerm": true } ] }', TRUE);
+
+-- route new inserts through the pending list
+ALTER TABLE documentdb_data.documents_1001 SET (autovacuum_enabled = off);
+ALTER INDEX documentdb_data.documents_rum_index_1002 SET (fastupdate = on);
+
+SELECT COUNT(documentdb_api.insert_one('pending_db', 'pending_list',  FORMAT('{ "_id": %s, "a": %s }', i, i)::bson)) FROM generate_series(1, 100) AS i;
+SELECT COUNT(*) > 0 AS has_pending_pages FROM generate_series(1, (pg_relation_size('documentdb_data.documents_rum_index_1002') / 8192)::int - 1) AS blkno
+    WHERE documentdb_api_internal.documentdb_rum_page_get_stats(public.get_raw_page('documentdb_data.documents_rum_index_1002', blkno))->>'flagsStr' LIKE '%LIST%';
+
+set documentdb.forceDisableSeqScan to on;
+
+-- bitmap scans read the pending list directly
+set enable_indexscan to off;
+SELECT COUNT(*) FROM bson_aggregation_find('pending_db', '{ "find": "pending_list", "filter": { "a": { "$gte": 50 } } }');
+SELECT COUNT(*) FROM bson_aggregation_find('pending_db', '{ "find": "pending_list", "filter": { "a": 25 } }');
+
+-- index scans return the matches in the pending list ahead of the index, and leave the list in place
+reset enable_indexscan;
+set enable_bitmapscan to off;
+EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('pending_db', '{ "find": "pending_list", "filter": { "a": { "$gte": 50 } } }');
+SELECT COUNT(*) FROM bson_aggregation_find('pending_db', '{ "find": "pending_list", "filter": { "a": { "$gte": 50 } } }');
+SELECT COUNT(*) FROM bson_aggregation_find('pending_db', '{ "find": "pending_list", "filter": { "a": 25 } }');
+SELECT COUNT(*) FROM bson_aggregation_find('pending_db', '{ "find": "pending_list", "filter": { "a": { "$in": [ 10, 20, 30 ] } } }');
+SELECT COUNT(*) > 0 AS has_pending_pages FROM generate_series(1, (pg_relation_size('documentdb_data.documents_rum_index_1002') / 8192)::int - 1) AS blkno
+    WHERE documentdb_api_internal.documentdb_rum_page_get_stats(public.get_raw_page('documentdb_data.documents_rum_index_1002', blkno))->>'flagsStr' LIKE '%LIST%';
+
+-- the order by is not pushed down to an index that can have a pending list
+EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('pending_db', '{ "find": "pending_list", "filter": { "a": { "$gte": 95 } }, "sort": { "a": 1 } }');
+SELECT document FROM bson_aggregation_find('pending_db', '{ "find": "pending_list", "filter": { "a": { "$gte": 95 } }, "sort": { "a": 1 } }');
+
+-- vacuum flushes anything appended since
+SELECT COUNT(documentdb_api.insert_one('pending_db', 'pending_list',  FORMAT('{ "_id": %s, "a": %s }', i, i)::bson)) FROM generate_series(101, 150) AS i;
+VACUUM documentdb_data.documents_1001;
+SELECT COUNT(*) > 0 AS has_pending_pages FROM generate_series(1, (pg_relation_size('documentdb_data.documents_rum_index_1002') / 8192)::int - 1) AS blkno
+    WHERE documentdb_api_internal.documentdb_rum_page_get_stats(public.get_raw_page('documentdb_data.documents_rum_index_1002', blkno))->>'flagsStr' LIKE '%LIST%';
+reset enable_bitmapscan;
+SELECT COUNT(*) FROM bson_aggregation_find('pending_db', '{ "find": "pending_list", "filter": { "a": { "$gte": 50 } } }');
+
+-- with fastupdate off and the list merged, the order by is pushed down again
+ALTER INDEX documentdb_data.documents_rum_index_1002 SET (fastupdate = off);
+set enable_bitmapscan to off;
+EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('pending_db', '{ "find": "pending_list", "filter": { "a": { "$gte": 95 } }, "sort": { "a": 1 } }');
+reset enable_bitmapscan;
+
+reset documentdb.forceDisableSeqScan;
+SELECT documentdb_api.drop_collection('pending_db', 'pending_list');
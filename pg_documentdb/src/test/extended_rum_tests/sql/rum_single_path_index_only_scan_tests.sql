@@ -0,0 +1,53 @@
+SET search_path TO documentdb_api_catalog, documentdb_core, public;
+SET documentdb.next_collection_id TO 1500;
+SET documentdb.next_collection_index_id TO 1500;
+
+set documentdb.enableSinglePathIndexOnlyScan to on;
+set documentdb.forceDisableSeqScan to on;
+set enable_bitmapscan to off;
+
+-- scalar values only: counts are answered from the index alone
+SELECT documentdb_api.create_collection('ios_db', 'ios_scalar');
+SELECT documentdb_api_internal.create_indexes_non_concurrently(
+    'ios_db', '{ "createIndexes": "ios_scalar", "indexes": [ { "key": { "a": 1 }, "name": "a_1", "enableCompositeTerm": false } ] }', TRUE);
+SELECT COUNT(documentdb_api.insert_one('ios_db', 'ios_scalar', FORMAT('{ "_id": %s, "a": %s }', i, i)::bson)) FROM generate_series(1, 100) AS i;
+EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_count('ios_db', '{ "count": "ios_scalar", "query": { "a": { "$gt": 90 } } }');
+-- the count matches the one of the regular index scan
+SELECT document FROM bson_aggregation_count('ios_db', '{ "count": "ios_scalar", "query": { "a": { "$gt": 90 } } }');
+set documentdb.enableSinglePathIndexOnlyScan to off;
+SELECT document FROM bson_aggregation_count('ios_db', '{ "count": "ios_scalar", "query": { "a": { "$gt": 90 } } }');
+set documentdb.enableSinglePathIndexOnlyScan to on;
+
+-- an array along the path needs the document to be rechecked, the index isn't used index only
+SELECT documentdb_api.create_collection('ios_db', 'ios_multikey');
+SELECT documentdb_api_internal.create_indexes_non_concurrently(
+    'ios_db', '{ "createIndexes": "ios_multikey", "indexes": [ { "key": { "a.b": 1 }, "name": "a.b_1", "enableCompositeTerm": false } ] }', TRUE);
+SELECT COUNT(documentdb_api.insert_one('ios_db', 'ios_multikey', FORMAT('{ "_id": %s, "a": [ { "b": %s }, { "b": %s } ] }', i, i, i + 1)::bson)) FROM generate_series(1, 100) AS i;
+EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_count('ios_db', '{ "count": "ios_multikey", "query": { "a.b": { "$gt": 90 } } }');
+-- the count matches the one of the regular index scan
+SELECT document FROM bson_aggregation_count('ios_db', '{ "count": "ios_multikey", "query": { "a.b": { "$gt": 90 } } }');
+set documentdb.enableSinglePathIndexOnlyScan to off;
+SELECT document FROM bson_aggregation_count('ios_db', '{ "count": "ios_multikey", "query": { "a.b": { "$gt": 90 } } }');
+set documentdb.enableSinglePathIndexOnlyScan to on;
+
+-- truncated terms need the document to be rechecked, the index isn't used index only
+SET documentdb.indexTermLimitOverride TO 100;
+SELECT documentdb_api.create_collection('ios_db', 'ios_truncated');
+SELECT documentdb_api_internal.create_indexes_non_concurrently(
+    'ios_db', '{ "createIndexes": "ios_truncated", "indexes": [ { "key": { "a": 1 }, "name": "a_1", "enableCompositeTerm": false } ] }', TRUE);
+RESET documentdb.indexTermLimitOverride;
+SELECT COUNT(documentdb_api.insert_one('ios_db', 'ios_truncated', FORMAT('{ "_id": %s, "a": %s }', i, i)::bson)) FROM generate_series(1, 50) AS i;
+SELECT COUNT(documentdb_api.insert_one('ios_db', 'ios_truncated', FORMAT('{ "_id": %s, "a": "%s" }', i, repeat('a', 200) || i)::bson)) FROM generate_series(51, 100) AS i;
+EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_count('ios_db', '{ "count": "ios_truncated", "query": { "a": { "$gt": 25 } } }');
+-- the count matches the one of the regular index scan
+SELECT document FROM bson_aggregation_count('ios_db', '{ "count": "ios_truncated", "query": { "a": { "$gt": 25 } } }');
+set documentdb.enableSinglePathIndexOnlyScan to off;
+SELECT document FROM bson_aggregation_count('ios_db', '{ "count": "ios_truncated", "query": { "a": { "$gt": 25 } } }');
+set documentdb.enableSinglePathIndexOnlyScan to on;
+
+reset enable_bitmapscan;
+reset documentdb.forceDisableSeqScan;
+reset documentdb.enableSinglePathIndexOnlyScan;
+SELECT documentdb_api.drop_collection('ios_db', 'ios_scalar');
+SELECT documentdb_api.drop_collection('ios_db', 'ios_multikey');
+SELECT documentdb_api.drop_collection('ios_db', 'ios_truncated');
@@ -0,0 +1,88 @@
+SET search_path TO documentdb_api_catalog, documentdb_core, public;
+SET documentdb.next_collection_id TO 1300;
+SET documentdb.next_collection_index_id TO 1300;
+
+SELECT documentdb_api.create_collection('word_db', 'word_decoding');
+ALTER TABLE documentdb_data.documents_1301 SET (autovacuum_enabled = off);
+
+-- two values with one posting tree each, and a third with only two items far apart in the heap
+SELECT COUNT(documentdb_api.insert_one('word_db', 'word_decoding',  FORMAT('{ "_id": %s, "a": %s }', i, CASE WHEN i % 12000 = 0 THEN 3 ELSE i % 2 END)::bson)) FROM generate_series(1, 30000) AS i;
+
+SELECT documentdb_api_internal.create_indexes_non_concurrently(
+    'word_db',
+    '{ "createIndexes": "word_decoding", "indexes": [ { "key": { "a": 1 }, "name": "a_1", "enableCompositeTerm": true } ] }', TRUE);
+
+-- heap offsets past 63 take two varbyte bytes, and so do the block numbers past 127 that start each leaf page
+SELECT MAX((ctid::text::point)[1]) > 63 AS has_wide_offsets, MAX((ctid::text::point)[0]) > 127 AS has_wide_blocks FROM documentdb_data.documents_1301;
+SELECT COUNT(*) > 1 AS has_posting_tree_leaves FROM generate_series(1, (pg_relation_size('documentdb_data.documents_rum_index_1302') / 8192)::int - 1) AS blkno
+    WHERE documentdb_api_internal.documentdb_rum_page_get_stats(public.get_raw_page('documentdb_data.documents_rum_index_1302', blkno))->>'flagsStr' LIKE '%LEAF%DATA%';
+
+set documentdb.forceDisableSeqScan to on;
+
+-- bitmap scans return the same documents with the word decoder on and off
+set enable_indexscan to off;
+set documentdb_rum.rum_enable_word_item_ptr_decoding to off;
+CREATE TEMP TABLE word_decoding_off AS SELECT document::text FROM bson_aggregation_find('word_db', '{ "find": "word_decoding", "filter": { "a": 0 } }');
+set documentdb_rum.rum_enable_word_item_ptr_decoding to on;
+CREATE TEMP TABLE word_decoding_on AS SELECT document::text FROM bson_aggregation_find('word_db', '{ "find": "word_decoding", "filter": { "a": 0 } }');
+SELECT (SELECT COUNT(*) FROM word_decoding_on) AS count, (SELECT COUNT(*) FROM word_decoding_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM word_decoding_on EXCEPT ALL SELECT * FROM word_decoding_off) UNION ALL (SELECT * FROM word_decoding_off EXCEPT ALL SELECT * FROM word_decoding_on)) AS same_documents;
+DROP TABLE word_decoding_on, word_decoding_off;
+set documentdb_rum.rum_enable_word_item_ptr_decoding to off;
+CREATE TEMP TABLE word_decoding_off AS SELECT document::text FROM bson_aggregation_find('word_db', '{ "find": "word_decoding", "filter": { "a": 1 } }');
+set documentdb_rum.rum_enable_word_item_ptr_decoding to on;
+CREATE TEMP TABLE word_decoding_on AS SELECT document::text FROM bson_aggregation_find('word_db', '{ "find": "word_decoding", "filter": { "a": 1 } }');
+SELECT (SELECT COUNT(*) FROM word_decoding_on) AS count, (SELECT COUNT(*) FROM word_decoding_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM word_decoding_on EXCEPT ALL SELECT * FROM word_decoding_off) UNION ALL (SELECT * FROM word_decoding_off EXCEPT ALL SELECT * FROM word_decoding_on)) AS same_documents;
+DROP TABLE word_decoding_on, word_decoding_off;
+set documentdb_rum.rum_enable_word_item_ptr_decoding to off;
+CREATE TEMP TABLE word_decoding_off AS SELECT document::text FROM bson_aggregation_find('word_db', '{ "find": "word_decoding", "filter": { "a": { "$gte": 1 } } }');
+set documentdb_rum.rum_enable_word_item_ptr_decoding to on;
+CREATE TEMP TABLE word_decoding_on AS SELECT document::text FROM bson_aggregation_find('word_db', '{ "find": "word_decoding", "filter": { "a": { "$gte": 1 } } }');
+SELECT (SELECT COUNT(*) FROM word_decoding_on) AS count, (SELECT COUNT(*) FROM word_decoding_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM word_decoding_on EXCEPT ALL SELECT * FROM word_decoding_off) UNION ALL (SELECT * FROM word_decoding_off EXCEPT ALL SELECT * FROM word_decoding_on)) AS same_documents;
+DROP TABLE word_decoding_on, word_decoding_off;
+set documentdb_rum.rum_enable_word_item_ptr_decoding to off;
+CREATE TEMP TABLE word_decoding_off AS SELECT document::text FROM bson_aggregation_find('word_db', '{ "find": "word_decoding", "filter": { "a": { "$in": [ 0, 3 ] } } }');
+set documentdb_rum.rum_enable_word_item_ptr_decoding to on;
+CREATE TEMP TABLE word_decoding_on AS SELECT document::text FROM bson_aggregation_find('word_db', '{ "find": "word_decoding", "filter": { "a": { "$in": [ 0, 3 ] } } }');
+SELECT (SELECT COUNT(*) FROM word_decoding_on) AS count, (SELECT COUNT(*) FROM word_decoding_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM word_decoding_on EXCEPT ALL SELECT * FROM word_decoding_off) UNION ALL (SELECT * FROM word_decoding_off EXCEPT ALL SELECT * FROM word_decoding_on)) AS same_documents;
+DROP TABLE word_decoding_on, word_decoding_off;
+reset enable_indexscan;
+
+-- index scans return the same documents with the word decoder on and off
+set enable_bitmapscan to off;
+set documentdb_rum.rum_enable_word_item_ptr_decoding to off;
+CREATE TEMP TABLE word_decoding_off AS SELECT document::text FROM bson_aggregation_find('word_db', '{ "find": "word_decoding", "filter": { "a": 0 } }');
+set documentdb_rum.rum_enable_word_item_ptr_decoding to on;
+CREATE TEMP TABLE word_decoding_on AS SELECT document::text FROM bson_aggregation_find('word_db', '{ "find": "word_decoding", "filter": { "a": 0 } }');
+SELECT (SELECT COUNT(*) FROM word_decoding_on) AS count, (SELECT COUNT(*) FROM word_decoding_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM word_decoding_on EXCEPT ALL SELECT * FROM word_decoding_off) UNION ALL (SELECT * FROM word_decoding_off EXCEPT ALL SELECT * FROM word_decoding_on)) AS same_documents;
+DROP TABLE word_decoding_on, word_decoding_off;
+set documentdb_rum.rum_enable_word_item_ptr_decoding to off;
+CREATE TEMP TABLE word_decoding_off AS SELECT document::text FROM bson_aggregation_find('word_db', '{ "find": "word_decoding", "filter": { "a": 1 } }');
+set documentdb_rum.rum_enable_word_item_ptr_decoding to on;
+CREATE TEMP TABLE word_decoding_on AS SELECT document::text FROM bson_aggregation_find('word_db', '{ "find": "word_decoding", "filter": { "a": 1 } }');
+SELECT (SELECT COUNT(*) FROM word_decoding_on) AS count, (SELECT COUNT(*) FROM word_decoding_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM word_decoding_on EXCEPT ALL SELECT * FROM word_decoding_off) UNION ALL (SELECT * FROM word_decoding_off EXCEPT ALL SELECT * FROM word_decoding_on)) AS same_documents;
+DROP TABLE word_decoding_on, word_decoding_off;
+set documentdb_rum.rum_enable_word_item_ptr_decoding to off;
+CREATE TEMP TABLE word_decoding_off AS SELECT document::text FROM bson_aggregation_find('word_db', '{ "find": "word_decoding", "filter": { "a": { "$gte": 1 } } }');
+set documentdb_rum.rum_enable_word_item_ptr_decoding to on;
+CREATE TEMP TABLE word_decoding_on AS SELECT document::text FROM bson_aggregation_find('word_db', '{ "find": "word_decoding", "filter": { "a": { "$gte": 1 } } }');
+SELECT (SELECT COUNT(*) FROM word_decoding_on) AS count, (SELECT COUNT(*) FROM word_decoding_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM word_decoding_on EXCEPT ALL SELECT * FROM word_decoding_off) UNION ALL (SELECT * FROM word_decoding_off EXCEPT ALL SELECT * FROM word_decoding_on)) AS same_documents;
+DROP TABLE word_decoding_on, word_decoding_off;
+set documentdb_rum.rum_enable_word_item_ptr_decoding to off;
+CREATE TEMP TABLE word_decoding_off AS SELECT document::text FROM bson_aggregation_find('word_db', '{ "find": "word_decoding", "filter": { "a": { "$in": [ 0, 3 ] } } }');
+set documentdb_rum.rum_enable_word_item_ptr_decoding to on;
+CREATE TEMP TABLE word_decoding_on AS SELECT document::text FROM bson_aggregation_find('word_db', '{ "find": "word_decoding", "filter": { "a": { "$in": [ 0, 3 ] } } }');
+SELECT (SELECT COUNT(*) FROM word_decoding_on) AS count, (SELECT COUNT(*) FROM word_decoding_off) AS count_off,
+    NOT EXISTS ((SELECT * FROM word_decoding_on EXCEPT ALL SELECT * FROM word_decoding_off) UNION ALL (SELECT * FROM word_decoding_off EXCEPT ALL SELECT * FROM word_decoding_on)) AS same_documents;
+DROP TABLE word_decoding_on, word_decoding_off;
+reset enable_bitmapscan;
+
+reset documentdb_rum.rum_enable_word_item_ptr_decoding;
+reset documentdb.forceDisableSeqScan;
+SELECT documentdb_api.drop_collection('word_db', 'word_decoding');
@@ -0,0 +1,47 @@
+# findAndModify with documentdb.enableFindAndModifySkipLocked picks the next
+# matching document when another transaction holds the lock on the first one,
+# instead of waiting for that transaction to end. Only sorted commands that do
+# not query by _id skip locked documents.
+
+setup
+{
+	SET client_min_messages TO warning;
+	CREATE FUNCTION replace_json_braces_get_bson(text, text, text) RETURNS documentdb_core.bson
+		LANGUAGE C IMMUTABLE STRICT AS '$libdir/pg_documentdb_core', 'replace_json_braces_get_bson';
+	DO $$
+	BEGIN
+		PERFORM documentdb_api.insert_one('isolation_db', 'queue', replace_json_braces_get_bson('<"_id": 1, "status": "ready">', '<', '>'));
+		PERFORM documentdb_api.insert_one('isolation_db', 'queue', replace_json_braces_get_bson('<"_id": 2, "status": "ready">', '<', '>'));
+		PERFORM documentdb_api.insert_one('isolation_db', 'queue', replace_json_braces_get_bson('<"_id": 3, "status": "ready">', '<', '>'));
+	END $$;
+}
+
+teardown
+{
+	DO $$ BEGIN PERFORM documentdb_api.drop_collection('isolation_db', 'queue'); END $$;
+	DROP FUNCTION replace_json_braces_get_bson(text, text, text);
+}
+
+session s1
+step s1-begin { BEGIN; }
+step s1-take { SELECT p_result FROM documentdb_api.find_and_modify('isolation_db', replace_json_braces_get_bson('<"findAndModify": "queue", "query": <"status": "ready">, "sort": <"_id": 1>, "update": <"$set": <"status": "taken">>, "fields": <"_id": 1>>', '<', '>')); }
+step s1-commit { COMMIT; }
+
+session s2
+setup { SET documentdb.enableFindAndModifySkipLocked TO on; }
+step s2-take { SELECT p_result FROM documentdb_api.find_and_modify('isolation_db', replace_json_braces_get_bson('<"findAndModify": "queue", "query": <"status": "ready">, "sort": <"_id": 1>, "update": <"$set": <"status": "taken">>, "fields": <"_id": 1>>', '<', '>')); }
+step s2-remove { SELECT p_result FROM documentdb_api.find_and_modify('isolation_db', replace_json_braces_get_bson('<"findAndModify": "queue", "query": <"status": "ready">, "sort": <"_id": 1>, "remove": true, "fields": <"_id": 1>>', '<', '>')); }
+step s2-take-unsorted { SELECT p_result FROM documentdb_api.find_and_modify('isolation_db', replace_json_braces_get_bson('<"findAndModify": "queue", "query": <"status": "ready">, "update": <"$set": <"status": "taken">>, "fields": <"_id": 1>>', '<', '>')); }
+step s2-take-by-id { SELECT p_result FROM documentdb_api.find_and_modify('isolation_db', replace_json_braces_get_bson('<"findAndModify": "queue", "query": <"_id": 1>, "sort": <"_id": 1>, "update": <"$set": <"status": "done">>, "fields": <"_id": 1>>', '<', '>')); }
+step s2-disable-skip-locked { SET documentdb.enableFindAndModifySkipLocked TO off; }
+
+# s2 takes the second document while s1 holds the first one
+permutation s1-begin s1-take s2-take s1-commit
+permutation s1-begin s1-take s2-remove s1-commit
+
+# unsorted commands and _id lookups wait for s1 even with the flag
+permutation s1-begin s1-take s2-take-unsorted s1-commit
+permutation s1-begin s1-take s2-take-by-id s1-commit
+
+# without the flag, s2 waits for s1 and then takes the next document still ready
+permutation s2-disable-skip-locked s1-begin s1-take s2-take s1-commit
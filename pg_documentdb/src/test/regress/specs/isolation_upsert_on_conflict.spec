@@ -0,0 +1,31 @@
+# With documentdb.enableUpsertOnConflict, an upsert on _id that races with a
+# concurrent insert of the same _id waits for it and then updates the inserted
+# document, instead of failing with a duplicate key error.
+
+setup
+{
+	SET client_min_messages TO warning;
+	CREATE FUNCTION replace_json_braces_get_bson(text, text, text) RETURNS documentdb_core.bson
+		LANGUAGE C IMMUTABLE STRICT AS '$libdir/pg_documentdb_core', 'replace_json_braces_get_bson';
+	DO $$ BEGIN PERFORM documentdb_api.create_collection('isolation_db', 'counters'); END $$;
+}
+
+teardown
+{
+	DO $$ BEGIN PERFORM documentdb_api.drop_collection('isolation_db', 'counters'); END $$;
+	DROP FUNCTION replace_json_braces_get_bson(text, text, text);
+}
+
+session s1
+setup { SET documentdb.enableUpsertOnConflict TO on; }
+step s1-begin { BEGIN; }
+step s1-upsert { SELECT p_result FROM documentdb_api.update('isolation_db', replace_json_braces_get_bson('<"update": "counters", "updates": [<"q": <"_id": 1>, "u": <"$inc": <"n": 1>>, "upsert": true>]>', '<', '>')); }
+step s1-commit { COMMIT; }
+step s1-select { SELECT document FROM documentdb_api.collection('isolation_db', 'counters'); }
+
+session s2
+setup { SET documentdb.enableUpsertOnConflict TO on; }
+step s2-upsert { SELECT p_result FROM documentdb_api.update('isolation_db', replace_json_braces_get_bson('<"update": "counters", "updates": [<"q": <"_id": 1>, "u": <"$inc": <"n": 1>>, "upsert": true>]>', '<', '>')); }
+
+# s2 waits for the uncommitted insert of s1 and then applies its update to it
+permutation s1-begin s1-upsert s2-upsert s1-commit s1-select
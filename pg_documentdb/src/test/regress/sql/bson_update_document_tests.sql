@@ -922,4 +922,42 @@ SELECT newDocument as bson_update_document FROM documentdb_api_internal.bson_upd
 SELECT newDocument as bson_update_document FROM documentdb_api_internal.bson_update_document('{"_id": 1, "key": 1,"key2": 2,"f": {"g": 1, "h": 1},"h":1}', '{ "": { "$rename": { "key": "f.g"} } }', '{}');
 SELECT newDocument as bson_update_document FROM documentdb_api_internal.bson_update_document('{"_id": 2, "key": 2,"x": {"y": 1, "z": 2}}', '{ "": { "$rename": { "key": "newName","x.y":"z","x.z":"k"} } }', '{}');
 
-SET documentdb.enableupdatebsondocument TO true;
\ No newline at end of file
+SET documentdb.enableupdatebsondocument TO true;
+
+-- updates of existing fixed width values are patched in place
+SET documentdb.enableUpdateInPlacePatch TO on;
+SELECT newDocument as bson_update_document FROM documentdb_api_internal.bson_update_document('{"_id": 1, "a": {"$numberLong": "10"}, "b": {"c": true}, "d": 1.5, "e": "x"}', '{ "": { "$inc": { "a": 5 }, "$set": { "b.c": false }, "$max": { "d": 2.5 } } }', '{}');
+-- no-op
+SELECT newDocument as bson_update_document FROM documentdb_api_internal.bson_update_document('{"_id": 1, "a": 1, "e": "x"}', '{ "": { "$set": { "a": 1 } } }', '{}');
+-- the type of the value changes: the document is rebuilt
+SELECT newDocument as bson_update_document FROM documentdb_api_internal.bson_update_document('{"_id": 1, "a": 1, "e": "x"}', '{ "": { "$inc": { "a": 0.5 } } }', '{}');
+-- the field is added: the document is rebuilt
+SELECT newDocument as bson_update_document FROM documentdb_api_internal.bson_update_document('{"_id": 1, "a": 1, "e": "x"}', '{ "": { "$set": { "a": 2, "b": 2 } } }', '{}');
+SELECT newDocument as bson_update_document FROM documentdb_api_internal.bson_update_document('{"_id": 1, "a": "x"}', '{ "": { "$inc": { "a": 1 } } }', '{}');
+SET documentdb.enableUpdateInPlacePatch TO off;
+
+-- values of every fixed width type and nested documents are patched, the other updates rebuild the document
+CREATE TEMP TABLE in_place_updates (id int, document bson, spec bson);
+INSERT INTO in_place_updates VALUES
+    (1, '{"_id": 1, "d": {"$date": {"$numberLong": "1000"}}}', '{ "": { "$max": { "d": {"$date": {"$numberLong": "2000"}} } } }'),
+    (2, '{"_id": 2, "o": {"$oid": "000000000000000000000001"}}', '{ "": { "$set": { "o": {"$oid": "000000000000000000000002"} } } }'),
+    (3, '{"_id": 3, "t": {"$timestamp": {"t": 1, "i": 1}}}', '{ "": { "$set": { "t": {"$timestamp": {"t": 2, "i": 3}} } } }'),
+    (4, '{"_id": 4, "m": {"$numberDecimal": "2"}}', '{ "": { "$inc": { "m": {"$numberDecimal": "1.5"} } } }'),
+    (5, '{"_id": 5, "a": {"b": {"c": 1, "d": "x"}, "e": 1}}', '{ "": { "$inc": { "a.b.c": 1 } } }'),
+    (6, '{"_id": 6, "l": {"$numberLong": "4"}}', '{ "": { "$mul": { "l": {"$numberLong": "3"} } } }'),
+    (7, '{"_id": 7, "i": 5}', '{ "": { "$bit": { "i": { "and": 4 } } } }'),
+    (8, '{"_id": 8, "f": 2.5}', '{ "": { "$min": { "f": 1.5 } } }'),
+    (9, '{"_id": 9, "s": "ab"}', '{ "": { "$set": { "s": "cd" } } }'),
+    (10, '{"_id": 10, "a": [ {"b": 1} ]}', '{ "": { "$set": { "a.0.b": 2 } } }'),
+    (11, '{"_id": 11, "i": 2147483647}', '{ "": { "$mul": { "i": 2 } } }');
+SELECT COUNT(*) * 0 AS count FROM documentdb_api_internal.command_feature_counter_stats(true);
+SET documentdb.enableUpdateInPlacePatch TO on;
+CREATE TEMP TABLE in_place_on AS SELECT id, newDocument FROM in_place_updates, documentdb_api_internal.bson_update_document(document, spec, '{}');
+SELECT COALESCE(SUM(usage_count), 0) AS in_place_patches FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'update_in_place_patch';
+SET documentdb.enableUpdateInPlacePatch TO off;
+CREATE TEMP TABLE in_place_off AS SELECT id, newDocument FROM in_place_updates, documentdb_api_internal.bson_update_document(document, spec, '{}');
+SELECT COALESCE(SUM(usage_count), 0) AS in_place_patches FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'update_in_place_patch';
+SELECT id, newDocument FROM in_place_on ORDER BY id;
+-- the patched documents are the same as the rebuilt ones
+SELECT COUNT(*) AS differences FROM in_place_on JOIN in_place_off USING (id) WHERE in_place_on.newDocument::text IS DISTINCT FROM in_place_off.newDocument::text;
+DROP TABLE in_place_updates, in_place_on, in_place_off;
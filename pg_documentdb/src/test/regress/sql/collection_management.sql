@@ -134,3 +134,9 @@ SELECT * FROM documentdb_api.collection('db','lagacy_coll');
 SELECT document, shard_key_value FROM documentdb_api.collection('db','lagacy_coll');
 ROLLBACK;
 
+-- retry tables created without the object_id index
+BEGIN;
+SET LOCAL documentdb.enableRetryTableWithoutObjectIdIndex = on;
+SELECT documentdb_api.insert_one('db','compact_retry_coll',' { "_id" :  1, "b" : 2 }', NULL);
+SELECT count(*) FROM pg_indexes WHERE schemaname = 'documentdb_data' AND tablename = (SELECT 'retry_' || collection_id FROM documentdb_api_catalog.collections WHERE database_name = 'db' AND collection_name = 'compact_retry_coll');
+ROLLBACK;
@@ -372,4 +372,34 @@ SELECT index_cmd, cmd_type, index_id, index_cmd_status, collection_id FROM docum
 CALL documentdb_api_internal.build_index_concurrently(1);
 
 --all indexes should be built and queue should be empty.
-SELECT * FROM documentdb_api_catalog.documentdb_index_queue;
\ No newline at end of file
+SELECT * FROM documentdb_api_catalog.documentdb_index_queue;
+
+-- a build that failed after its build phase left a ready but not valid index behind: the next
+-- attempt resumes from the validation phase instead of building the index again
+DELETE FROM documentdb_api_catalog.documentdb_index_queue;
+SELECT documentdb_api.create_collection('db', 'resumecoll');
+SELECT COUNT(documentdb_api.insert_one('db', 'resumecoll', FORMAT('{ "_id": %s, "a": %s }', i, i)::bson)) FROM generate_series(1, 100) AS i;
+SELECT ok FROM documentdb_api.create_indexes_background('db', '{ "createIndexes": "resumecoll", "indexes": [ { "key" : { "a": 1 }, "name": "a_1"}] }');
+
+-- inject the failure: build the queued index, leave it ready but not valid and fail the request
+DO $$
+DECLARE
+  v_index_cmd text;
+  v_index_id int;
+BEGIN
+  SELECT index_cmd, index_id INTO v_index_cmd, v_index_id FROM documentdb_api_catalog.documentdb_index_queue;
+  EXECUTE replace(v_index_cmd, 'CREATE INDEX CONCURRENTLY', 'CREATE INDEX');
+  UPDATE pg_index SET indisvalid = false
+  WHERE indexrelid = format('documentdb_data.documents_rum_index_%s', v_index_id)::regclass;
+END;
+$$;
+UPDATE documentdb_api_catalog.documentdb_index_queue SET index_cmd_status = 3, attempt = 1;
+SELECT indexrelid AS resume_index_oid FROM documentdb_test_helpers.get_data_table_indexes('db', 'resumecoll') WHERE NOT indisprimary \gset
+
+SET documentdb.enableResumableIndexBuild TO on;
+CALL documentdb_api_internal.build_index_concurrently(1);
+-- the request is done and the same index is now valid
+SELECT * FROM documentdb_api_catalog.documentdb_index_queue;
+SELECT indexrelid = :resume_index_oid AS resumed, indisvalid, indisready
+FROM documentdb_test_helpers.get_data_table_indexes('db', 'resumecoll') WHERE NOT indisprimary;
+RESET documentdb.enableResumableIndexBuild;
\ No newline at end of file
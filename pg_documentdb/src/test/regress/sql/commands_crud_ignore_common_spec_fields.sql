@@ -53,4 +53,18 @@ select documentdb_api.insert('db', '{
 	"documents":[{"_id":2,"a":"id2"}],
 	"ordered": false,
         "bypassDocumentValidation": true,
-	"comment": "NoOp2"}');
\ No newline at end of file
+	"comment": "NoOp2"}');
+
+-- writeConcern only relaxes durability as far as the server policy allows
+SELECT p_success, current_setting('synchronous_commit') FROM documentdb_api.insert('db', '{ "insert":"ignoreCommonSpec", "documents":[{"_id":3,"a":"id3"}], "writeConcern": { "w": 1, "j": false } }');
+SET documentdb.writeConcernRelaxation TO 'journal';
+SELECT p_success, current_setting('synchronous_commit') FROM documentdb_api.insert('db', '{ "insert":"ignoreCommonSpec", "documents":[{"_id":4,"a":"id4"}], "writeConcern": { "w": 1, "j": false } }');
+SELECT p_success, current_setting('synchronous_commit') FROM documentdb_api.insert('db', '{ "insert":"ignoreCommonSpec", "documents":[{"_id":5,"a":"id5"}], "writeConcern": { "w": 0 } }');
+SELECT p_success, current_setting('synchronous_commit') FROM documentdb_api.insert('db', '{ "insert":"ignoreCommonSpec", "documents":[{"_id":6,"a":"id6"}], "writeConcern": { "w": "majority", "j": false } }');
+SELECT p_success, current_setting('synchronous_commit') FROM documentdb_api.insert('db', '{ "insert":"ignoreCommonSpec", "documents":[{"_id":7,"a":"id7"}], "writeConcern": { "w": 1, "j": true } }');
+-- an explicit transaction keeps the synchronous commit for all of its statements
+BEGIN;
+select documentdb_api.insert('db', '{ "insert":"ignoreCommonSpec", "documents":[{"_id":8,"a":"id8"}], "writeConcern": { "w": 0 } }');
+SHOW synchronous_commit;
+ROLLBACK;
+RESET documentdb.writeConcernRelaxation;
@@ -334,3 +334,24 @@ SELECT documentdb_api.delete(
         "ordered": false
      }'
 );
+
+-- consecutive deletes by _id of a batch run as a single statement
+SELECT COUNT(*) * 0 AS count FROM documentdb_api_internal.command_feature_counter_stats(true);
+SET documentdb.enableSetBasedDeleteById TO on;
+SELECT 1 FROM documentdb_api.insert_one('delete', 'set_based', '{"_id": 1, "a": 1}');
+SELECT 1 FROM documentdb_api.insert_one('delete', 'set_based', '{"_id": 2, "a": 2}');
+SELECT 1 FROM documentdb_api.insert_one('delete', 'set_based', '{"_id": 3, "a": 3}');
+SELECT 1 FROM documentdb_api.insert_one('delete', 'set_based', '{"_id": 4, "a": 4}');
+SELECT 1 FROM documentdb_api.insert_one('delete', 'set_based', '{"_id": 5, "a": 5}');
+SELECT 1 FROM documentdb_api.insert_one('delete', 'set_based', '{"_id": 6, "a": 6}');
+
+SELECT documentdb_api.delete('delete', '{"delete": "set_based", "deletes": [ {"q": {"_id": 1}, "limit": 1}, {"q": {"_id": 2}, "limit": 0}, {"q": {"_id": 2}, "limit": 1}, {"q": {"_id": {"$eq": 3}}, "limit": 1}, {"q": {"a": 5}, "limit": 1}, {"q": {"_id": 6}, "limit": 0}, {"q": {"_id": 100}, "limit": 1} ]}');
+SELECT document FROM documentdb_api.collection('delete', 'set_based') ORDER BY 1;
+
+-- _id 1 to 3 and _id 6 and 100 are each deleted by one statement
+SELECT COALESCE(SUM(usage_count), 0) AS set_based_deletes FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'set_based_delete_by_id';
+RESET documentdb.enableSetBasedDeleteById;
+
+SELECT 1 FROM documentdb_api.insert_one('delete', 'set_based', '{"_id": 7, "a": 7}');
+SELECT documentdb_api.delete('delete', '{"delete": "set_based", "deletes": [ {"q": {"_id": 4}, "limit": 1}, {"q": {"_id": 7}, "limit": 1} ]}');
+SELECT COALESCE(SUM(usage_count), 0) AS set_based_deletes FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'set_based_delete_by_id';
@@ -235,4 +235,34 @@ set documentdb.enableBypassDocumentValidation = on;
 select documentdb_api.find_and_modify('fam', '{"findAndModify": "collection", "query": {"_id": 3}, "update": {"$set": {"a": "zero"}}, "new": true, "upsert": true, "bypassDocumentValidation": true, "fields": {"foo": {"$pow": [1, 2]}}}');
 SELECT documentdb_api_catalog.bson_dollar_project(document,'{"_id":0,"a":1,"b":1}') FROM documentdb_api.collection('fam', 'collection') ORDER BY document;
 set documentdb.enableSchemaValidation = off;
-set documentdb.enableBypassDocumentValidation = off;
\ No newline at end of file
+set documentdb.enableBypassDocumentValidation = off;
+
+-- skip documents locked by other transactions when selecting the document to modify
+set documentdb.enableFindAndModifySkipLocked = on;
+SELECT 1 FROM documentdb_api.insert_one('fam', 'queue', '{"_id": 1, "status": "ready", "priority": 1}');
+SELECT 1 FROM documentdb_api.insert_one('fam', 'queue', '{"_id": 2, "status": "ready", "priority": 3}');
+SELECT 1 FROM documentdb_api.insert_one('fam', 'queue', '{"_id": 3, "status": "ready", "priority": 2}');
+BEGIN;
+-- a document locked by the current transaction is not skipped
+SELECT documentdb_api.find_and_modify('fam', '{"findAndModify": "queue", "query": {"status": "ready"}, "sort": {"priority": -1}, "update": {"$set": {"status": "taken"}}, "new": true, "fields": {"_id": 1}}');
+SELECT documentdb_api.find_and_modify('fam', '{"findAndModify": "queue", "query": {"status": "ready"}, "sort": {"priority": -1}, "update": {"$set": {"status": "taken"}}, "new": true, "fields": {"_id": 1}}');
+ROLLBACK;
+SELECT documentdb_api.find_and_modify('fam', '{"findAndModify": "queue", "query": {"status": "ready"}, "sort": {"priority": 1}, "remove": true, "fields": {"_id": 1}}');
+-- upserts never skip a locked document, they would insert a second one
+SELECT documentdb_api.find_and_modify('fam', '{"findAndModify": "queue", "query": {"_id": 4}, "update": {"$set": {"status": "ready"}}, "upsert": true, "new": true, "fields": {"_id": 1}}');
+set documentdb.enableFindAndModifySkipLocked = off;
+
+-- compiled schema validators are cached per collection and follow collMod changes
+set documentdb.enableSchemaValidation = on;
+set documentdb.enableSchemaValidatorCache = on;
+SELECT 1 FROM documentdb_api.insert_one('fam', 'validator_cache', '{"_id": 1, "f1": 1}');
+SELECT documentdb_api.coll_mod('fam', 'validator_cache', '{"collMod": "validator_cache", "validator": {"$jsonSchema": {"bsonType": "object", "properties": {"f1": {"bsonType": "int"}, "f2": {"bsonType": "int"}, "f3": {"bsonType": "int"}, "f4": {"bsonType": "int"}, "f5": {"bsonType": "int"}, "f6": {"bsonType": "int"}, "f7": {"bsonType": "int"}, "f8": {"bsonType": "int"}, "f9": {"bsonType": "int"}, "f10": {"bsonType": "int"}}}}}');
+-- expect to fail since "f10" is not an int
+SELECT documentdb_api.find_and_modify('fam', '{"findAndModify": "validator_cache", "query": {"_id": 2}, "update": {"$set": {"f10": "ten"}}, "upsert": true, "new": true, "fields": {"_id": 1}}');
+SELECT documentdb_api.find_and_modify('fam', '{"findAndModify": "validator_cache", "query": {"_id": 2}, "update": {"$set": {"f10": 10}}, "upsert": true, "new": true, "fields": {"_id": 1}}');
+SELECT documentdb_api.coll_mod('fam', 'validator_cache', '{"collMod": "validator_cache", "validator": {"$jsonSchema": {"bsonType": "object", "properties": {"f10": {"bsonType": "string"}}}}}');
+-- expect to fail since the new validator requires "f10" to be a string
+SELECT documentdb_api.find_and_modify('fam', '{"findAndModify": "validator_cache", "query": {"_id": 3}, "update": {"$set": {"f10": 10}}, "upsert": true, "new": true, "fields": {"_id": 1}}');
+SELECT documentdb_api.find_and_modify('fam', '{"findAndModify": "validator_cache", "query": {"_id": 3}, "update": {"$set": {"f10": "ten"}}, "upsert": true, "new": true, "fields": {"_id": 1}}');
+set documentdb.enableSchemaValidatorCache = off;
+set documentdb.enableSchemaValidation = off;
@@ -0,0 +1,41 @@
+SET search_path TO documentdb_api,documentdb_core,documentdb_api_catalog;
+SET documentdb.next_collection_id TO 9700;
+SET documentdb.next_collection_index_id TO 9700;
+
+-- batched inserts into the collection table through the table access method
+SELECT documentdb_api.create_collection('insert', 'direct');
+SET documentdb.enableDirectMultiInsert TO on;
+SELECT COUNT(*) * 0 AS count FROM documentdb_api_internal.command_feature_counter_stats(true);
+SELECT documentdb_api.insert('insert', '{"insert":"direct", "documents":[{"_id":1,"a":1},{"_id":2,"a":2},{"_id":3,"a":3}]}');
+SELECT document FROM documentdb_api.collection('insert', 'direct') ORDER BY document-> '_id';
+SELECT COALESCE(SUM(usage_count), 0) AS direct_multi_inserts FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'direct_multi_insert';
+
+-- a duplicate _id in the batch falls back to inserting one document at a time
+SELECT documentdb_api.insert('insert', '{"insert":"direct", "documents":[{"_id":4,"a":4},{"_id":4,"a":5},{"_id":5,"a":6}],"ordered":false}');
+SELECT document FROM documentdb_api.collection('insert', 'direct') ORDER BY document-> '_id';
+SELECT COALESCE(SUM(usage_count), 0) AS direct_multi_inserts FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'direct_multi_insert';
+
+-- a unique secondary index is enforced by its exclusion constraint
+SELECT 1 FROM documentdb_api_internal.create_indexes_non_concurrently('insert', '{"createIndexes": "direct", "indexes": [{"key": {"a": 1}, "name": "a_1", "unique": true}]}', true);
+SELECT documentdb_api.insert('insert', '{"insert":"direct", "documents":[{"_id":6,"a":1},{"_id":7,"a":7}],"ordered":false}');
+SELECT documentdb_api.insert('insert', '{"insert":"direct", "documents":[{"_id":8,"a":8},{"_id":9,"a":8}],"ordered":false}');
+SELECT document FROM documentdb_api.collection('insert', 'direct') ORDER BY document-> '_id';
+SELECT COALESCE(SUM(usage_count), 0) AS direct_multi_inserts FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'direct_multi_insert';
+SELECT documentdb_api.insert('insert', '{"insert":"direct", "documents":[{"_id":10,"a":10},{"_id":11,"a":11}]}');
+SELECT COALESCE(SUM(usage_count), 0) AS direct_multi_inserts FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'direct_multi_insert';
+
+-- documents are validated before the batch is inserted
+SET documentdb.enableSchemaValidation TO on;
+SELECT documentdb_api.create_collection('insert', 'validated');
+SELECT documentdb_api.coll_mod('insert', 'validated', '{"collMod": "validated", "validator": {"$jsonSchema": {"bsonType": "object", "properties": {"a": {"bsonType": "int"}}}}}');
+SELECT documentdb_api.insert('insert', '{"insert":"validated", "documents":[{"_id":1,"a":1},{"_id":2,"a":"two"},{"_id":3,"a":3}],"ordered":false}');
+SELECT COALESCE(SUM(usage_count), 0) AS direct_multi_inserts FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'direct_multi_insert';
+SELECT documentdb_api.insert('insert', '{"insert":"validated", "documents":[{"_id":4,"a":4},{"_id":5,"a":5}]}');
+SELECT document FROM documentdb_api.collection('insert', 'validated') ORDER BY document-> '_id';
+SELECT COALESCE(SUM(usage_count), 0) AS direct_multi_inserts FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'direct_multi_insert';
+RESET documentdb.enableSchemaValidation;
+
+-- with the flag off the planned INSERT is used
+RESET documentdb.enableDirectMultiInsert;
+SELECT documentdb_api.insert('insert', '{"insert":"direct", "documents":[{"_id":12,"a":12},{"_id":13,"a":13}]}');
+SELECT COALESCE(SUM(usage_count), 0) AS direct_multi_inserts FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'direct_multi_insert';
@@ -621,4 +621,41 @@ select documentdb_api.update('update', '{"update":"server1470_noref", "updates":
 select documentdb_api.update('update', '{"update":"server1470_extraf_1", "updates":[{"q": {"name": "first", "pic": {"$ref": "foo", "extraField": "extraField", "$id": {"$oid": "4c48d04cd33a5a92628c9af6"} } }, "u":{"$set": {"refx": 1}}, "multi": true, "upsert": true} ] }');
 select documentdb_api.update('update', '{"update":"server1470_extraf_2", "updates":[{"q": {"name": "first", "pic": {"$id": {"$oid": "4c48d04cd33a5a92628c9af6"}, "extraField": "extraFiele", "$ref": "foo" } }, "u":{"$set": {"refx": 1}}, "multi": true, "upsert": true} ] }');
 
-SET documentdb.enableupdatebsondocument TO true;
\ No newline at end of file
+SET documentdb.enableupdatebsondocument TO true;
+
+-- upserts filtering only on _id run as a single insert that updates on conflict
+SET documentdb.enableUpsertOnConflict TO on;
+select documentdb_api.update('update', '{"update":"upsert_on_conflict", "updates":[{"q":{"_id": 1},"u":{"$setOnInsert": {"created": 1}, "$inc": {"n": 1}},"upsert":true}]}');
+select documentdb_api.update('update', '{"update":"upsert_on_conflict", "updates":[{"q":{"_id": 1},"u":{"$setOnInsert": {"created": 1}, "$inc": {"n": 1}},"upsert":true}]}');
+select documentdb_api.update('update', '{"update":"upsert_on_conflict", "updates":[{"q":{"_id": 1},"u":{"$set": {"created": 1}},"upsert":true}]}');
+SELECT document FROM documentdb_api.collection('update', 'upsert_on_conflict');
+-- a no-op on conflict doesn't write a new version of the row
+BEGIN;
+select documentdb_api.update('update', '{"update":"upsert_on_conflict", "updates":[{"q":{"_id": 1},"u":{"$set": {"created": 1}},"upsert":true}]}');
+SELECT pg_stat_get_xact_tuples_updated(('documentdb_data.documents_' || collection_id)::regclass) AS updated FROM documentdb_api_catalog.collections WHERE database_name = 'update' AND collection_name = 'upsert_on_conflict';
+select documentdb_api.update('update', '{"update":"upsert_on_conflict", "updates":[{"q":{"_id": 1},"u":{"$inc": {"n": 1}},"upsert":true}]}');
+SELECT pg_stat_get_xact_tuples_updated(('documentdb_data.documents_' || collection_id)::regclass) AS updated FROM documentdb_api_catalog.collections WHERE database_name = 'update' AND collection_name = 'upsert_on_conflict';
+ROLLBACK;
+SET documentdb.enableUpsertOnConflict TO off;
+
+-- the result of each update is reported when asked for
+BEGIN;
+SELECT p_result FROM documentdb_api.update('update', '{"update":"upsert_on_conflict", "updates":[{"q":{"_id": 1},"u":{"$inc": {"n": 1}}}, {"q":{"_id": 2},"u":{"$set": {"a": 1}}}, {"q":{"_id": 3},"u":{"$set": {"a": 1}},"upsert":true}], "ordered": false, "returnStatementResults": true}');
+ROLLBACK;
+
+-- consecutive updates by _id of a batch run as a single statement
+SELECT COUNT(*) * 0 AS count FROM documentdb_api_internal.command_feature_counter_stats(true);
+SET documentdb.enableSetBasedUpdateById TO on;
+SELECT 1 FROM documentdb_api.insert_one('update', 'set_based', '{"_id": 1, "a": 1}');
+SELECT 1 FROM documentdb_api.insert_one('update', 'set_based', '{"_id": 2, "a": 2}');
+SELECT 1 FROM documentdb_api.insert_one('update', 'set_based', '{"_id": 3, "a": 3}');
+
+SELECT p_result FROM documentdb_api.update('update', '{"update": "set_based", "updates": [ {"q": {"_id": 1}, "u": {"$inc": {"a": 10}}}, {"q": {"_id": 2}, "u": {"$set": {"a": 2}}}, {"q": {"_id": 1}, "u": {"$inc": {"a": 100}}}, {"q": {"_id": {"$eq": 3}}, "u": {"$set": {"b": 1}}}, {"q": {"a": 3}, "u": {"$set": {"c": 1}}}, {"q": {"_id": 4}, "u": {"$set": {"b": 1}}}, {"q": {"_id": 2}, "u": {"$bork": {"a": 1}}} ], "ordered": false}');
+SELECT document FROM documentdb_api.collection('update', 'set_based') ORDER BY 1;
+
+-- _id 1 to 3 are updated as a set; _id 4 and 2 fail as a set and are updated one by one
+SELECT COALESCE(SUM(usage_count), 0) AS set_based_updates FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'set_based_update_by_id';
+RESET documentdb.enableSetBasedUpdateById;
+
+SELECT p_result FROM documentdb_api.update('update', '{"update": "set_based", "updates": [ {"q": {"_id": 1}, "u": {"$inc": {"a": 1}}}, {"q": {"_id": 2}, "u": {"$inc": {"a": 1}}} ]}');
+SELECT COALESCE(SUM(usage_count), 0) AS set_based_updates FROM documentdb_api_internal.command_feature_counter_stats(true) WHERE feature_name = 'set_based_update_by_id';
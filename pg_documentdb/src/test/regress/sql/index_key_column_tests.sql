@@ -0,0 +1,61 @@
+SET search_path TO documentdb_api, documentdb_api_catalog, documentdb_core;
+SET documentdb.next_collection_id TO 8500;
+SET documentdb.next_collection_index_id TO 8500;
+-- indexKeyFields is behind a feature flag
+SELECT documentdb_api.create_collection_view('ikc_db', '{ "create": "ikc", "indexKeyFields": [ "a" ] }');
+set documentdb.enableIndexKeyColumn to on;
+-- it takes distinct top level field names, and only for collections
+SELECT documentdb_api.create_collection_view('ikc_db', '{ "create": "ikc", "indexKeyFields": "a" }');
+SELECT documentdb_api.create_collection_view('ikc_db', '{ "create": "ikc", "indexKeyFields": [ ] }');
+SELECT documentdb_api.create_collection_view('ikc_db', '{ "create": "ikc", "indexKeyFields": [ 1 ] }');
+SELECT documentdb_api.create_collection_view('ikc_db', '{ "create": "ikc", "indexKeyFields": [ "a.b" ] }');
+SELECT documentdb_api.create_collection_view('ikc_db', '{ "create": "ikc", "indexKeyFields": [ "$a" ] }');
+SELECT documentdb_api.create_collection_view('ikc_db', '{ "create": "ikc", "indexKeyFields": [ "a", "a" ] }');
+SELECT documentdb_api.create_collection_view('ikc_db', '{ "create": "ikc", "viewOn": "other", "indexKeyFields": [ "a" ] }');
+SELECT documentdb_api.create_collection_view('ikc_db', '{ "create": "ikc", "indexKeyFields": [ "a", "b" ] }');
+-- creating the collection again needs the same fields
+SELECT documentdb_api.create_collection_view('ikc_db', '{ "create": "ikc", "indexKeyFields": [ "b", "a" ] }');
+SELECT documentdb_api.create_collection_view('ikc_db', '{ "create": "ikc", "indexKeyFields": [ "a" ] }');
+SELECT documentdb_api.create_collection_view('ikc_db', '{ "create": "ikc" }');
+-- the index_document column holds _id and the listed fields of every document
+SELECT p_result FROM documentdb_api.insert('ikc_db', '{ "insert": "ikc", "documents": [ { "_id": 1, "a": 1, "b": { "x": 1 }, "c": 1 }, { "_id": 2, "a": [ 2, 3 ], "c": 2 } ] }');
+SELECT documentdb_api.insert_one('ikc_db', 'ikc', '{ "_id": 3, "c": 3 }');
+SELECT index_document FROM documentdb_data.documents_8501 ORDER BY object_id;
+-- regular indexes that only read these fields are built on it, the others on the document
+SELECT documentdb_api_internal.create_indexes_non_concurrently('ikc_db', '{ "createIndexes": "ikc", "indexes": [
+    { "key": { "a": 1 }, "name": "a_1" },
+    { "key": { "a": 1, "b.x": 1 }, "name": "a_1_b.x_1" },
+    { "key": { "_id": 1, "a": 1 }, "name": "_id_1_a_1" },
+    { "key": { "c": 1 }, "name": "c_1" },
+    { "key": { "a": -1 }, "name": "a_-1_partial", "partialFilterExpression": { "c": { "$gt": 1 } } },
+    { "key": { "$**": 1 }, "name": "wildcard" } ] }', TRUE);
+SELECT indexrelid::regclass AS index_name, attname AS column_name
+    FROM pg_index JOIN pg_attribute ON attrelid = indrelid AND attnum = ANY (indkey)
+    WHERE indrelid = 'documentdb_data.documents_8501'::regclass AND attnum > 2
+    ORDER BY indexrelid::regclass::text;
+-- updates that don't change the listed fields are HOT when no index reads the document
+SELECT documentdb_api.create_collection_view('ikc_db', '{ "create": "hot", "indexKeyFields": [ "a" ] }');
+SELECT documentdb_api_internal.create_indexes_non_concurrently('ikc_db', '{ "createIndexes": "hot", "indexes": [ { "key": { "a": 1 }, "name": "a_1" } ] }', TRUE);
+SELECT p_result FROM documentdb_api.insert('ikc_db', '{ "insert": "hot", "documents": [ { "_id": 1, "a": 1, "c": 1 }, { "_id": 2, "a": 2, "c": 2 }, { "_id": 3, "a": 3, "c": 3 } ] }');
+BEGIN;
+SELECT p_result FROM documentdb_api.update('ikc_db', '{ "update": "hot", "updates": [ { "q": { "_id": 1 }, "u": { "$inc": { "c": 1 } } } ] }');
+SELECT pg_stat_get_xact_tuples_updated('documentdb_data.documents_8502'::regclass) AS updated,
+    pg_stat_get_xact_tuples_hot_updated('documentdb_data.documents_8502'::regclass) AS hot_updated;
+SELECT p_result FROM documentdb_api.update('ikc_db', '{ "update": "hot", "updates": [ { "q": { "_id": 2 }, "u": { "$inc": { "a": 1 } } } ] }');
+SELECT pg_stat_get_xact_tuples_updated('documentdb_data.documents_8502'::regclass) AS updated,
+    pg_stat_get_xact_tuples_hot_updated('documentdb_data.documents_8502'::regclass) AS hot_updated;
+ROLLBACK;
+-- queries on the document use the index built on index_document
+set enable_seqscan to off;
+set enable_bitmapscan to off;
+EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('ikc_db', '{ "find": "hot", "filter": { "a": 2 } }');
+SELECT document FROM bson_aggregation_find('ikc_db', '{ "find": "hot", "filter": { "a": 2 } }');
+-- $merge recomputes the column of the documents it updates
+SELECT documentdb_api.insert_one('ikc_db', 'source', '{ "_id": 1, "a": 10 }');
+SELECT documentdb_api.insert_one('ikc_db', 'source', '{ "_id": 4, "a": 4 }');
+SELECT cursorpage FROM aggregate_cursor_first_page('ikc_db', '{ "aggregate": "source", "pipeline": [ { "$merge": { "into": "hot" } } ], "cursor": { "batchSize": 1 } }', 4294967294);
+SELECT index_document FROM documentdb_data.documents_8502 ORDER BY object_id;
+SELECT document FROM bson_aggregation_find('ikc_db', '{ "find": "hot", "filter": { "a": 10 } }');
+reset enable_seqscan;
+reset enable_bitmapscan;
+reset documentdb.enableIndexKeyColumn;
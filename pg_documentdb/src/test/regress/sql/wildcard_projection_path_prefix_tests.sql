@@ -0,0 +1,84 @@
+SET search_path TO documentdb_api, documentdb_api_catalog, documentdb_core;
+SET documentdb.next_collection_id TO 8400;
+SET documentdb.next_collection_index_id TO 8400;
+
+CREATE FUNCTION documentdb_test_helpers.gin_bson_get_wildcard_project_generated_terms(documentdb_core.bson, text, bool, bool, bool, int4, text)
+    RETURNS SETOF documentdb_core.bson LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT AS '$libdir/pg_documentdb',
+$$gin_bson_get_wildcard_project_generated_terms$$;
+
+-- terms under the path prefix are written relative to it, the prefix itself becomes "$"
+SELECT * FROM documentdb_test_helpers.gin_bson_get_wildcard_project_generated_terms('{ "_id": 1, "p": { "attrs": { "os": "ios", "device": "phone" }, "other": 1 } }', '[ "p.attrs" ]', false, false, false, 2699, '');
+SELECT * FROM documentdb_test_helpers.gin_bson_get_wildcard_project_generated_terms('{ "_id": 1, "p": { "attrs": { "os": "ios", "device": "phone" }, "other": 1 } }', '[ "p.attrs" ]', false, false, false, 2699, 'p.attrs');
+SELECT * FROM documentdb_test_helpers.gin_bson_get_wildcard_project_generated_terms('{ "_id": 2, "p": { "attrs": { "os": "android", "build": { "major": 12 } } } }', '[ "p.attrs" ]', false, false, false, 2699, 'p.attrs');
+SELECT * FROM documentdb_test_helpers.gin_bson_get_wildcard_project_generated_terms('{ "_id": 3, "p": { "attrs": 5 } }', '[ "p.attrs" ]', false, false, false, 2699, 'p.attrs');
+
+-- the prefix is only elided for indexes that truncate their terms
+SELECT * FROM documentdb_test_helpers.gin_bson_get_wildcard_project_generated_terms('{ "_id": 3, "p": { "attrs": 5 } }', '[ "p.attrs" ]', false, false, false, -1, 'p.attrs');
+
+-- new inclusion projection indexes record the prefix shared by their paths when enabled
+set documentdb.enableWildcardProjectionPathPrefixElision to on;
+SELECT documentdb_api_internal.create_indexes_non_concurrently('wp_prefix_db',
+    '{ "createIndexes": "prefix_on", "indexes": [ { "key": { "$**": 1 }, "name": "wp_attrs", "wildcardProjection": { "p.attrs": 1 } } ] }', TRUE);
+SELECT documentdb_test_helpers.documentdb_index_get_pg_def('wp_prefix_db', 'prefix_on', 'wp_attrs');
+SELECT documentdb_api_internal.create_indexes_non_concurrently('wp_prefix_db',
+    '{ "createIndexes": "prefix_paths", "indexes": [ { "key": { "$**": 1 }, "name": "wp_attrs", "wildcardProjection": { "p.attrs.os": 1, "p.attrs.device": 1, "p.attrsx": 1 } } ] }', TRUE);
+SELECT documentdb_test_helpers.documentdb_index_get_pg_def('wp_prefix_db', 'prefix_paths', 'wp_attrs');
+
+-- exclusion projections, projections including _id and projections without a shared prefix keep the full paths
+SELECT documentdb_api_internal.create_indexes_non_concurrently('wp_prefix_db',
+    '{ "createIndexes": "prefix_exclusion", "indexes": [ { "key": { "$**": 1 }, "name": "wp_attrs", "wildcardProjection": { "p.attrs": 0 } } ] }', TRUE);
+SELECT documentdb_test_helpers.documentdb_index_get_pg_def('wp_prefix_db', 'prefix_exclusion', 'wp_attrs');
+SELECT documentdb_api_internal.create_indexes_non_concurrently('wp_prefix_db',
+    '{ "createIndexes": "prefix_with_id", "indexes": [ { "key": { "$**": 1 }, "name": "wp_attrs", "wildcardProjection": { "p.attrs": 1, "_id": 1 } } ] }', TRUE);
+SELECT documentdb_test_helpers.documentdb_index_get_pg_def('wp_prefix_db', 'prefix_with_id', 'wp_attrs');
+SELECT documentdb_api_internal.create_indexes_non_concurrently('wp_prefix_db',
+    '{ "createIndexes": "prefix_none", "indexes": [ { "key": { "$**": 1 }, "name": "wp_attrs", "wildcardProjection": { "p.attrs": 1, "q": 1 } } ] }', TRUE);
+SELECT documentdb_test_helpers.documentdb_index_get_pg_def('wp_prefix_db', 'prefix_none', 'wp_attrs');
+
+set documentdb.enableWildcardProjectionPathPrefixElision to off;
+SELECT documentdb_api_internal.create_indexes_non_concurrently('wp_prefix_db',
+    '{ "createIndexes": "prefix_off", "indexes": [ { "key": { "$**": 1 }, "name": "wp_attrs", "wildcardProjection": { "p.attrs": 1 } } ] }', TRUE);
+SELECT documentdb_test_helpers.documentdb_index_get_pg_def('wp_prefix_db', 'prefix_off', 'wp_attrs');
+reset documentdb.enableWildcardProjectionPathPrefixElision;
+
+SELECT documentdb_api.insert_one('wp_prefix_db', 'prefix_on', '{ "_id": 1, "p": { "attrs": { "os": "ios", "device": "phone" }, "other": 1 } }');
+SELECT documentdb_api.insert_one('wp_prefix_db', 'prefix_on', '{ "_id": 2, "p": { "attrs": { "os": "android", "build": { "major": 12 } } } }');
+SELECT documentdb_api.insert_one('wp_prefix_db', 'prefix_on', '{ "_id": 3, "p": { "attrs": 5 } }');
+SELECT documentdb_api.insert_one('wp_prefix_db', 'prefix_on', '{ "_id": 4, "p": { "attrs": { "os": "ios" }, "other": 2 } }');
+SELECT documentdb_api.insert_one('wp_prefix_db', 'prefix_on', '{ "_id": 5, "p": { "other": 3 } }');
+SELECT documentdb_api.insert_one('wp_prefix_db', 'prefix_on', '{ "_id": 6, "p": { "attrsx": { "os": "ios" } } }');
+SELECT documentdb_api.insert_one('wp_prefix_db', 'prefix_off', '{ "_id": 1, "p": { "attrs": { "os": "ios", "device": "phone" }, "other": 1 } }');
+SELECT documentdb_api.insert_one('wp_prefix_db', 'prefix_off', '{ "_id": 2, "p": { "attrs": { "os": "android", "build": { "major": 12 } } } }');
+SELECT documentdb_api.insert_one('wp_prefix_db', 'prefix_off', '{ "_id": 3, "p": { "attrs": 5 } }');
+SELECT documentdb_api.insert_one('wp_prefix_db', 'prefix_off', '{ "_id": 4, "p": { "attrs": { "os": "ios" }, "other": 2 } }');
+SELECT documentdb_api.insert_one('wp_prefix_db', 'prefix_off', '{ "_id": 5, "p": { "other": 3 } }');
+SELECT documentdb_api.insert_one('wp_prefix_db', 'prefix_off', '{ "_id": 6, "p": { "attrsx": { "os": "ios" } } }');
+
+-- queries on the prefix itself and on paths below it use the index and match the same documents either way
+BEGIN;
+  set local enable_seqscan TO OFF;
+  SELECT documentdb_test_helpers.run_explain_and_trim($cmd$ EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrs": 5 } }') $cmd$);
+  SELECT (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrs": 5 } }')) AS prefix_on, (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_off", "filter": { "p.attrs": 5 } }')) AS prefix_off;
+  SELECT documentdb_test_helpers.run_explain_and_trim($cmd$ EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrs": { "os": "ios" } } }') $cmd$);
+  SELECT (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrs": { "os": "ios" } } }')) AS prefix_on, (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_off", "filter": { "p.attrs": { "os": "ios" } } }')) AS prefix_off;
+  SELECT documentdb_test_helpers.run_explain_and_trim($cmd$ EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrs": { "$exists": true } } }') $cmd$);
+  SELECT (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrs": { "$exists": true } } }')) AS prefix_on, (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_off", "filter": { "p.attrs": { "$exists": true } } }')) AS prefix_off;
+  SELECT documentdb_test_helpers.run_explain_and_trim($cmd$ EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrs": { "$gt": 1 } } }') $cmd$);
+  SELECT (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrs": { "$gt": 1 } } }')) AS prefix_on, (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_off", "filter": { "p.attrs": { "$gt": 1 } } }')) AS prefix_off;
+  SELECT documentdb_test_helpers.run_explain_and_trim($cmd$ EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrs.os": "ios" } }') $cmd$);
+  SELECT (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrs.os": "ios" } }')) AS prefix_on, (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_off", "filter": { "p.attrs.os": "ios" } }')) AS prefix_off;
+  SELECT documentdb_test_helpers.run_explain_and_trim($cmd$ EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrs.os": { "$in": [ "ios", "android" ] } } }') $cmd$);
+  SELECT (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrs.os": { "$in": [ "ios", "android" ] } } }')) AS prefix_on, (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_off", "filter": { "p.attrs.os": { "$in": [ "ios", "android" ] } } }')) AS prefix_off;
+  SELECT documentdb_test_helpers.run_explain_and_trim($cmd$ EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrs.build.major": { "$gte": 10 } } }') $cmd$);
+  SELECT (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrs.build.major": { "$gte": 10 } } }')) AS prefix_on, (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_off", "filter": { "p.attrs.build.major": { "$gte": 10 } } }')) AS prefix_off;
+  SELECT documentdb_test_helpers.run_explain_and_trim($cmd$ EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrs.os": { "$exists": true } } }') $cmd$);
+  SELECT (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrs.os": { "$exists": true } } }')) AS prefix_on, (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_off", "filter": { "p.attrs.os": { "$exists": true } } }')) AS prefix_off;
+
+-- paths outside the projection can't use the index
+  SELECT documentdb_test_helpers.run_explain_and_trim($cmd$ EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.other": 1 } }') $cmd$);
+  SELECT (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.other": 1 } }')) AS prefix_on, (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_off", "filter": { "p.other": 1 } }')) AS prefix_off;
+  SELECT documentdb_test_helpers.run_explain_and_trim($cmd$ EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrsx.os": "ios" } }') $cmd$);
+  SELECT (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p.attrsx.os": "ios" } }')) AS prefix_on, (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_off", "filter": { "p.attrsx.os": "ios" } }')) AS prefix_off;
+  SELECT documentdb_test_helpers.run_explain_and_trim($cmd$ EXPLAIN (COSTS OFF) SELECT document FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p": { "$exists": true } } }') $cmd$);
+  SELECT (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_on", "filter": { "p": { "$exists": true } } }')) AS prefix_on, (SELECT COUNT(*) FROM bson_aggregation_find('wp_prefix_db', '{ "find": "prefix_off", "filter": { "p": { "$exists": true } } }')) AS prefix_off;
+ROLLBACK;
@@ -26,6 +26,7 @@
 #include "update/bson_update_operators.h"
 #include "aggregation/bson_positional_query.h"
 #include "utils/hashset_utils.h"
+#include "utils/feature_counter.h"
 #include "commands/commands_common.h"
 
 #include "api_hooks_def.h"
@@ -140,6 +141,10 @@ typedef struct BsonUpdateIntermediatePathNode
 	 * Other than $rename operator this value will be NULL
 	 */
 	const BsonPathNode *sourceOrTargetNodeForRenameOP;
+
+	/* Only set on the root: whether the update can be applied by patching
+	 * existing values in place (see TryApplyUpdateInPlace) */
+	bool canPatchInPlace;
 } BsonUpdateIntermediatePathNode;
 
 /*
@@ -245,6 +250,21 @@ typedef struct UpdateOperatorWriter
 } UpdateOperatorWriter;
 
 
+/*
+ * A new value for an existing value of the source document, written
+ * in place in a copy of the document.
+ */
+typedef struct InPlaceValuePatch
+{
+	/* Offset of the existing value from the start of the bson data */
+	uint32_t offset;
+
+	/* The new value, with the same type as the existing value */
+	bson_value_t value;
+} InPlaceValuePatch;
+
+extern bool EnableUpdateInPlacePatch;
+
 /* --------------------------------------------------------- */
 /* Forward declaration */
 /* --------------------------------------------------------- */
@@ -345,6 +365,22 @@ static bool HandleUnresolvedArrayFields(const BsonUpdateIntermediatePathNode *tr
 										const CurrentDocumentState *state,
 										BsonUpdateTracker *tracker);
 
+/* In place patch functions */
+static bool CanPatchUpdateTreeInPlace(const BsonUpdateIntermediatePathNode *tree,
+									  bool isRootLevel);
+static bool TryApplyUpdateInPlace(pgbson *sourceDoc,
+								  const BsonUpdateIntermediatePathNode *updateRoot,
+								  const CurrentDocumentState *state,
+								  pgbson **targetDoc);
+static bool CollectInPlaceValuePatches(const bson_iter_t *documentIterator,
+									   uint32_t documentOffset,
+									   const BsonUpdateIntermediatePathNode *tree,
+									   bool isRootLevel,
+									   const CurrentDocumentState *state,
+									   List **patches);
+static int GetFixedWidthValueSize(bson_type_t type);
+static void WriteFixedWidthValue(uint8_t *target, const bson_value_t *value);
+
 /* Operator specific writer state functions */
 static void * HandlePullWriterGetState(const bson_value_t *tree);
 
@@ -755,6 +791,9 @@ GetOperatorUpdateState(const bson_value_t *updateSpec, const bson_value_t *query
 	PostValidateArrayFilters(arrayFilterHash, updateSpec);
 	hash_destroy(arrayFilterHash);
 
+	bool isRootLevel = true;
+	root->canPatchInPlace = CanPatchUpdateTreeInPlace(root, isRootLevel);
+
 	return &root->base;
 }
 
@@ -789,15 +828,23 @@ ProcessUpdateOperatorWithState(pgbson *sourceDoc,
 		.indexOfPositionalTypeQueryFilter = -1
 	};
 
+	const BsonUpdateIntermediatePathNode *updateRoot =
+		(const BsonUpdateIntermediatePathNode *) updateState;
+
+	pgbson *patchedDoc = NULL;
+	if (EnableUpdateInPlacePatch && updateRoot->canPatchInPlace && !isUpsert &&
+		updateTracker == NULL &&
+		TryApplyUpdateInPlace(sourceDoc, updateRoot, &currentDocState, &patchedDoc))
+	{
+		return patchedDoc;
+	}
+
 	PgbsonInitIterator(sourceDoc, &docIterator);
 
 	/* Update */
 	pgbson_writer writer;
 	PgbsonWriterInit(&writer);
 
-	const BsonUpdateIntermediatePathNode *updateRoot =
-		(const BsonUpdateIntermediatePathNode *) updateState;
-
 	/* Step 1 - write the _id */
 	bool updated = HandleUpdateDocumentId(&writer, updateRoot, &currentDocState);
 
@@ -1638,6 +1685,354 @@ HandleUpdateDocumentId(pgbson_writer *writer,
 }
 
 
+/*
+ * Whether the update tree can be applied by patching values of the
+ * source document in place: the _id is not updated, there are no positional
+ * or $rename paths, and every leaf is an operator that writes a single
+ * scalar value computed from the existing one.
+ */
+static bool
+CanPatchUpdateTreeInPlace(const BsonUpdateIntermediatePathNode *tree, bool isRootLevel)
+{
+	if (tree->hasPositionalChildren ||
+		tree->positionalData.type != PositionalType_None ||
+		tree->sourceOrTargetNodeForRenameOP != NULL)
+	{
+		return false;
+	}
+
+	const BsonPathNode *node;
+	foreach_child(node, (&tree->base))
+	{
+		if (isRootLevel && StringViewEquals(&node->field, &IdFieldStringView))
+		{
+			if (IsIntermediateNode(node) ||
+				CastAsUpdateLeafNode(node)->writeFunc != NULL)
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		if (IsIntermediateNode(node))
+		{
+			bool isChildRootLevel = false;
+			if (!CanPatchUpdateTreeInPlace(CastAsUpdateIntermediateNode(node),
+										   isChildRootLevel))
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		const BsonUpdateLeafNode *leaf = CastAsUpdateLeafNode(node);
+		if (leaf->positionalData.type != PositionalType_None)
+		{
+			return false;
+		}
+
+		if (leaf->writeFunc != HandleUpdateDollarSet &&
+			leaf->writeFunc != HandleUpdateDollarInc &&
+			leaf->writeFunc != HandleUpdateDollarMin &&
+			leaf->writeFunc != HandleUpdateDollarMax &&
+			leaf->writeFunc != HandleUpdateDollarMul &&
+			leaf->writeFunc != HandleUpdateDollarBit &&
+			leaf->writeFunc != HandleUpdateDollarCurrentDate)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/*
+ * Tries to apply an update that can be patched in place (see CanPatchUpdateTreeInPlace)
+ * without rebuilding the document: when every updated path exists in the source
+ * document and every new value has the same fixed width type as the existing
+ * value, the new values are written over the existing ones in a copy of the
+ * source document.
+ *
+ * Returns false if the document needs to be rebuilt. Otherwise, sets targetDoc to
+ * the updated document, or NULL if the update was a no-op.
+ */
+static bool
+TryApplyUpdateInPlace(pgbson *sourceDoc, const BsonUpdateIntermediatePathNode *updateRoot,
+					  const CurrentDocumentState *state, pgbson **targetDoc)
+{
+	/* The regular path writes the _id first, only patch documents that have it first */
+	bson_iter_t documentIterator;
+	PgbsonInitIterator(sourceDoc, &documentIterator);
+	if (!bson_iter_next(&documentIterator) ||
+		strcmp(bson_iter_key(&documentIterator), IdFieldStringView.string) != 0)
+	{
+		return false;
+	}
+
+	List *patches = NIL;
+	uint32_t documentOffset = 0;
+	bool isRootLevel = true;
+	PgbsonInitIterator(sourceDoc, &documentIterator);
+	if (!CollectInPlaceValuePatches(&documentIterator, documentOffset, updateRoot,
+									isRootLevel, state, &patches))
+	{
+		return false;
+	}
+
+	if (patches == NIL)
+	{
+		*targetDoc = NULL;
+		return true;
+	}
+
+	pgbson *patchedDoc = CopyPgbsonIntoMemoryContext(sourceDoc, CurrentMemoryContext);
+	uint8_t *patchedData = (uint8_t *) VARDATA_ANY(patchedDoc);
+
+	ListCell *cell;
+	foreach(cell, patches)
+	{
+		InPlaceValuePatch *patch = (InPlaceValuePatch *) lfirst(cell);
+		WriteFixedWidthValue(patchedData + patch->offset, &patch->value);
+	}
+
+	list_free_deep(patches);
+	*targetDoc = patchedDoc;
+	ReportFeatureUsage(FEATURE_USAGE_UPDATE_IN_PLACE_PATCH);
+	return true;
+}
+
+
+/*
+ * Walks the update tree along the document pointed to by documentIterator, which
+ * starts at documentOffset of the source document, and collects the values to
+ * patch in place for the updated fields.
+ *
+ * Returns false if one of the updated values can't be patched in place.
+ */
+static bool
+CollectInPlaceValuePatches(const bson_iter_t *documentIterator, uint32_t documentOffset,
+						   const BsonUpdateIntermediatePathNode *tree, bool isRootLevel,
+						   const CurrentDocumentState *state, List **patches)
+{
+	const BsonPathNode *node;
+	foreach_child(node, (&tree->base))
+	{
+		if (isRootLevel && StringViewEquals(&node->field, &IdFieldStringView))
+		{
+			continue;
+		}
+
+		bson_iter_t fieldIterator = *documentIterator;
+		if (!bson_iter_find_w_len(&fieldIterator, node->field.string,
+								  node->field.length))
+		{
+			/* Adding a field changes the layout of the document */
+			return false;
+		}
+
+		/* The value follows the type byte and the null terminated key of the element */
+		uint32_t valueOffset = documentOffset + bson_iter_offset(&fieldIterator) + 1 +
+							   bson_iter_key_len(&fieldIterator) + 1;
+
+		if (IsIntermediateNode(node))
+		{
+			bson_iter_t childIterator;
+			bool isChildRootLevel = false;
+			if (!BSON_ITER_HOLDS_DOCUMENT(&fieldIterator) ||
+				!bson_iter_recurse(&fieldIterator, &childIterator) ||
+				!CollectInPlaceValuePatches(&childIterator, valueOffset,
+											CastAsUpdateIntermediateNode(node),
+											isChildRootLevel, state, patches))
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		const bson_value_t *existingValue = bson_iter_value(&fieldIterator);
+		if (GetFixedWidthValueSize(existingValue->value_type) < 0)
+		{
+			return false;
+		}
+
+		/* Let the operator compute the new value into a scratch document */
+		pgbson_writer valueWriter;
+		PgbsonWriterInit(&valueWriter);
+		pgbson_element_writer elementWriter;
+		PgbsonInitObjectElementWriter(&valueWriter, &elementWriter, node->field.string,
+									  node->field.length);
+
+		const BsonUpdateLeafNode *leaf = CastAsUpdateLeafNode(node);
+		UpdateSetValueState setValueState =
+		{
+			.fieldPath = &node->field,
+			.relativePath = leaf->relativePath,
+			.isArray = false,
+			.hasArrayAncestors = false
+		};
+
+		UpdateOperatorWriter updateWriter;
+		memset(&updateWriter, 0, sizeof(UpdateOperatorWriter));
+		updateWriter.writer = &elementWriter;
+		updateWriter.relativePath = leaf->relativePath;
+
+		leaf->writeFunc(existingValue, &updateWriter, &leaf->base.fieldData.value,
+						leaf->updateNodeContext, &setValueState, state);
+
+		if (updateWriter.modifyType == MODIFY_TYPE_NOCHANGE)
+		{
+			PgbsonWriterFree(&valueWriter);
+			continue;
+		}
+
+		bson_iter_t newValueIterator;
+		PgbsonWriterGetIterator(&valueWriter, &newValueIterator);
+		if (updateWriter.modifyType != MODIFY_TYPE_CHANGED ||
+			!bson_iter_next(&newValueIterator) ||
+			bson_iter_type(&newValueIterator) != existingValue->value_type)
+		{
+			PgbsonWriterFree(&valueWriter);
+			return false;
+		}
+
+		/* fixed width values are copied into the bson_value_t */
+		InPlaceValuePatch *patch = palloc(sizeof(InPlaceValuePatch));
+		patch->offset = valueOffset;
+		patch->value = *bson_iter_value(&newValueIterator);
+		*patches = lappend(*patches, patch);
+		PgbsonWriterFree(&valueWriter);
+	}
+
+	return true;
+}
+
+
+/*
+ * Returns the size of the encoded value for bson types that have a fixed
+ * width, -1 otherwise.
+ */
+static int
+GetFixedWidthValueSize(bson_type_t type)
+{
+	switch (type)
+	{
+		case BSON_TYPE_BOOL:
+		{
+			return 1;
+		}
+
+		case BSON_TYPE_INT32:
+		{
+			return 4;
+		}
+
+		case BSON_TYPE_DOUBLE:
+		case BSON_TYPE_INT64:
+		case BSON_TYPE_DATE_TIME:
+		case BSON_TYPE_TIMESTAMP:
+		{
+			return 8;
+		}
+
+		case BSON_TYPE_OID:
+		{
+			return 12;
+		}
+
+		case BSON_TYPE_DECIMAL128:
+		{
+			return 16;
+		}
+
+		default:
+		{
+			return -1;
+		}
+	}
+}
+
+
+/*
+ * Writes the encoded form of a fixed width value (see GetFixedWidthValueSize)
+ * to the target buffer.
+ */
+static void
+WriteFixedWidthValue(uint8_t *target, const bson_value_t *value)
+{
+	switch (value->value_type)
+	{
+		case BSON_TYPE_BOOL:
+		{
+			target[0] = value->value.v_bool ? 1 : 0;
+			break;
+		}
+
+		case BSON_TYPE_INT32:
+		{
+			uint32_t encoded = BSON_UINT32_TO_LE((uint32_t) value->value.v_int32);
+			memcpy(target, &encoded, sizeof(uint32_t));
+			break;
+		}
+
+		case BSON_TYPE_DOUBLE:
+		{
+			double encoded = BSON_DOUBLE_TO_LE(value->value.v_double);
+			memcpy(target, &encoded, sizeof(double));
+			break;
+		}
+
+		case BSON_TYPE_INT64:
+		{
+			uint64_t encoded = BSON_UINT64_TO_LE((uint64_t) value->value.v_int64);
+			memcpy(target, &encoded, sizeof(uint64_t));
+			break;
+		}
+
+		case BSON_TYPE_DATE_TIME:
+		{
+			uint64_t encoded = BSON_UINT64_TO_LE((uint64_t) value->value.v_datetime);
+			memcpy(target, &encoded, sizeof(uint64_t));
+			break;
+		}
+
+		case BSON_TYPE_TIMESTAMP:
+		{
+			/* the increment is stored before the timestamp */
+			uint32_t increment = BSON_UINT32_TO_LE(value->value.v_timestamp.increment);
+			uint32_t timestamp = BSON_UINT32_TO_LE(value->value.v_timestamp.timestamp);
+			memcpy(target, &increment, sizeof(uint32_t));
+			memcpy(target + sizeof(uint32_t), &timestamp, sizeof(uint32_t));
+			break;
+		}
+
+		case BSON_TYPE_OID:
+		{
+			memcpy(target, value->value.v_oid.bytes, sizeof(value->value.v_oid.bytes));
+			break;
+		}
+
+		case BSON_TYPE_DECIMAL128:
+		{
+			uint64_t low = BSON_UINT64_TO_LE(value->value.v_decimal128.low);
+			uint64_t high = BSON_UINT64_TO_LE(value->value.v_decimal128.high);
+			memcpy(target, &low, sizeof(uint64_t));
+			memcpy(target + sizeof(uint64_t), &high, sizeof(uint64_t));
+			break;
+		}
+
+		default:
+		{
+			ereport(ERROR, (errmsg("Unexpected type %s for an in place update",
+								   BsonTypeName(value->value_type))));
+		}
+	}
+}
+
+
 /*
  * Traverses the document with the sourceDocIterator, walks the update tree
  * and applies the update from the tree and writes the resultant modified
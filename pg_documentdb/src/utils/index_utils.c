@@ -8,7 +8,18 @@
  *-------------------------------------------------------------------------
  */
 #include <postgres.h>
+#include <access/genam.h>
+#include <access/table.h>
+#include <access/xact.h>
+#include <catalog/index.h>
+#include <commands/defrem.h>
+#include <commands/progress.h>
+#include <storage/lmgr.h>
 #include <storage/proc.h>
+#include <utils/backend_progress.h>
+#include <utils/inval.h>
+#include <utils/rel.h>
+#include <utils/relcache.h>
 #include <utils/snapmgr.h>
 #include <tcop/pquery.h>
 
@@ -51,3 +62,93 @@ PopAllActiveSnapshots(void)
 		ActivePortal->portalSnapshot = NULL;
 	}
 }
+
+
+/*
+ * ValidateReadyIndexConcurrently finishes a concurrent index build whose
+ * build phase already completed (the index is ready for inserts but not yet
+ * valid), by running only the validation phase of CREATE INDEX CONCURRENTLY.
+ *
+ * Mirrors phase 3 of DefineIndex in pg/src/backend/commands/indexcmds.c, and
+ * reports to pg_stat_progress_create_index the same way so that currentOp
+ * shows the progress of the validation. Must be called with a transaction
+ * started outside of a transaction block: commits the transactions it uses
+ * and returns with a new one started.
+ */
+void
+ValidateReadyIndexConcurrently(Oid heapRelationId, Oid indexRelationId)
+{
+	Relation heapRelation = table_open(heapRelationId, ShareUpdateExclusiveLock);
+	LockRelId heapRelId = heapRelation->rd_lockInfo.lockRelId;
+	table_close(heapRelation, NoLock);
+
+	/* Like DefineIndex, other backends may only ignore our snapshots while
+	 * we validate an index that has no expressions or predicate. */
+	Relation indexRelation = index_open(indexRelationId, AccessShareLock);
+	bool safeIndex = RelationGetIndexExpressions(indexRelation) == NIL &&
+					 RelationGetIndexPredicate(indexRelation) == NIL;
+	index_close(indexRelation, AccessShareLock);
+
+	LOCKTAG heapLockTag;
+	SET_LOCKTAG_RELATION(heapLockTag, heapRelId.dbId, heapRelId.relId);
+
+	/* Keep out schema changes across the transactions below, like DefineIndex */
+	LockRelationIdForSession(&heapRelId, ShareUpdateExclusiveLock);
+
+	pgstat_progress_start_command(PROGRESS_COMMAND_CREATE_INDEX, heapRelationId);
+	pgstat_progress_update_param(PROGRESS_CREATEIDX_COMMAND,
+								 PROGRESS_CREATEIDX_COMMAND_CREATE_CONCURRENTLY);
+	pgstat_progress_update_param(PROGRESS_CREATEIDX_INDEX_OID, indexRelationId);
+
+	PG_TRY();
+	{
+		PopAllActiveSnapshots();
+		CommitTransactionCommand();
+		StartTransactionCommand();
+
+		if (safeIndex)
+		{
+			set_indexsafe_procflags();
+		}
+
+		/* Wait for the writers that might not have seen the index as ready */
+		pgstat_progress_update_param(PROGRESS_CREATEIDX_PHASE,
+									 PROGRESS_CREATEIDX_PHASE_WAIT_2);
+		WaitForLockers(heapLockTag, ShareLock, true);
+
+		Snapshot snapshot = RegisterSnapshot(GetTransactionSnapshot());
+		PushActiveSnapshot(snapshot);
+
+		validate_index(heapRelationId, indexRelationId, snapshot);
+
+		TransactionId limitXmin = snapshot->xmin;
+		PopActiveSnapshot();
+		UnregisterSnapshot(snapshot);
+
+		CommitTransactionCommand();
+		StartTransactionCommand();
+
+		if (safeIndex)
+		{
+			set_indexsafe_procflags();
+		}
+
+		/* Readers with older snapshots could miss tuples the index doesn't have */
+		pgstat_progress_update_param(PROGRESS_CREATEIDX_PHASE,
+									 PROGRESS_CREATEIDX_PHASE_WAIT_3);
+		WaitForOlderSnapshots(limitXmin, true);
+
+		index_set_state_flags(indexRelationId, INDEX_CREATE_SET_VALID);
+		CacheInvalidateRelcacheByRelid(heapRelationId);
+	}
+	PG_CATCH();
+	{
+		pgstat_progress_end_command();
+		UnlockRelationIdForSession(&heapRelId, ShareUpdateExclusiveLock);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+
+	pgstat_progress_end_command();
+	UnlockRelationIdForSession(&heapRelId, ShareUpdateExclusiveLock);
+}
@@ -80,7 +80,9 @@ CreateExtensionHashCTL(Size keySize, Size entrySize,
 HTAB * CreatePgbsonElementHashSet(void);
 HTAB * CreatePgbsonElementPathAndValueHashSet(void);
 HTAB * CreateStringViewHashSet(void);
+HTAB * CreateStringViewHashMap(Size entrySize);
 HTAB * CreateBsonValueHashSet(void);
+HTAB * CreateBsonValueHashMap(Size entrySize);
 HTAB * CreatePgbsonElementOrderedHashSet(void);
 HTAB * CreateBsonValueWithCollationHashSet(int extraDataSize);
 
@@ -168,6 +168,25 @@ CreateStringViewHashSet()
 }
 
 
+/*
+ * Creates a hash table keyed on StringView (with the same hash and
+ * comparison semantics as CreateStringViewHashSet) whose entries are
+ * entrySize bytes. The StringView key must be the first field of the entry.
+ */
+HTAB *
+CreateStringViewHashMap(Size entrySize)
+{
+	Assert(entrySize >= sizeof(StringView));
+	HASHCTL hashInfo = CreateExtensionHashCTL(
+		sizeof(StringView),
+		entrySize,
+		StringViewHashEntryCompareFunc,
+		StringViewHashEntryHashFunc
+		);
+	return hash_create("StringView Hash Map", 32, &hashInfo, DefaultExtensionHashFlags);
+}
+
+
 /*
  * StringViewHashEntryHashFunc is the (HASHCTL.hash) callback used to hash a StringView
  */
@@ -214,6 +233,29 @@ CreateBsonValueHashSet()
 }
 
 
+/*
+ * Creates a hash table keyed on bson_value_t (with the same hash and
+ * comparison semantics as CreateBsonValueHashSet) whose entries are
+ * entrySize bytes. The bson_value_t key must be the first field of the entry.
+ */
+HTAB *
+CreateBsonValueHashMap(Size entrySize)
+{
+	Assert(entrySize >= sizeof(bson_value_t));
+	HASHCTL hashInfo = CreateExtensionHashCTL(
+		sizeof(bson_value_t),
+		entrySize,
+		BsonValueHashEntryCompareFunc,
+		BsonValueHashFunc);
+	static const int numElements = 32;
+	HTAB *bsonValueHashMap =
+		hash_create("Bson Value Hash Map", numElements, &hashInfo,
+					DefaultExtensionHashFlags);
+
+	return bsonValueHashMap;
+}
+
+
 static uint32
 BsonValueHashFunc(const void *obj, size_t objsize)
 {
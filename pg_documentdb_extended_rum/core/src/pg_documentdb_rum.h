@@ -82,13 +82,17 @@ typedef RumPageOpaqueData *RumPageOpaque;
  * of LP_DEAD for posting tree pages.
  */
 
-/* DEPRECATED (REUSABLE): #define RUM_LIST (1 << 4) */
+/* DEPRECATED (REUSABLE): the old RUM_LIST (1 << 4) */
 #define RUM_PAGE_IS_DEAD_ROWS (1 << 4)
 
-/* DEPRECATED (REUSABLE): #define RUM_LIST_FULLROW (1 << 5) */
+/* DEPRECATED (REUSABLE): the old RUM_LIST_FULLROW (1 << 5) */
 #define RUM_HALF_DEAD (1 << 6)
 #define RUM_INCOMPLETE_SPLIT (1 << 7)   /* page was split, but parent not updated */
 
+/* Pending list pages, see rumfast.c */
+#define RUM_LIST (1 << 8)
+#define RUM_LIST_FULLROW (1 << 9)       /* the page ends with a complete heap tuple */
+
 /* Page numbers of fixed-location pages */
 #define RUM_METAPAGE_BLKNO (0)
 #define RUM_ROOT_BLKNO (1)
@@ -115,8 +119,8 @@ typedef struct RumMetaPageData
 	uint32 rumVersion;
 
 	/*
-	 * Pointers to head and tail of pending list (unused).
-	 * XXX unused - pending list is removed.
+	 * Pointers to head and tail of the pending list, only used when the
+	 * index has fastupdate enabled.
 	 */
 	BlockNumber head;
 	BlockNumber tail;
@@ -127,8 +131,9 @@ typedef struct RumMetaPageData
 	uint32 tailFreeSize;
 
 	/*
-	 * We store both number of pages and number of heap tuples that are in the
-	 * pending list.
+	 * Number of pages in the pending list.  nPendingHeapTuples is not kept
+	 * for the pending list: the extension adapter uses it to mark the index
+	 * as multi-key (see documentdb_rum_update_multi_key_status).
 	 */
 	BlockNumber nPendingPages;
 	int64 nPendingHeapTuples;
@@ -167,6 +172,10 @@ typedef struct RumMetaPageData
 #define RumPageSetNonDeleted(page) (RumPageGetOpaque(page)->flags &= ~RUM_DELETED)
 #define RumPageForceSetDeleted(page) (RumPageGetOpaque(page)->flags = RUM_DELETED)
 
+#define RumPageIsList(page) ((RumPageGetOpaque(page)->flags & RUM_LIST) != 0)
+#define RumPageHasFullRow(page) ((RumPageGetOpaque(page)->flags & RUM_LIST_FULLROW) != 0)
+#define RumPageSetFullRow(page) (RumPageGetOpaque(page)->flags |= RUM_LIST_FULLROW)
+
 #define RumPageIsHalfDead(page) ((RumPageGetOpaque(page)->flags & RUM_HALF_DEAD) != 0)
 #define RumPageSetHalfDead(page) (RumPageGetOpaque(page)->flags |= RUM_HALF_DEAD)
 #define RumPageSetNonHalfDead(page) (RumPageGetOpaque(page)->flags &= ~RUM_HALF_DEAD)
@@ -434,8 +443,22 @@ typedef struct RumOptions
 	bool useAlternativeOrder;
 	int attachColumn;
 	int addToColumn;
+	bool useFastUpdate;         /* use the pending list for inserts */
+	int pendingListCleanupSize; /* maximum size of the pending list in kB,
+	                             * -1 to use the GUC value */
 }   RumOptions;
 
+#define RUM_DEFAULT_USE_FASTUPDATE false
+#define RumGetUseFastUpdate(relation) \
+	((relation)->rd_options ? \
+	 ((RumOptions *) (relation)->rd_options)->useFastUpdate : \
+	 RUM_DEFAULT_USE_FASTUPDATE)
+#define RumGetPendingListCleanupSize(relation) \
+	((relation)->rd_options && \
+	 ((RumOptions *) (relation)->rd_options)->pendingListCleanupSize != -1 ? \
+	 ((RumOptions *) (relation)->rd_options)->pendingListCleanupSize : \
+	 RumPendingListLimit)
+
 #define ALT_ADD_INFO_NULL_FLAG (0x8000)
 
 /* Macros for buffer lock/unlock operations */
@@ -570,6 +593,26 @@ extern void rumEntryInsert(RumState *rumstate,
 						   OffsetNumber attnum, Datum key, RumNullCategory category,
 						   RumItem *items, uint32 nitem, RumStatsData *buildStats);
 
+/* rumfast.c */
+typedef struct RumTupleCollector
+{
+	IndexTuple *tuples;
+	uint32 ntuples;
+	uint32 lentuples;
+	uint32 sumsize;
+}   RumTupleCollector;
+
+extern void rumHeapTupleFastCollect(RumState *rumstate,
+									RumTupleCollector *collector,
+									OffsetNumber attnum, Datum value, bool isNull,
+									ItemPointer ht_ctid, Datum outerAddInfo,
+									bool outerAddInfoIsNull);
+extern void rumHeapTupleFastInsert(RumState *rumstate,
+								   RumTupleCollector *collector);
+extern void rumInsertCleanup(RumState *rumstate, bool forceCleanup,
+							 IndexBulkDeleteResult *stats);
+extern bool rumHasPendingList(Relation index);
+
 /* rumbtree.c */
 
 typedef struct RumBtreeStack
@@ -915,12 +958,19 @@ typedef struct RumScanOpaqueData
 	RumScanType scanType;
 	bool isParallelEnabled;
 
+	/* Heap block range [start, end) claimed by a parallel regular scan */
+	BlockNumber parallelRangeStart;
+	BlockNumber parallelRangeEnd;
+
 	ScanDirection naturalOrder;
 	bool secondPass;
 
 	/* on a regular scan, how many loops of scans were done. */
 	uint32_t scanLoops;
 
+	/* whether the last bitmap scan added the entries of its key one by one */
+	bool isBitmapEntryUnion;
+
 	/* In an ordered scan, the key pointing to the order by key */
 	int32_t orderByKeyIndex;
 	bool orderByHasRecheck;
@@ -933,6 +983,12 @@ typedef struct RumScanOpaqueData
 	/* documentdb: whether or not to use a simple scanGetNextItem in rumgettuple */
 	bool useSimpleScan;
 
+	/* Pending list matches of a tuple scan, in TID order (see scanPendingItems) */
+	ItemPointerData *pendingItems;
+	uint32 nPendingItems;
+	uint32 pendingItemsReturned;
+	bool returnedPendingItem;
+
 	/* LP_DEAD stuff */
 	ItemPointerData *killedItems;
 	int numKilled;
@@ -973,12 +1029,25 @@ extern bool rum_parallel_seize(ParallelIndexScanDesc parallelScan,
 							   BlockNumber *blockNumber);
 extern void rum_parallel_release(ParallelIndexScanDesc parallelScan, BlockNumber
 								 nextBlock);
+extern bool rum_parallel_claim_heap_range(ParallelIndexScanDesc parallelScan,
+										  BlockNumber *startBlock,
+										  BlockNumber *endBlock);
 
 /* rumget.c */
 extern int64 rumgetbitmap(IndexScanDesc scan, TIDBitmap *tbm);
 extern bool rumgettuple(IndexScanDesc scan, ScanDirection direction);
 extern void RumKillEntryItems(RumScanOpaque so, RumOrderByScanData *scanData);
 
+/*
+ * Invoked with each distinct key that has a visible heap tuple, returns
+ * false to stop the enumeration.
+ */
+typedef bool (*RumDistinctEntryCallback) (Datum key, void *callbackState);
+extern bool rumEnumerateDistinctEntries(Relation index, Relation heapRelation,
+										Snapshot snapshot, OffsetNumber attnum,
+										RumDistinctEntryCallback callback,
+										void *callbackState);
+
 /* rumvacuum.c */
 extern IndexBulkDeleteResult * rumbulkdelete(IndexVacuumInfo *info,
 											 IndexBulkDeleteResult *stats,
@@ -1079,6 +1148,7 @@ extern RumItem * rumGetBAEntry(BuildAccumulator *accum,
 
 /* GUC parameters */
 extern PGDLLIMPORT int RumFuzzySearchLimit;
+extern PGDLLIMPORT int RumPendingListLimit;
 extern PGDLLIMPORT int RumDataPageIntermediateSplitSize;
 extern PGDLLIMPORT bool RumThrowErrorOnInvalidDataPage;
 extern PGDLLIMPORT bool RumDisableFastScan;
@@ -1088,14 +1158,19 @@ extern PGDLLIMPORT bool RumSkipRetryOnDeletePage;
 extern PGDLLIMPORT bool RumForceOrderedIndexScan;
 extern PGDLLIMPORT bool RumPreferOrderedIndexScan;
 extern PGDLLIMPORT bool RumEnableSkipIntermediateEntry;
+extern PGDLLIMPORT bool RumEnableParallelRegularScan;
+extern PGDLLIMPORT bool RumEnableBitmapEntryUnion;
 extern PGDLLIMPORT bool RumVacuumEntryItems;
 extern PGDLLIMPORT bool RumUseNewItemPtrDecoding;
+extern PGDLLIMPORT bool RumEnableWordItemPtrDecoding;
 extern PGDLLIMPORT bool RumPruneEmptyPages;
 extern PGDLLIMPORT bool RumTrackIncompleteSplit;
 extern PGDLLIMPORT bool RumFixIncompleteSplit;
 extern PGDLLIMPORT bool RumInjectPageSplitIncomplete;
+extern PGDLLIMPORT bool RumInjectDistinctEntryRestart;
 extern PGDLLIMPORT bool RumEnableParallelVacuumFlags;
 extern PGDLLIMPORT bool RumEnableCustomCostEstimate;
+extern PGDLLIMPORT bool RumEnableEntryPresenceCostEstimate;
 extern PGDLLIMPORT bool RumEnableNewBulkDelete;
 extern PGDLLIMPORT bool RumNewBulkDeleteInlineDataPages;
 extern PGDLLIMPORT bool RumVacuumSkipPrunePostingTreePages;
@@ -1332,14 +1407,82 @@ rumDataPageLeafReadWithBlockNumberIncr(Pointer ptr, OffsetNumber attnum, RumItem
 }
 
 
+/*
+ * Number of item pointers decoded per word by rumPopulateDataPage: a word of
+ * 8 bytes with no continuation bit set holds 4 single-byte block deltas and
+ * 4 single-byte offsets.
+ */
+#define RUM_ITEMS_PER_DECODE_WORD 4
+#define RUM_VARBYTE_CONTINUATION_MASK UINT64CONST(0x8080808080808080)
+
+/*
+ * Checks whether the next RUM_ITEMS_PER_DECODE_WORD item pointers at ptr are
+ * all single-byte (block delta, offset) pairs with a valid offset and no
+ * additional information, so they can be decoded without the varbyte loop.
+ */
+static inline bool
+rumCanDecodeItemPointerWord(Pointer ptr)
+{
+	const unsigned char *p = (const unsigned char *) ptr;
+	uint64 word;
+
+	memcpy(&word, ptr, sizeof(uint64));
+	if ((word & RUM_VARBYTE_CONTINUATION_MASK) != 0)
+	{
+		return false;
+	}
+
+	/* every offset byte must be non-zero and flag its addInfo as null */
+	return (p[1] & p[3] & p[5] & p[7] & SEVENTHBIT) != 0 &&
+		   (p[1] & SIXMASK) != 0 && (p[3] & SIXMASK) != 0 &&
+		   (p[5] & SIXMASK) != 0 && (p[7] & SIXMASK) != 0;
+}
+
+
 inline static void
 rumPopulateDataPage(RumState *rumstate, RumScanEntry entry, OffsetNumber maxoff, Page
 					pageInner)
 {
 	InitBlockNumberIncrZero(blockNumberIncr);
 	Pointer ptr = RumDataPageGetData(pageInner);
+	Pointer wordLimit = (Pointer) pageInner + BLCKSZ - sizeof(uint64);
+	bool useWordDecoding = RumEnableWordItemPtrDecoding &&
+						   !rumstate->useAlternativeOrder &&
+						   rumstate->addAttrs[entry->attnum - 1] == NULL;
+
 	for (OffsetNumber i = FirstOffsetNumber; i <= maxoff; i = OffsetNumberNext(i))
 	{
+		/*
+		 * Posting lists of densely packed heap tuples mostly consist of
+		 * zero or small block deltas with small offsets, each fitting a
+		 * single byte. Decode those a word at a time and fall back to the
+		 * varbyte decoder for anything else.
+		 */
+		while (useWordDecoding &&
+			   maxoff - i + 1 >= RUM_ITEMS_PER_DECODE_WORD &&
+			   ptr <= wordLimit && rumCanDecodeItemPointerWord(ptr))
+		{
+			const unsigned char *p = (const unsigned char *) ptr;
+			RumItem *items = &entry->list[i - FirstOffsetNumber];
+
+			for (int j = 0; j < RUM_ITEMS_PER_DECODE_WORD; j++)
+			{
+				blockNumberIncr += p[2 * j];
+				items[j].iptr.ip_blkid.bi_lo = blockNumberIncr & 0xFFFF;
+				items[j].iptr.ip_blkid.bi_hi = (blockNumberIncr >> 16) & 0xFFFF;
+				items[j].iptr.ip_posid = p[2 * j + 1] & SIXMASK;
+				items[j].addInfoIsNull = true;
+			}
+
+			ptr += sizeof(uint64);
+			i += RUM_ITEMS_PER_DECODE_WORD;
+		}
+
+		if (i > maxoff)
+		{
+			break;
+		}
+
 		ptr = rumDataPageLeafReadWithBlockNumberIncr(ptr, entry->attnum,
 													 &entry->list[i - FirstOffsetNumber],
 													 true,
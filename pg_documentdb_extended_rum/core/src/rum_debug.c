@@ -112,6 +112,12 @@ RumPageFlagsToString(Page page)
 		separator = "|";
 	}
 
+	if (RumPageIsList(page))
+	{
+		appendStringInfo(flagsStr, "%sLIST", separator);
+		separator = "|";
+	}
+
 	if (RumPageIsDeleted(page))
 	{
 		appendStringInfo(flagsStr, "%sDELETED", separator);
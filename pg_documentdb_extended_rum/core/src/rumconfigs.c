@@ -32,6 +32,10 @@ PGDLLEXPORT bool RumThrowErrorOnInvalidDataPage =
 #define RUM_DEFAULT_USE_NEW_ITEM_PTR_DECODING true
 PGDLLEXPORT bool RumUseNewItemPtrDecoding = RUM_DEFAULT_USE_NEW_ITEM_PTR_DECODING;
 
+#define RUM_DEFAULT_ENABLE_WORD_ITEM_PTR_DECODING false
+PGDLLEXPORT bool RumEnableWordItemPtrDecoding =
+	RUM_DEFAULT_ENABLE_WORD_ITEM_PTR_DECODING;
+
 #define RUM_ENABLE_PARALLEL_VACUUM_FLAGS true
 PGDLLEXPORT bool RumEnableParallelVacuumFlags = RUM_ENABLE_PARALLEL_VACUUM_FLAGS;
 
@@ -65,6 +69,16 @@ PGDLLEXPORT bool RumPreferOrderedIndexScan = RUM_DEFAULT_PREFER_ORDERED_INDEX_SC
 PGDLLEXPORT bool RumEnableSkipIntermediateEntry =
 	RUM_DEFAULT_ENABLE_SKIP_INTERMEDIATE_ENTRY;
 
+#define RUM_DEFAULT_ENABLE_PARALLEL_REGULAR_SCAN false
+PGDLLEXPORT bool RumEnableParallelRegularScan = RUM_DEFAULT_ENABLE_PARALLEL_REGULAR_SCAN;
+
+#define RUM_DEFAULT_ENABLE_BITMAP_ENTRY_UNION false
+PGDLLEXPORT bool RumEnableBitmapEntryUnion = RUM_DEFAULT_ENABLE_BITMAP_ENTRY_UNION;
+
+#define RUM_DEFAULT_ENABLE_INJECT_DISTINCT_ENTRY_RESTART false
+PGDLLEXPORT bool RumInjectDistinctEntryRestart =
+	RUM_DEFAULT_ENABLE_INJECT_DISTINCT_ENTRY_RESTART;
+
 /* ruminsert.c */
 #define RUM_DEFAULT_ENABLE_PARALLEL_INDEX_BUILD true
 PGDLLEXPORT bool RumEnableParallelIndexBuild = RUM_DEFAULT_ENABLE_PARALLEL_INDEX_BUILD;
@@ -73,6 +87,10 @@ PGDLLEXPORT bool RumEnableParallelIndexBuild = RUM_DEFAULT_ENABLE_PARALLEL_INDEX
 PGDLLEXPORT int RumParallelIndexWorkersOverride =
 	RUM_DEFAULT_PARALLEL_INDEX_WORKERS_OVERRIDE;
 
+/* rumfast.c */
+#define RUM_DEFAULT_PENDING_LIST_LIMIT 4096
+PGDLLEXPORT int RumPendingListLimit = RUM_DEFAULT_PENDING_LIST_LIMIT;
+
 /* rumvacuum.c */
 #define RUM_DEFAULT_SKIP_RETRY_ON_DELETE_PAGE true
 PGDLLEXPORT bool RumSkipRetryOnDeletePage = RUM_DEFAULT_SKIP_RETRY_ON_DELETE_PAGE;
@@ -114,6 +132,10 @@ PGDLLEXPORT bool RumEnableSupportDeadIndexItems =
 #define RUM_DEFAULT_ENABLE_CUSTOM_COST_ESTIMATE true
 PGDLLEXPORT bool RumEnableCustomCostEstimate = RUM_DEFAULT_ENABLE_CUSTOM_COST_ESTIMATE;
 
+#define RUM_DEFAULT_ENABLE_ENTRY_PRESENCE_COST_ESTIMATE false
+PGDLLEXPORT bool RumEnableEntryPresenceCostEstimate =
+	RUM_DEFAULT_ENABLE_ENTRY_PRESENCE_COST_ESTIMATE;
+
 PGDLLEXPORT rum_format_log_hook rum_unredacted_log_emit_hook = NULL;
 
 
@@ -171,6 +193,24 @@ InitializeCommonDocumentDBGUCs(const char *rumGucPrefix, const
 		PGC_USERSET, 0,
 		NULL, NULL, NULL);
 
+	DefineCustomBoolVariable(
+		psprintf("%s.enable_parallel_regular_scan", documentDBRumGucPrefix),
+		"Sets whether or not regular (non-ordered) scans can be shared by parallel workers",
+		NULL,
+		&RumEnableParallelRegularScan,
+		RUM_DEFAULT_ENABLE_PARALLEL_REGULAR_SCAN,
+		PGC_USERSET, 0,
+		NULL, NULL, NULL);
+
+	DefineCustomBoolVariable(
+		psprintf("%s.enable_bitmap_entry_union", documentDBRumGucPrefix),
+		"Sets whether or not bitmap scans add the items of each entry of a union key (like $in) directly to the bitmap",
+		NULL,
+		&RumEnableBitmapEntryUnion,
+		RUM_DEFAULT_ENABLE_BITMAP_ENTRY_UNION,
+		PGC_USERSET, 0,
+		NULL, NULL, NULL);
+
 	DefineCustomBoolVariable(
 		psprintf("%s.enable_parallel_index_build", documentDBRumGucPrefix),
 		"Sets whether or not to enable parallel index build",
@@ -180,6 +220,15 @@ InitializeCommonDocumentDBGUCs(const char *rumGucPrefix, const
 		PGC_USERSET, 0,
 		NULL, NULL, NULL);
 
+	DefineCustomIntVariable(
+		psprintf("%s.pending_list_limit", documentDBRumGucPrefix),
+		"Sets the maximum size of the pending list for RUM indexes with fastupdate enabled.",
+		NULL,
+		&RumPendingListLimit,
+		RUM_DEFAULT_PENDING_LIST_LIMIT, 64, MAX_KILOBYTES,
+		PGC_USERSET, GUC_UNIT_KB,
+		NULL, NULL, NULL);
+
 	DefineCustomIntVariable(
 		psprintf("%s.parallel_index_workers_override", documentDBRumGucPrefix),
 		"Sets the number of parallel index workers to use (default: -1, meaning no override)",
@@ -233,6 +282,15 @@ InitializeCommonDocumentDBGUCs(const char *rumGucPrefix, const
 		PGC_USERSET, 0,
 		NULL, NULL, NULL);
 
+	DefineCustomBoolVariable(
+		psprintf("%s.rum_enable_word_item_ptr_decoding", documentDBRumGucPrefix),
+		"Sets whether or not to decode runs of single byte item pointers a word at a time",
+		NULL,
+		&RumEnableWordItemPtrDecoding,
+		RUM_DEFAULT_ENABLE_WORD_ITEM_PTR_DECODING,
+		PGC_USERSET, 0,
+		NULL, NULL, NULL);
+
 	DefineCustomBoolVariable(
 		psprintf("%s.enable_inject_page_split_incomplete", documentDBRumGucPrefix),
 		"Test GUC - sets whether or not to enable injecting a failure in the middle of a page split",
@@ -242,6 +300,15 @@ InitializeCommonDocumentDBGUCs(const char *rumGucPrefix, const
 		PGC_USERSET, 0,
 		NULL, NULL, NULL);
 
+	DefineCustomBoolVariable(
+		psprintf("%s.enable_inject_distinct_entry_restart", documentDBRumGucPrefix),
+		"Test GUC - sets whether or not the distinct entry walk restarts from the root after every posting tree",
+		NULL,
+		&RumInjectDistinctEntryRestart,
+		RUM_DEFAULT_ENABLE_INJECT_DISTINCT_ENTRY_RESTART,
+		PGC_USERSET, 0,
+		NULL, NULL, NULL);
+
 	DefineCustomBoolVariable(
 		psprintf("%s.enable_set_vacuum_parallel_flags", documentDBRumGucPrefix),
 		"Enables setting the parallel vacuum flags in Postgres",
@@ -260,6 +327,15 @@ InitializeCommonDocumentDBGUCs(const char *rumGucPrefix, const
 		PGC_USERSET, 0,
 		NULL, NULL, NULL);
 
+	DefineCustomBoolVariable(
+		psprintf("%s.enable_entry_presence_cost_estimate", documentDBRumGucPrefix),
+		"Sets whether or not the cost estimate probes the index for the posting sizes of exact match entries",
+		NULL,
+		&RumEnableEntryPresenceCostEstimate,
+		RUM_DEFAULT_ENABLE_ENTRY_PRESENCE_COST_ESTIMATE,
+		PGC_USERSET, 0,
+		NULL, NULL, NULL);
+
 	DefineCustomBoolVariable(
 		psprintf("%s.prune_rum_empty_pages", documentDBRumGucPrefix),
 		"Sets whether or not to prune empty pages during vacuuming",
@@ -366,6 +442,20 @@ InitializeCommonDocumentDBGUCs(const char *rumGucPrefix, const
 					   , AccessExclusiveLock
 #endif
 					   );
+	add_bool_reloption(rum_relopt_kind, "fastupdate",
+					   "Enables the pending list for fast insertion into the index",
+					   RUM_DEFAULT_USE_FASTUPDATE
+#if PG_VERSION_NUM >= 130000
+					   , ShareUpdateExclusiveLock
+#endif
+					   );
+	add_int_reloption(rum_relopt_kind, "pending_list_limit",
+					  "Maximum size of the pending list for this index, in kilobytes",
+					  -1, 64, MAX_KILOBYTES
+#if PG_VERSION_NUM >= 130000
+					  , ShareUpdateExclusiveLock
+#endif
+					  );
 }
 
 
@@ -379,13 +469,20 @@ documentdb_rumoptions(Datum reloptions, bool validate)
 		  offsetIfDefault },
 		{ "to", RELOPT_TYPE_STRING, offsetof(RumOptions, addToColumn), offsetIfDefault },
 		{ "order_by_attach", RELOPT_TYPE_BOOL, offsetof(RumOptions, useAlternativeOrder),
-		  offsetIfDefault }
+		  offsetIfDefault },
+		{ "fastupdate", RELOPT_TYPE_BOOL, offsetof(RumOptions, useFastUpdate),
+		  offsetIfDefault },
+		{ "pending_list_limit", RELOPT_TYPE_INT,
+		  offsetof(RumOptions, pendingListCleanupSize), offsetIfDefault }
 	};
 #else
 	static const relopt_parse_elt tab[] = {
 		{ "attach", RELOPT_TYPE_STRING, offsetof(RumOptions, attachColumn) },
 		{ "to", RELOPT_TYPE_STRING, offsetof(RumOptions, addToColumn) },
-		{ "order_by_attach", RELOPT_TYPE_BOOL, offsetof(RumOptions, useAlternativeOrder) }
+		{ "order_by_attach", RELOPT_TYPE_BOOL, offsetof(RumOptions, useAlternativeOrder) },
+		{ "fastupdate", RELOPT_TYPE_BOOL, offsetof(RumOptions, useFastUpdate) },
+		{ "pending_list_limit", RELOPT_TYPE_INT,
+		  offsetof(RumOptions, pendingListCleanupSize) }
 	};
 #endif
 
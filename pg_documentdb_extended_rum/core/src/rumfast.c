@@ -0,0 +1,561 @@
+/*-------------------------------------------------------------------------
+ *
+ * rumfast.c
+ *	  Fast insert routines for the RUM index (the pending list).
+ *
+ * When fastupdate is enabled on the index, ruminsert does not descend the
+ * entry tree for every extracted term.  Instead, the tuples for a heap row
+ * are appended to a list of pending pages hanging off the metapage, and are
+ * merged into the entry and posting trees in bulk by rumInsertCleanup, which
+ * runs once the list outgrows pending_list_limit and on vacuum.  Scans read
+ * the pending list directly and never merge it (see rumget.c).
+ *
+ * This follows the design of PostgreSQL's GIN pending list (ginfast.c),
+ * using generic WAL records.
+ *
+ * Portions Copyright (c) Microsoft Corporation.  All rights reserved.
+ * Portions Copyright (c) 1996-2022, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+#include "miscadmin.h"
+
+#include "access/transam.h"
+#include "commands/vacuum.h"
+#include "storage/lmgr.h"
+#include "storage/predicate.h"
+
+#include "pg_documentdb_rum.h"
+
+#if PG_VERSION_NUM >= 180000
+#define RumVacuumDelayPointCompat() \
+	vacuum_delay_point(false);
+#else
+#define RumVacuumDelayPointCompat() \
+	vacuum_delay_point();
+#endif
+
+/* Usable space on a freshly initialized pending list page */
+#define RumListPageSize \
+	(BLCKSZ - SizeOfPageHeaderData - MAXALIGN(sizeof(RumPageOpaqueData)))
+
+/* Pending pages removed per WAL record (the metapage takes one slot) */
+#define RUM_NDELETE_AT_ONCE (MAX_GENERIC_XLOG_PAGES - 1)
+
+/* Description of a freshly built chain of pending pages */
+typedef struct RumPendingSublist
+{
+	BlockNumber head;
+	BlockNumber tail;
+	uint32 tailFreeSize;
+	BlockNumber nPendingPages;
+} RumPendingSublist;
+
+
+/*
+ * Write tuples to a freshly allocated (locked) pending list page, link it to
+ * rightlink and release it.  Returns the free space left on the page.
+ */
+static uint32
+writeListPage(Relation index, Buffer buffer, IndexTuple *tuples, uint32 ntuples,
+			  BlockNumber rightlink, bool isLastPage)
+{
+	GenericXLogState *state;
+	Page page;
+	uint32 i;
+	uint32 freeSize;
+
+	state = GenericXLogStart(index);
+	page = GenericXLogRegisterBuffer(state, buffer, GENERIC_XLOG_FULL_IMAGE);
+	RumInitPage(page, RUM_LIST, BufferGetPageSize(buffer));
+
+	for (i = 0; i < ntuples; i++)
+	{
+		if (PageAddItem(page, (Item) tuples[i], IndexTupleSize(tuples[i]),
+						InvalidOffsetNumber, false, false) == InvalidOffsetNumber)
+		{
+			elog(ERROR, "failed to add item to index page in \"%s\"",
+				 RelationGetRelationName(index));
+		}
+	}
+
+	RumPageGetOpaque(page)->rightlink = rightlink;
+
+	/* Only the last page of a sublist completes the heap tuple */
+	if (isLastPage)
+	{
+		RumPageSetFullRow(page);
+	}
+
+	freeSize = PageGetExactFreeSpace(page);
+	GenericXLogFinish(state);
+	UnlockReleaseBuffer(buffer);
+
+	return freeSize;
+}
+
+
+/*
+ * Build a chain of pending pages holding the tuples of one heap row.  The
+ * chain is not reachable from the metapage until the caller links it in.
+ */
+static void
+makeSublist(Relation index, IndexTuple *tuples, uint32 ntuples,
+			RumPendingSublist *sublist)
+{
+	Buffer curBuffer;
+	uint32 i,
+		   startTuple = 0;
+	Size size = 0;
+
+	Assert(ntuples > 0);
+
+	curBuffer = RumNewBuffer(index);
+	sublist->head = BufferGetBlockNumber(curBuffer);
+	sublist->nPendingPages = 1;
+
+	for (i = 0; i < ntuples; i++)
+	{
+		Size tupsize = MAXALIGN(IndexTupleSize(tuples[i])) + sizeof(ItemIdData);
+
+		if (size + tupsize > RumListPageSize)
+		{
+			/* The current page is full, continue on a new one */
+			Buffer nextBuffer = RumNewBuffer(index);
+
+			writeListPage(index, curBuffer, tuples + startTuple, i - startTuple,
+						  BufferGetBlockNumber(nextBuffer), false);
+
+			curBuffer = nextBuffer;
+			sublist->nPendingPages++;
+			startTuple = i;
+			size = 0;
+		}
+
+		size += tupsize;
+	}
+
+	sublist->tail = BufferGetBlockNumber(curBuffer);
+	sublist->tailFreeSize = writeListPage(index, curBuffer, tuples + startTuple,
+										  ntuples - startTuple, InvalidBlockNumber,
+										  true);
+}
+
+
+/*
+ * Append the tuples collected for one heap row to the pending list.
+ *
+ * Tuples go onto the tail page if they all fit there; otherwise a new
+ * sublist is built and linked after the tail, so the entries of a heap row
+ * never straddle the boundary between two appends.
+ */
+void
+rumHeapTupleFastInsert(RumState *rumstate, RumTupleCollector *collector)
+{
+	Relation index = rumstate->index;
+	Buffer metabuffer;
+	Buffer buffer = InvalidBuffer;
+	Page metapage;
+	Page page;
+	RumMetaPageData *metadata;
+	GenericXLogState *state;
+	RumPendingSublist sublist;
+	Size totalSize;
+	bool separateList = false;
+	bool needCleanup;
+	uint32 i;
+
+	if (collector->ntuples == 0)
+	{
+		return;
+	}
+
+	/*
+	 * The pending list is not organized by key, so serializable scans take a
+	 * predicate lock on the metapage to cover it.
+	 */
+	CheckForSerializableConflictIn(index, NULL, RUM_METAPAGE_BLKNO);
+
+	totalSize = collector->sumsize + collector->ntuples * sizeof(ItemIdData);
+
+	metabuffer = ReadBuffer(index, RUM_METAPAGE_BLKNO);
+
+	if (totalSize > RumListPageSize)
+	{
+		/* Won't fit on a single page, so it needs a sublist anyway */
+		separateList = true;
+	}
+	else
+	{
+		LockBuffer(metabuffer, RUM_EXCLUSIVE);
+		metadata = RumPageGetMeta(BufferGetPage(metabuffer));
+
+		if (metadata->head == InvalidBlockNumber ||
+			totalSize > metadata->tailFreeSize)
+		{
+			/*
+			 * Empty list or no room on the tail: build a sublist without
+			 * holding the metapage lock to keep concurrent inserts going.
+			 */
+			separateList = true;
+			LockBuffer(metabuffer, RUM_UNLOCK);
+		}
+	}
+
+	if (separateList)
+	{
+		makeSublist(index, collector->tuples, collector->ntuples, &sublist);
+
+		LockBuffer(metabuffer, RUM_EXCLUSIVE);
+		metadata = RumPageGetMeta(BufferGetPage(metabuffer));
+
+		if (metadata->head != InvalidBlockNumber)
+		{
+			buffer = ReadBuffer(index, metadata->tail);
+			LockBuffer(buffer, RUM_EXCLUSIVE);
+		}
+
+		state = GenericXLogStart(index);
+		metapage = GenericXLogRegisterBuffer(state, metabuffer, 0);
+		metadata = RumPageGetMeta(metapage);
+
+		if (BufferIsValid(buffer))
+		{
+			/* Link the sublist after the current tail */
+			page = GenericXLogRegisterBuffer(state, buffer, 0);
+			Assert(RumPageRightMost(page));
+			RumPageGetOpaque(page)->rightlink = sublist.head;
+		}
+		else
+		{
+			metadata->head = sublist.head;
+		}
+
+		metadata->tail = sublist.tail;
+		metadata->tailFreeSize = sublist.tailFreeSize;
+		metadata->nPendingPages += sublist.nPendingPages;
+	}
+	else
+	{
+		/* Everything fits on the tail page, metapage is still locked */
+		buffer = ReadBuffer(index, metadata->tail);
+		LockBuffer(buffer, RUM_EXCLUSIVE);
+
+		state = GenericXLogStart(index);
+		metapage = GenericXLogRegisterBuffer(state, metabuffer, 0);
+		metadata = RumPageGetMeta(metapage);
+		page = GenericXLogRegisterBuffer(state, buffer, 0);
+
+		for (i = 0; i < collector->ntuples; i++)
+		{
+			IndexTuple itup = collector->tuples[i];
+
+			if (PageAddItem(page, (Item) itup, IndexTupleSize(itup),
+							InvalidOffsetNumber, false, false) == InvalidOffsetNumber)
+			{
+				elog(ERROR, "failed to add item to index page in \"%s\"",
+					 RelationGetRelationName(index));
+			}
+		}
+
+		metadata->tailFreeSize = PageGetExactFreeSpace(page);
+	}
+
+	GenericXLogFinish(state);
+
+	if (BufferIsValid(buffer))
+	{
+		UnlockReleaseBuffer(buffer);
+	}
+
+	metadata = RumPageGetMeta(BufferGetPage(metabuffer));
+	needCleanup = (int64) metadata->nPendingPages * RumListPageSize >
+				  (int64) RumGetPendingListCleanupSize(index) * 1024L;
+
+	UnlockReleaseBuffer(metabuffer);
+
+	if (needCleanup)
+	{
+		rumInsertCleanup(rumstate, false, NULL);
+	}
+}
+
+
+/*
+ * Load the pending tuples on page between startoff and maxoff into the
+ * accumulator.
+ */
+static void
+processPendingPage(BuildAccumulator *accum, Page page,
+				   OffsetNumber startoff, OffsetNumber maxoff)
+{
+	RumState *rumstate = accum->rumstate;
+	OffsetNumber off;
+
+	for (off = startoff; off <= maxoff; off = OffsetNumberNext(off))
+	{
+		IndexTuple itup = (IndexTuple) PageGetItem(page, PageGetItemId(page, off));
+		OffsetNumber attnum;
+		Datum key;
+		RumNullCategory category;
+		RumItem item;
+
+		attnum = rumtuple_get_attrnum(rumstate, itup);
+		key = rumtuple_get_key(rumstate, itup, &category);
+		rumReadTuple(rumstate, attnum, itup, &item, true);
+
+		rumInsertBAEntries(accum, &item.iptr, attnum, &key,
+						   &item.addInfo, &item.addInfoIsNull, &category, 1);
+	}
+}
+
+
+/*
+ * Remove pending pages from the head of the list up to (not including)
+ * newHead.  The caller holds the metapage exclusively locked and has already
+ * merged the contents of these pages into the main structure.
+ */
+static void
+shiftList(Relation index, Buffer metabuffer, BlockNumber newHead,
+		  IndexBulkDeleteResult *stats)
+{
+	BlockNumber blknoToDelete = RumPageGetMeta(BufferGetPage(metabuffer))->head;
+
+	do
+	{
+		Buffer buffers[RUM_NDELETE_AT_ONCE];
+		GenericXLogState *state;
+		RumMetaPageData *metadata;
+		int ndeleted = 0;
+		int i;
+
+		while (ndeleted < RUM_NDELETE_AT_ONCE && blknoToDelete != newHead)
+		{
+			Page page;
+
+			buffers[ndeleted] = ReadBuffer(index, blknoToDelete);
+			LockBuffer(buffers[ndeleted], RUM_EXCLUSIVE);
+			page = BufferGetPage(buffers[ndeleted]);
+
+			blknoToDelete = RumPageRightLink(page);
+			ndeleted++;
+		}
+
+		if (stats)
+		{
+			stats->pages_deleted += ndeleted;
+		}
+
+		state = GenericXLogStart(index);
+		metadata = RumPageGetMeta(GenericXLogRegisterBuffer(state, metabuffer, 0));
+
+		metadata->head = blknoToDelete;
+		metadata->nPendingPages -= Min(metadata->nPendingPages, ndeleted);
+
+		if (blknoToDelete == InvalidBlockNumber)
+		{
+			metadata->tail = InvalidBlockNumber;
+			metadata->tailFreeSize = 0;
+			metadata->nPendingPages = 0;
+		}
+
+		for (i = 0; i < ndeleted; i++)
+		{
+			Page page = GenericXLogRegisterBuffer(state, buffers[i], 0);
+
+			/* Vacuum recycles the page like any other deleted page */
+			RumPageForceSetDeleted(page);
+			RumPageSetDeleteXid(page, ReadNextTransactionId());
+		}
+
+		GenericXLogFinish(state);
+
+		for (i = 0; i < ndeleted; i++)
+		{
+			UnlockReleaseBuffer(buffers[i]);
+		}
+	} while (blknoToDelete != newHead);
+}
+
+
+/*
+ * Move the tuples of the pending list into the main index structure.
+ *
+ * Only one backend cleans the list at a time, serialized by a heavyweight
+ * lock on the metapage.  A forced cleanup (vacuum, or an index tuple scan)
+ * waits for that lock and empties the whole list, since its caller relies on
+ * every pending entry being merged on return.  Otherwise the cleanup gives
+ * up if another backend is already at it, and stops at the page that was the
+ * tail when it started so busy inserters cannot keep it running forever.
+ *
+ * Entries are merged through a build accumulator, flushed when the end of
+ * the list is reached or memory runs out at a heap tuple boundary.  Pages are
+ * only removed from the list after their contents reached the main
+ * structure, so a concurrent bitmap scan may see an entry twice but never
+ * misses one.
+ */
+void
+rumInsertCleanup(RumState *rumstate, bool forceCleanup,
+				 IndexBulkDeleteResult *stats)
+{
+	Relation index = rumstate->index;
+	Buffer metabuffer;
+	Buffer buffer;
+	Page page;
+	RumMetaPageData *metadata;
+	BuildAccumulator accum;
+	MemoryContext opCtx;
+	MemoryContext oldCtx;
+	BlockNumber blkno;
+	BlockNumber blknoFinish;
+	bool cleanupFinish = false;
+	long workMemory;
+
+	if (forceCleanup)
+	{
+		LockPage(index, RUM_METAPAGE_BLKNO, ExclusiveLock);
+		workMemory = maintenance_work_mem;
+	}
+	else
+	{
+		if (!ConditionalLockPage(index, RUM_METAPAGE_BLKNO, ExclusiveLock))
+		{
+			return;
+		}
+
+		workMemory = work_mem;
+	}
+
+	metabuffer = ReadBuffer(index, RUM_METAPAGE_BLKNO);
+	LockBuffer(metabuffer, RUM_SHARE);
+	metadata = RumPageGetMeta(BufferGetPage(metabuffer));
+
+	if (metadata->head == InvalidBlockNumber)
+	{
+		/* Nothing to do */
+		UnlockReleaseBuffer(metabuffer);
+		UnlockPage(index, RUM_METAPAGE_BLKNO, ExclusiveLock);
+		return;
+	}
+
+	blknoFinish = metadata->tail;
+	blkno = metadata->head;
+
+	buffer = ReadBuffer(index, blkno);
+	LockBuffer(buffer, RUM_SHARE);
+	page = BufferGetPage(buffer);
+
+	LockBuffer(metabuffer, RUM_UNLOCK);
+
+	opCtx = RumContextCreate(CurrentMemoryContext,
+							 "Rum insert cleanup temporary context");
+	oldCtx = MemoryContextSwitchTo(opCtx);
+
+	accum.rumstate = rumstate;
+	rumInitBA(&accum);
+
+	for (;;)
+	{
+		OffsetNumber maxoff;
+
+		Assert(RumPageIsList(page) && !RumPageIsDeleted(page));
+
+		if (blkno == blknoFinish && !forceCleanup)
+		{
+			cleanupFinish = true;
+		}
+
+		maxoff = PageGetMaxOffsetNumber(page);
+		processPendingPage(&accum, page, FirstOffsetNumber, maxoff);
+
+		if (RumPageRightMost(page) ||
+			(RumPageHasFullRow(page) &&
+			 (cleanupFinish || accum.allocatedMemory >= workMemory * 1024L)))
+		{
+			RumItem *items;
+			Datum key;
+			RumNullCategory category;
+			uint32 nlist;
+			OffsetNumber attnum;
+
+			/*
+			 * Take the metapage lock to hold off inserters while the pages
+			 * read so far are merged and removed.  The current page is
+			 * relocked after it, and anything appended to it meanwhile is
+			 * picked up as well.
+			 */
+			LockBuffer(buffer, RUM_UNLOCK);
+			LockBuffer(metabuffer, RUM_EXCLUSIVE);
+			LockBuffer(buffer, RUM_SHARE);
+
+			Assert(!RumPageIsDeleted(page));
+			if (PageGetMaxOffsetNumber(page) != maxoff)
+			{
+				processPendingPage(&accum, page, OffsetNumberNext(maxoff),
+								   PageGetMaxOffsetNumber(page));
+			}
+
+			rumBeginBAScan(&accum);
+			while ((items = rumGetBAEntry(&accum, &attnum, &key, &category,
+										  &nlist)) != NULL)
+			{
+				rumEntryInsert(rumstate, attnum, key, category, items, nlist,
+							   NULL);
+			}
+
+			/* The next page, if any, becomes the head of the list */
+			blkno = RumPageRightLink(page);
+			UnlockReleaseBuffer(buffer);
+
+			shiftList(index, metabuffer, blkno, stats);
+			LockBuffer(metabuffer, RUM_UNLOCK);
+
+			if (blkno == InvalidBlockNumber || cleanupFinish)
+			{
+				break;
+			}
+
+			MemoryContextReset(opCtx);
+			rumInitBA(&accum);
+		}
+		else
+		{
+			blkno = RumPageRightLink(page);
+			UnlockReleaseBuffer(buffer);
+		}
+
+		RumVacuumDelayPointCompat();
+
+		buffer = ReadBuffer(index, blkno);
+		LockBuffer(buffer, RUM_SHARE);
+		page = BufferGetPage(buffer);
+	}
+
+	ReleaseBuffer(metabuffer);
+	UnlockPage(index, RUM_METAPAGE_BLKNO, ExclusiveLock);
+
+	MemoryContextSwitchTo(oldCtx);
+	MemoryContextDelete(opCtx);
+}
+
+
+/*
+ * Returns true if the index has entries waiting in its pending list.
+ */
+bool
+rumHasPendingList(Relation index)
+{
+	Buffer metabuffer;
+	bool hasPendingList;
+
+	metabuffer = ReadBuffer(index, RUM_METAPAGE_BLKNO);
+	LockBuffer(metabuffer, RUM_SHARE);
+	hasPendingList =
+		RumPageGetMeta(BufferGetPage(metabuffer))->head != InvalidBlockNumber;
+	UnlockReleaseBuffer(metabuffer);
+
+	return hasPendingList;
+}
@@ -15,6 +15,7 @@
 #include "rumsort.h"
 
 #include "access/relscan.h"
+#include "access/tableam.h"
 #include "storage/predicate.h"
 #include "miscadmin.h"
 #include "utils/builtins.h"
@@ -700,6 +701,280 @@ collectMatchBitmap(RumBtreeData *btree, RumBtreeStack *stack,
 }
 
 
+/*
+ * Whether any of the items in a posting list points to a heap tuple that
+ * is visible to the snapshot.
+ */
+static bool
+postingListHasVisibleTuple(RumState *rumstate, Relation heapRelation,
+						   Snapshot snapshot, OffsetNumber attnum,
+						   Pointer ptr, int nitems)
+{
+	RumItem item;
+
+	MemSet(&item, 0, sizeof(item));
+	ItemPointerSetMin(&item.iptr);
+	for (int i = 0; i < nitems; i++)
+	{
+		bool allDead = false;
+
+		ptr = rumDataPageLeafRead(ptr, attnum, &item, false, rumstate);
+		if (table_index_fetch_tuple_check(heapRelation, &item.iptr, snapshot,
+										  &allDead))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+/*
+ * Whether any of the items of a posting tree points to a heap tuple that
+ * is visible to the snapshot. Walks the leaf pages left to right and stops
+ * at the first visible one.
+ */
+static bool
+postingTreeHasVisibleTuple(RumState *rumstate, Relation heapRelation,
+						   Snapshot snapshot, OffsetNumber attnum,
+						   BlockNumber rootPostingTree)
+{
+	RumPostingTreeScan *gdi;
+	Buffer buffer;
+	bool hasVisibleTuple = false;
+
+	gdi = rumPrepareScanPostingTree(rumstate->index, rootPostingTree, true,
+									ForwardScanDirection, attnum, rumstate);
+	buffer = rumScanBeginPostingTree(gdi, NULL);
+	IncrBufferRefCount(buffer); /* prevent unpin in freeRumBtreeStack */
+	freeRumBtreeStack(gdi->stack);
+	pfree(gdi);
+
+	for (;;)
+	{
+		Page page = BufferGetPage(buffer);
+		OffsetNumber maxoff = RumDataPageMaxOff(page);
+
+		if (RumPageIsNotDeleted(page) && maxoff >= FirstOffsetNumber)
+		{
+			hasVisibleTuple = postingListHasVisibleTuple(rumstate, heapRelation,
+														 snapshot, attnum,
+														 RumDataPageGetData(page),
+														 maxoff);
+		}
+
+		if (hasVisibleTuple || RumPageRightMost(page))
+		{
+			break;
+		}
+
+		buffer = rumStep(buffer, rumstate->index, RUM_SHARE, ForwardScanDirection);
+	}
+
+	UnlockReleaseBuffer(buffer);
+	return hasVisibleTuple;
+}
+
+
+/*
+ * Walks the keys of the given attribute in the entry tree in order and
+ * hands each one that still has a tuple visible to the snapshot to the
+ * callback. Since every key is stored once in the entry tree, the work
+ * done is proportional to the number of distinct keys and not the number
+ * of heap tuples, apart from skipping over dead items.
+ *
+ * Heap visibility is checked with the entry page share locked, the same
+ * way _bt_check_unique does. The callback runs with that lock held too so
+ * it must not do any I/O. Returns false if the index can't be enumerated right now
+ * (there are pending list entries that aren't in the entry tree yet).
+ */
+bool
+rumEnumerateDistinctEntries(Relation index, Relation heapRelation,
+							Snapshot snapshot, OffsetNumber attnum,
+							RumDistinctEntryCallback callback,
+							void *callbackState)
+{
+	RumState rumstate;
+	RumBtreeData btreeEntry;
+	RumBtreeStack *stackEntry;
+	Form_pg_attribute attr;
+
+	/*
+	 * Where to (re)start from: RUM_CAT_EMPTY_QUERY positions the stack on
+	 * the leftmost key of attnum. On a restart this is the last key already
+	 * handed to the callback, which is skipped.
+	 */
+	Datum startKey = (Datum) 0;
+	RumNullCategory startCategory = RUM_CAT_EMPTY_QUERY;
+	bool skipStartKey = false;
+
+	if (rumHasPendingList(index))
+	{
+		return false;
+	}
+
+	initRumState(&rumstate, index);
+	attr = RumTupleDescAttr(rumstate.origTupdesc, attnum - 1);
+
+	PredicateLockRelation(index, snapshot);
+
+restartEnumeration:
+	rumPrepareEntryScan(&btreeEntry, attnum, startKey, startCategory, &rumstate);
+	btreeEntry.searchMode = true;
+	stackEntry = rumFindLeafPage(&btreeEntry, NULL);
+	btreeEntry.findItem(&btreeEntry, stackEntry);
+
+	for (;;)
+	{
+		Page page;
+		ItemId itemId;
+		IndexTuple itup;
+		Datum idatum;
+		RumNullCategory icategory;
+		bool hasVisibleTuple;
+		bool isKeyCopied = false;
+
+		CHECK_FOR_INTERRUPTS();
+
+		if (!moveRightIfItNeeded(&btreeEntry, stackEntry))
+		{
+			break;
+		}
+
+		page = BufferGetPage(stackEntry->buffer);
+		itemId = PageGetItemId(page, stackEntry->off);
+		itup = (IndexTuple) PageGetItem(page, itemId);
+
+		if (rumtuple_get_attrnum(&rumstate, itup) != attnum)
+		{
+			break;
+		}
+
+		/* Entries whose items are all known dead are skipped outright */
+		bool ignoreKilledTuples = true;
+		if (IsEntryDeadForKilledTuple(ignoreKilledTuples, itemId))
+		{
+			stackEntry->off++;
+			continue;
+		}
+
+		idatum = rumtuple_get_key(&rumstate, itup, &icategory);
+
+		/* Null keys and placeholders sort after all the normal keys */
+		if (icategory != RUM_CAT_NORM_KEY)
+		{
+			break;
+		}
+
+		if (skipStartKey)
+		{
+			skipStartKey = false;
+			if (rumCompareEntries(&rumstate, attnum, idatum, icategory,
+								  startKey, startCategory) == 0)
+			{
+				stackEntry->off++;
+				continue;
+			}
+		}
+
+		if (RumIsPostingTree(itup))
+		{
+			BlockNumber rootPostingTree = RumGetPostingTree(itup);
+
+			/*
+			 * As in collectMatchBitmap, release the entry page while walking
+			 * the posting tree and re-find the key afterwards.
+			 */
+			idatum = datumCopy(idatum, attr->attbyval, attr->attlen);
+			isKeyCopied = !attr->attbyval;
+			LockBuffer(stackEntry->buffer, RUM_UNLOCK);
+
+			hasVisibleTuple = postingTreeHasVisibleTuple(&rumstate, heapRelation,
+														 snapshot, attnum,
+														 rootPostingTree);
+
+			LockBuffer(stackEntry->buffer, RUM_SHARE);
+			page = BufferGetPage(stackEntry->buffer);
+			if (!RumPageIsLeaf(page) || RumInjectDistinctEntryRestart)
+			{
+				/*
+				 * The root became an internal page while it was unlocked
+				 * (or the test GUC injects that). Finish with this key and
+				 * descend again from the root to continue right after it.
+				 */
+				LockBuffer(stackEntry->buffer, RUM_UNLOCK);
+				freeRumBtreeStack(stackEntry);
+
+				if (hasVisibleTuple && !callback(idatum, callbackState))
+				{
+					return true;
+				}
+
+				startKey = idatum;
+				startCategory = icategory;
+				skipStartKey = true;
+				goto restartEnumeration;
+			}
+
+			for (;;)
+			{
+				Datum newDatum;
+				RumNullCategory newCategory;
+
+				if (!moveRightIfItNeeded(&btreeEntry, stackEntry))
+				{
+					elog(ERROR, "lost saved point in index");
+				}
+
+				page = BufferGetPage(stackEntry->buffer);
+				itup = (IndexTuple) PageGetItem(page,
+												PageGetItemId(page, stackEntry->off));
+				if (rumtuple_get_attrnum(&rumstate, itup) != attnum)
+				{
+					elog(ERROR, "lost saved point in index");
+				}
+
+				newDatum = rumtuple_get_key(&rumstate, itup, &newCategory);
+				if (rumCompareEntries(&rumstate, attnum, newDatum, newCategory,
+									  idatum, icategory) == 0)
+				{
+					break;
+				}
+
+				stackEntry->off++;
+			}
+		}
+		else
+		{
+			hasVisibleTuple = postingListHasVisibleTuple(&rumstate, heapRelation,
+														 snapshot, attnum,
+														 RumGetPosting(itup),
+														 RumGetNPosting(itup));
+		}
+
+		bool continueEnumeration = !hasVisibleTuple ||
+								   callback(idatum, callbackState);
+
+		if (isKeyCopied)
+		{
+			pfree(DatumGetPointer(idatum));
+		}
+
+		if (!continueEnumeration)
+		{
+			break;
+		}
+
+		stackEntry->off++;
+	}
+
+	LockBuffer(stackEntry->buffer, RUM_UNLOCK);
+	freeRumBtreeStack(stackEntry);
+	return true;
+}
+
+
 /*
  * set right position in entry->list accordingly to markAddInfo.
  * returns true if there is not such position.
@@ -1892,14 +2167,8 @@ startScan(IndexScanDesc scan)
 		scanType = RumOrderedScan;
 		startOrderedScanEntries(scan, rumstate, so);
 	}
-	else if (scan->xs_want_itup)
+	else if (scan->xs_want_itup && isSupportedOrderedScan)
 	{
-		if (!isSupportedOrderedScan)
-		{
-			ereport(ERROR, (errmsg(
-								"Unexpected index only scan when ordered scan is not supported.")));
-		}
-
 		/* If we want to return index tuples, we can use ordered scan */
 		scanType = RumOrderedScan;
 		startOrderedScanEntries(scan, rumstate, so);
@@ -1916,8 +2185,14 @@ startScan(IndexScanDesc scan)
 	}
 	else if (so->norderbys == 0 && !so->willSort && !rumstate->useAlternativeOrder)
 	{
+		/* Index only scans without ordering get their tuple in setUnorderedIndexOnlyTuple */
 		startScanEntryExtended(scan, rumstate, so);
 	}
+	else if (scan->xs_want_itup)
+	{
+		ereport(ERROR, (errmsg(
+							"Unexpected index only scan when ordered scan is not supported.")));
+	}
 	else
 	{
 		for (i = 0; i < so->totalentries; i++)
@@ -3016,6 +3291,15 @@ scanGetItemRegular(IndexScanDesc scan, RumItem *advancePast,
 
 	/* Start by assuming we want to begin the scan at advancePast */
 	RumItemSetInvalid(&myIntermediatePast);
+
+	/* A parallel worker may skip whole heap ranges owned by other workers:
+	 * seek the posting trees there instead of stepping through the items.
+	 */
+	if (so->isParallelEnabled && ItemPointerIsValid(&advancePast->iptr))
+	{
+		myIntermediatePast = *advancePast;
+	}
+
 	for (;;)
 	{
 		/*
@@ -3208,6 +3492,55 @@ scanGetItemRegular(IndexScanDesc scan, RumItem *advancePast,
 }
 
 
+/*
+ * Get next heap item pointer (after advancePast) of a regular scan shared
+ * with parallel workers. The heap is handed out in block ranges through the
+ * shared scan descriptor, and only the items of the ranges claimed by this
+ * worker are returned.
+ */
+static bool
+scanGetItemRegularParallel(IndexScanDesc scan, RumItem *advancePast,
+						   RumItem *item, bool *recheck)
+{
+	RumScanOpaque so = (RumScanOpaque) scan->opaque;
+	RumItem myAdvancePast = *advancePast;
+
+	for (;;)
+	{
+		BlockNumber itemBlock;
+
+		CHECK_FOR_INTERRUPTS();
+		if (!scanGetItemRegular(scan, &myAdvancePast, item, recheck))
+		{
+			return false;
+		}
+
+		/* Items come in heap order: claim ranges until one can hold the item */
+		itemBlock = ItemPointerGetBlockNumber(&item->iptr);
+		while (so->parallelRangeEnd != InvalidBlockNumber &&
+			   itemBlock >= so->parallelRangeEnd)
+		{
+			if (!rum_parallel_claim_heap_range(scan->parallel_scan,
+											   &so->parallelRangeStart,
+											   &so->parallelRangeEnd))
+			{
+				return false;
+			}
+		}
+
+		if (itemBlock >= so->parallelRangeStart)
+		{
+			return true;
+		}
+
+		/* The item belongs to another worker, move past its range */
+		RumItemSetInvalid(&myAdvancePast);
+		ItemPointerSet(&myAdvancePast.iptr, so->parallelRangeStart - 1,
+					   MaxOffsetNumber);
+	}
+}
+
+
 /*
  * Finds part of page containing requested item using small index at the end
  * of page.
@@ -4333,6 +4666,10 @@ scanGetItem(IndexScanDesc scan, RumItem *advancePast,
 	{
 		return scanGetItemOrdered(scan, advancePast, item, recheck, recheckOrderby);
 	}
+	else if (so->isParallelEnabled)
+	{
+		return scanGetItemRegularParallel(scan, advancePast, item, recheck);
+	}
 	else
 	{
 		return scanGetItemRegular(scan, advancePast, item, recheck);
@@ -4340,6 +4677,419 @@ scanGetItem(IndexScanDesc scan, RumItem *advancePast,
 }
 
 
+/* A pending list tuple matching one entry of a scan key */
+typedef struct RumPendingMatch
+{
+	ItemPointerData iptr;
+	uint32 keyIndex;
+	uint32 entryIndex;
+	Datum addInfo;
+	bool addInfoIsNull;
+} RumPendingMatch;
+
+
+static int
+pendingMatchCmp(const void *a, const void *b)
+{
+	return rumCompareItemPointers(&((const RumPendingMatch *) a)->iptr,
+								  &((const RumPendingMatch *) b)->iptr);
+}
+
+
+/*
+ * Checks whether a key read from the pending list satisfies the search
+ * condition of a scan entry (the same conditions collectMatchBitmap and
+ * the entry tree descent apply).
+ */
+static bool
+pendingKeyMatchesEntry(RumState *rumstate, RumScanEntry entry,
+					   Datum key, RumNullCategory category)
+{
+	if (entry->isPartialMatch)
+	{
+		/* Partial matches never match nulls (nor do null queries) */
+		if (entry->queryCategory != RUM_CAT_NORM_KEY ||
+			category != RUM_CAT_NORM_KEY)
+		{
+			return false;
+		}
+
+		return DatumGetInt32(FunctionCall4Coll(
+								 &rumstate->comparePartialFn[entry->attnumOrig - 1],
+								 rumstate->supportCollation[entry->attnumOrig - 1],
+								 entry->queryKey,
+								 key,
+								 UInt16GetDatum(entry->strategy),
+								 PointerGetDatum(entry->extra_data))) == 0;
+	}
+
+	if (entry->queryCategory == RUM_CAT_EMPTY_QUERY)
+	{
+		/* Full scan entries match everything but null items in ALL mode */
+		return entry->searchMode != GIN_SEARCH_MODE_ALL ||
+			   category != RUM_CAT_NULL_ITEM;
+	}
+
+	return rumCompareEntries(rumstate, entry->attnumOrig,
+							 entry->queryKey, entry->queryCategory,
+							 key, category) == 0;
+}
+
+
+/*
+ * Collects the TIDs in the pending list (see rumfast.c) that satisfy the scan
+ * keys: into the bitmap if one is given, otherwise into so->pendingItems in
+ * TID order for rumgettuple.
+ *
+ * The pending list is in insertion order, so every tuple on it is tested
+ * against every scan entry; the matches are then grouped by heap TID to run
+ * the consistent functions.  This must run before the main index scan: a
+ * cleanup removes pending pages only after their entries reached the main
+ * structure, and pages are walked with coupled locks from the head, so an
+ * entry moved concurrently is seen on one side or the other.
+ */
+static int64
+scanPendingInsert(IndexScanDesc scan, TIDBitmap *tbm)
+{
+	RumScanOpaque so = (RumScanOpaque) scan->opaque;
+	RumState *rumstate = &so->rumstate;
+	Relation index = scan->indexRelation;
+	MemoryContext oldCtx;
+	Buffer metabuffer;
+	Buffer buffer;
+	BlockNumber blkno;
+	RumPendingMatch *matches;
+	uint32 nmatches = 0;
+	uint32 maxmatches = 64;
+	uint32 i,
+		   start;
+	int64 ntids = 0;
+
+	metabuffer = ReadBuffer(index, RUM_METAPAGE_BLKNO);
+	LockBuffer(metabuffer, RUM_SHARE);
+	blkno = RumPageGetMeta(BufferGetPage(metabuffer))->head;
+
+	/* Inserts into the pending list check for conflicts on the metapage */
+	PredicateLockPage(index, RUM_METAPAGE_BLKNO, scan->xs_snapshot);
+
+	if (blkno == InvalidBlockNumber)
+	{
+		UnlockReleaseBuffer(metabuffer);
+		return 0;
+	}
+
+	buffer = ReadBuffer(index, blkno);
+	LockBuffer(buffer, RUM_SHARE);
+	UnlockReleaseBuffer(metabuffer);
+
+	oldCtx = MemoryContextSwitchTo(so->tempCtx);
+	matches = palloc(sizeof(RumPendingMatch) * maxmatches);
+
+	for (;;)
+	{
+		Page page = BufferGetPage(buffer);
+		OffsetNumber off,
+					 maxoff = PageGetMaxOffsetNumber(page);
+
+		for (off = FirstOffsetNumber; off <= maxoff; off = OffsetNumberNext(off))
+		{
+			IndexTuple itup = (IndexTuple) PageGetItem(page, PageGetItemId(page, off));
+			OffsetNumber attnum = rumtuple_get_attrnum(rumstate, itup);
+			RumNullCategory icategory;
+			Datum idatum = rumtuple_get_key(rumstate, itup, &icategory);
+			bool itemRead = false;
+			RumItem item;
+			uint32 keyIndex,
+				   entryIndex;
+
+			for (keyIndex = 0; keyIndex < so->nkeys; keyIndex++)
+			{
+				RumScanKey key = so->keys[keyIndex];
+
+				if (key->orderBy)
+				{
+					continue;
+				}
+
+				for (entryIndex = 0; entryIndex < key->nentries; entryIndex++)
+				{
+					RumScanEntry entry = key->scanEntry[entryIndex];
+
+					if (entry->attnumOrig != attnum ||
+						!pendingKeyMatchesEntry(rumstate, entry, idatum, icategory))
+					{
+						continue;
+					}
+
+					if (!itemRead)
+					{
+						rumReadTuple(rumstate, attnum, itup, &item, true);
+						itemRead = true;
+					}
+
+					if (nmatches >= maxmatches)
+					{
+						maxmatches *= 2;
+						matches = repalloc(matches,
+										   sizeof(RumPendingMatch) * maxmatches);
+					}
+
+					matches[nmatches].iptr = item.iptr;
+					matches[nmatches].keyIndex = keyIndex;
+					matches[nmatches].entryIndex = entryIndex;
+					matches[nmatches].addInfo = item.addInfo;
+					matches[nmatches].addInfoIsNull = item.addInfoIsNull;
+					nmatches++;
+				}
+			}
+		}
+
+		blkno = RumPageRightLink(page);
+		if (blkno == InvalidBlockNumber)
+		{
+			UnlockReleaseBuffer(buffer);
+			break;
+		}
+		else
+		{
+			/* Lock the next page before letting go of the current one */
+			Buffer nextBuffer = ReadBuffer(index, blkno);
+
+			LockBuffer(nextBuffer, RUM_SHARE);
+			UnlockReleaseBuffer(buffer);
+			buffer = nextBuffer;
+		}
+	}
+
+	if (nmatches > 1)
+	{
+		qsort(matches, nmatches, sizeof(RumPendingMatch), pendingMatchCmp);
+	}
+
+	if (tbm == NULL && nmatches > 0)
+	{
+		so->pendingItems = MemoryContextAlloc(so->keyCtx,
+											  sizeof(ItemPointerData) * nmatches);
+	}
+
+	for (start = 0; start < nmatches; start = i)
+	{
+		bool match = true;
+		uint32 keyIndex;
+
+		for (keyIndex = 0; keyIndex < so->nkeys; keyIndex++)
+		{
+			RumScanKey key = so->keys[keyIndex];
+			uint32 j;
+
+			if (key->orderBy)
+			{
+				continue;
+			}
+
+			for (j = 0; j < key->nentries; j++)
+			{
+				key->entryRes[j] = false;
+				key->addInfo[j] = (Datum) 0;
+				key->addInfoIsNull[j] = true;
+			}
+		}
+
+		for (i = start; i < nmatches &&
+			 rumCompareItemPointers(&matches[i].iptr, &matches[start].iptr) == 0;
+			 i++)
+		{
+			RumScanKey key = so->keys[matches[i].keyIndex];
+
+			key->entryRes[matches[i].entryIndex] = true;
+			key->addInfo[matches[i].entryIndex] = matches[i].addInfo;
+			key->addInfoIsNull[matches[i].entryIndex] = matches[i].addInfoIsNull;
+		}
+
+		for (keyIndex = 0; match && keyIndex < so->nkeys; keyIndex++)
+		{
+			if (so->keys[keyIndex]->orderBy)
+			{
+				continue;
+			}
+
+			match = callConsistentFn(rumstate, so->keys[keyIndex]);
+		}
+
+		if (!match)
+		{
+			continue;
+		}
+
+		if (tbm != NULL)
+		{
+			/* Pending list items are always rechecked */
+			tbm_add_tuples(tbm, &matches[start].iptr, 1, true);
+		}
+		else
+		{
+			so->pendingItems[ntids] = matches[start].iptr;
+		}
+
+		ntids++;
+	}
+
+	MemoryContextSwitchTo(oldCtx);
+	MemoryContextReset(so->tempCtx);
+
+	if (tbm == NULL)
+	{
+		so->nPendingItems = (uint32) ntids;
+	}
+
+	return ntids;
+}
+
+
+/*
+ * Whether an item of the main structure was already returned from the
+ * pending list (a cleanup may move it over while the scan runs).
+ */
+static inline bool
+isReturnedPendingItem(RumScanOpaque so, ItemPointer iptr)
+{
+	if (so->nPendingItems == 0)
+	{
+		return false;
+	}
+
+	return bsearch(iptr, so->pendingItems, so->nPendingItems,
+				   sizeof(ItemPointerData), KillItemPointerSortComparer) != NULL;
+}
+
+
+/* Number of item pointers handed to the TIDBitmap at a time */
+#define RUM_BITMAP_UNION_BATCH_SIZE 256
+
+/*
+ * Whether a bitmap scan can add the items of every entry to the bitmap on
+ * their own, instead of merging all the entries item by item. This holds
+ * for a single key that matches the items of any of its entries (like $in
+ * on many values), which is checked by calling the consistent function with
+ * one entry matching at a time. As in GIN, the consistent function is
+ * expected to be monotone. Sets *recheck if any of the entries needs it.
+ */
+static bool
+isBitmapEntryUnionScan(RumScanOpaque so, bool *recheck)
+{
+	RumState *rumstate = &so->rumstate;
+	RumScanKey key;
+	MemoryContext oldCtx;
+	uint32 i, j;
+	bool isUnion = true;
+
+	if (!RumEnableBitmapEntryUnion || so->nkeys != 1 ||
+		so->scanType != RumRegularScan)
+	{
+		return false;
+	}
+
+	key = so->keys[0];
+	if (key->orderBy || key->nentries < 2 ||
+		key->searchMode != GIN_SEARCH_MODE_DEFAULT ||
+		rumstate->addAttrs[key->attnum - 1] != NULL)
+	{
+		return false;
+	}
+
+	*recheck = false;
+	oldCtx = MemoryContextSwitchTo(so->tempCtx);
+	for (i = 0; i < key->nentries && isUnion; i++)
+	{
+		for (j = 0; j < key->nentries; j++)
+		{
+			key->entryRes[j] = (i == j);
+			key->addInfo[j] = (Datum) 0;
+			key->addInfoIsNull[j] = true;
+		}
+
+		isUnion = callConsistentFn(rumstate, key);
+		*recheck = *recheck || key->recheckCurItem;
+	}
+	MemoryContextSwitchTo(oldCtx);
+	MemoryContextReset(so->tempCtx);
+
+	return isUnion;
+}
+
+
+/*
+ * Adds the items of every entry of the key to the bitmap, which takes care
+ * of the union across entries. Returns the number of items added.
+ */
+static int64
+addKeyEntriesToBitmap(IndexScanDesc scan, RumScanKey key, TIDBitmap *tbm,
+					  bool recheck)
+{
+	RumScanOpaque so = (RumScanOpaque) scan->opaque;
+	ItemPointerData items[RUM_BITMAP_UNION_BATCH_SIZE];
+	int nitems = 0;
+	int64 ntids = 0;
+	uint32 i;
+
+	for (i = 0; i < key->nentries; i++)
+	{
+		RumScanEntry entry = key->scanEntry[i];
+
+		while (!entry->isFinished)
+		{
+			entryGetItem(&so->rumstate, entry, NULL, scan->xs_snapshot, NULL, so);
+			if (entry->isFinished)
+			{
+				break;
+			}
+
+			items[nitems++] = entry->curItem.iptr;
+			if (nitems == RUM_BITMAP_UNION_BATCH_SIZE)
+			{
+				CHECK_FOR_INTERRUPTS();
+				tbm_add_tuples(tbm, items, nitems, recheck);
+				ntids += nitems;
+				nitems = 0;
+			}
+		}
+	}
+
+	if (nitems > 0)
+	{
+		tbm_add_tuples(tbm, items, nitems, recheck);
+		ntids += nitems;
+	}
+
+	return ntids;
+}
+
+
+/*
+ * Reads the pending list ahead of a tuple scan.  Its matches are returned
+ * before the items of the main structure, which then skips them.  That only
+ * works when the caller needs neither index order nor the index tuple, so
+ * the planner does not offer ordered or index only scans on an index that
+ * can have a pending list (see documentdb_rum_get_pending_list_status).
+ */
+static void
+scanPendingItems(IndexScanDesc scan)
+{
+	RumScanOpaque so = (RumScanOpaque) scan->opaque;
+
+	if (scanPendingInsert(scan, NULL) > 0 &&
+		(so->norderbys > 0 || scan->xs_want_itup))
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("cannot run an ordered or index only scan on index \"%s\" "
+						"while its pending list has matching entries",
+						RelationGetRelationName(scan->indexRelation)),
+				 errhint("Vacuum the table to merge the pending list.")));
+	}
+}
+
+
 #define RumIsNewKey(s) (((RumScanOpaque) scan->opaque)->keys == NULL)
 #define RumIsVoidRes(s) (((RumScanOpaque) scan->opaque)->isVoidRes)
 
@@ -4364,7 +5114,12 @@ rumgetbitmap(IndexScanDesc scan, TIDBitmap *tbm)
 		return 0;
 	}
 
-	ntids = 0;
+	/*
+	 * First, scan the pending list and collect any matching entries into the
+	 * bitmap.  This must happen before the main index scan (see
+	 * scanPendingInsert).
+	 */
+	ntids = scanPendingInsert(scan, tbm);
 
 	so->entriesIncrIndex = -1;
 
@@ -4373,6 +5128,12 @@ rumgetbitmap(IndexScanDesc scan, TIDBitmap *tbm)
 	 */
 	startScan(scan);
 
+	so->isBitmapEntryUnion = isBitmapEntryUnionScan(so, &recheck);
+	if (so->isBitmapEntryUnion)
+	{
+		return ntids + addKeyEntriesToBitmap(scan, so->keys[0], tbm, recheck);
+	}
+
 	ItemPointerSetInvalid(&item.iptr);
 
 	for (;;)
@@ -4602,6 +5363,40 @@ reverseScan(IndexScanDesc scan)
 }
 
 
+/*
+ * documentdb: Sets the tuple returned by an index only scan that is not an
+ * ordered scan. Such scans can't project their terms back into a document,
+ * so they are only planned when the executor doesn't need any index column
+ * (e.g. counts) and the index has no truncated terms or arrays along its
+ * path, so no match needs a recheck. The executor would recheck the quals
+ * against the all-null tuple returned here, so a recheck is an error.
+ */
+static void
+setUnorderedIndexOnlyTuple(IndexScanDesc scan, RumScanOpaque so)
+{
+	RumProjectIndexTupleData *projectData = so->projectIndexTupleData;
+
+	if (scan->xs_recheck)
+	{
+		ereport(ERROR, (errmsg(
+							"Unexpected recheck in an index only scan that is not ordered.")));
+	}
+
+	if (projectData->iscan_tuple == NULL)
+	{
+		Datum values[INDEX_MAX_KEYS] = { 0 };
+		bool isnull[INDEX_MAX_KEYS];
+
+		memset(isnull, true, sizeof(isnull));
+		projectData->iscan_tuple = IndexBuildTupleDynamic(projectData->indexTupleDesc,
+														  values, isnull, NULL,
+														  so->keyCtx);
+	}
+
+	scan->xs_itup = projectData->iscan_tuple;
+}
+
+
 bool
 rumgettuple(IndexScanDesc scan, ScanDirection direction)
 {
@@ -4653,6 +5448,9 @@ rumgettuple(IndexScanDesc scan, ScanDirection direction)
 			bool isScanParallelValid = rum_parallel_scan_start(scan, &runStartScan);
 			if (runStartScan)
 			{
+				/* Matches in the pending list keep the scan on this thread
+				 * (see rum_parallel_scan_start_notify) */
+				scanPendingItems(scan);
 				startScan(scan);
 				so->isParallelEnabled = rum_parallel_scan_start_notify(scan);
 			}
@@ -4671,6 +5469,7 @@ rumgettuple(IndexScanDesc scan, ScanDirection direction)
 		}
 		else
 		{
+			scanPendingItems(scan);
 			startScan(scan);
 		}
 
@@ -4698,6 +5497,23 @@ rumgettuple(IndexScanDesc scan, ScanDirection direction)
 		}
 	}
 
+	if (so->returnedPendingItem)
+	{
+		/* The prior tuple came from the pending list, not from so->item */
+		scan->kill_prior_tuple = false;
+		so->returnedPendingItem = false;
+	}
+
+	if (so->pendingItemsReturned < so->nPendingItems)
+	{
+		/* Pending list items go first, see scanPendingItems */
+		SET_SCAN_TID(scan, so->pendingItems[so->pendingItemsReturned++]);
+		scan->xs_recheck = true;
+		scan->xs_recheckorderby = false;
+		so->returnedPendingItem = true;
+		return true;
+	}
+
 	if (so->useSimpleScan)
 	{
 		if (scan->kill_prior_tuple && RumEnableSupportDeadIndexItems)
@@ -4717,15 +5533,27 @@ rumgettuple(IndexScanDesc scan, ScanDirection direction)
 			}
 		}
 
-		if (scanGetItem(scan, &so->item, &so->item, &recheck, &recheckOrderby))
+		while (scanGetItem(scan, &so->item, &so->item, &recheck, &recheckOrderby))
 		{
+			if (isReturnedPendingItem(so, &so->item.iptr))
+			{
+				continue;
+			}
+
 			SET_SCAN_TID(scan, so->item.iptr);
 			scan->xs_recheck = recheck;
 			scan->xs_recheckorderby = recheckOrderby;
 
 			if (scan->xs_want_itup && so->projectIndexTupleData)
 			{
-				scan->xs_itup = so->projectIndexTupleData->iscan_tuple;
+				if (so->scanType == RumOrderedScan)
+				{
+					scan->xs_itup = so->projectIndexTupleData->iscan_tuple;
+				}
+				else
+				{
+					setUnorderedIndexOnlyTuple(scan, so);
+				}
 			}
 
 			return true;
@@ -4736,15 +5564,21 @@ rumgettuple(IndexScanDesc scan, ScanDirection direction)
 
 	if (so->naturalOrder != NoMovementScanDirection)
 	{
-		if (scanGetItem(scan, &so->item, &so->item, &recheck, &recheckOrderby))
+		while (scanGetItem(scan, &so->item, &so->item, &recheck, &recheckOrderby))
 		{
+			if (isReturnedPendingItem(so, &so->item.iptr))
+			{
+				continue;
+			}
+
 			SET_SCAN_TID(scan, so->item.iptr);
 			scan->xs_recheck = recheck;
 			scan->xs_recheckorderby = recheckOrderby;
 
 			return true;
 		}
-		else if (so->secondPass == false)
+
+		if (so->secondPass == false)
 		{
 			reverseScan(scan);
 			so->secondPass = true;
@@ -4760,7 +5594,8 @@ rumgettuple(IndexScanDesc scan, ScanDirection direction)
 		uint32 i,
 			   j = 0;
 
-		if (rumCompareItemPointers(&GET_SCAN_TID(scan), &item->iptr) == 0)
+		if (rumCompareItemPointers(&GET_SCAN_TID(scan), &item->iptr) == 0 ||
+			isReturnedPendingItem(so, &item->iptr))
 		{
 			if (should_free)
 			{
@@ -2535,6 +2535,87 @@ rumHeapTupleInsert(RumState *rumstate, OffsetNumber attnum,
 }
 
 
+/*
+ * Extract index entries for a single indexable item and form pending list
+ * tuples for them, to be appended to the pending list by
+ * rumHeapTupleFastInsert (fast-update insertion).
+ */
+void
+rumHeapTupleFastCollect(RumState *rumstate, RumTupleCollector *collector,
+						OffsetNumber attnum, Datum value, bool isNull,
+						ItemPointer ht_ctid, Datum outerAddInfo,
+						bool outerAddInfoIsNull)
+{
+	Datum *entries;
+	RumNullCategory *categories;
+	int32 i,
+		  nentries;
+	Datum *addInfo;
+	bool *addInfoIsNull;
+
+	entries = rumExtractEntries(rumstate, attnum, value, isNull,
+								&nentries, &categories, &addInfo, &addInfoIsNull);
+
+	if (attnum == rumstate->attrnAddToColumn)
+	{
+		addInfo = palloc(sizeof(*addInfo) * nentries);
+		addInfoIsNull = palloc(sizeof(*addInfoIsNull) * nentries);
+
+		for (i = 0; i < nentries; i++)
+		{
+			addInfo[i] = outerAddInfo;
+			addInfoIsNull[i] = outerAddInfoIsNull;
+		}
+	}
+
+	/* Allocate/reallocate memory for storing collected tuples */
+	if (collector->tuples == NULL)
+	{
+		collector->lentuples = Max(16, nentries);
+		collector->tuples = (IndexTuple *) palloc(sizeof(IndexTuple) *
+												  collector->lentuples);
+	}
+	else if (collector->lentuples < collector->ntuples + nentries)
+	{
+		collector->lentuples = Max(collector->lentuples * 2,
+								   collector->ntuples + nentries);
+		collector->tuples = (IndexTuple *) repalloc(collector->tuples,
+													sizeof(IndexTuple) *
+													collector->lentuples);
+	}
+
+	/*
+	 * Each pending list tuple is a leaf tuple with a single item posting
+	 * list, so that the additional information travels with the TID.
+	 */
+	for (i = 0; i < nentries; i++)
+	{
+		RumItem insert_item;
+		IndexTuple itup;
+
+		/* Check existance of additional information attribute in index */
+		if (!addInfoIsNull[i] && !rumstate->addAttrs[attnum - 1])
+		{
+			Form_pg_attribute attr = RumTupleDescAttr(rumstate->origTupdesc,
+													  attnum - 1);
+
+			elog(ERROR, "additional information attribute \"%s\" is not found in index",
+				 NameStr(attr->attname));
+		}
+
+		memset(&insert_item, 0, sizeof(insert_item));
+		insert_item.iptr = *ht_ctid;
+		insert_item.addInfo = addInfo[i];
+		insert_item.addInfoIsNull = addInfoIsNull[i];
+
+		itup = RumFormTuple(rumstate, attnum, entries[i], categories[i],
+							&insert_item, 1, true);
+		collector->tuples[collector->ntuples++] = itup;
+		collector->sumsize += IndexTupleSize(itup);
+	}
+}
+
+
 bool
 ruminsert(Relation index, Datum *values, bool *isnull,
 		  ItemPointer ht_ctid, Relation heapRel,
@@ -2567,11 +2648,30 @@ ruminsert(Relation index, Datum *values, bool *isnull,
 		outerAddInfoIsNull = isnull[rumstate.attrnAttachColumn - 1];
 	}
 
-	for (i = 0; i < rumstate.origTupdesc->natts; i++)
+	if (RumGetUseFastUpdate(index))
+	{
+		RumTupleCollector collector;
+
+		memset(&collector, 0, sizeof(RumTupleCollector));
+
+		for (i = 0; i < rumstate.origTupdesc->natts; i++)
+		{
+			rumHeapTupleFastCollect(&rumstate, &collector,
+									(OffsetNumber) (i + 1),
+									values[i], isnull[i], ht_ctid,
+									outerAddInfo, outerAddInfoIsNull);
+		}
+
+		rumHeapTupleFastInsert(&rumstate, &collector);
+	}
+	else
 	{
-		rumHeapTupleInsert(&rumstate, (OffsetNumber) (i + 1),
-						   values[i], isnull[i], ht_ctid,
-						   outerAddInfo, outerAddInfoIsNull);
+		for (i = 0; i < rumstate.origTupdesc->natts; i++)
+		{
+			rumHeapTupleInsert(&rumstate, (OffsetNumber) (i + 1),
+							   values[i], isnull[i], ht_ctid,
+							   outerAddInfo, outerAddInfoIsNull);
+		}
 	}
 
 	MemoryContextSwitchTo(oldCtx);
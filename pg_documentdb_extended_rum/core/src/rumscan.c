@@ -47,9 +47,16 @@ typedef enum RumParallelScanState
 	RumParallelScanState_Done = 5,
 } RumParallelScanState;
 
+/*
+ * Number of heap blocks handed out at a time to the workers of a parallel
+ * regular scan.
+ */
+#define RUM_PARALLEL_HEAP_RANGE_BLOCKS 64
+
 typedef struct RumParallelScanDescData
 {
 	BlockNumber rum_ps_current_page; /* latest or next page to be scanned */
+	BlockNumber rum_ps_next_heap_block; /* next heap range of a regular scan */
 	RumParallelScanState parallel_scan_state;
 	bool isParallelScanEligible;
 	LWLock rum_ps_lock;             /* protects shared parallel state */
@@ -79,9 +86,15 @@ rumbeginscan(Relation rel, int nkeys, int norderbys)
 	so->sortedEntries = NULL;
 	so->orderByScanData = NULL;
 	so->scanLoops = 0;
+	so->isBitmapEntryUnion = false;
+	so->isParallelEnabled = false;
 	so->killedItems = NULL;
 	so->numKilled = 0;
 	so->killedItemsSkipped = 0;
+	so->pendingItems = NULL;
+	so->nPendingItems = 0;
+	so->pendingItemsReturned = 0;
+	so->returnedPendingItem = false;
 	so->orderByKeyIndex = -1;
 	so->orderScanDirection = ForwardScanDirection;
 	so->tempCtx = RumContextCreate(CurrentMemoryContext,
@@ -508,6 +521,10 @@ freeScanKeys(RumScanOpaque so)
 	MemoryContextReset(so->keyCtx);
 	so->keys = NULL;
 	so->nkeys = 0;
+	so->pendingItems = NULL;
+	so->nPendingItems = 0;
+	so->pendingItemsReturned = 0;
+	so->returnedPendingItem = false;
 
 	if (so->sortedEntries)
 	{
@@ -785,6 +802,8 @@ rumNewScanKey(IndexScanDesc scan)
 	so->naturalOrder = NoMovementScanDirection;
 	so->useSimpleScan = false;
 	so->secondPass = false;
+	so->parallelRangeStart = 0;
+	so->parallelRangeEnd = 0;
 	so->orderByHasRecheck = false;
 	so->entriesIncrIndex = -1;
 	so->norderbys = scan->numberOfOrderBys;
@@ -1022,6 +1041,7 @@ ruminitparallelscan(void *target)
 
 	LWLockInitialize(&rum_ps_target->rum_ps_lock, RumParallelScanTrancheId);
 	rum_ps_target->rum_ps_current_page = InvalidBlockNumber;
+	rum_ps_target->rum_ps_next_heap_block = 0;
 	rum_ps_target->parallel_scan_state = RumParallelScanState_NotInitialized;
 	rum_ps_target->isParallelScanEligible = false;
 	ConditionVariableInit(&rum_ps_target->rum_ps_cv);
@@ -1046,6 +1066,7 @@ rumparallelrescan(IndexScanDesc scan)
 	 */
 	LWLockAcquire(&psdata->rum_ps_lock, LW_EXCLUSIVE);
 	psdata->rum_ps_current_page = InvalidBlockNumber;
+	psdata->rum_ps_next_heap_block = 0;
 	psdata->parallel_scan_state = RumParallelScanState_NotInitialized;
 	psdata->isParallelScanEligible = false;
 	LWLockRelease(&psdata->rum_ps_lock);
@@ -1218,6 +1239,46 @@ rum_parallel_release(ParallelIndexScanDesc parallelScan, BlockNumber nextBlock)
 }
 
 
+/*
+ * Claims the next range of heap blocks [startBlock, endBlock) for a parallel
+ * regular scan. Every worker walks all the entries of the scan, but only
+ * returns the items that fall in the ranges it claimed, so each heap tuple is
+ * returned by exactly one worker. An endBlock of InvalidBlockNumber means the
+ * range is unbounded. Returns false once every range has been claimed.
+ */
+bool
+rum_parallel_claim_heap_range(ParallelIndexScanDesc parallelScan,
+							  BlockNumber *startBlock, BlockNumber *endBlock)
+{
+	RumParallelScanDescData *psdata;
+	bool result = false;
+
+	Assert(parallelScan);
+
+	psdata = (RumParallelScanDescData *) ParallelScanGetOpaque(parallelScan);
+
+	LWLockAcquire(&psdata->rum_ps_lock, LW_EXCLUSIVE);
+	if (psdata->rum_ps_next_heap_block != InvalidBlockNumber)
+	{
+		*startBlock = psdata->rum_ps_next_heap_block;
+		if (*startBlock >= MaxBlockNumber - RUM_PARALLEL_HEAP_RANGE_BLOCKS)
+		{
+			*endBlock = InvalidBlockNumber;
+		}
+		else
+		{
+			*endBlock = *startBlock + RUM_PARALLEL_HEAP_RANGE_BLOCKS;
+		}
+
+		psdata->rum_ps_next_heap_block = *endBlock;
+		result = true;
+	}
+	LWLockRelease(&psdata->rum_ps_lock);
+
+	return result;
+}
+
+
 bool
 rum_parallel_scan_start_notify(IndexScanDesc scan)
 {
@@ -1233,9 +1294,21 @@ rum_parallel_scan_start_notify(IndexScanDesc scan)
 
 	LWLockAcquire(&psdata->rum_ps_lock, LW_EXCLUSIVE);
 	psdata->parallel_scan_state = RumParallelScanState_StartScanDone;
-	psdata->isParallelScanEligible = so->scanType == RumOrderedScan &&
-									 ScanDirectionIsForward(so->orderScanDirection);
+
+	/* Ordered scans share the entry tree page by page, regular scans
+	 * share the heap by block ranges (see rum_parallel_claim_heap_range).
+	 * Matches in the pending list are only known to this thread, which
+	 * then runs the scan alone.
+	 */
+	psdata->isParallelScanEligible =
+		so->nPendingItems == 0 &&
+		((so->scanType == RumOrderedScan &&
+		  ScanDirectionIsForward(so->orderScanDirection)) ||
+		 (RumEnableParallelRegularScan && so->scanType == RumRegularScan &&
+		  so->norderbys == 0 && !so->willSort &&
+		  !so->rumstate.useAlternativeOrder));
 	psdata->rum_ps_current_page = InvalidBlockNumber;
+	psdata->rum_ps_next_heap_block = 0;
 	isParallelEnabled = psdata->isParallelScanEligible;
 	LWLockRelease(&psdata->rum_ps_lock);
 	ConditionVariableBroadcast(&psdata->rum_ps_cv);
@@ -1382,6 +1455,11 @@ try_explain_documentdb_rum_index(IndexScanDesc scan, ExplainState *es)
 	}
 
 	ExplainPropertyText("scanType", scanType, es);
+	if (so->isBitmapEntryUnion)
+	{
+		ExplainPropertyBool("bitmapEntryUnion", true, es);
+	}
+
 	for (i = 0; i < so->nkeys; i++)
 	{
 		StringInfo buf = makeStringInfo();
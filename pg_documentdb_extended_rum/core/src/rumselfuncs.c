@@ -27,6 +27,9 @@
 
 #define DEFAULT_PAGE_CPU_MULTIPLIER 50.0
 
+/* Maximum number of entries probed for their posting sizes per cost estimate */
+#define RUM_COST_MAX_PRESENCE_PROBES 8
+
 typedef struct
 {
 	bool attHasFullScan[INDEX_MAX_KEYS];
@@ -35,6 +38,16 @@ typedef struct
 	double exactEntries;
 	double searchEntries;
 	double arrayScans;
+
+	/* State used to probe the posting sizes of exact entries (NULL if disabled) */
+	RumState *presenceState;
+	int presenceProbes;
+
+	/* Sum of the posting sizes of the entries of the current clause */
+	double clauseEntryItems;
+
+	/* Whether the current clause has entries whose posting size is unknown */
+	bool clauseHasUnprobedEntries;
 } GinQualCounts;
 
 
@@ -53,6 +66,9 @@ static bool gincost_scalararrayopexpr(PlannerInfo *root,
 									  ScalarArrayOpExpr *clause,
 									  double numIndexEntries,
 									  GinQualCounts *counts);
+static bool rumGetEntryPostingListSize(RumState *rumstate, OffsetNumber attnum,
+									   Datum key, RumNullCategory category,
+									   double *numItems);
 
 /*
  * Cost estimate logic for documentdb_extended_rum. Implements logic handling
@@ -112,6 +128,8 @@ RumCostEstimateCore(PlannerInfo *root, IndexPath *path, double loop_count,
 	Cost descentCost;
 	Relation indexRel;
 	RumStatsData ginStats;
+	Relation presenceIndexRel = NULL;
+	double presenceItems = -1;
 	ListCell *lc;
 	int i;
 
@@ -228,6 +246,18 @@ RumCostEstimateCore(PlannerInfo *root, IndexPath *path, double loop_count,
 	counts.arrayScans = 1;
 	matchPossible = true;
 
+	/*
+	 * The posting sizes of the entries are only a complete picture of the
+	 * index if nothing is waiting in the pending list.
+	 */
+	if (RumEnableEntryPresenceCostEstimate && !index->hypothetical &&
+		numPendingPages == 0)
+	{
+		presenceIndexRel = index_open(index->indexoid, NoLock);
+		counts.presenceState = (RumState *) palloc(sizeof(RumState));
+		initRumState(counts.presenceState, presenceIndexRel);
+	}
+
 	foreach(lc, path->indexclauses)
 	{
 		IndexClause *iclause = lfirst_node(IndexClause, lc);
@@ -238,6 +268,9 @@ RumCostEstimateCore(PlannerInfo *root, IndexPath *path, double loop_count,
 			RestrictInfo *rinfo = lfirst_node(RestrictInfo, lc2);
 			Expr *clause = rinfo->clause;
 
+			counts.clauseEntryItems = 0;
+			counts.clauseHasUnprobedEntries = false;
+
 			if (IsA(clause, OpExpr))
 			{
 				matchPossible = gincost_opexpr(root,
@@ -252,6 +285,7 @@ RumCostEstimateCore(PlannerInfo *root, IndexPath *path, double loop_count,
 			}
 			else if (IsA(clause, ScalarArrayOpExpr))
 			{
+				counts.clauseHasUnprobedEntries = true;
 				matchPossible = gincost_scalararrayopexpr(root,
 														  index,
 														  iclause->indexcol,
@@ -269,9 +303,29 @@ RumCostEstimateCore(PlannerInfo *root, IndexPath *path, double loop_count,
 				elog(ERROR, "unsupported GIN indexqual type: %d",
 					 (int) nodeTag(clause));
 			}
+
+			/*
+			 * Every tuple matching the clause is in the posting of at least
+			 * one of its entries, and the quals are ANDed: keep the smallest.
+			 */
+			if (counts.presenceState != NULL && !counts.clauseHasUnprobedEntries)
+			{
+				presenceItems = presenceItems < 0 ? counts.clauseEntryItems :
+								Min(presenceItems, counts.clauseEntryItems);
+			}
+		}
+
+		if (!matchPossible)
+		{
+			break;
 		}
 	}
 
+	if (presenceIndexRel != NULL)
+	{
+		index_close(presenceIndexRel, NoLock);
+	}
+
 	/* Fall out if there were any provably-unsatisfiable quals */
 	if (!matchPossible)
 	{
@@ -281,6 +335,17 @@ RumCostEstimateCore(PlannerInfo *root, IndexPath *path, double loop_count,
 		return;
 	}
 
+	/*
+	 * The statistics of the table can't tell how sparse the path behind an
+	 * index term is (e.g. the exists terms of a sparse field), but the
+	 * posting sizes can: cap the selectivity with them.
+	 */
+	if (presenceItems >= 0 && index->rel->tuples > 0)
+	{
+		*indexSelectivity = Min(*indexSelectivity,
+								presenceItems / index->rel->tuples);
+	}
+
 	/*
 	 * If attribute has a full scan and at the same time doesn't have normal
 	 * scan, then we'll have to scan all non-null entries of that attribute.
@@ -512,6 +577,7 @@ gincost_pattern(IndexOptInfo *index, int indexcol,
 	Pointer *extra_data = NULL;
 	bool *nullFlags = NULL;
 	int32 searchMode = GIN_SEARCH_MODE_DEFAULT;
+	Datum *entries;
 	int32 i;
 
 	Assert(indexcol < index->nkeycolumns);
@@ -559,15 +625,16 @@ gincost_pattern(IndexOptInfo *index, int indexcol,
 
 	set_fn_opclass_options(&flinfo, index->opclassoptions[indexcol]);
 
-	FunctionCall7Coll(&flinfo,
-					  collation,
-					  query,
-					  PointerGetDatum(&nentries),
-					  UInt16GetDatum(strategy_op),
-					  PointerGetDatum(&partial_matches),
-					  PointerGetDatum(&extra_data),
-					  PointerGetDatum(&nullFlags),
-					  PointerGetDatum(&searchMode));
+	entries = (Datum *) DatumGetPointer(
+		FunctionCall7Coll(&flinfo,
+						  collation,
+						  query,
+						  PointerGetDatum(&nentries),
+						  UInt16GetDatum(strategy_op),
+						  PointerGetDatum(&partial_matches),
+						  PointerGetDatum(&extra_data),
+						  PointerGetDatum(&nullFlags),
+						  PointerGetDatum(&searchMode)));
 
 	if (nentries <= 0 && searchMode == GIN_SEARCH_MODE_DEFAULT)
 	{
@@ -584,15 +651,45 @@ gincost_pattern(IndexOptInfo *index, int indexcol,
 		if (partial_matches && partial_matches[i])
 		{
 			counts->partialEntries += 100;
+			counts->clauseHasUnprobedEntries = true;
 		}
 		else
 		{
 			counts->exactEntries++;
+
+			if (counts->presenceState != NULL &&
+				counts->presenceProbes < RUM_COST_MAX_PRESENCE_PROBES)
+			{
+				RumNullCategory category = (nullFlags && nullFlags[i]) ?
+										   RUM_CAT_NULL_KEY : RUM_CAT_NORM_KEY;
+				double entryItems;
+
+				counts->presenceProbes++;
+				if (rumGetEntryPostingListSize(counts->presenceState, indexcol + 1,
+											   entries[i], category, &entryItems))
+				{
+					counts->clauseEntryItems += entryItems;
+				}
+				else
+				{
+					counts->clauseHasUnprobedEntries = true;
+				}
+			}
+			else
+			{
+				counts->clauseHasUnprobedEntries = true;
+			}
 		}
 
 		counts->searchEntries++;
 	}
 
+	if (searchMode != GIN_SEARCH_MODE_DEFAULT)
+	{
+		/* Items without any entry may match as well */
+		counts->clauseHasUnprobedEntries = true;
+	}
+
 	if (searchMode == GIN_SEARCH_MODE_DEFAULT)
 	{
 		counts->attHasNormalScan[indexcol] = true;
@@ -646,6 +743,7 @@ gincost_opexpr(PlannerInfo *root,
 	{
 		counts->exactEntries++;
 		counts->searchEntries++;
+		counts->clauseHasUnprobedEntries = true;
 		return true;
 	}
 
@@ -750,8 +848,13 @@ gincost_scalararrayopexpr(PlannerInfo *root,
 			continue;
 		}
 
-		/* Otherwise, apply extractQuery and get the actual term counts */
+		/*
+		 * Otherwise, apply extractQuery and get the actual term counts. The
+		 * elements get no presence state: the clause is never capped by the
+		 * posting sizes, so there is no point in probing the index for them.
+		 */
 		memset(&elemcounts, 0, sizeof(elemcounts));
+		elemcounts.presenceState = NULL;
 
 		if (gincost_pattern(index, indexcol, clause_op, elemValues[i],
 							&elemcounts))
@@ -796,3 +899,44 @@ gincost_scalararrayopexpr(PlannerInfo *root,
 
 	return true;
 }
+
+
+/*
+ * Gets an upper bound of the number of items behind an exact match entry by
+ * looking it up in the entry tree: the size of its posting list, or 0 if the
+ * entry is not in the index. Returns false for entries that have a posting
+ * tree: their size is only known by walking all of their leaves.
+ */
+static bool
+rumGetEntryPostingListSize(RumState *rumstate, OffsetNumber attnum, Datum key,
+						   RumNullCategory category, double *numItems)
+{
+	RumBtreeData btreeEntry;
+	RumBtreeStack *stackEntry;
+	bool isBounded = true;
+
+	*numItems = 0;
+	rumPrepareEntryScan(&btreeEntry, attnum, key, category, rumstate);
+	btreeEntry.searchMode = true;
+	stackEntry = rumFindLeafPage(&btreeEntry, NULL);
+
+	if (btreeEntry.findItem(&btreeEntry, stackEntry))
+	{
+		Page page = BufferGetPage(stackEntry->buffer);
+		IndexTuple itup = (IndexTuple) PageGetItem(page, PageGetItemId(page,
+																	   stackEntry->off));
+
+		if (RumIsPostingTree(itup))
+		{
+			isBounded = false;
+		}
+		else
+		{
+			*numItems = RumGetNPosting(itup);
+		}
+	}
+
+	LockBuffer(stackEntry->buffer, RUM_UNLOCK);
+	freeRumBtreeStack(stackEntry);
+	return isBounded;
+}
@@ -263,8 +263,9 @@ initRumState(RumState *state, Relation index)
 			}
 		}
 
-		if (!(AttributeNumberIsValid(state->attrnAttachColumn) &&
-			  AttributeNumberIsValid(state->attrnAddToColumn)))
+		/* Options other than attach/to (e.g. fastupdate) may be set alone */
+		if (AttributeNumberIsValid(state->attrnAttachColumn) !=
+			AttributeNumberIsValid(state->attrnAddToColumn))
 		{
 			elog(ERROR, "AddTo and OrderBy columns should be defined both");
 		}
@@ -34,6 +34,12 @@
 	vacuum_delay_point();
 #endif
 
+#if PG_VERSION_NUM >= 170000
+#define RumIsAutoVacuumWorkerProcess() AmAutoVacuumWorkerProcess()
+#else
+#define RumIsAutoVacuumWorkerProcess() IsAutoVacuumWorkerProcess()
+#endif
+
 extern bool RumSkipRetryOnDeletePage;
 extern bool RumVacuumEntryItems;
 extern bool RumPruneEmptyPages;
@@ -1613,6 +1619,19 @@ rumbulkdelete(IndexVacuumInfo *info,
 			  IndexBulkDeleteResult *stats, IndexBulkDeleteCallback callback,
 			  void *callback_state)
 {
+	/*
+	 * On the first pass, merge the pending list into the main structure so
+	 * the dead TIDs in it get removed as well.
+	 */
+	if (stats == NULL)
+	{
+		RumState rumState;
+
+		stats = (IndexBulkDeleteResult *) palloc0(sizeof(IndexBulkDeleteResult));
+		initRumState(&rumState, info->index);
+		rumInsertCleanup(&rumState, true, stats);
+	}
+
 	if (RumEnableNewBulkDelete)
 	{
 		return rumbulkdeleteNew(info, stats, callback, callback_state);
@@ -1832,6 +1851,14 @@ rumvacuumcleanup(IndexVacuumInfo *info, IndexBulkDeleteResult *stats)
 	 */
 	if (info->analyze_only)
 	{
+		if (RumIsAutoVacuumWorkerProcess())
+		{
+			RumState rumState;
+
+			initRumState(&rumState, index);
+			rumInsertCleanup(&rumState, false, stats);
+		}
+
 		return stats;
 	}
 
@@ -1841,7 +1868,11 @@ rumvacuumcleanup(IndexVacuumInfo *info, IndexBulkDeleteResult *stats)
 	 */
 	if (stats == NULL)
 	{
+		RumState rumState;
+
 		stats = (IndexBulkDeleteResult *) palloc0(sizeof(IndexBulkDeleteResult));
+		initRumState(&rumState, index);
+		rumInsertCleanup(&rumState, !RumIsAutoVacuumWorkerProcess(), stats);
 	}
 
 	InitRumVacuumState(&gvs, index, stats);
@@ -1911,6 +1942,10 @@ rumvacuumcleanup(IndexVacuumInfo *info, IndexBulkDeleteResult *stats)
 			RecordFreeIndexPage(index, blkno);
 			totFreePages++;
 		}
+		else if (RumPageIsList(page))
+		{
+			/* Pending list pages are tracked on the metapage */
+		}
 		else if (RumPageIsData(page))
 		{
 			idxStat.nDataPages++;
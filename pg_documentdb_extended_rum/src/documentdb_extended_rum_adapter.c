@@ -51,6 +51,12 @@ extern PGDLLIMPORT bool can_documentdb_rum_index_scan_ordered(IndexScanDesc scan
 extern PGDLLIMPORT Datum documentdb_rumhandler(PG_FUNCTION_ARGS);
 extern PGDLLEXPORT bool documentdb_rum_get_multi_key_status(Relation indexRelation);
 extern PGDLLEXPORT void documentdb_rum_update_multi_key_status(Relation indexRelation);
+static bool documentdb_rum_get_pending_list_status(Relation indexRelation);
+static bool documentdb_rum_enumerate_distinct_terms(Relation indexRelation,
+													Relation heapRelation,
+													Snapshot snapshot,
+													IndexTermCallbackFunc callback,
+													void *state);
 
 /* Static Globals */
 static BsonIndexAmEntry DocumentDBIndexAmEntry = {
@@ -76,6 +82,8 @@ static BsonIndexAmEntry DocumentDBIndexAmEntry = {
 	.get_opclass_internal_catalog_schema = GetDocumentDBCatalogSchema,
 	.get_multikey_status = documentdb_rum_get_multi_key_status,
 	.get_truncation_status = RumGetTruncationStatus,
+	.get_pending_list_status = documentdb_rum_get_pending_list_status,
+	.enumerate_distinct_terms = documentdb_rum_enumerate_distinct_terms,
 };
 static DocumentDBRumOidCacheData Cache = { 0 };
 static bool has_custom_routine = false;
@@ -337,6 +345,17 @@ documentdb_rum_get_multi_key_status(Relation indexRelation)
 }
 
 
+/*
+ * An index can have a pending list if it has one now, or if it has fastupdate
+ * on: inserts don't invalidate plans, while turning fastupdate on does.
+ */
+static bool
+documentdb_rum_get_pending_list_status(Relation indexRelation)
+{
+	return RumGetUseFastUpdate(indexRelation) || rumHasPendingList(indexRelation);
+}
+
+
 PGDLLEXPORT void
 documentdb_rum_update_multi_key_status(Relation index)
 {
@@ -365,3 +384,17 @@ documentdb_rum_update_multi_key_status(Relation index)
 	GenericXLogFinish(state);
 	UnlockReleaseBuffer(metaBuffer);
 }
+
+
+static bool
+documentdb_rum_enumerate_distinct_terms(Relation indexRelation, Relation heapRelation,
+										Snapshot snapshot,
+										IndexTermCallbackFunc callback, void *state)
+{
+	EnsureDocumentDBExtendedRumLib();
+
+	/* Single path indexes have their terms in the first attribute */
+	OffsetNumber attnum = 1;
+	return rumEnumerateDistinctEntries(indexRelation, heapRelation, snapshot, attnum,
+									   callback, state);
+}
@@ -32,6 +32,11 @@ pub trait DynamicConfiguration: Send + Sync + Debug {
     // Needed to downcast to concrete type
     fn as_any(&self) -> &dyn std::any::Any;
 
+    async fn allow_unacknowledged_writes(&self) -> bool {
+        self.equals_value("writeConcernRelaxation", "unacknowledged")
+            .await
+    }
+
     async fn enable_change_streams(&self) -> bool {
         self.get_bool("enableChangeStreams", false).await
     }
@@ -40,10 +45,26 @@ pub trait DynamicConfiguration: Send + Sync + Debug {
         self.get_bool("enableConnectionStatus", false).await
     }
 
+    async fn enable_group_inserts(&self) -> bool {
+        self.get_bool("enableGroupInserts", false).await
+    }
+
+    async fn enable_group_updates(&self) -> bool {
+        self.get_bool("enableGroupUpdates", false).await
+    }
+
     async fn enable_verbose_logging_in_gateway(&self) -> bool {
         self.get_bool("enableVerboseLoggingInGateway", false).await
     }
 
+    async fn group_write_max_documents(&self) -> i32 {
+        self.get_i32("groupWriteMaxDocuments", 100).await
+    }
+
+    async fn group_write_window_micro_secs(&self) -> i32 {
+        self.get_i32("groupWriteWindowInMicroSec", 200).await
+    }
+
     async fn index_build_sleep_milli_secs(&self) -> i32 {
         self.get_i32("indexBuildWaitSleepTimeInMilliSec", 1000)
             .await
@@ -98,3 +119,82 @@ pub trait DynamicConfiguration: Send + Sync + Debug {
         write!(f, "")
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use std::collections::HashMap;
+
+    use super::*;
+
+    #[derive(Debug, Default)]
+    struct TestConfiguration {
+        values: HashMap<String, String>,
+    }
+
+    #[async_trait]
+    impl DynamicConfiguration for TestConfiguration {
+        async fn get_str(&self, key: &str) -> Option<String> {
+            self.values.get(key).cloned()
+        }
+
+        async fn get_bool(&self, key: &str, default: bool) -> bool {
+            self.values
+                .get(key)
+                .and_then(|v| v.parse::<bool>().ok())
+                .unwrap_or(default)
+        }
+
+        async fn get_i32(&self, key: &str, default: i32) -> i32 {
+            self.values
+                .get(key)
+                .and_then(|v| v.parse::<i32>().ok())
+                .unwrap_or(default)
+        }
+
+        async fn equals_value(&self, key: &str, value: &str) -> bool {
+            self.values.get(key).is_some_and(|v| v == value)
+        }
+
+        fn topology(&self) -> RawBson {
+            RawBson::Null
+        }
+
+        async fn enable_developer_explain(&self) -> bool {
+            false
+        }
+
+        async fn max_connections(&self) -> usize {
+            0
+        }
+
+        async fn allow_transaction_snapshot(&self) -> bool {
+            false
+        }
+
+        fn as_any(&self) -> &dyn std::any::Any {
+            self
+        }
+    }
+
+    #[tokio::test]
+    async fn test_allow_unacknowledged_writes() {
+        let mut configuration = TestConfiguration::default();
+        assert!(!configuration.allow_unacknowledged_writes().await);
+
+        for (relaxation, allowed) in [
+            ("none", false),
+            ("journal", false),
+            ("unacknowledged", true),
+        ] {
+            configuration.values.insert(
+                "writeConcernRelaxation".to_string(),
+                relaxation.to_string(),
+            );
+            assert_eq!(
+                configuration.allow_unacknowledged_writes().await,
+                allowed,
+                "writeConcernRelaxation = {relaxation}"
+            );
+        }
+    }
+}
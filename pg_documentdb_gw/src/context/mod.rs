@@ -11,11 +11,17 @@ mod cursor;
 mod request;
 mod service;
 mod transaction;
+mod write_group;
 
 pub use cursor::{Cursor, CursorStore, CursorStoreEntry};
 
 pub use transaction::{RequestTransactionInfo, Transaction, TransactionStore};
 
+pub use write_group::{
+    split_insert_group_response, split_update_group_response, GroupedWriteResult, WriteGroup,
+    WriteGroupKey, WriteGroupMembers, WriteGroupStore,
+};
+
 pub use connection::ConnectionContext;
 pub use request::RequestContext;
 pub use service::ServiceContext;
@@ -12,7 +12,7 @@ use tokio::sync::RwLock;
 
 use crate::{
     configuration::{DynamicConfiguration, SetupConfiguration},
-    context::{CursorStore, TransactionStore},
+    context::{CursorStore, TransactionStore, WriteGroupStore},
     error::{DocumentDBError, Result},
     postgres::{Connection, ConnectionPool, QueryCatalog},
     service::TlsProvider,
@@ -35,6 +35,8 @@ pub struct ServiceContextInner {
     pub system_shared_pools: RwLock<HashMap<usize, Arc<ConnectionPool>>>,
     pub cursor_store: CursorStore,
     pub transaction_store: TransactionStore,
+    pub insert_group_store: WriteGroupStore,
+    pub update_group_store: WriteGroupStore,
     pub query_catalog: QueryCatalog,
     pub tls_provider: TlsProvider,
 }
@@ -63,6 +65,8 @@ impl ServiceContext {
             system_shared_pools: RwLock::new(HashMap::new()),
             cursor_store: CursorStore::new(setup_configuration.as_ref(), true),
             transaction_store: TransactionStore::new(Duration::from_secs(timeout_secs)),
+            insert_group_store: WriteGroupStore::default(),
+            update_group_store: WriteGroupStore::default(),
             query_catalog,
             tls_provider,
         };
@@ -119,6 +123,14 @@ impl ServiceContext {
         &self.0.transaction_store
     }
 
+    pub fn insert_group_store(&self) -> &WriteGroupStore {
+        &self.0.insert_group_store
+    }
+
+    pub fn update_group_store(&self) -> &WriteGroupStore {
+        &self.0.update_group_store
+    }
+
     pub fn query_catalog(&self) -> &QueryCatalog {
         &self.0.query_catalog
     }
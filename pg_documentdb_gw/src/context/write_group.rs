@@ -0,0 +1,493 @@
+/*-------------------------------------------------------------------------
+ * Copyright (c) Microsoft Corporation.  All rights reserved.
+ *
+ * src/context/write_group.rs
+ *
+ *-------------------------------------------------------------------------
+ */
+
+use std::{collections::HashMap, sync::Mutex};
+
+use bson::{rawdoc, RawArrayBuf, RawBson, RawBsonRef, RawDocument, RawDocumentBuf};
+use tokio::sync::oneshot;
+
+use crate::error::{DocumentDBError, Result};
+
+/// What a member of a write group receives once the group has been executed.
+#[derive(Debug)]
+pub enum GroupedWriteResult {
+    /// The response the member would have received for running its write on its own.
+    Response(RawDocumentBuf),
+
+    /// Nothing of the group was written, the member runs its write on its own.
+    Failed,
+
+    /// The group ran but its outcome for the member is not known, the member reports the
+    /// error instead of running its write again.
+    Error(String),
+}
+
+// Maps Username, Database, Collection, writeConcern -> the group new writes join.
+// The writeConcern is kept as its bson bytes, empty when the request has none.
+pub type WriteGroupKey = (String, String, String, Vec<u8>);
+
+/// The requests waiting for the result of a group, in the order they joined.
+/// Any of them that has not been answered when this is dropped, because the group never ran,
+/// runs its write on its own.
+#[derive(Default)]
+pub struct WriteGroupMembers(Vec<oneshot::Sender<GroupedWriteResult>>);
+
+impl WriteGroupMembers {
+    pub fn len(&self) -> usize {
+        self.0.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.0.is_empty()
+    }
+
+    /// Sends each member its result, in the order the members joined.
+    pub fn send(mut self, results: impl IntoIterator<Item = GroupedWriteResult>) {
+        for (member, result) in self.0.drain(..).zip(results) {
+            let _ = member.send(result);
+        }
+    }
+
+    /// Sends every member the same error.
+    pub fn send_error(self, message: &str) {
+        let count = self.len();
+        self.send((0..count).map(|_| GroupedWriteResult::Error(message.to_string())));
+    }
+}
+
+impl Drop for WriteGroupMembers {
+    fn drop(&mut self) {
+        for member in self.0.drain(..) {
+            let _ = member.send(GroupedWriteResult::Failed);
+        }
+    }
+}
+
+/// Writes waiting to be run together: the document of each member, in the order they joined.
+pub struct WriteGroup {
+    pub documents: Vec<RawDocumentBuf>,
+    pub members: WriteGroupMembers,
+}
+
+#[derive(Default)]
+struct WriteGroups {
+    next_group_id: u64,
+    open_groups: HashMap<WriteGroupKey, u64>,
+    groups: HashMap<u64, WriteGroup>,
+}
+
+/// Holds the write groups of one kind of write for all the connections of the gateway.
+/// The lock is never held across an await.
+#[derive(Default)]
+pub struct WriteGroupStore {
+    groups: Mutex<WriteGroups>,
+}
+
+impl WriteGroupStore {
+    /// Adds the document to the open group of the key. If there is none, or it is full,
+    /// a new group is opened and the caller becomes its leader.
+    pub fn join(
+        &self,
+        key: WriteGroupKey,
+        document: RawDocumentBuf,
+        max_documents: usize,
+    ) -> (
+        Option<WriteGroupLeader<'_>>,
+        oneshot::Receiver<GroupedWriteResult>,
+    ) {
+        let (sender, receiver) = oneshot::channel();
+        let mut state = self.groups.lock().unwrap_or_else(|e| e.into_inner());
+        let WriteGroups {
+            next_group_id,
+            open_groups,
+            groups,
+        } = &mut *state;
+
+        if let Some(group) = open_groups
+            .get(&key)
+            .and_then(|group_id| groups.get_mut(group_id))
+        {
+            if group.documents.len() < max_documents {
+                group.documents.push(document);
+                group.members.0.push(sender);
+                return (None, receiver);
+            }
+        }
+
+        let group_id = *next_group_id;
+        *next_group_id += 1;
+        open_groups.insert(key.clone(), group_id);
+        groups.insert(
+            group_id,
+            WriteGroup {
+                documents: vec![document],
+                members: WriteGroupMembers(vec![sender]),
+            },
+        );
+
+        (
+            Some(WriteGroupLeader {
+                store: self,
+                key,
+                group_id,
+            }),
+            receiver,
+        )
+    }
+
+    fn remove(&self, key: &WriteGroupKey, group_id: u64) -> Option<WriteGroup> {
+        let mut state = self.groups.lock().unwrap_or_else(|e| e.into_inner());
+        if state.open_groups.get(key) == Some(&group_id) {
+            state.open_groups.remove(key);
+        }
+        state.groups.remove(&group_id)
+    }
+}
+
+/// Held by the request that opened a group, until it closes the group to execute it.
+/// If the request goes away before that, the group is dropped and its members write on
+/// their own.
+pub struct WriteGroupLeader<'a> {
+    store: &'a WriteGroupStore,
+    key: WriteGroupKey,
+    group_id: u64,
+}
+
+impl WriteGroupLeader<'_> {
+    /// Closes the group so that no more writes join it and hands it over for execution.
+    pub fn close(self) -> Option<WriteGroup> {
+        self.store.remove(&self.key, self.group_id)
+    }
+}
+
+impl Drop for WriteGroupLeader<'_> {
+    fn drop(&mut self) {
+        self.store.remove(&self.key, self.group_id);
+    }
+}
+
+/// Splits the response of an unordered insert of the documents of a group into the response
+/// of each member. Write errors are attributed by their index and renumbered to 0, any other
+/// field, such as a writeConcernError, applies to every member.
+pub fn split_insert_group_response(
+    response: &RawDocument,
+    member_count: usize,
+) -> Result<Vec<RawDocumentBuf>> {
+    let mut write_errors = vec![None; member_count];
+    let mut shared_fields = RawDocumentBuf::new();
+    for entry in response {
+        let (key, value) = entry?;
+        match key {
+            "n" => {}
+            "ok" => ensure_group_ok(value)?,
+            "writeErrors" => attribute_entries(value, &mut write_errors)?,
+            _ => shared_fields.append(key, value.to_raw_bson()),
+        }
+    }
+
+    let mut responses = Vec::with_capacity(member_count);
+    for write_error in write_errors {
+        let mut response = match write_error {
+            Some(write_error) => rawdoc! {
+                "n": 0,
+                "ok": 1.0,
+                "writeErrors": [write_error],
+            },
+            None => rawdoc! {
+                "n": 1,
+                "ok": 1.0,
+            },
+        };
+        append_fields(&mut response, &shared_fields)?;
+        responses.push(response);
+    }
+
+    Ok(responses)
+}
+
+/// Splits the response of an unordered update of the statements of a group, which reports the
+/// result of each statement, into the response of each member. Statement results, upserts and
+/// write errors are attributed by their index and renumbered to 0, any other field applies to
+/// every member.
+pub fn split_update_group_response(
+    response: &RawDocument,
+    member_count: usize,
+) -> Result<Vec<RawDocumentBuf>> {
+    let mut statement_results = vec![None; member_count];
+    let mut upserts = vec![None; member_count];
+    let mut write_errors = vec![None; member_count];
+    let mut shared_fields = RawDocumentBuf::new();
+    for entry in response {
+        let (key, value) = entry?;
+        match key {
+            "n" | "nModified" => {}
+            "ok" => ensure_group_ok(value)?,
+            "statementResults" => attribute_entries(value, &mut statement_results)?,
+            "upserted" => attribute_entries(value, &mut upserts)?,
+            "writeErrors" => attribute_entries(value, &mut write_errors)?,
+            _ => shared_fields.append(key, value.to_raw_bson()),
+        }
+    }
+
+    let mut responses = Vec::with_capacity(member_count);
+    for ((statement_result, upsert), write_error) in
+        statement_results.into_iter().zip(upserts).zip(write_errors)
+    {
+        let mut response = rawdoc! { "ok": 1.0 };
+        match statement_result {
+            Some(statement_result) => {
+                let count = |field: &str| {
+                    statement_result
+                        .get(field)
+                        .ok()
+                        .flatten()
+                        .map(|value| value.to_raw_bson())
+                        .unwrap_or(RawBson::Int32(0))
+                };
+                response.append("nModified", count("nModified"));
+                response.append("n", count("n"));
+            }
+            None => {
+                response.append("nModified", 0);
+                response.append("n", 0);
+            }
+        }
+        if let Some(upsert) = upsert {
+            response.append("upserted", single_entry_array(upsert));
+        }
+        if let Some(write_error) = write_error {
+            response.append("writeErrors", single_entry_array(write_error));
+        }
+        append_fields(&mut response, &shared_fields)?;
+        responses.push(response);
+    }
+
+    Ok(responses)
+}
+
+fn ensure_group_ok(value: RawBsonRef<'_>) -> Result<()> {
+    if value.as_f64() != Some(1.0) {
+        return Err(DocumentDBError::internal_error(
+            "Grouped write did not succeed.".to_string(),
+        ));
+    }
+    Ok(())
+}
+
+/// Hands each entry of an array of documents with an index to the member at that index,
+/// renumbering the index to 0.
+fn attribute_entries(value: RawBsonRef<'_>, members: &mut [Option<RawDocumentBuf>]) -> Result<()> {
+    let entries = value.as_array().ok_or(DocumentDBError::internal_error(
+        "Expected grouped write results to be an array.".to_string(),
+    ))?;
+    for entry in entries {
+        let entry = entry?.as_document().ok_or(DocumentDBError::internal_error(
+            "Expected grouped write result to be a document.".to_string(),
+        ))?;
+        let index = entry
+            .get_i32("index")
+            .map_err(DocumentDBError::pg_response_invalid)?;
+        let member_entry = usize::try_from(index)
+            .ok()
+            .and_then(|index| members.get_mut(index))
+            .ok_or(DocumentDBError::internal_error(format!(
+                "Index {index} is out of the grouped write."
+            )))?;
+
+        let mut renumbered = rawdoc! { "index": 0 };
+        for field in entry {
+            let (k, v) = field?;
+            if k != "index" {
+                renumbered.append(k, v.to_raw_bson());
+            }
+        }
+        *member_entry = Some(renumbered);
+    }
+    Ok(())
+}
+
+fn single_entry_array(entry: RawDocumentBuf) -> RawArrayBuf {
+    let mut array = RawArrayBuf::new();
+    array.push(entry);
+    array
+}
+
+fn append_fields(response: &mut RawDocumentBuf, fields: &RawDocument) -> Result<()> {
+    for field in fields {
+        let (k, v) = field?;
+        response.append(k, v.to_raw_bson());
+    }
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn key() -> WriteGroupKey {
+        (
+            "user".to_string(),
+            "db".to_string(),
+            "coll".to_string(),
+            Vec::new(),
+        )
+    }
+
+    #[test]
+    fn test_split_insert_group_response_without_errors() {
+        let response = rawdoc! { "n": 2, "ok": 1.0 };
+        let responses = split_insert_group_response(&response, 2).unwrap();
+        assert_eq!(responses, vec![rawdoc! { "n": 1, "ok": 1.0 }; 2]);
+    }
+
+    #[test]
+    fn test_split_insert_group_response_with_errors() {
+        let response = rawdoc! {
+            "n": 1,
+            "ok": 1.0,
+            "writeErrors": [
+                { "index": 0, "code": 11000, "errmsg": "duplicate" },
+                { "index": 2, "code": 121, "errmsg": "invalid" },
+            ],
+        };
+        let responses = split_insert_group_response(&response, 3).unwrap();
+        assert_eq!(
+            responses,
+            vec![
+                rawdoc! {
+                    "n": 0,
+                    "ok": 1.0,
+                    "writeErrors": [{ "index": 0, "code": 11000, "errmsg": "duplicate" }],
+                },
+                rawdoc! { "n": 1, "ok": 1.0 },
+                rawdoc! {
+                    "n": 0,
+                    "ok": 1.0,
+                    "writeErrors": [{ "index": 0, "code": 121, "errmsg": "invalid" }],
+                },
+            ]
+        );
+    }
+
+    #[test]
+    fn test_split_insert_group_response_shares_other_fields() {
+        let response = rawdoc! { "n": 2, "ok": 1.0, "writeConcernError": { "code": 64 } };
+        let responses = split_insert_group_response(&response, 2).unwrap();
+        assert_eq!(
+            responses,
+            vec![rawdoc! { "n": 1, "ok": 1.0, "writeConcernError": { "code": 64 } }; 2]
+        );
+    }
+
+    #[test]
+    fn test_split_insert_group_response_rejects_unknown_index() {
+        let response = rawdoc! {
+            "n": 0,
+            "ok": 1.0,
+            "writeErrors": [{ "index": 1, "code": 11000, "errmsg": "duplicate" }],
+        };
+        assert!(split_insert_group_response(&response, 1).is_err());
+    }
+
+    #[test]
+    fn test_split_update_group_response() {
+        let response = rawdoc! {
+            "ok": 1.0,
+            "nModified": 1,
+            "n": 2,
+            "upserted": [{ "index": 2, "_id": 3 }],
+            "writeErrors": [{ "index": 1, "code": 14, "errmsg": "type mismatch" }],
+            "statementResults": [
+                { "index": 0, "n": 1, "nModified": 1 },
+                { "index": 2, "n": 1, "nModified": 0 },
+            ],
+        };
+        let responses = split_update_group_response(&response, 3).unwrap();
+        assert_eq!(
+            responses,
+            vec![
+                rawdoc! { "ok": 1.0, "nModified": 1, "n": 1 },
+                rawdoc! {
+                    "ok": 1.0,
+                    "nModified": 0,
+                    "n": 0,
+                    "writeErrors": [{ "index": 0, "code": 14, "errmsg": "type mismatch" }],
+                },
+                rawdoc! {
+                    "ok": 1.0,
+                    "nModified": 0,
+                    "n": 1,
+                    "upserted": [{ "index": 0, "_id": 3 }],
+                },
+            ]
+        );
+    }
+
+    #[test]
+    fn test_write_group_store_join_and_close() {
+        let store = WriteGroupStore::default();
+
+        let (leader, _leader_receiver) = store.join(key(), rawdoc! { "a": 1 }, 2);
+        let (member, _member_receiver) = store.join(key(), rawdoc! { "a": 2 }, 2);
+        assert!(leader.is_some());
+        assert!(member.is_none());
+
+        // The group is full, the next write opens a new one
+        let (next_leader, _next_receiver) = store.join(key(), rawdoc! { "a": 3 }, 2);
+        assert!(next_leader.is_some());
+
+        let group = leader.unwrap().close().unwrap();
+        assert_eq!(group.documents.len(), 2);
+        assert_eq!(group.members.len(), 2);
+    }
+
+    #[test]
+    fn test_write_group_store_separates_write_concerns() {
+        let store = WriteGroupStore::default();
+        let mut majority = key();
+        majority.3 = rawdoc! { "w": "majority" }.into_bytes();
+
+        let (leader, _leader_receiver) = store.join(key(), rawdoc! { "a": 1 }, 2);
+        let (other_leader, _other_receiver) = store.join(majority, rawdoc! { "a": 2 }, 2);
+        assert!(leader.is_some());
+        assert!(other_leader.is_some());
+    }
+
+    #[test]
+    fn test_write_group_leader_dropped_fails_members() {
+        let store = WriteGroupStore::default();
+
+        let (leader, _leader_receiver) = store.join(key(), rawdoc! { "a": 1 }, 2);
+        let (_, mut member_receiver) = store.join(key(), rawdoc! { "a": 2 }, 2);
+        drop(leader);
+
+        assert!(matches!(
+            member_receiver.try_recv(),
+            Ok(GroupedWriteResult::Failed)
+        ));
+    }
+
+    #[test]
+    fn test_write_group_members_answered_once() {
+        let store = WriteGroupStore::default();
+
+        let (leader, mut leader_receiver) = store.join(key(), rawdoc! { "a": 1 }, 2);
+        let (_, mut member_receiver) = store.join(key(), rawdoc! { "a": 2 }, 2);
+        let group = leader.unwrap().close().unwrap();
+        group.members.send_error("unknown outcome");
+
+        assert!(matches!(
+            leader_receiver.try_recv(),
+            Ok(GroupedWriteResult::Error(_))
+        ));
+        assert!(matches!(
+            member_receiver.try_recv(),
+            Ok(GroupedWriteResult::Error(_))
+        ));
+    }
+}
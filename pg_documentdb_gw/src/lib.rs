@@ -412,6 +412,13 @@ where
 {
     *collection = request_context.info.collection().unwrap_or("").to_string();
 
+    // { w: 0 } writes are acknowledged before they run when the server policy allows it
+    let is_unacknowledged_write =
+        is_unacknowledged_write(connection_context, request_context).await;
+    if is_unacknowledged_write && connection_context.requires_response {
+        responses::writer::write(header, &Response::ok(), stream).await?;
+    }
+
     let format_response_start = request_context.tracker.start_timer();
 
     // Process the response for the message
@@ -428,13 +435,39 @@ where
 
     let response = match response_result {
         Ok(response) => response,
+        Err(e) if is_unacknowledged_write => {
+            // The client was already acknowledged and does not expect to hear back
+            log::warn!(activity_id = request_context.activity_id; "Unacknowledged write failed: {e}");
+
+            if let Some(telemetry) = connection_context.telemetry_provider.as_ref() {
+                let error_response =
+                    CommandError::from_error(connection_context, &e, request_context.activity_id)
+                        .await;
+                let response_size = error_response
+                    .to_raw_document_buf()
+                    .map_or(0, |response| response.as_bytes().len());
+                telemetry
+                    .emit_request_event(
+                        connection_context,
+                        header,
+                        Some(request_context.payload),
+                        Right((&error_response, response_size)),
+                        collection.to_string(),
+                        request_context.tracker,
+                        request_context.activity_id,
+                        &parse_client_info(connection_context.client_information.as_ref()),
+                    )
+                    .await;
+            }
+            return Ok(());
+        }
         Err(e) => {
             return Err(e);
         }
     };
 
     // Write the response back to the stream
-    if connection_context.requires_response {
+    if connection_context.requires_response && !is_unacknowledged_write {
         responses::writer::write(header, &response, stream).await?;
     }
 
@@ -456,6 +489,23 @@ where
     Ok(())
 }
 
+async fn is_unacknowledged_write(
+    connection_context: &ConnectionContext,
+    request_context: &RequestContext<'_>,
+) -> bool {
+    request_context
+        .info
+        .write_concern()
+        .allows_early_acknowledgment(
+            request_context.payload.request_type(),
+            request_context.info.transaction_info.is_some(),
+        )
+        && connection_context
+            .dynamic_configuration()
+            .allow_unacknowledged_writes()
+            .await
+}
+
 #[expect(clippy::too_many_arguments)]
 async fn log_and_write_error(
     connection_context: &ConnectionContext,
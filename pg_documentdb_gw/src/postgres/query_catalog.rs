@@ -70,6 +70,7 @@ pub struct QueryCatalog {
     pub insert: String,
     pub aggregate_cursor_first_page: String,
     pub process_update: String,
+    pub process_update_bulk: String,
     pub list_databases: String, // Has 1 param
     pub list_collections: String,
     pub validate: String,
@@ -285,6 +286,10 @@ impl QueryCatalog {
         &self.process_update
     }
 
+    pub fn process_update_bulk(&self) -> &str {
+        &self.process_update_bulk
+    }
+
     pub fn list_databases(&self, filter_string: &str) -> String {
         self.list_databases
             .replace("{filter_string}", filter_string)
@@ -459,6 +464,7 @@ pub fn create_query_catalog() -> QueryCatalog {
             insert: "SELECT * FROM documentdb_api.insert($1, $2, $3, NULL)".to_string(),
             aggregate_cursor_first_page: "SELECT cursorPage, continuation, persistConnection, cursorId FROM documentdb_api.aggregate_cursor_first_page($1, $2)".to_string(),
             process_update: "SELECT * FROM documentdb_api.update($1, $2, $3, NULL)".to_string(),
+            process_update_bulk: "CALL documentdb_api.update_bulk($1, $2, $3, NULL)".to_string(),
             list_databases: "WITH r1 AS (SELECT DISTINCT database_name AS name
                                 FROM documentdb_api_catalog.collections),
                              r2 AS (SELECT documentdb_core.row_get_bson(r1) AS document FROM r1),
@@ -6,18 +6,26 @@
  *-------------------------------------------------------------------------
  */
 
-use std::sync::Arc;
+use std::{
+    sync::Arc,
+    time::{Duration, Instant},
+};
 
-use bson::{spec::ElementType, RawBsonRef, RawDocumentBuf};
+use bson::{rawdoc, spec::ElementType, RawArrayBuf, RawBsonRef, RawDocument, RawDocumentBuf};
+use tokio_postgres::types::Type;
 
 use crate::{
     bson::convert_to_bool,
     configuration::DynamicConfiguration,
-    context::{ConnectionContext, RequestContext},
+    context::{
+        split_insert_group_response, split_update_group_response, ConnectionContext,
+        GroupedWriteResult, RequestContext, WriteGroup,
+    },
     error::{DocumentDBError, ErrorCode, Result},
-    postgres::PgDataClient,
+    postgres::{Connection, PgDataClient, PgDocument},
     processor::cursor,
-    responses::{PgResponse, Response},
+    requests::{request_tracker::RequestTracker, Request},
+    responses::{PgResponse, RawResponse, Response},
 };
 
 pub async fn process_delete(
@@ -56,8 +64,23 @@ pub async fn process_find(
 pub async fn process_insert(
     request_context: &mut RequestContext<'_>,
     connection_context: &ConnectionContext,
+    dynamic_config: &Arc<dyn DynamicConfiguration>,
     pg_data_client: &impl PgDataClient,
 ) -> Result<Response> {
+    if dynamic_config.enable_group_inserts().await {
+        if let Some(response) = process_grouped_write(
+            request_context,
+            connection_context,
+            dynamic_config,
+            pg_data_client,
+            WriteGroupKind::Insert,
+        )
+        .await?
+        {
+            return Ok(response);
+        }
+    }
+
     let insert_rows = pg_data_client
         .execute_insert(request_context, connection_context)
         .await?;
@@ -67,6 +90,383 @@ pub async fn process_insert(
         .await
 }
 
+#[derive(Clone, Copy)]
+enum WriteGroupKind {
+    Insert,
+    Update,
+}
+
+/// Single statement writes of the same user into the same collection, with the same
+/// writeConcern, that arrive within the group write window are run together by one unordered
+/// write command, so that they share its commits. Each request still gets the response for its
+/// own statement.
+/// Returns None if the request can't be grouped, or if nothing of the group was written, in
+/// which case the write runs on its own.
+async fn process_grouped_write(
+    request_context: &mut RequestContext<'_>,
+    connection_context: &ConnectionContext,
+    dynamic_config: &Arc<dyn DynamicConfiguration>,
+    pg_data_client: &impl PgDataClient,
+    kind: WriteGroupKind,
+) -> Result<Option<Response>> {
+    let request_info = request_context.info;
+    if connection_context.transaction.is_some()
+        || request_info.transaction_info.is_some()
+        || request_info.max_time_ms.is_some()
+    {
+        return Ok(None);
+    }
+
+    let (command, statements_field) = match kind {
+        WriteGroupKind::Insert => ("insert", "documents"),
+        WriteGroupKind::Update => ("update", "updates"),
+    };
+    let (statement, write_concern) =
+        match single_write_statement(request_context.payload, command, statements_field)? {
+            Some(statement) => statement,
+            None => return Ok(None),
+        };
+
+    let key = (
+        connection_context.auth_state.username()?.to_string(),
+        request_info.db()?.to_string(),
+        request_info.collection()?.to_string(),
+        write_concern
+            .as_ref()
+            .map(|write_concern| write_concern.as_bytes().to_vec())
+            .unwrap_or_default(),
+    );
+    let store = match kind {
+        WriteGroupKind::Insert => connection_context.service_context.insert_group_store(),
+        WriteGroupKind::Update => connection_context.service_context.update_group_store(),
+    };
+    let max_documents = dynamic_config.group_write_max_documents().await.max(1) as usize;
+    let (leader, receiver) = store.join(key, statement, max_documents);
+
+    if let Some(leader) = leader {
+        let window = dynamic_config.group_write_window_micro_secs().await.max(0) as u64;
+        wait_for_group_window(Duration::from_micros(window)).await;
+
+        if let Some(group) = leader.close() {
+            execute_write_group(
+                request_context,
+                connection_context,
+                pg_data_client,
+                kind,
+                group,
+                write_concern,
+            )
+            .await;
+        }
+    }
+
+    match receiver.await {
+        Ok(GroupedWriteResult::Response(response)) => {
+            let response = PgResponse::transform_document_write_errors(
+                &response,
+                connection_context,
+                request_context.activity_id,
+            )
+            .await?
+            .unwrap_or(response);
+            Ok(Some(Response::Raw(RawResponse(response))))
+        }
+        Ok(GroupedWriteResult::Failed) => Ok(None),
+        Ok(GroupedWriteResult::Error(message)) => Err(DocumentDBError::internal_error(message)),
+        Err(_) => Err(DocumentDBError::internal_error(
+            "Grouped write was interrupted before reporting its result.".to_string(),
+        )),
+    }
+}
+
+/// Waits for other writes to join a group. Tokio timers have a resolution of a millisecond, so
+/// windows shorter than that are waited by yielding to the other tasks, which lets the writes
+/// that are already in flight join, until the window has elapsed.
+async fn wait_for_group_window(window: Duration) {
+    if window >= Duration::from_millis(1) {
+        tokio::time::sleep(window).await;
+        return;
+    }
+
+    let start = Instant::now();
+    while start.elapsed() < window {
+        tokio::task::yield_now().await;
+    }
+}
+
+/// Returns the only statement of a write command, and its writeConcern, if the command has
+/// exactly one statement and no options that would differ between the requests of a group.
+fn single_write_statement(
+    request: &Request<'_>,
+    command: &str,
+    statements_field: &str,
+) -> Result<Option<(RawDocumentBuf, Option<RawDocumentBuf>)>> {
+    let mut statements = None;
+    let mut write_concern = None;
+    for entry in request.document() {
+        let (k, v) = entry?;
+        match k {
+            _ if k == statements_field => statements = Some(v),
+            "writeConcern" => match v.as_document() {
+                Some(document) => write_concern = Some(document.to_raw_document_buf()),
+                None => return Ok(None),
+            },
+            "ordered" if v.element_type() == ElementType::Boolean => {}
+            _ if k == command => {}
+            "$db" | "lsid" | "$clusterTime" | "$readPreference" => {}
+            _ => return Ok(None),
+        }
+    }
+
+    let statement = match (statements, request.extra()) {
+        (Some(RawBsonRef::Array(statements)), None) => {
+            let mut statements = statements.into_iter();
+            match (statements.next(), statements.next()) {
+                (Some(statement), None) => statement.ok().and_then(|s| s.as_document()),
+                _ => None,
+            }
+        }
+        // A document sequence holds exactly one document if it spans all of it
+        (None, Some(extra)) => RawDocument::from_bytes(extra).ok(),
+        _ => None,
+    };
+
+    let statement =
+        statement.filter(|statement| command != "update" || is_groupable_update(statement));
+    Ok(statement.map(|statement| (statement.to_raw_document_buf(), write_concern)))
+}
+
+/// Whether an update statement is well formed, so that it can't fail the command of its group
+/// as a whole: any other failure of the statement is reported as a write error of its own.
+fn is_groupable_update(statement: &RawDocument) -> bool {
+    let mut has_query = false;
+    let mut has_update = false;
+    for entry in statement {
+        let (k, v) = match entry {
+            Ok(entry) => entry,
+            Err(_) => return false,
+        };
+        let is_valid = match k {
+            "q" => {
+                has_query = true;
+                v.element_type() == ElementType::EmbeddedDocument
+            }
+            "u" => {
+                has_update = true;
+                matches!(
+                    v.element_type(),
+                    ElementType::EmbeddedDocument | ElementType::Array
+                )
+            }
+            "upsert" | "multi" => v.element_type() == ElementType::Boolean,
+            "arrayFilters" => v.element_type() == ElementType::Array,
+            "sort" => v.element_type() == ElementType::EmbeddedDocument,
+            "hint" => true,
+            _ => false,
+        };
+        if !is_valid {
+            return false;
+        }
+    }
+
+    has_query && has_update
+}
+
+/// Runs a group on behalf of its leader. The statements run in a task of their own so that
+/// the members get their result even if the request of the leader is cancelled meanwhile.
+/// If the group can't be started, it is dropped and its members write on their own.
+async fn execute_write_group(
+    request_context: &RequestContext<'_>,
+    connection_context: &ConnectionContext,
+    pg_data_client: &impl PgDataClient,
+    kind: WriteGroupKind,
+    group: WriteGroup,
+    write_concern: Option<RawDocumentBuf>,
+) {
+    let activity_id = request_context.activity_id.to_string();
+    let (db, collection) = match (request_context.info.db(), request_context.info.collection()) {
+        (Ok(db), Ok(collection)) => (db.to_string(), collection.to_string()),
+        _ => return,
+    };
+
+    let connection = match pg_data_client.pull_connection_with_transaction(false).await {
+        Ok(connection) => connection,
+        Err(e) => {
+            log::warn!(
+                activity_id = activity_id.as_str();
+                "Failed to get a connection for a grouped write, running its writes on their own: {e}"
+            );
+            return;
+        }
+    };
+
+    let query_catalog = connection_context.service_context.query_catalog();
+    let task = match kind {
+        WriteGroupKind::Insert => tokio::spawn(execute_insert_group(
+            connection,
+            query_catalog.insert().to_string(),
+            db,
+            collection,
+            write_concern,
+            group,
+            activity_id.clone(),
+        )),
+        WriteGroupKind::Update => tokio::spawn(execute_update_group(
+            connection,
+            query_catalog.process_update_bulk().to_string(),
+            db,
+            collection,
+            write_concern,
+            group,
+            activity_id.clone(),
+        )),
+    };
+
+    if let Err(e) = task.await {
+        log::error!(activity_id = activity_id.as_str(); "Grouped write task failed: {e}");
+    }
+}
+
+/// Whether the error was raised by the server for the statement, which then wrote nothing.
+fn is_statement_error(error: &DocumentDBError) -> bool {
+    matches!(error, DocumentDBError::PostgresError(e, _) if e.as_db_error().is_some())
+}
+
+/// Writes the documents of a group with one unordered insert and hands every member its part
+/// of the response. Once the insert has committed, the members are never told to insert again.
+async fn execute_insert_group(
+    connection: Connection,
+    query: String,
+    db: String,
+    collection: String,
+    write_concern: Option<RawDocumentBuf>,
+    group: WriteGroup,
+    activity_id: String,
+) {
+    let WriteGroup { documents, members } = group;
+    let mut documents_array = RawArrayBuf::new();
+    for document in documents {
+        documents_array.push(document);
+    }
+
+    let mut request = rawdoc! {
+        "insert": collection,
+        "documents": documents_array,
+        "ordered": false,
+        "$db": db.as_str(),
+    };
+    if let Some(write_concern) = write_concern {
+        request.append("writeConcern", write_concern);
+    }
+
+    let mut request_tracker = RequestTracker::new();
+    let insert_rows = match connection
+        .query(
+            &query,
+            &[Type::TEXT, Type::BYTEA, Type::BYTEA],
+            &[&db, &PgDocument(&request), &None::<&[u8]>],
+            None,
+            &mut request_tracker,
+        )
+        .await
+    {
+        Ok(insert_rows) => insert_rows,
+        Err(e) if is_statement_error(&e) => {
+            log::warn!(
+                activity_id = activity_id.as_str();
+                "Grouped insert failed, running its inserts on their own: {e}"
+            );
+            return;
+        }
+        Err(e) => {
+            log::error!(activity_id = activity_id.as_str(); "Grouped insert was interrupted: {e}");
+            members.send_error(&format!("Grouped insert was interrupted: {e}"));
+            return;
+        }
+    };
+
+    let responses = PgResponse::new(insert_rows)
+        .as_raw_document()
+        .and_then(|response| split_insert_group_response(response, members.len()));
+    match responses {
+        Ok(responses) => members.send(responses.into_iter().map(GroupedWriteResult::Response)),
+        Err(e) => {
+            log::error!(
+                activity_id = activity_id.as_str();
+                "Failed to split the response of a grouped insert: {e}"
+            );
+            members.send_error(&format!(
+                "Grouped insert ran but its response could not be read: {e}"
+            ));
+        }
+    }
+}
+
+/// Runs the updates of a group as one unordered bulk update and hands every member its part of
+/// the response. The bulk update commits as it goes, so if it fails part of the group may have
+/// been written and the members are never told to update again.
+async fn execute_update_group(
+    connection: Connection,
+    query: String,
+    db: String,
+    collection: String,
+    write_concern: Option<RawDocumentBuf>,
+    group: WriteGroup,
+    activity_id: String,
+) {
+    let WriteGroup { documents, members } = group;
+    let mut updates_array = RawArrayBuf::new();
+    for update in documents {
+        updates_array.push(update);
+    }
+
+    let mut request = rawdoc! {
+        "update": collection,
+        "updates": updates_array,
+        "ordered": false,
+        "returnStatementResults": true,
+        "$db": db.as_str(),
+    };
+    if let Some(write_concern) = write_concern {
+        request.append("writeConcern", write_concern);
+    }
+
+    let mut request_tracker = RequestTracker::new();
+    let update_rows = match connection
+        .query(
+            &query,
+            &[Type::TEXT, Type::BYTEA, Type::BYTEA],
+            &[&db, &PgDocument(&request), &None::<&[u8]>],
+            None,
+            &mut request_tracker,
+        )
+        .await
+    {
+        Ok(update_rows) => update_rows,
+        Err(e) => {
+            log::error!(activity_id = activity_id.as_str(); "Grouped update failed: {e}");
+            members.send_error(&format!("Grouped update failed: {e}"));
+            return;
+        }
+    };
+
+    let responses = PgResponse::new(update_rows)
+        .as_raw_document()
+        .and_then(|response| split_update_group_response(response, members.len()));
+    match responses {
+        Ok(responses) => members.send(responses.into_iter().map(GroupedWriteResult::Response)),
+        Err(e) => {
+            log::error!(
+                activity_id = activity_id.as_str();
+                "Failed to split the response of a grouped update: {e}"
+            );
+            members.send_error(&format!(
+                "Grouped update ran but its response could not be read: {e}"
+            ));
+        }
+    }
+}
+
 pub async fn process_aggregate(
     request_context: &mut RequestContext<'_>,
     connection_context: &ConnectionContext,
@@ -82,8 +482,23 @@ pub async fn process_aggregate(
 pub async fn process_update(
     request_context: &mut RequestContext<'_>,
     connection_context: &ConnectionContext,
+    dynamic_config: &Arc<dyn DynamicConfiguration>,
     pg_data_client: &impl PgDataClient,
 ) -> Result<Response> {
+    if dynamic_config.enable_group_updates().await {
+        if let Some(response) = process_grouped_write(
+            request_context,
+            connection_context,
+            dynamic_config,
+            pg_data_client,
+            WriteGroupKind::Update,
+        )
+        .await?
+        {
+            return Ok(response);
+        }
+    }
+
     let update_rows = pg_data_client
         .execute_update(request_context, connection_context)
         .await?;
@@ -176,6 +176,7 @@ pub async fn process_request(
                 data_management::process_insert(
                     request_context,
                     connection_context,
+                    &dynamic_config,
                     &pg_data_client,
                 )
                 .await
@@ -220,6 +221,7 @@ pub async fn process_request(
                 data_management::process_update(
                     request_context,
                     connection_context,
+                    &dynamic_config,
                     &pg_data_client,
                 )
                 .await
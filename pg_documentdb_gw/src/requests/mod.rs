@@ -9,6 +9,7 @@
 pub mod read_concern;
 pub mod read_preference;
 pub mod request_tracker;
+pub mod write_concern;
 
 use std::{
     fmt::{self, Debug},
@@ -19,6 +20,7 @@ use bson::{spec::ElementType, Document, RawBsonRef, RawDocument, RawDocumentBuf}
 use read_concern::ReadConcern;
 use read_preference::ReadPreference;
 use tokio_postgres::IsolationLevel;
+use write_concern::WriteConcern;
 
 use crate::{
     bson::convert_to_f64,
@@ -52,6 +54,7 @@ pub struct RequestInfo<'a> {
     collection: Option<&'a str>,
     pub session_id: Option<&'a [u8]>,
     read_concern: ReadConcern,
+    write_concern: WriteConcern,
 }
 
 impl RequestInfo<'_> {
@@ -63,6 +66,7 @@ impl RequestInfo<'_> {
             collection: None,
             session_id: None,
             read_concern: ReadConcern::default(),
+            write_concern: WriteConcern::default(),
         }
     }
 
@@ -82,6 +86,10 @@ impl RequestInfo<'_> {
     pub fn read_concern(&self) -> &ReadConcern {
         &self.read_concern
     }
+
+    pub fn write_concern(&self) -> &WriteConcern {
+        &self.write_concern
+    }
 }
 
 #[derive(PartialEq, Debug)]
@@ -349,6 +357,7 @@ impl<'a> Request<'a> {
         let mut isolation_level = None;
         let mut collection = None;
         let mut read_concern = ReadConcern::default();
+        let mut write_concern = WriteConcern::default();
 
         let collection_field = self.collection_field();
         for entry in self.document() {
@@ -406,6 +415,7 @@ impl<'a> Request<'a> {
                         isolation_level = Some(IsolationLevel::RepeatableRead)
                     }
                 }
+                "writeConcern" => write_concern = WriteConcern::parse(v.as_document()),
                 "$readPreference" => ReadPreference::parse(v.as_document())?,
                 key if collection_field.contains(&key) => {
                     // Aggregate needs special handling because having '1' as a collection is valid
@@ -443,6 +453,7 @@ impl<'a> Request<'a> {
             transaction_info,
             db,
             read_concern,
+            write_concern,
         })
     }
 
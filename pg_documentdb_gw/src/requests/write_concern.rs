@@ -0,0 +1,106 @@
+/*-------------------------------------------------------------------------
+ * Copyright (c) Microsoft Corporation.  All rights reserved.
+ *
+ * src/requests/write_concern.rs
+ *
+ *-------------------------------------------------------------------------
+ */
+
+use bson::RawDocument;
+
+use crate::{bson::convert_to_f64, requests::RequestType};
+
+#[derive(Debug, Default, PartialEq)]
+pub enum WriteConcern {
+    /// Write concern is not specified or waits for an acknowledgment.
+    #[default]
+    Acknowledged,
+
+    /// The client does not wait for an acknowledgment ({ w: 0 }).
+    Unacknowledged,
+}
+
+impl WriteConcern {
+    pub fn parse(write_concern: Option<&RawDocument>) -> Self {
+        // Tagged and "majority" write concerns are strings and always acknowledged
+        let num_nodes = write_concern
+            .and_then(|doc| doc.get("w").ok().flatten())
+            .and_then(convert_to_f64);
+        match num_nodes {
+            Some(num_nodes) if num_nodes == 0.0 => WriteConcern::Unacknowledged,
+            _ => WriteConcern::Acknowledged,
+        }
+    }
+
+    /// Whether a request may be acknowledged before it runs, when the server policy allows it.
+    /// Only insert, update and delete qualify, and never inside a transaction since
+    /// transactions always need to hear about failed writes.
+    pub fn allows_early_acknowledgment(
+        &self,
+        request_type: &RequestType,
+        in_transaction: bool,
+    ) -> bool {
+        let is_write = matches!(
+            request_type,
+            RequestType::Insert | RequestType::Update | RequestType::Delete
+        );
+
+        is_write && !in_transaction && *self == WriteConcern::Unacknowledged
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use bson::rawdoc;
+
+    use super::*;
+
+    #[test]
+    fn test_parse_write_concern() {
+        assert_eq!(WriteConcern::parse(None), WriteConcern::Acknowledged);
+        assert_eq!(
+            WriteConcern::parse(Some(&rawdoc! {})),
+            WriteConcern::Acknowledged
+        );
+        assert_eq!(
+            WriteConcern::parse(Some(&rawdoc! { "w": 0 })),
+            WriteConcern::Unacknowledged
+        );
+        assert_eq!(
+            WriteConcern::parse(Some(&rawdoc! { "w": 0.0, "j": true })),
+            WriteConcern::Unacknowledged
+        );
+        assert_eq!(
+            WriteConcern::parse(Some(&rawdoc! { "w": 0_i64 })),
+            WriteConcern::Unacknowledged
+        );
+        assert_eq!(
+            WriteConcern::parse(Some(&rawdoc! { "w": 1 })),
+            WriteConcern::Acknowledged
+        );
+        assert_eq!(
+            WriteConcern::parse(Some(&rawdoc! { "w": "majority" })),
+            WriteConcern::Acknowledged
+        );
+        assert_eq!(
+            WriteConcern::parse(Some(&rawdoc! { "j": false })),
+            WriteConcern::Acknowledged
+        );
+    }
+
+    #[test]
+    fn test_allows_early_acknowledgment() {
+        let unacknowledged = WriteConcern::Unacknowledged;
+        assert!(unacknowledged.allows_early_acknowledgment(&RequestType::Insert, false));
+        assert!(unacknowledged.allows_early_acknowledgment(&RequestType::Update, false));
+        assert!(unacknowledged.allows_early_acknowledgment(&RequestType::Delete, false));
+
+        // Transactions and other commands always get their response
+        assert!(!unacknowledged.allows_early_acknowledgment(&RequestType::Insert, true));
+        assert!(!unacknowledged.allows_early_acknowledgment(&RequestType::FindAndModify, false));
+        assert!(!unacknowledged.allows_early_acknowledgment(&RequestType::Find, false));
+
+        let acknowledged = WriteConcern::Acknowledged;
+        assert!(!acknowledged.allows_early_acknowledgment(&RequestType::Insert, false));
+    }
+}
@@ -81,24 +81,38 @@ impl PgResponse {
         context: &ConnectionContext,
         activity_id: &str,
     ) -> Result<Response> {
-        if let Ok(Some(_)) = self.as_raw_document()?.get("writeErrors") {
+        if let Some(raw) =
+            Self::transform_document_write_errors(self.as_raw_document()?, context, activity_id)
+                .await?
+        {
+            return Ok(Response::Raw(RawResponse(raw)));
+        }
+        Ok(Response::Pg(self))
+    }
+
+    /// Same as transform_write_errors for a response document built by the gateway.
+    /// Returns None if the document has no 'writeErrors'.
+    pub async fn transform_document_write_errors(
+        document: &RawDocument,
+        context: &ConnectionContext,
+        activity_id: &str,
+    ) -> Result<Option<RawDocumentBuf>> {
+        if let Ok(Some(_)) = document.get("writeErrors") {
             // TODO: Conceivably faster without conversion to document
-            let mut response = Document::try_from(self.as_raw_document()?)?;
+            let mut response = Document::try_from(document)?;
             let write_errors = response.get_array_mut("writeErrors").map_err(|e| {
                 DocumentDBError::internal_error(pg_returned_invalid_response_message(e))
             })?;
 
             for value in write_errors {
-                self.transform_error(context, value, activity_id).await?;
+                Self::transform_error(context, value, activity_id).await?;
             }
-            let raw = RawDocumentBuf::from_document(&response)?;
-            return Ok(Response::Raw(RawResponse(raw)));
+            return Ok(Some(RawDocumentBuf::from_document(&response)?));
         }
-        Ok(Response::Pg(self))
+        Ok(None)
     }
 
     async fn transform_error(
-        &self,
         context: &ConnectionContext,
         bson: &mut Bson,
         activity_id: &str,
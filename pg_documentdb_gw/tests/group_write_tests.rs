@@ -0,0 +1,158 @@
+/*-------------------------------------------------------------------------
+ * Copyright (c) Microsoft Corporation.  All rights reserved.
+ *
+ * tests/group_write_tests.rs
+ *
+ *-------------------------------------------------------------------------
+ */
+
+use std::time::Duration;
+
+use bson::{doc, Document};
+use mongodb::{
+    error::{ErrorKind, WriteFailure},
+    Collection,
+};
+use tokio::task::JoinSet;
+use tokio_postgres::NoTls;
+
+pub mod common;
+
+async fn set_group_writes(setting: &str, enabled: bool) {
+    let (client, connection) = tokio_postgres::Config::new()
+        .host("localhost")
+        .port(9712)
+        .dbname("postgres")
+        .connect(NoTls)
+        .await
+        .unwrap();
+    tokio::spawn(connection);
+
+    client
+        .batch_execute(&format!(
+            "ALTER SYSTEM SET documentdb.{setting} TO {enabled}; ALTER SYSTEM SET documentdb.groupWriteWindowInMicroSec TO 20000; SELECT pg_reload_conf();"
+        ))
+        .await
+        .unwrap();
+}
+
+fn write_error_code(error: &mongodb::error::Error) -> Option<i32> {
+    match *error.kind {
+        ErrorKind::Write(WriteFailure::WriteError(ref write_error)) => Some(write_error.code),
+        _ => None,
+    }
+}
+
+/*
+ * Concurrent insertOne calls grouped by the gateway each get the result of their own document:
+ * duplicate _ids fail with a duplicate key error, within a group and against an existing
+ * document, and every other document is inserted exactly once.
+*/
+#[tokio::test]
+pub async fn validate_grouped_inserts() {
+    let mut config = common::configuration();
+    config.dynamic_configuration_refresh_interval_secs = Some(1);
+    let client = common::initialize_with_config(config).await;
+    let db = common::setup_db(&client, "group_write_tests_insert").await;
+    let coll: Collection<Document> = db.collection("test");
+    coll.insert_one(doc! { "_id": 0 }).await.unwrap();
+
+    set_group_writes("enableGroupInserts", true).await;
+    tokio::time::sleep(Duration::from_secs(3)).await;
+
+    // _id 0 already exists and _id 100 is inserted twice
+    let ids = (1..=20).chain([0, 100, 100]);
+    let mut inserts = JoinSet::new();
+    for id in ids {
+        let coll = coll.clone();
+        inserts.spawn(async move { (id, coll.insert_one(doc! { "_id": id }).await) });
+    }
+
+    let mut duplicates = 0;
+    while let Some(result) = inserts.join_next().await {
+        let (id, result) = result.unwrap();
+        match result {
+            Ok(_) => assert!(id != 0, "_id 0 should be a duplicate"),
+            Err(e) => {
+                assert!(id == 0 || id == 100, "_id {id} failed: {e:?}");
+                assert_eq!(write_error_code(&e), Some(11000), "{e:?}");
+                duplicates += 1;
+            }
+        }
+    }
+    assert_eq!(duplicates, 2);
+    assert_eq!(coll.count_documents(doc! {}).await.unwrap(), 22);
+
+    // Requests with different writeConcerns are not grouped together but all succeed
+    let mut inserts = JoinSet::new();
+    for id in 200..210 {
+        let db = db.clone();
+        inserts.spawn(async move {
+            let mut command = doc! { "insert": "test", "documents": [{ "_id": id }] };
+            if id % 2 == 0 {
+                command.insert("writeConcern", doc! { "w": 1 });
+            }
+            db.run_command(command).await
+        });
+    }
+    while let Some(result) = inserts.join_next().await {
+        let result = result.unwrap().unwrap();
+        assert_eq!(result.get_i32("n"), Ok(1), "{result:?}");
+        assert!(result.get_array("writeErrors").is_err(), "{result:?}");
+    }
+    assert_eq!(coll.count_documents(doc! {}).await.unwrap(), 32);
+
+    set_group_writes("enableGroupInserts", false).await;
+}
+
+/*
+ * Concurrent updateOne calls grouped by the gateway run as one unordered bulk update: every
+ * $inc is applied once and each request reports its own match and modification.
+*/
+#[tokio::test]
+pub async fn validate_grouped_updates() {
+    let mut config = common::configuration();
+    config.dynamic_configuration_refresh_interval_secs = Some(1);
+    let client = common::initialize_with_config(config).await;
+    let db = common::setup_db(&client, "group_write_tests_update").await;
+    let coll: Collection<Document> = db.collection("test");
+    coll.insert_one(doc! { "_id": 1, "n": 0 }).await.unwrap();
+    coll.insert_one(doc! { "_id": 2, "n": 0 }).await.unwrap();
+
+    set_group_writes("enableGroupUpdates", true).await;
+    tokio::time::sleep(Duration::from_secs(3)).await;
+
+    let mut updates = JoinSet::new();
+    for i in 0..20 {
+        let coll = coll.clone();
+        let id = if i % 2 == 0 { 1 } else { 2 };
+        updates.spawn(async move {
+            coll.update_one(doc! { "_id": id }, doc! { "$inc": { "n": 1 } })
+                .await
+        });
+    }
+    // An update that matches nothing is reported as such and does not affect the others
+    let no_match = coll.clone();
+    updates.spawn(async move {
+        no_match
+            .update_one(doc! { "_id": 3 }, doc! { "$inc": { "n": 1 } })
+            .await
+    });
+
+    let mut matched = 0;
+    let mut modified = 0;
+    while let Some(result) = updates.join_next().await {
+        let result = result.unwrap().unwrap();
+        matched += result.matched_count;
+        modified += result.modified_count;
+    }
+    assert_eq!(matched, 20);
+    assert_eq!(modified, 20);
+
+    for id in [1, 2] {
+        let document = coll.find_one(doc! { "_id": id }).await.unwrap().unwrap();
+        assert_eq!(document.get_i32("n"), Ok(10), "{document:?}");
+    }
+
+    set_group_writes("enableGroupUpdates", false).await;
+}
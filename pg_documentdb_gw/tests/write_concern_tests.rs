@@ -0,0 +1,93 @@
+/*-------------------------------------------------------------------------
+ * Copyright (c) Microsoft Corporation.  All rights reserved.
+ *
+ * tests/write_concern_tests.rs
+ *
+ *-------------------------------------------------------------------------
+ */
+
+use std::time::Duration;
+
+use bson::doc;
+use tokio_postgres::NoTls;
+
+pub mod common;
+
+async fn set_write_concern_relaxation(value: &str) {
+    let (client, connection) = tokio_postgres::Config::new()
+        .host("localhost")
+        .port(9712)
+        .dbname("postgres")
+        .connect(NoTls)
+        .await
+        .unwrap();
+    tokio::spawn(connection);
+
+    client
+        .batch_execute(&format!(
+            "ALTER SYSTEM SET documentdb.writeConcernRelaxation TO '{value}'; SELECT pg_reload_conf();"
+        ))
+        .await
+        .unwrap();
+}
+
+/*
+ * Verify that a { w: 0 } insert is acknowledged before it runs once the server allows it:
+ * a failing insert still gets { ok: 1 } without write errors, a valid insert is applied.
+*/
+#[tokio::test]
+pub async fn validate_unacknowledged_insert_is_acknowledged_early() {
+    let mut config = common::configuration();
+    config.dynamic_configuration_refresh_interval_secs = Some(1);
+    let client = common::initialize_with_config(config).await;
+    let db = common::setup_db(&client, "write_concern_tests_early_ack").await;
+    let coll = db.collection("test");
+    coll.insert_one(doc! { "_id": 1 }).await.unwrap();
+
+    // With the default policy the duplicate key error is sent back
+    let result = db
+        .run_command(doc! {
+            "insert": "test",
+            "documents": [{ "_id": 1 }],
+            "writeConcern": { "w": 0 }
+        })
+        .await
+        .unwrap();
+    assert!(result.get_array("writeErrors").is_ok(), "{result:?}");
+
+    set_write_concern_relaxation("unacknowledged").await;
+    tokio::time::sleep(Duration::from_secs(3)).await;
+
+    let result = db
+        .run_command(doc! {
+            "insert": "test",
+            "documents": [{ "_id": 1 }],
+            "writeConcern": { "w": 0 }
+        })
+        .await
+        .unwrap();
+    assert_eq!(result, doc! { "ok": 1.0 });
+
+    let result = db
+        .run_command(doc! {
+            "insert": "test",
+            "documents": [{ "_id": 2 }],
+            "writeConcern": { "w": 0 }
+        })
+        .await
+        .unwrap();
+    assert_eq!(result, doc! { "ok": 1.0 });
+
+    // The insert runs after the acknowledgment
+    let mut count = 0;
+    for _ in 0..50 {
+        count = coll.count_documents(doc! {}).await.unwrap();
+        if count == 2 {
+            break;
+        }
+        tokio::time::sleep(Duration::from_millis(100)).await;
+    }
+    assert_eq!(count, 2);
+
+    set_write_concern_relaxation("none").await;
+}
@@ -0,0 +1,110 @@
+#!/bin/bash
+
+# exit immediately if a command exits with a non-zero status
+set -e
+# fail if trying to reference a variable that is not set.
+set -u
+
+PG_VERSION=16
+
+# Overrides from environment
+if [ "${PG_VERSION_USED:-}" != "" ]; then
+  PG_VERSION=$PG_VERSION_USED
+elif [ "${PGVERSION_USED:-}" != "" ]; then
+  PG_VERSION=${PGVERSION_USED}
+fi
+
+coordinatorPort="9712"
+batchSize="1000"
+clients="4"
+duration="30"
+help="false"
+while getopts "p:b:c:t:h" opt; do
+  case $opt in
+    p) coordinatorPort="$OPTARG"
+    ;;
+    b) batchSize="$OPTARG"
+    ;;
+    c) clients="$OPTARG"
+    ;;
+    t) duration="$OPTARG"
+    ;;
+    h) help="true"
+    ;;
+  esac
+
+  # Assume empty string if it's unset since we cannot reference to
+  # an unset variabled due to "set -u".
+  case ${OPTARG:-""} in
+    -*) echo "Option $opt needs a valid argument. use -h to get help."
+    exit 1
+    ;;
+  esac
+done
+
+if [ "${TERM:-}" == "" ] || [ "${TERM:-}" == "dumb" ]; then
+  red=""
+  green=""
+  reset=""
+else
+  red=`tput setaf 1`
+  green=`tput setaf 2`
+  reset=`tput sgr0`
+fi
+
+if [ "$help" == "true" ]; then
+    echo "${green}measures batched insert throughput with and without documentdb.enableDirectMultiInsert."
+    echo "${green}run_insert_benchmark [-p <port>] [-b <batchSize>] [-c <clients>] [-t <seconds>]"
+    echo "${green}[-p <port>] - optional argument. the port of a server started with start_oss_server.sh (default $coordinatorPort)"
+    echo "${green}[-b <batchSize>] - optional argument. documents per insert command (default $batchSize)"
+    echo "${green}[-c <clients>] - optional argument. concurrent pgbench clients (default $clients)"
+    echo "${green}[-t <seconds>] - optional argument. duration of each run (default $duration)"
+    exit 1;
+fi
+
+source="${BASH_SOURCE[0]}"
+while [[ -h $source ]]; do
+   scriptroot="$( cd -P "$( dirname "$source" )" && pwd )"
+   source="$(readlink "$source")"
+
+   # if $source was a relative symlink, we need to resolve it relative to the path where the
+   # symlink file was located
+   [[ $source != /* ]] && source="$scriptroot/$source"
+done
+
+scriptDir="$( cd -P "$( dirname "$source" )" && pwd )"
+
+. $scriptDir/utils.sh
+
+pg_config_path=$(GetPGConfig $PG_VERSION)
+pgBinDir=$($pg_config_path --bindir)
+PATH=$pgBinDir:$PATH;
+
+psqlCommand="psql -X -q -v ON_ERROR_STOP=1 -p $coordinatorPort -d postgres"
+
+# Build the insert spec once so that the benchmark measures the insert and not the
+# construction of the batch.
+$psqlCommand <<EOF
+DROP TABLE IF EXISTS insert_benchmark_spec;
+CREATE TABLE insert_benchmark_spec AS
+  SELECT ('{ "insert": "insert_benchmark", "ordered": false, "documents": [' ||
+          string_agg(format('{ "a": %s, "b": "value %s" }', i, i), ',') || '] }')::documentdb_core.bson AS spec
+  FROM generate_series(1, $batchSize) i;
+SELECT documentdb_api.drop_collection('benchmark', 'insert_benchmark');
+SELECT documentdb_api.create_collection('benchmark', 'insert_benchmark');
+EOF
+
+benchmarkScript=$(mktemp)
+trap "rm -f $benchmarkScript" EXIT
+echo "SELECT documentdb_api.insert('benchmark', spec) FROM insert_benchmark_spec;" > $benchmarkScript
+
+for mode in off on; do
+  tps=$(PGOPTIONS="-c documentdb.enableDirectMultiInsert=$mode" \
+    pgbench -n -p $coordinatorPort -c $clients -j $clients -T $duration -f $benchmarkScript postgres \
+    | grep -m 1 "^tps" | awk '{ print $3 }')
+  docsPerSecond=$(awk -v tps=$tps -v batch=$batchSize 'BEGIN { printf "%.0f", tps * batch }')
+  echo "${green}enableDirectMultiInsert=$mode: $tps batches/s, $docsPerSecond documents/s${reset}"
+done
+
+$psqlCommand -c "SELECT documentdb_api.drop_collection('benchmark', 'insert_benchmark');" > /dev/null
+$psqlCommand -c "DROP TABLE insert_benchmark_spec;"